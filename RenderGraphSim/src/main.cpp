@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "RenderGraphAllocator.h"
+
+namespace fs = std::filesystem;
+using namespace RenderGraphInternal;
+
+// ============================================================
+// Replays render graph allocation captures (HobbyRenderer --rendergraph-capture <path>, or the "Capture Allocations"
+// button in the Render Graph UI) through the renderer's own heap allocator and aliasing planner, with no GPU.
+// Reports planning time, heap memory and fragmentation; the --max-* limits turn it into a regression check.
+// ============================================================
+
+struct ReplaySummary
+{
+    uint32_t m_NumFrames = 0;
+    size_t m_MaxResources = 0;
+    double m_TotalPlanTimeMs = 0.0;
+    double m_MaxPlanTimeMs = 0.0;
+    uint64_t m_PeakHeapMemory = 0;
+    uint32_t m_PeakNumHeaps = 0;
+    uint64_t m_FinalHeapMemory = 0;
+    uint64_t m_PeakPlacedMemory = 0;
+    uint64_t m_PeakLiveMemory = 0;
+    double m_SumFragmentation = 0.0;
+    float m_MaxFragmentation = 0.0f;
+    uint64_t m_NumAliasedTextures = 0;
+    uint64_t m_NumAliasedBuffers = 0;
+};
+
+static constexpr double kMB = 1024.0 * 1024.0;
+
+static ReplaySummary Replay(const std::vector<RecordedFrame>& frames, bool bPrintFrames)
+{
+    ReplaySummary summary;
+    AllocationSimulator simulator;
+    for (const RecordedFrame& frame : frames)
+    {
+        const AllocationSimulator::FrameResult result = simulator.SimulateFrame(frame);
+        const uint64_t placedMemory = result.m_Textures.m_AllocatedMemory + result.m_Buffers.m_AllocatedMemory;
+        const float fragmentation = result.m_Heaps.GetFragmentationPercent();
+
+        summary.m_NumFrames++;
+        summary.m_MaxResources = std::max(summary.m_MaxResources, frame.m_Resources.size());
+        summary.m_TotalPlanTimeMs += result.m_PlanTimeMs;
+        summary.m_MaxPlanTimeMs = std::max(summary.m_MaxPlanTimeMs, result.m_PlanTimeMs);
+        summary.m_PeakHeapMemory = std::max(summary.m_PeakHeapMemory, result.m_Heaps.m_TotalSize);
+        summary.m_PeakNumHeaps = std::max(summary.m_PeakNumHeaps, result.m_Heaps.m_NumHeaps);
+        summary.m_FinalHeapMemory = result.m_Heaps.m_TotalSize;
+        summary.m_PeakPlacedMemory = std::max(summary.m_PeakPlacedMemory, placedMemory);
+        summary.m_PeakLiveMemory = std::max(summary.m_PeakLiveMemory, result.m_PeakLiveMemory);
+        summary.m_SumFragmentation += fragmentation;
+        summary.m_MaxFragmentation = std::max(summary.m_MaxFragmentation, fragmentation);
+        summary.m_NumAliasedTextures += result.m_Textures.m_NumAliased;
+        summary.m_NumAliasedBuffers += result.m_Buffers.m_NumAliased;
+
+        if (bPrintFrames)
+        {
+            std::cout << "  frame " << frame.m_FrameNumber << ": " << frame.m_Resources.size() << " resources, "
+                      << result.m_Textures.m_NumAliased + result.m_Buffers.m_NumAliased << " aliased, placed "
+                      << placedMemory / kMB << " MB (live peak " << result.m_PeakLiveMemory / kMB << " MB), heaps "
+                      << result.m_Heaps.m_NumHeaps << " / " << result.m_Heaps.m_TotalSize / kMB << " MB, "
+                      << fragmentation << "% fragmented, " << result.m_PlanTimeMs << " ms\n";
+        }
+    }
+    return summary;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<fs::path> inputs;
+    uint32_t iterations = 1;
+    bool bDisableAliasing = false;
+    bool bPrintFrames = false;
+    double maxHeapMB = 0.0;
+    double maxFragmentation = 0.0;
+
+    const char* usage = "Usage: RenderGraphSim -i <capture.json> [-i <capture.json> ...] [--iterations <n>] [--no-aliasing]\n"
+                        "                      [--frames] [--max-heap-mb <MB>] [--max-fragmentation <percent>]\n";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if ((arg == "-i" || arg == "--input") && i + 1 < argc)
+        {
+            inputs.emplace_back(argv[++i]);
+        }
+        else if (arg == "--iterations" && i + 1 < argc)
+        {
+            iterations = std::max(1u, (uint32_t)std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (arg == "--no-aliasing")
+        {
+            bDisableAliasing = true;
+        }
+        else if (arg == "--frames")
+        {
+            bPrintFrames = true;
+        }
+        else if (arg == "--max-heap-mb" && i + 1 < argc)
+        {
+            maxHeapMB = std::strtod(argv[++i], nullptr);
+        }
+        else if (arg == "--max-fragmentation" && i + 1 < argc)
+        {
+            maxFragmentation = std::strtod(argv[++i], nullptr);
+        }
+        else
+        {
+            std::cerr << "[RenderGraphSim] Unknown argument: " << arg << '\n' << usage;
+            return 1;
+        }
+    }
+
+    if (inputs.empty())
+    {
+        std::cerr << "[RenderGraphSim] No capture specified. Use -i <path>.\n" << usage;
+        return 1;
+    }
+
+    bool bWithinLimits = true;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const fs::path& input : inputs)
+    {
+        std::ifstream file(input);
+        std::vector<RecordedFrame> frames;
+        std::string error;
+        if (!file || !ReadFrameDump(file, frames, error))
+        {
+            std::cerr << "[RenderGraphSim] Failed to read " << input << ": " << (file ? error : "cannot open file") << '\n';
+            return 1;
+        }
+        if (bDisableAliasing)
+        {
+            for (RecordedFrame& frame : frames)
+                frame.m_bAliasingEnabled = false;
+        }
+
+        // Every iteration replays from empty heaps; the fastest run is reported, the rest only warm up
+        ReplaySummary summary = Replay(frames, bPrintFrames);
+        for (uint32_t iteration = 1; iteration < iterations; ++iteration)
+        {
+            const ReplaySummary run = Replay(frames, false);
+            if (run.m_TotalPlanTimeMs < summary.m_TotalPlanTimeMs)
+                summary = run;
+        }
+
+        const double frameCount = std::max(1u, summary.m_NumFrames);
+        std::cout << "[RenderGraphSim] " << input.filename().string() << ": " << summary.m_NumFrames << " frames, up to "
+                  << summary.m_MaxResources << " heap-placed resources per frame\n"
+                  << "  Plan time:     " << summary.m_TotalPlanTimeMs << " ms total, " << std::setprecision(4)
+                  << summary.m_TotalPlanTimeMs / frameCount << " ms/frame avg, " << summary.m_MaxPlanTimeMs << " ms max"
+                  << std::setprecision(2) << " (best of " << iterations << ")\n"
+                  << "  Heap memory:   " << summary.m_PeakHeapMemory / kMB << " MB peak in up to " << summary.m_PeakNumHeaps
+                  << " heaps, " << summary.m_FinalHeapMemory / kMB << " MB at the end\n"
+                  << "  Placed memory: " << summary.m_PeakPlacedMemory / kMB << " MB peak, lower bound (peak live) "
+                  << summary.m_PeakLiveMemory / kMB << " MB\n"
+                  << "  Fragmentation: " << summary.m_SumFragmentation / frameCount << "% avg, " << summary.m_MaxFragmentation << "% max\n"
+                  << "  Aliased:       " << summary.m_NumAliasedTextures / frameCount << " textures, "
+                  << summary.m_NumAliasedBuffers / frameCount << " buffers per frame avg\n";
+
+        if (maxHeapMB > 0.0 && summary.m_PeakHeapMemory / kMB > maxHeapMB)
+        {
+            std::cerr << "[RenderGraphSim] " << input.filename().string() << ": peak heap memory over the " << maxHeapMB << " MB limit\n";
+            bWithinLimits = false;
+        }
+        if (maxFragmentation > 0.0 && summary.m_MaxFragmentation > maxFragmentation)
+        {
+            std::cerr << "[RenderGraphSim] " << input.filename().string() << ": fragmentation over the " << maxFragmentation << "% limit\n";
+            bWithinLimits = false;
+        }
+    }
+
+    return bWithinLimits ? 0 : 2;
+}
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "AsyncMeshQueue.h"
 #include "SceneLoader.h"
+#include "Renderer.h"
 #include "Utilities.h"
 #include "meshoptimizer.h"
 #include "cgltf.h"
@@ -68,8 +69,12 @@ static void ProcessSinglePrimitiveFromMapped(const uint8_t* bufData, const Pendi
 {
     SDL_assert(info.posAccessor.present && "Mmap fast path requires position accessor to be present");
 
+    // All the intermediate arrays below live in this thread's scratch arena; only cmd's arrays outlive the call
+    ScratchArena& arena = g_Renderer.m_TaskScheduler->GetScratchArena();
+    ScratchArena::Scope scratchScope{ arena };
+
     const uint32_t vertCount = info.posAccessor.count;
-    std::vector<srrhi::Vertex> rawVertices(vertCount);
+    std::pmr::vector<srrhi::Vertex> rawVertices(vertCount, &arena);
 
     for (uint32_t v = 0; v < vertCount; ++v)
     {
@@ -97,7 +102,7 @@ static void ProcessSinglePrimitiveFromMapped(const uint8_t* bufData, const Pendi
         rawVertices[v] = vx;
     }
 
-    std::vector<uint32_t> rawIndices;
+    std::pmr::vector<uint32_t> rawIndices(&arena);
     if (info.indexAccessor.present)
     {
         rawIndices.resize(info.indexAccessor.count);
@@ -115,12 +120,12 @@ static void ProcessSinglePrimitiveFromMapped(const uint8_t* bufData, const Pendi
     }
 
     // ── Vertex remapping + optimisation ────────────────────────────────────
-    std::vector<uint32_t> remap(rawIndices.size());
+    std::pmr::vector<uint32_t> remap(rawIndices.size(), &arena);
     size_t uniqueVerts = meshopt_generateVertexRemap(remap.data(), rawIndices.data(), rawIndices.size(),
                                                       rawVertices.data(), rawVertices.size(), sizeof(srrhi::Vertex));
 
-    std::vector<srrhi::Vertex> optVerts(uniqueVerts);
-    std::vector<uint32_t>      localIdx(rawIndices.size());
+    std::pmr::vector<srrhi::Vertex> optVerts(uniqueVerts, &arena);
+    std::pmr::vector<uint32_t>      localIdx(rawIndices.size(), &arena);
     meshopt_remapVertexBuffer(optVerts.data(), rawVertices.data(), rawVertices.size(), sizeof(srrhi::Vertex), remap.data());
     meshopt_remapIndexBuffer(localIdx.data(), rawIndices.data(), rawIndices.size(), remap.data());
     meshopt_optimizeVertexCache(localIdx.data(), localIdx.data(), localIdx.size(), uniqueVerts);
@@ -172,12 +177,12 @@ static void ProcessSinglePrimitiveFromMapped(const uint8_t* bufData, const Pendi
     const float    simplifyScale = meshopt_simplifyScale(&optVerts[0].m_Pos.x, uniqueVerts, sizeof(srrhi::Vertex));
     const uint32_t baseIndexCount = (uint32_t)localIdx.size();
 
-    std::vector<uint32_t> currentLodIndices = localIdx;
+    std::pmr::vector<uint32_t> currentLodIndices(localIdx, &arena);
     float accumulatedError = 0.0f;
 
     for (uint32_t lod = 0; lod < srrhi::CommonConsts::MAX_LOD_COUNT; ++lod)
     {
-        std::vector<uint32_t> lodIndices;
+        std::pmr::vector<uint32_t> lodIndices(&arena);
         float lodError = 0.0f;
 
         if (lod == 0)
@@ -217,9 +222,9 @@ static void ProcessSinglePrimitiveFromMapped(const uint8_t* bufData, const Pendi
         for (uint32_t idx : lodIndices) cmd.m_Indices.push_back(idx);
 
         size_t maxMeshlets = meshopt_buildMeshletsBound(lodIndices.size(), maxVerts, maxTriangles);
-        std::vector<meshopt_Meshlet> lMeshlets(maxMeshlets);
-        std::vector<unsigned int>    lVerts(maxMeshlets * maxVerts);
-        std::vector<unsigned char>   lTris(maxMeshlets * maxTriangles * 3);
+        std::pmr::vector<meshopt_Meshlet> lMeshlets(maxMeshlets, &arena);
+        std::pmr::vector<unsigned int>    lVerts(maxMeshlets * maxVerts, &arena);
+        std::pmr::vector<unsigned char>   lTris(maxMeshlets * maxTriangles * 3, &arena);
 
         size_t meshletCount = meshopt_buildMeshlets(lMeshlets.data(), lVerts.data(), lTris.data(),
             lodIndices.data(), lodIndices.size(),
@@ -277,7 +282,7 @@ static void ProcessSinglePrimitiveFromMapped(const uint8_t* bufData, const Pendi
     //     cmd.m_MeshData.m_LODCount, cmd.m_Vertices.size(), cmd.m_Indices.size(), cmd.m_Meshlets.size());
 }
 
-// 4 worker threads: mesh processing (quantization, LOD, meshlets) is
+// 4 concurrent loads: mesh processing (quantization, LOD, meshlets) is
 // CPU-heavy and embarrassingly parallel across primitives.
 AsyncMeshQueue::AsyncMeshQueue()
  : AsyncQueueBase(4) {}
@@ -5,9 +5,9 @@
 
 // ─── AsyncMeshQueue ──────────────────────────────────────────────────────────
 // Loads and processes mesh data (vertex quantization, LOD generation, meshlet
-// building) on a pool of background threads — CPU only, no GPU work.
+// building) as a background lane on the TaskScheduler — CPU only, no GPU work.
 //
-// The caller-provided callback is invoked on a worker thread with a
+// The caller-provided callback is invoked on a scheduler worker with a
 // MeshUpdateCommand containing fully-processed, ready-to-upload data.
 // Scene::ApplyPendingUpdates() should collect these commands and perform the
 // GPU buffer re-creation on the main thread.
@@ -1,148 +1,258 @@
 #include "pch.h"
 #include "AsyncQueueBase.h"
+#include "Renderer.h"
 
 const std::vector<AsyncQueueBase::RegistryEntry>& AsyncQueueBase::GetActiveQueues()
 {
     return ms_ActiveQueues;
 }
 
-AsyncQueueBase::AsyncQueueBase(uint32_t workerCount)
-    : m_WorkerCount(workerCount > 0 ? workerCount : 1)
+AsyncQueueBase::AsyncQueueBase(uint32_t maxConcurrency)
+    : m_MaxConcurrency(maxConcurrency > 0 ? maxConcurrency : 1)
 {
 }
 
 AsyncQueueBase::~AsyncQueueBase()
 {
     // Safety net: if the owner forgot to call Stop() before destruction,
-    // stop the workers here to avoid std::terminate on joinable threads.
-    bool anyJoinable = false;
-    for (std::thread& t : m_Workers)
-        if (t.joinable()) { anyJoinable = true; break; }
-
-    if (anyJoinable)
+    // drain here so no lane task is left pointing at a destroyed queue.
+    if (m_bRunning)
     {
-        {
-            std::lock_guard<std::mutex> lk(m_Mutex);
-            m_bStopping = true;
-        }
-        m_CV.notify_all();
-        JoinAll();
-        m_bRunning = false;
-
-        ms_ActiveQueues.erase(
-            std::remove_if(ms_ActiveQueues.begin(), ms_ActiveQueues.end(),
-                [this](const RegistryEntry& e) { return e.m_Queue == this; }),
-            ms_ActiveQueues.end());
+        Detach();
     }
 }
 
+uint32_t AsyncQueueBase::GetLaneBudget()
+{
+    // Keep one worker out of reach of the lanes so FrameCritical work always has somewhere to run. A single worker
+    // can't be split that way; the lanes get it and the main thread, which helps while it waits, covers frame work.
+    // With no workers at all the lanes only advance when a non-worker thread helps or Flush()es.
+    const TaskScheduler* scheduler = ms_Scheduler ? ms_Scheduler : g_Renderer.m_TaskScheduler.get();
+    const uint32_t workerCount = scheduler ? scheduler->GetThreadCount() : 0;
+    return workerCount > 1 ? workerCount - 1 : 1;
+}
+
 void AsyncQueueBase::Start(const char* logTag)
 {
     SDL_assert(!m_bRunning && "AsyncQueueBase::Start() called while already running");
+    SDL_assert(g_Renderer.m_TaskScheduler && "AsyncQueueBase::Start() needs the TaskScheduler");
+
+    uint32_t runnerCount = 0;
     {
-        std::lock_guard<std::mutex> lk(m_Mutex);
-        m_bStopping = false;
-        // Do NOT reset m_PendingCount here: items may have been enqueued before
-        // Start() was called, and after a proper Stop() the count is already 0.
+        std::lock_guard<std::mutex> lk(ms_LaneMutex);
+        ms_Scheduler = g_Renderer.m_TaskScheduler.get();
+        m_bRunning = true;
+        ms_LaneQueues.push_back(this);
+        // Items may have been enqueued before Start(); give them their runners now.
+        runnerCount = ReserveLaneRunnersLocked();
     }
-    m_bRunning = true;
-    m_Workers.reserve(m_WorkerCount);
-    for (uint32_t i = 0; i < m_WorkerCount; ++i)
-        m_Workers.emplace_back(&AsyncQueueBase::ThreadFunc, this);
+    SubmitLaneRunners(runnerCount);
 
     ms_ActiveQueues.push_back({ logTag, this });
-    SDL_Log("[%s] Background thread pool started (%u worker%s)",
-            logTag, m_WorkerCount, m_WorkerCount == 1 ? "" : "s");
+    SDL_Log("[%s] Background lane started (up to %u concurrent task%s, %u worker%s shared by all lanes)",
+            logTag, m_MaxConcurrency, m_MaxConcurrency == 1 ? "" : "s",
+            GetLaneBudget(), GetLaneBudget() == 1 ? "" : "s");
 }
 
 void AsyncQueueBase::Stop(const char* logTag)
 {
-    bool anyJoinable = false;
-    for (std::thread& t : m_Workers)
-        if (t.joinable()) { anyJoinable = true; break; }
+    if (!m_bRunning)
+        return;
+
+    Detach();
 
-    if (!anyJoinable)
+    SDL_Log("[%s] Background lane stopped", logTag);
+}
+
+void AsyncQueueBase::Detach()
+{
     {
+        std::unique_lock<std::mutex> lk(ms_LaneMutex);
+        DrainLocked(lk);
+
+        // Still under the lock: no runner can pick this queue between the drain and its removal
         m_bRunning = false;
-        return;
-    }
-    {
-        std::lock_guard<std::mutex> lk(m_Mutex);
-        m_bStopping = true;
+        ms_LaneQueues.erase(std::remove(ms_LaneQueues.begin(), ms_LaneQueues.end(), this), ms_LaneQueues.end());
     }
-    m_CV.notify_all();
-    JoinAll();
-    m_bRunning = false;
 
     ms_ActiveQueues.erase(
         std::remove_if(ms_ActiveQueues.begin(), ms_ActiveQueues.end(),
             [this](const RegistryEntry& e) { return e.m_Queue == this; }),
         ms_ActiveQueues.end());
+}
+
+void AsyncQueueBase::DrainLocked(std::unique_lock<std::mutex>& lock)
+{
+    // Help instead of only waiting: the runners may have no worker to run on (an empty pool, or the caller is the
+    // worker they would need), so the calling thread takes this queue's items itself while a cap slot is free.
+    // Runners never touch a queue once its last item has finished, so pending == 0 means it is safe to go.
+    while (m_PendingCount > 0)
+    {
+        if (!m_Queue.empty() && m_RunningCount < m_MaxConcurrency)
+        {
+            Task task = std::move(m_Queue.front());
+            m_Queue.pop();
+            ++m_RunningCount;
+
+            lock.unlock();
+            task();
+            lock.lock();
 
-    SDL_Log("[%s] Background thread pool stopped", logTag);
+            FinishItemLocked();
+        }
+        else
+        {
+            m_DrainCV.wait(lock);
+        }
+    }
 }
 
-void AsyncQueueBase::JoinAll()
+void AsyncQueueBase::FinishItemLocked()
 {
-    for (std::thread& t : m_Workers)
-        if (t.joinable()) t.join();
-    m_Workers.clear();
+    SDL_assert(m_PendingCount > 0 && m_RunningCount > 0 && "AsyncQueueBase: pending count underflow");
+    --m_PendingCount;
+    --m_RunningCount;
+
+    // Wakes Flush()/Stop(): either done, or a cap slot freed up for the helping thread
+    m_DrainCV.notify_all();
 }
 
 uint32_t AsyncQueueBase::GetQueuedCount() const
 {
-    std::lock_guard<std::mutex> lk(m_Mutex);
+    std::lock_guard<std::mutex> lk(ms_LaneMutex);
     return static_cast<uint32_t>(m_Queue.size());
 }
 
 uint32_t AsyncQueueBase::GetPendingCount() const
 {
-    std::lock_guard<std::mutex> lk(m_Mutex);
+    std::lock_guard<std::mutex> lk(ms_LaneMutex);
     return m_PendingCount;
 }
 
+uint32_t AsyncQueueBase::GetMaxConcurrency() const
+{
+    std::lock_guard<std::mutex> lk(ms_LaneMutex);
+    return m_MaxConcurrency;
+}
+
+void AsyncQueueBase::SetMaxConcurrency(uint32_t maxConcurrency)
+{
+    uint32_t runnerCount = 0;
+    {
+        std::lock_guard<std::mutex> lk(ms_LaneMutex);
+        m_MaxConcurrency = maxConcurrency > 0 ? maxConcurrency : 1;
+
+        // Raising the cap puts queued items to work right away; lowering it
+        // takes effect as running items finish.
+        runnerCount = ReserveLaneRunnersLocked();
+    }
+    SubmitLaneRunners(runnerCount);
+}
+
 void AsyncQueueBase::Flush()
 {
     if (!m_bRunning)
         return;
-    std::unique_lock<std::mutex> lk(m_Mutex);
-    m_DrainCV.wait(lk, [this]() { return m_PendingCount == 0; });
+    std::unique_lock<std::mutex> lk(ms_LaneMutex);
+    DrainLocked(lk);
 }
 
 void AsyncQueueBase::EnqueueTask(Task task)
 {
+    uint32_t runnerCount = 0;
     {
-        std::lock_guard<std::mutex> lk(m_Mutex);
+        std::lock_guard<std::mutex> lk(ms_LaneMutex);
         ++m_PendingCount;
         m_Queue.push(std::move(task));
+
+        if (m_bRunning)
+            runnerCount = ReserveLaneRunnersLocked();
     }
-    m_CV.notify_one();
+    SubmitLaneRunners(runnerCount);
 }
 
-void AsyncQueueBase::ThreadFunc()
+uint32_t AsyncQueueBase::CountRunnableLocked()
 {
-    while (true)
+    uint32_t runnable = 0;
+    for (const AsyncQueueBase* queue : ms_LaneQueues)
     {
-        Task task;
-        {
-            std::unique_lock<std::mutex> lock(m_Mutex);
-            m_CV.wait(lock, [this]() { return !m_Queue.empty() || m_bStopping; });
+        const uint32_t freeSlots = queue->m_MaxConcurrency > queue->m_RunningCount ? queue->m_MaxConcurrency - queue->m_RunningCount : 0;
+        runnable += std::min(static_cast<uint32_t>(queue->m_Queue.size()), freeSlots);
+    }
+    return runnable;
+}
 
-            // Drain the queue completely before honouring a stop request.
-            if (m_bStopping && m_Queue.empty())
-                break;
+uint32_t AsyncQueueBase::ReserveLaneRunnersLocked()
+{
+    // Runners that are submitted but not executing an item will pick up runnable work anyway
+    const uint32_t idleRunners = ms_LaneRunners - ms_BusyRunners;
+    const uint32_t runnable = CountRunnableLocked();
+    const uint32_t budget = GetLaneBudget();
+    if (runnable <= idleRunners || ms_LaneRunners >= budget)
+        return 0;
 
-            task = std::move(m_Queue.front());
-            m_Queue.pop();
+    const uint32_t count = std::min(runnable - idleRunners, budget - ms_LaneRunners);
+    ms_LaneRunners += count;
+    return count;
+}
+
+AsyncQueueBase* AsyncQueueBase::PickLaneQueueLocked()
+{
+    // Round-robin so one busy lane can't keep the others waiting for a runner
+    const uint32_t queueCount = static_cast<uint32_t>(ms_LaneQueues.size());
+    for (uint32_t i = 0; i < queueCount; ++i)
+    {
+        AsyncQueueBase* queue = ms_LaneQueues[(ms_NextLaneQueue + i) % queueCount];
+        if (!queue->m_Queue.empty() && queue->m_RunningCount < queue->m_MaxConcurrency)
+        {
+            ms_NextLaneQueue = (ms_NextLaneQueue + i + 1) % queueCount;
+            return queue;
         }
+    }
+    return nullptr;
+}
 
-        task();
+void AsyncQueueBase::SubmitLaneRunners(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        ms_Scheduler->ScheduleDetachedTask([]() { RunLane(); }, TaskPriority::Background);
+}
 
+void AsyncQueueBase::RunLane()
+{
+    AsyncQueueBase* queue = nullptr;
+    Task task;
+    {
+        std::lock_guard<std::mutex> lk(ms_LaneMutex);
+        // Retire if another runner or a flushing thread got here first, or the worker pool shrank under the budget
+        queue = (ms_LaneRunners <= GetLaneBudget()) ? PickLaneQueueLocked() : nullptr;
+        if (!queue)
         {
-            std::lock_guard<std::mutex> lk(m_Mutex);
-            SDL_assert(m_PendingCount > 0 && "AsyncQueueBase: pending count underflow");
-            if (--m_PendingCount == 0)
-                m_DrainCV.notify_all();
+            --ms_LaneRunners;
+            return;
         }
+        task = std::move(queue->m_Queue.front());
+        queue->m_Queue.pop();
+        ++queue->m_RunningCount;
+        ++ms_BusyRunners;
     }
+
+    task();
+
+    bool bResubmit = false;
+    {
+        std::lock_guard<std::mutex> lk(ms_LaneMutex);
+        --ms_BusyRunners;
+        // Not touching 'queue' past here: once its last item is done the owner may destroy it
+        queue->FinishItemLocked();
+
+        // Keep the slot while any lane has work, unless the budget was lowered under us
+        if (ms_LaneRunners <= GetLaneBudget() && CountRunnableLocked() > 0)
+            bResubmit = true;
+        else
+            --ms_LaneRunners;
+    }
+
+    if (bResubmit)
+        SubmitLaneRunners(1);
 }
@@ -1,39 +1,52 @@
 #pragma once
 
+class TaskScheduler;
+
 // ============================================================================
 // AsyncQueueBase
 // ============================================================================
-// Non-template base class for background-thread queues.
+// Non-template base class for background queues.
+//
+// The queue stores type-erased std::function<void()> tasks and runs them as a
+// Background-priority lane on the shared TaskScheduler (g_Renderer's), rather
+// than on threads of its own, so streaming doesn't oversubscribe the machine.
+// At most GetMaxConcurrency() tasks run at once; they start in FIFO order.
+// Lane tasks are detached: ExecuteAllScheduledTasks() does not wait for them.
 //
-// The queue stores type-erased std::function<void()> tasks.  One or more
-// worker threads pop and execute tasks concurrently in FIFO order.
-// The worker count is fixed at construction time (default: 1).
+// All lanes share one set of runner tasks, capped at GetLaneBudget(): one
+// worker less than the pool, so blocking I/O and mesh processing can never
+// occupy every worker and starve FrameCritical work. Lane tasks run on the
+// regular (P-core) workers; there is no separate background-core placement.
 //
 // Public API:
-//   AsyncQueueBase(workerCount)  — choose thread-pool size (default 1).
-//   Start(logTag)                — launch worker threads (call before Enqueue*).
-//   Stop(logTag)                 — drain queue, join all workers.
+//   AsyncQueueBase(maxConcurrency) — cap on concurrently running tasks (default 1).
+//   Start(logTag)                — start feeding the scheduler (tasks queued before stay queued until then).
+//   Stop(logTag)                 — drain queue, stop feeding the scheduler.
 //   IsRunning()                  — true between Start() and Stop().
 //   GetQueuedCount()             — items waiting in the queue (not yet picked up).
 //   GetPendingCount()            — items queued + currently executing.
-//   Flush()                      — block until GetPendingCount() reaches 0.
+//   Flush()                      — run queued items on the calling thread until GetPendingCount() reaches 0.
+//   SetMaxConcurrency(count)     — change the cap; takes effect as running tasks finish.
+//   GetLaneBudget()              — scheduler workers all lanes together may occupy.
 //
 // Protected API (for derived classes):
 //   EnqueueTask(task)  — push a callable; increments pending count.
 //
 // Thread safety:
-//   EnqueueTask() / GetQueuedCount() / GetPendingCount() — any thread.
-//   Start() / Stop() / Flush() — single owner thread only.
+//   EnqueueTask() / GetQueuedCount() / GetPendingCount() / SetMaxConcurrency() / Flush() — any thread.
+//   Start() / Stop() — single owner thread only.
+//   Flush() and Stop() help rather than just block, so they also make progress
+//   from a scheduler worker or with an empty worker pool.
 // ============================================================================
 class AsyncQueueBase
 {
 public:
-    // workerCount: number of background threads to spawn on Start().
-    // Default is 1 (original single-thread behaviour).
-    explicit AsyncQueueBase(uint32_t workerCount = 1);
+    // maxConcurrency: how many of this queue's tasks may run on the scheduler at once.
+    // Default is 1 (strictly one-at-a-time, like the original single background thread).
+    explicit AsyncQueueBase(uint32_t maxConcurrency = 1);
 
-    // Destructor: if workers were started but never stopped, join them here
-    // to avoid std::terminate on joinable threads.
+    // Destructor: if the queue was started but never stopped, drain it here so
+    // no lane task outlives the queue.
     virtual ~AsyncQueueBase();
 
     void Start(const char* logTag);
@@ -43,9 +56,16 @@ public:
     uint32_t GetQueuedCount()  const;
     uint32_t GetPendingCount() const;
 
-    // Block until all queued + in-flight tasks complete. No-op if not running.
+    uint32_t GetMaxConcurrency() const;
+    void     SetMaxConcurrency(uint32_t maxConcurrency);
+
+    // Block until all queued + in-flight tasks complete, running queued items on
+    // the calling thread (within the concurrency cap) while it waits. No-op if not running.
     void Flush();
 
+    // Upper bound on lane tasks running on scheduler workers at once, across all queues
+    static uint32_t GetLaneBudget();
+
     // ── Static registry ──────────────────────────────────────────────────────
     // Queues are registered automatically on Start() and removed on Stop().
     // Access is main-thread only (Start/Stop are owner-thread; UI reads here).
@@ -58,22 +78,38 @@ private:
 protected:
     using Task = std::function<void()>;
 
-    // Push a task onto the queue. Increments pending count and wakes one worker.
-    // Thread-safe; may be called from any thread after Start().
+    // Push a task onto the queue. Increments pending count and hands the lane
+    // another scheduler slot if it is below its concurrency cap.
+    // Thread-safe; may be called from any thread.
     void EnqueueTask(Task task);
 
 private:
-    void ThreadFunc();
-    void JoinAll();
+    // Scheduler task body, shared by all lanes: runs one queued item from whichever
+    // lane has one allowed to start, then re-submits itself while there is work so
+    // higher-priority scheduler work can interleave.
+    static void RunLane();
+    static void SubmitLaneRunners(uint32_t count);
+    // How many more runners the lanes can use right now (within GetLaneBudget()); counts them as submitted
+    static uint32_t ReserveLaneRunnersLocked();
+    static uint32_t CountRunnableLocked();
+    static AsyncQueueBase* PickLaneQueueLocked();
+
+    void FinishItemLocked();
+    void DrainLocked(std::unique_lock<std::mutex>& lock);
+    void Detach();
 
-    const uint32_t          m_WorkerCount;
-    std::vector<std::thread> m_Workers;
+    // Lane state of every queue lives under one mutex: runners move between queues
+    inline static std::mutex                   ms_LaneMutex;
+    inline static std::vector<AsyncQueueBase*> ms_LaneQueues;        // started queues, in round-robin order
+    inline static TaskScheduler*               ms_Scheduler    = nullptr;
+    inline static uint32_t                     ms_LaneRunners  = 0;  // runner tasks submitted, not yet retired
+    inline static uint32_t                     ms_BusyRunners  = 0;  // runners currently executing an item
+    inline static uint32_t                     ms_NextLaneQueue = 0;
 
-    mutable std::mutex      m_Mutex;
-    std::condition_variable m_CV;
     std::condition_variable m_DrainCV;
     std::queue<Task>        m_Queue;
-    uint32_t                m_PendingCount = 0;
-    bool                    m_bRunning     = false;
-    bool                    m_bStopping    = false;
+    uint32_t                m_MaxConcurrency;
+    uint32_t                m_RunningCount  = 0; // items executing, on runners or helping threads
+    uint32_t                m_PendingCount  = 0;
+    bool                    m_bRunning      = false;
 };
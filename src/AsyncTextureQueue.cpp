@@ -3,7 +3,7 @@
 #include "TextureLoader.h"
 
 AsyncTextureQueue::AsyncTextureQueue()
-    : AsyncQueueBase(2) // 2 worker threads: texture loading is IO-heavy and benefits from some parallelism, but too many may cause disk thrashing.
+    : AsyncQueueBase(2) // 2 concurrent loads: texture loading is IO-heavy and benefits from some parallelism, but too many may cause disk thrashing.
 {
 }
 
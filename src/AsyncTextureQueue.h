@@ -5,8 +5,8 @@
 #include "Scene.h"
 
 // ─── AsyncTextureQueue ───────────────────────────────────────────────────────
-// Loads texture files on a background thread (CPU only: no GPU work).
-// The caller-provided callback is invoked on the background thread with a
+// Loads texture files as a background lane on the TaskScheduler (CPU only: no GPU work).
+// The caller-provided callback is invoked on a scheduler worker with a
 // TextureUpdateCommand containing ready-to-upload CPU data.
 // Scene::ApplyPendingUpdates() should collect these commands and perform
 // the GPU texture creation/upload on the main thread.
@@ -88,7 +88,7 @@ static void DownsampleTextureToPow2(nvrhi::CommandListHandle commandList, nvrhi:
     g_Renderer.AddComputePass(params);
 }
 
-static void GenerateHZBMips(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph, nvrhi::BufferHandle spdAtomicCounter)
+static void GenerateHZBMips(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph, nvrhi::BufferHandle spdAtomicCounter, const nvrhi::BufferRange& spdAtomicCounterRange)
 {
     PROFILE_FUNCTION();
 
@@ -104,7 +104,7 @@ static void GenerateHZBMips(nvrhi::CommandListHandle commandList, const RenderGr
     DownsampleTextureToPow2(commandList, depth, hzb, srrhi::CommonConsts::SAMPLER_MIN_REDUCTION_INDEX);
 
     // Then generate the rest of the mip chain using SPD
-    g_Renderer.GenerateMipsUsingSPD(hzb, spdAtomicCounter, commandList, "Generate HZB Mips", srrhi::CommonConsts::SPD_REDUCTION_MIN);
+    g_Renderer.GenerateMipsUsingSPD(hzb, spdAtomicCounter, spdAtomicCounterRange, commandList, "Generate HZB Mips", srrhi::CommonConsts::SPD_REDUCTION_MIN);
 }
 
 class BasePassRendererBase : public IRenderer
@@ -593,8 +593,9 @@ public:
         PerformOcclusionCulling(commandList, args, handles);
         RenderInstances(commandList, args, handles);
 
-        nvrhi::BufferHandle spdAtomicCounter = renderGraph.GetBuffer(m_RG_SPDAtomicCounter, RGResourceAccessMode::Write);
-        GenerateHZBMips(commandList, renderGraph, spdAtomicCounter);
+        nvrhi::BufferRange spdAtomicCounterRange;
+        nvrhi::BufferHandle spdAtomicCounter = renderGraph.GetBuffer(m_RG_SPDAtomicCounter, RGResourceAccessMode::Write, spdAtomicCounterRange);
+        GenerateHZBMips(commandList, renderGraph, spdAtomicCounter, spdAtomicCounterRange);
     }
 
     const char* GetName() const override { return "Opaque Renderer"; }
@@ -780,8 +781,9 @@ public:
         DownsampleTextureToPow2(commandList, handles.hdr, handles.opaque, srrhi::CommonConsts::SAMPLER_LINEAR_CLAMP_INDEX);
 
         // Generate mips for opaque color using SPD
-        nvrhi::BufferHandle spdAtomicCounter = renderGraph.GetBuffer(m_RG_SPDAtomicCounter, RGResourceAccessMode::Write);
-        g_Renderer.GenerateMipsUsingSPD(handles.opaque, spdAtomicCounter, commandList, "Generate Mips for Opaque Color", srrhi::CommonConsts::SPD_REDUCTION_AVERAGE);
+        nvrhi::BufferRange spdAtomicCounterRange;
+        nvrhi::BufferHandle spdAtomicCounter = renderGraph.GetBuffer(m_RG_SPDAtomicCounter, RGResourceAccessMode::Write, spdAtomicCounterRange);
+        g_Renderer.GenerateMipsUsingSPD(handles.opaque, spdAtomicCounter, spdAtomicCounterRange, commandList, "Generate Mips for Opaque Color", srrhi::CommonConsts::SPD_REDUCTION_AVERAGE);
 
         Matrix view, viewProjForCulling;
         Vector4 frustumPlanes[5];
@@ -810,6 +812,7 @@ private:
     RGBufferHandle m_RG_SPDAtomicCounter;
 };
 
+// Phase 2 HZB, part one: mip 0 from this frame's final depth. Reading depth keeps it on the graphics queue.
 class HZBGeneratorPhase2 : public IRenderer
 {
 public:
@@ -821,6 +824,37 @@ public:
         renderGraph.ReadTexture(g_RG_DepthTexture);
         renderGraph.WriteTexture(g_RG_HZBTexture);
 
+        return true;
+    }
+
+    void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) override
+    {
+        if (g_Renderer.m_FreezeCullingCamera)
+        {
+            return;
+        }
+
+        nvrhi::TextureHandle depth = renderGraph.GetTexture(g_RG_DepthTexture, RGResourceAccessMode::Read);
+        nvrhi::TextureHandle hzb = renderGraph.GetTexture(g_RG_HZBTexture, RGResourceAccessMode::Write);
+        DownsampleTextureToPow2(commandList, depth, hzb, srrhi::CommonConsts::SAMPLER_MIN_REDUCTION_INDEX);
+    }
+
+private:
+    const char* GetName() const override { return "HZBGeneratorPhase2"; }
+};
+
+// Phase 2 HZB, part two: the rest of the mip chain. It only touches the HZB and its SPD counter, both UAVs, and
+// nothing reads the HZB again until the transparent pass culls against it, so it runs on the async compute queue
+// alongside the TLAS update, lighting and sky.
+class HZBMipsPhase2 : public IRenderer
+{
+public:
+    bool Setup(RenderGraph& renderGraph) override
+    {
+        if (!g_Renderer.m_EnableOcclusionCulling) return false;
+
+        renderGraph.WriteTexture(g_RG_HZBTexture);
+
         const std::string counterName = std::string{ GetName() } + " HZB SPD Atomic Counter";
 
         renderGraph.DeclareBuffer(RenderGraph::GetSPDAtomicCounterDesc(counterName.c_str()), m_RG_SPDAtomicCounter);
@@ -831,17 +865,26 @@ public:
 
     void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) override
     {
-        nvrhi::BufferHandle spdAtomicCounter = renderGraph.GetBuffer(m_RG_SPDAtomicCounter, RGResourceAccessMode::Write);
-        GenerateHZBMips(commandList, renderGraph, spdAtomicCounter);
+        if (g_Renderer.m_FreezeCullingCamera)
+        {
+            return;
+        }
+
+        nvrhi::BufferRange spdAtomicCounterRange;
+        nvrhi::BufferHandle spdAtomicCounter = renderGraph.GetBuffer(m_RG_SPDAtomicCounter, RGResourceAccessMode::Write, spdAtomicCounterRange);
+        nvrhi::TextureHandle hzb = renderGraph.GetTexture(g_RG_HZBTexture, RGResourceAccessMode::Write);
+        g_Renderer.GenerateMipsUsingSPD(hzb, spdAtomicCounter, spdAtomicCounterRange, commandList, "Generate HZB Mips", srrhi::CommonConsts::SPD_REDUCTION_MIN);
     }
 
 private:
     RGBufferHandle m_RG_SPDAtomicCounter;
 
-    const char* GetName() const override { return "HZBGeneratorPhase2"; }
+    const char* GetName() const override { return "HZBMipsPhase2"; }
+    bool PrefersAsyncCompute() const override { return true; }
 };
 
 REGISTER_RENDERER(OpaqueRenderer);
 REGISTER_RENDERER(HZBGeneratorPhase2);
+REGISTER_RENDERER(HZBMipsPhase2);
 REGISTER_RENDERER(MaskedPassRenderer);
 REGISTER_RENDERER(TransparentPassRenderer);
@@ -12,6 +12,12 @@ RGTextureHandle g_RG_GBufferGeoNormals;
 RGTextureHandle g_RG_GBufferORM;
 RGTextureHandle g_RG_GBufferEmissive;
 RGTextureHandle g_RG_GBufferMotionVectors;
+// Previous frame's depth and G-buffer, double-buffered with the handles above while ReSTIR DI is on
+RGTextureHandle g_RG_DepthHistory;
+RGTextureHandle g_RG_GBufferAlbedoHistory;
+RGTextureHandle g_RG_GBufferNormalsHistory;
+RGTextureHandle g_RG_GBufferGeoNormalsHistory;
+RGTextureHandle g_RG_GBufferORMHistory;
 RGTextureHandle g_RG_HDRColor;
 RGTextureHandle g_RG_ExposureTexture;
 
@@ -28,6 +34,15 @@ public:
         
         const uint32_t width = g_Renderer.m_RHI->m_SwapchainExtent.x;
         const uint32_t height = g_Renderer.m_RHI->m_SwapchainExtent.y;
+
+        // ReSTIR DI resamples against last frame's surfaces: keep the previous copy of what it reads
+        auto declareSurface = [&renderGraph](const RGTextureDesc& desc, RGTextureHandle& handle, RGTextureHandle& historyHandle)
+        {
+            if (g_Renderer.KeepsGBufferHistory())
+                renderGraph.DeclareHistoryTexture(desc, handle, historyHandle);
+            else
+                renderGraph.DeclareTexture(desc, handle);
+        };
         
         // Declare transient depth texture
         if (g_Renderer.m_Mode != RenderingMode::ReferencePathTracer)
@@ -42,7 +57,7 @@ public:
             desc.m_NvrhiDesc.keepInitialState = true;
             desc.m_NvrhiDesc.setClearValue(nvrhi::Color{ Renderer::DEPTH_FAR, 0.0f, 0.0f, 0.0f });
             
-            renderGraph.DeclareTexture(desc, g_RG_DepthTexture);
+            declareSurface(desc, g_RG_DepthTexture, g_RG_DepthHistory);
         }
 
         // HDR Color Texture
@@ -73,22 +88,22 @@ public:
             // Albedo: RGBA8
             gbufferDesc.m_NvrhiDesc.format = Renderer::GBUFFER_ALBEDO_FORMAT;
             gbufferDesc.m_NvrhiDesc.debugName = "GBufferAlbedo_RG";
-            renderGraph.DeclareTexture(gbufferDesc, g_RG_GBufferAlbedo);
+            declareSurface(gbufferDesc, g_RG_GBufferAlbedo, g_RG_GBufferAlbedoHistory);
             
             // Normals: RG16_FLOAT
             gbufferDesc.m_NvrhiDesc.format = Renderer::GBUFFER_NORMALS_FORMAT;
             gbufferDesc.m_NvrhiDesc.debugName = "GBufferNormals_RG";
-            renderGraph.DeclareTexture(gbufferDesc, g_RG_GBufferNormals);
+            declareSurface(gbufferDesc, g_RG_GBufferNormals, g_RG_GBufferNormalsHistory);
 
             // Geo Normals: RG16_FLOAT (geometric primitive normal, no normal map)
             gbufferDesc.m_NvrhiDesc.format = Renderer::GBUFFER_NORMALS_FORMAT;
             gbufferDesc.m_NvrhiDesc.debugName = "GBufferGeoNormals_RG";
-            renderGraph.DeclareTexture(gbufferDesc, g_RG_GBufferGeoNormals);
+            declareSurface(gbufferDesc, g_RG_GBufferGeoNormals, g_RG_GBufferGeoNormalsHistory);
 
             // ORM: RGBA8
             gbufferDesc.m_NvrhiDesc.format = Renderer::GBUFFER_ORM_FORMAT;
             gbufferDesc.m_NvrhiDesc.debugName = "GBufferORM_RG";
-            renderGraph.DeclareTexture(gbufferDesc, g_RG_GBufferORM);
+            declareSurface(gbufferDesc, g_RG_GBufferORM, g_RG_GBufferORMHistory);
             
             // Emissive: RGBA8
             gbufferDesc.m_NvrhiDesc.format = Renderer::GBUFFER_EMISSIVE_FORMAT;
@@ -193,6 +208,9 @@ public:
         if (!scene.m_TLAS || !scene.m_RTInstanceDescBuffer || scene.m_RTInstanceDescs.empty())
             return false;
 
+        // Rebuilds the scene's TLAS, which lives outside the graph
+        renderGraph.MarkSideEffects();
+
         return true;
     }
 
@@ -124,6 +124,108 @@ void Config::ParseCommandLine(int argc, char* argv[])
             s_Instance.m_EnableRenderGraphAliasing = false;
             SDL_Log("[Config] Render graph aliasing disabled via command line");
         }
+        else if (std::strcmp(arg, "--disable-pass-culling") == 0)
+        {
+            s_Instance.m_EnableRenderGraphPassCulling = false;
+            SDL_Log("[Config] Render graph pass culling disabled via command line");
+        }
+        else if (std::strcmp(arg, "--disable-async-compute") == 0)
+        {
+            s_Instance.m_EnableAsyncCompute = false;
+            SDL_Log("[Config] Async compute disabled via command line");
+        }
+        else if (std::strcmp(arg, "--rendergraph-heap-budget") == 0)
+        {
+            if (i + 1 < argc)
+            {
+                s_Instance.m_RenderGraphHeapBudgetMB = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                SDL_Log("[Config] Render graph heap budget set via command line: %u MB", s_Instance.m_RenderGraphHeapBudgetMB);
+            }
+            else
+            {
+                SDL_LOG_ASSERT_FAIL("Missing value for --rendergraph-heap-budget", "[Config] Missing value for --rendergraph-heap-budget");
+            }
+        }
+        else if (std::strcmp(arg, "--rendergraph-capture") == 0)
+        {
+            if (i + 1 < argc)
+            {
+                s_Instance.m_RenderGraphCapturePath = argv[++i];
+                SDL_Log("[Config] Render graph allocation capture set via command line: %s", s_Instance.m_RenderGraphCapturePath.c_str());
+            }
+            else
+            {
+                SDL_LOG_ASSERT_FAIL("Missing value for --rendergraph-capture", "[Config] Missing value for --rendergraph-capture");
+            }
+        }
+        else if (std::strcmp(arg, "--rendergraph-capture-frames") == 0)
+        {
+            if (i + 1 < argc)
+            {
+                s_Instance.m_RenderGraphCaptureFrames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                SDL_Log("[Config] Render graph allocation capture frame count set via command line: %u", s_Instance.m_RenderGraphCaptureFrames);
+            }
+            else
+            {
+                SDL_LOG_ASSERT_FAIL("Missing value for --rendergraph-capture-frames", "[Config] Missing value for --rendergraph-capture-frames");
+            }
+        }
+        else if (std::strcmp(arg, "--disable-parallel-setup") == 0)
+        {
+            s_Instance.m_EnableParallelRenderGraphSetup = false;
+            SDL_Log("[Config] Parallel render graph setup disabled via command line");
+        }
+        else if (std::strcmp(arg, "--disable-critical-path-ordering") == 0)
+        {
+            s_Instance.m_EnableCriticalPathRecordingOrder = false;
+            SDL_Log("[Config] Critical-path recording order disabled via command line");
+        }
+        else if (std::strcmp(arg, "--disable-command-list-batching") == 0)
+        {
+            s_Instance.m_CommandListBatchMaxCPUTimeMs = 0.0f;
+            SDL_Log("[Config] Render pass command list batching disabled via command line");
+        }
+        else if (std::strcmp(arg, "--worker-threads") == 0)
+        {
+            if (i + 1 < argc)
+            {
+                s_Instance.m_WorkerThreadCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                SDL_Log("[Config] Worker thread count set via command line: %u", s_Instance.m_WorkerThreadCount);
+            }
+            else
+            {
+                SDL_LOG_ASSERT_FAIL("Missing value for --worker-threads", "[Config] Missing value for --worker-threads");
+            }
+        }
+        else if (std::strcmp(arg, "--pin-threads") == 0)
+        {
+            s_Instance.m_PinWorkerThreads = true;
+            SDL_Log("[Config] Worker thread pinning enabled via command line");
+        }
+        else if (std::strcmp(arg, "--scheduler-trace") == 0)
+        {
+            if (i + 1 < argc)
+            {
+                s_Instance.m_SchedulerTracePath = argv[++i];
+                SDL_Log("[Config] Scheduler trace set via command line: %s", s_Instance.m_SchedulerTracePath.c_str());
+            }
+            else
+            {
+                SDL_LOG_ASSERT_FAIL("Missing value for --scheduler-trace", "[Config] Missing value for --scheduler-trace");
+            }
+        }
+        else if (std::strcmp(arg, "--scheduler-trace-frame") == 0)
+        {
+            if (i + 1 < argc)
+            {
+                s_Instance.m_SchedulerTraceFrame = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                SDL_Log("[Config] Scheduler trace frame set via command line: %u", s_Instance.m_SchedulerTraceFrame);
+            }
+            else
+            {
+                SDL_LOG_ASSERT_FAIL("Missing value for --scheduler-trace-frame", "[Config] Missing value for --scheduler-trace-frame");
+            }
+        }
         else if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0)
         {
             SDL_Log("Agentic Renderer - Command Line Options:");
@@ -132,6 +234,17 @@ void Config::ParseCommandLine(int argc, char* argv[])
             SDL_Log("  --execute-per-pass               Execute command lists per pass");
             SDL_Log("  --execute-per-pass-and-wait      Wait for idle after each pass execution");
             SDL_Log("  --disable-rendergraph-aliasing   Disable render graph aliasing");
+            SDL_Log("  --disable-pass-culling           Record every enabled render pass, even if nothing reads its outputs");
+            SDL_Log("  --disable-async-compute          Record every render pass on the graphics queue");
+            SDL_Log("  --rendergraph-heap-budget <MB>   Compact render graph heaps when they exceed this size (default: 0, unlimited)");
+            SDL_Log("  --rendergraph-capture <path>     Write the render graph allocations of the first frames as JSON, for RenderGraphSim");
+            SDL_Log("  --rendergraph-capture-frames <n> Frames to record with --rendergraph-capture (default: 300)");
+            SDL_Log("  --disable-parallel-setup         Run render graph Setup() for each renderer one after another");
+            SDL_Log("  --disable-critical-path-ordering Record render passes in declaration order instead of longest-first");
+            SDL_Log("  --worker-threads <count>         Task scheduler worker count (default: one per performance core)");
+            SDL_Log("  --pin-threads                    Pin task scheduler workers to their own cores");
+            SDL_Log("  --scheduler-trace <path>         Write a Chrome trace JSON of one frame's task scheduler activity");
+            SDL_Log("  --scheduler-trace-frame <index>  Frame to trace with --scheduler-trace (default: 100)");
             SDL_Log("  --scene <path>                   Load the specified scene file");
             SDL_Log("  --gltf-samples <path>            Path to KhronosGroup/glTF-Sample-Assets repo root (for tests)");
             SDL_Log("  --irradiance <path>              Path to irradiance cubemap texture (DDS)");
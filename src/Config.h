@@ -18,6 +18,40 @@ struct Config
     // Enable render graph aliasing
     bool m_EnableRenderGraphAliasing = true;
 
+    // Skip scheduled render passes whose outputs never reach the backbuffer or a persistent resource
+    bool m_EnableRenderGraphPassCulling = true;
+
+    // Let render passes that prefer it run on the async compute queue
+    bool m_EnableAsyncCompute = true;
+
+    // Render graph transient heap budget in MB (0 = unlimited). Going over it releases empty heaps early and, if that
+    // isn't enough, compacts the heaps
+    uint32_t m_RenderGraphHeapBudgetMB = 0;
+    // Compact the render graph heaps when more than this percentage of their free memory lies outside the largest free block
+    uint32_t m_RenderGraphHeapFragmentationThreshold = 50;
+
+    // Record the first m_RenderGraphCaptureFrames frames' render graph allocations to this path, for RenderGraphSim (empty = off)
+    std::string m_RenderGraphCapturePath = "";
+    uint32_t m_RenderGraphCaptureFrames = 300;
+
+    // Run the renderers' render graph Setup() on the task scheduler and merge their declarations in scheduling order
+    bool m_EnableParallelRenderGraphSetup = true;
+
+    // Start recording the most expensive render passes (by last frames' CPU time) first
+    bool m_EnableCriticalPathRecordingOrder = true;
+
+    // Record adjacent cheap render passes into one command list while their summed CPU recording time (last frames'
+    // history) stays under this many ms; heavier passes keep their own list and record in parallel (0 = one list per pass)
+    float m_CommandListBatchMaxCPUTimeMs = 0.25f;
+
+    // Task scheduler worker count (0 = one per performance core, see TaskScheduler::GetDefaultThreadCount)
+    uint32_t m_WorkerThreadCount = 0;
+    // Pin task scheduler workers to their own cores
+    bool m_PinWorkerThreads = false;
+    // Write a Chrome trace of the task scheduler for frame m_SchedulerTraceFrame to this path (empty = off)
+    std::string m_SchedulerTracePath = "";
+    uint32_t m_SchedulerTraceFrame = 100;
+
     // Add more configuration options here as needed
     // int renderWidth = 1920;
     // int renderHeight = 1080;
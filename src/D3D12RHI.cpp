@@ -24,6 +24,7 @@ public:
     ComPtr<IDXGIFactory6> m_Factory;
     ComPtr<ID3D12Device> m_Device;
     ComPtr<ID3D12CommandQueue> m_CommandQueue;
+    ComPtr<ID3D12CommandQueue> m_ComputeQueue;
     ComPtr<ID3D12CommandQueue> m_CopyQueue;
     ComPtr<IDXGISwapChain3> m_SwapChain;
     bool m_bTearingSupported = false;
@@ -169,6 +170,7 @@ public:
         };
         
         CreateQueue(D3D12_COMMAND_LIST_TYPE_DIRECT, m_CommandQueue);
+        CreateQueue(D3D12_COMMAND_LIST_TYPE_COMPUTE, m_ComputeQueue);
         CreateQueue(D3D12_COMMAND_LIST_TYPE_COPY, m_CopyQueue);
 
         MICROPROFILE_CONDITIONAL(m_MicroProfileGfxQueue = MICROPROFILE_GPU_INIT_QUEUE("GPU-Graphics-Queue"));
@@ -176,6 +178,7 @@ public:
         nvrhi::d3d12::DeviceDesc nvrhiDesc;
         nvrhiDesc.pDevice = m_Device.Get();
         nvrhiDesc.pGraphicsCommandQueue = m_CommandQueue.Get();
+        nvrhiDesc.pComputeCommandQueue = m_ComputeQueue.Get();
         nvrhiDesc.pCopyCommandQueue = m_CopyQueue.Get();
         nvrhiDesc.errorCB = &ms_NvrhiCallback;
         nvrhiDesc.enableHeapDirectlyIndexed = true;
@@ -230,6 +233,7 @@ public:
 
         m_SwapChain.Reset();
         m_CommandQueue.Reset();
+        m_ComputeQueue.Reset();
         m_Device.Reset();
         m_Factory.Reset();
         m_Adapter.Reset();
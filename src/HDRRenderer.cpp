@@ -73,6 +73,9 @@ public:
 
         renderGraph.WriteTexture(g_RG_ExposureTexture);
 
+        // Tonemaps into the backbuffer and reads exposure back to the CPU
+        renderGraph.MarkSideEffects();
+
         return true;
     }
 
@@ -362,6 +362,119 @@ void ImGuiLayer::UpdateFrame()
             ImGui::TreePop();
         }
 
+        // Task scheduler
+        if (ImGui::TreeNode("Task Scheduler"))
+        {
+            TaskScheduler& scheduler = *g_Renderer.m_TaskScheduler;
+            const CpuTopology& topology = CpuTopology::Get();
+            ImGui::Text("Worker Threads: %u", scheduler.GetThreadCount());
+            ImGui::Text("CPU: %u logical, %u cores (%u efficiency), %u NUMA node(s)",
+                (uint32_t)topology.m_LogicalProcessors.size(), topology.m_PhysicalCoreCount, topology.m_EfficiencyCoreCount, topology.m_NumaNodeCount);
+
+            bool bPinWorkers = scheduler.IsWorkerPinningEnabled();
+            if (ImGui::Checkbox("Pin Workers To Cores", &bPinWorkers))
+            {
+                scheduler.SetWorkerPinning(bPinWorkers);
+            }
+
+            if (ImGui::BeginTable("TaskPriorityTable", 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Priority");
+                ImGui::TableSetupColumn("Submitted");
+                ImGui::TableSetupColumn("Executed");
+                ImGui::TableSetupColumn("Starvation Picks");
+                ImGui::TableHeadersRow();
+
+                static const char* kPriorityNames[] = { "Frame Critical", "Normal", "Background" };
+                static_assert(std::size(kPriorityNames) == TaskScheduler::kPriorityCount);
+                for (uint32_t p = 0; p < TaskScheduler::kPriorityCount; ++p)
+                {
+                    const TaskScheduler::PriorityStats stats = scheduler.GetPriorityStats(static_cast<TaskPriority>(p));
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    ImGui::Text("%s", kPriorityNames[p]);
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%llu", stats.m_Submitted);
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%llu", stats.m_Executed);
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%llu", stats.m_StarvationPicks);
+                }
+                ImGui::EndTable();
+            }
+
+            if (ImGui::BeginTable("TaskWorkerTable", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Thread");
+                ImGui::TableSetupColumn("Executed");
+                ImGui::TableSetupColumn("Steals");
+                ImGui::TableSetupColumn("Idle (ms)");
+                ImGui::TableSetupColumn("Lock Wait (ms)");
+                ImGui::TableSetupColumn("Max Queue");
+                ImGui::TableHeadersRow();
+
+                // Last row: the main thread and any other non-worker threads
+                for (uint32_t i = 0; i <= scheduler.GetThreadCount(); ++i)
+                {
+                    const TaskScheduler::WorkerStats stats = scheduler.GetWorkerStats(i);
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(0);
+                    if (i < scheduler.GetThreadCount())
+                        ImGui::Text("Worker %u", i);
+                    else
+                        ImGui::Text("External");
+                    ImGui::TableSetColumnIndex(1);
+                    ImGui::Text("%llu", stats.m_TasksExecuted);
+                    ImGui::TableSetColumnIndex(2);
+                    ImGui::Text("%llu", stats.m_Steals);
+                    ImGui::TableSetColumnIndex(3);
+                    ImGui::Text("%.1f", stats.m_IdleNs / 1e6);
+                    ImGui::TableSetColumnIndex(4);
+                    ImGui::Text("%.3f", stats.m_LockWaitNs / 1e6);
+                    ImGui::TableSetColumnIndex(5);
+                    ImGui::Text("%u", stats.m_QueueDepthHighWater);
+                }
+                ImGui::EndTable();
+            }
+            if (ImGui::Button("Reset Worker Stats"))
+            {
+                scheduler.ResetWorkerStats();
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Capture Frame Trace"))
+            {
+                g_Renderer.m_SchedulerTracePath = "scheduler_trace.json";
+            }
+
+            const ScratchArena::Stats scratchStats = scheduler.GetScratchArenaStats();
+            ImGui::Text("Scratch Arenas: %llu allocs, %llu heap blocks, %.2f MB high water, %.2f MB held",
+                scratchStats.m_Allocations, scratchStats.m_BlockAllocations,
+                scratchStats.m_HighWaterBytes / (1024.0 * 1024.0), scratchStats.m_CapacityBytes / (1024.0 * 1024.0));
+
+            // Async queues run as Background lanes on this scheduler
+            if (!AsyncQueueBase::GetActiveQueues().empty())
+            {
+                ImGui::Text("Streaming lanes: up to %u worker(s) of %u", AsyncQueueBase::GetLaneBudget(), scheduler.GetThreadCount());
+            }
+            for (const AsyncQueueBase::RegistryEntry& entry : AsyncQueueBase::GetActiveQueues())
+            {
+                AsyncQueueBase& queue = *entry.m_Queue;
+                const uint32_t queued = queue.GetQueuedCount();
+                const uint32_t pending = queue.GetPendingCount();
+                ImGui::Text("%s: %u queued, %u running", entry.m_Name, queued, pending > queued ? pending - queued : 0);
+
+                int maxConcurrency = (int)queue.GetMaxConcurrency();
+                ImGui::PushID(entry.m_Queue);
+                if (ImGui::SliderInt("Max Concurrency", &maxConcurrency, 1, (int)AsyncQueueBase::GetLaneBudget()))
+                {
+                    queue.SetMaxConcurrency((uint32_t)maxConcurrency);
+                }
+                ImGui::PopID();
+            }
+
+            ImGui::TreePop();
+        }
+
         // Pipeline statistics
         if (ImGui::TreeNode("Base Pass Pipeline Statistics"))
         {
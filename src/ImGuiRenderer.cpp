@@ -47,6 +47,9 @@ bool ImGuiRenderer::Setup(RenderGraph& renderGraph)
     if (fb_width <= 0 || fb_height <= 0)
         return false;
 
+    // Draws into the backbuffer
+    renderGraph.MarkSideEffects();
+
     return true;
 }
 
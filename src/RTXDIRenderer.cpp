@@ -29,6 +29,11 @@ extern RGTextureHandle g_RG_GBufferGeoNormals;
 extern RGTextureHandle g_RG_GBufferORM;
 extern RGTextureHandle g_RG_GBufferMotionVectors;
 extern RGTextureHandle g_RG_GBufferEmissive;
+extern RGTextureHandle g_RG_DepthHistory;
+extern RGTextureHandle g_RG_GBufferAlbedoHistory;
+extern RGTextureHandle g_RG_GBufferNormalsHistory;
+extern RGTextureHandle g_RG_GBufferGeoNormalsHistory;
+extern RGTextureHandle g_RG_GBufferORMHistory;
 
 // ============================================================================
 
@@ -447,22 +452,6 @@ public:
     // SPD atomic counter for env PDF mip generation (separate from local PDF counter).
     RGBufferHandle       m_RG_SPDEnvAtomicCounter;
 
-    // ------------------------------------------------------------------
-    // Persistent textures (G-buffer history for previous frame)
-    // ------------------------------------------------------------------
-    RGTextureHandle m_DepthHistory;
-    RGTextureHandle m_GBufferAlbedoHistory;
-    RGTextureHandle m_GbufferNormalsHistory;
-    RGTextureHandle m_GBufferORMHistory;
-    RGTextureHandle m_GeoNormalsHistory;   // previous-frame geo normals
-
-    // Track if history textures are newly created in current frame
-    bool m_AlbedoHistoryIsNew = false;
-    bool m_ORMHistoryIsNew    = false;
-    bool m_DepthHistoryIsNew  = false;
-    bool m_NormalsHistoryIsNew = false;
-    bool m_GeoNormalsHistoryIsNew = false;
-
     // ------------------------------------------------------------------
     // Per-frame transient RG handles (not needed by other renderers)
     // ------------------------------------------------------------------
@@ -766,66 +755,6 @@ public:
             makeHDR("RTXDISpecularOutput", g_RG_RTXDISpecularOutput);
         }
 
-        // ------------------------------------------------------------------
-        // Declare / retrieve persistent G-buffer history textures
-        // ------------------------------------------------------------------
-        {
-            RGTextureDesc desc;
-            desc.m_NvrhiDesc.width = width;
-            desc.m_NvrhiDesc.height = height;
-            desc.m_NvrhiDesc.format = Renderer::GBUFFER_ALBEDO_FORMAT;
-            desc.m_NvrhiDesc.initialState = nvrhi::ResourceStates::ShaderResource;
-            desc.m_NvrhiDesc.debugName = "GBufferAlbedoHistory";
-            m_AlbedoHistoryIsNew = renderGraph.DeclarePersistentTexture(desc, m_GBufferAlbedoHistory);
-        }
-
-        {
-            RGTextureDesc desc;
-            desc.m_NvrhiDesc.width  = width;
-            desc.m_NvrhiDesc.height = height;
-            desc.m_NvrhiDesc.format = Renderer::GBUFFER_ORM_FORMAT;
-            desc.m_NvrhiDesc.initialState = nvrhi::ResourceStates::ShaderResource;
-            desc.m_NvrhiDesc.debugName = "GBufferORMHistory";
-            m_ORMHistoryIsNew = renderGraph.DeclarePersistentTexture(desc, m_GBufferORMHistory);
-        }
-
-        // Previous-frame depth history (copy of depth buffer: same format, D24S8).
-        // isRenderTarget=true so NVRHI creates it with ALLOW_DEPTH_STENCIL, which is
-        // required to copy from the main depth buffer (also ALLOW_DEPTH_STENCIL) and
-        // to create a proper depth-component SRV.
-        {
-            RGTextureDesc desc;
-            desc.m_NvrhiDesc.width        = width;
-            desc.m_NvrhiDesc.height       = height;
-            desc.m_NvrhiDesc.format       = Renderer::DEPTH_FORMAT;
-            desc.m_NvrhiDesc.isRenderTarget = true; // needed for ALLOW_DEPTH_STENCIL flag
-            desc.m_NvrhiDesc.initialState = nvrhi::ResourceStates::ShaderResource;
-            desc.m_NvrhiDesc.debugName    = "DepthHistory";
-            m_DepthHistoryIsNew = renderGraph.DeclarePersistentTexture(desc, m_DepthHistory);
-        }
-
-        // Previous-frame G-buffer normals history.
-        {
-            RGTextureDesc desc;
-            desc.m_NvrhiDesc.width       = width;
-            desc.m_NvrhiDesc.height      = height;
-            desc.m_NvrhiDesc.format      = Renderer::GBUFFER_NORMALS_FORMAT;
-            desc.m_NvrhiDesc.initialState = nvrhi::ResourceStates::ShaderResource;
-            desc.m_NvrhiDesc.debugName   = "GBufferNormalsHistory";
-            m_NormalsHistoryIsNew = renderGraph.DeclarePersistentTexture(desc, m_GbufferNormalsHistory);
-        }
-
-        // Previous-frame geo normals history.
-        {
-            RGTextureDesc desc;
-            desc.m_NvrhiDesc.width       = width;
-            desc.m_NvrhiDesc.height      = height;
-            desc.m_NvrhiDesc.format      = nvrhi::Format::RG16_FLOAT;
-            desc.m_NvrhiDesc.initialState = nvrhi::ResourceStates::ShaderResource;
-            desc.m_NvrhiDesc.debugName   = "GeoNormalsHistory";
-            m_GeoNormalsHistoryIsNew = renderGraph.DeclarePersistentTexture(desc, m_GeoNormalsHistory);
-        }
-
         {
             RGBufferDesc bd;
             bd.m_NvrhiDesc.byteSize = m_Context->GetStaticParameters().NeighborOffsetCount * 2;
@@ -952,6 +881,17 @@ public:
         renderGraph.ReadTexture(g_RG_GBufferMotionVectors);
         renderGraph.ReadTexture(g_RG_GBufferEmissive);
 
+        // Previous frame's G-buffer. The handles only name this frame's history when ClearRenderer declared it; on the
+        // frame it is (re)created the slots hold nothing yet, and Render() binds the current G-buffer instead.
+        if (g_Renderer.KeepsGBufferHistory())
+        {
+            renderGraph.ReadTexture(g_RG_DepthHistory);
+            renderGraph.ReadTexture(g_RG_GBufferAlbedoHistory);
+            renderGraph.ReadTexture(g_RG_GBufferNormalsHistory);
+            renderGraph.ReadTexture(g_RG_GBufferGeoNormalsHistory);
+            renderGraph.ReadTexture(g_RG_GBufferORMHistory);
+        }
+
         // ------------------------------------------------------------------
         // FullSample per-frame resources
         // ------------------------------------------------------------------
@@ -1367,20 +1307,24 @@ public:
         nvrhi::TextureHandle motionTex       = renderGraph.GetTexture(g_RG_GBufferMotionVectors, RGResourceAccessMode::Read);
         nvrhi::TextureHandle emissiveTex     = renderGraph.GetTexture(g_RG_GBufferEmissive,      RGResourceAccessMode::Read);
 
-        // History textures (persistent, reused from existing members)
-        nvrhi::TextureHandle albedoHistoryTex  = renderGraph.GetTexture(m_GBufferAlbedoHistory,  RGResourceAccessMode::Write);
-        nvrhi::TextureHandle ormHistoryTex     = renderGraph.GetTexture(m_GBufferORMHistory,     RGResourceAccessMode::Write);
-        nvrhi::TextureHandle depthHistoryTex   = renderGraph.GetTexture(m_DepthHistory,          RGResourceAccessMode::Write);
-        nvrhi::TextureHandle normalsHistoryTex = renderGraph.GetTexture(m_GbufferNormalsHistory, RGResourceAccessMode::Write);
+        // Previous frame's G-buffer. Until there is one (first frame, resize), temporal resampling sees the current frame.
+        auto getHistory = [&renderGraph](RGTextureHandle history, nvrhi::TextureHandle current)
+        {
+            return renderGraph.IsHistoryValid(history) ? renderGraph.GetTexture(history, RGResourceAccessMode::Read) : current;
+        };
+        nvrhi::TextureHandle albedoHistoryTex  = getHistory(g_RG_GBufferAlbedoHistory,     albedoTex);
+        nvrhi::TextureHandle ormHistoryTex     = getHistory(g_RG_GBufferORMHistory,        ormTex);
+        nvrhi::TextureHandle depthHistoryTex   = getHistory(g_RG_DepthHistory,             depthTex);
+        nvrhi::TextureHandle normalsHistoryTex = getHistory(g_RG_GBufferNormalsHistory,    normalsTex);
+        nvrhi::TextureHandle geoNormalsHistTex = getHistory(g_RG_GBufferGeoNormalsHistory, geoNormalsTex);
 
         // FullSample per-frame textures (member variables)
         nvrhi::TextureHandle denoiserNRTex    = renderGraph.GetTexture(m_RG_DenoiserNormalRoughness, RGResourceAccessMode::Write);
-        nvrhi::TextureHandle geoNormalsHistTex= renderGraph.GetTexture(m_GeoNormalsHistory,        RGResourceAccessMode::Write);
         nvrhi::TextureHandle linearDepthTex   = renderGraph.GetTexture(m_RG_LinearDepth,         RGResourceAccessMode::Write);
         nvrhi::TextureHandle compositedTex    = renderGraph.GetTexture(g_RG_RTXDIDIComposited,   RGResourceAccessMode::Write);
 
         // Light buffers
-        nvrhi::BufferHandle  neighborOffsetsBuf  = renderGraph.GetBuffer(m_RG_NeighborOffsetsBuffer, m_AlbedoHistoryIsNew ?  RGResourceAccessMode::Write : RGResourceAccessMode::Read);
+        nvrhi::BufferHandle  neighborOffsetsBuf  = renderGraph.GetBuffer(m_RG_NeighborOffsetsBuffer, m_NeighborOffsetsBufferIsNew ? RGResourceAccessMode::Write : RGResourceAccessMode::Read);
         nvrhi::BufferHandle  risBuffer           = renderGraph.GetBuffer(m_RG_RISBuffer,             RGResourceAccessMode::Write);
         nvrhi::BufferHandle  lightReservoirBuf   = renderGraph.GetBuffer(g_RG_RTXDILightReservoirBuffer, RGResourceAccessMode::Write);
         nvrhi::BufferHandle  risLightDataBuf     = renderGraph.GetBuffer(m_RG_RISLightDataBuffer,    RGResourceAccessMode::Write);
@@ -1437,20 +1381,6 @@ public:
         nvrhi::TextureHandle diOutputTex    = !bDenoise ? renderGraph.GetTexture(g_RG_RTXDIDIOutput,       RGResourceAccessMode::Write) : cr.DummyUAVTexture;
         nvrhi::TextureHandle specularOutTex = !bDenoise ? renderGraph.GetTexture(g_RG_RTXDISpecularOutput, RGResourceAccessMode::Write) : cr.DummyUAVTexture;
 
-        // ------------------------------------------------------------------
-        // Initialize history textures on first frame
-        // ------------------------------------------------------------------
-        if (m_AlbedoHistoryIsNew)
-            commandList->copyTexture(albedoHistoryTex, nvrhi::TextureSlice{}, albedoTex,   nvrhi::TextureSlice{});
-        if (m_ORMHistoryIsNew)
-            commandList->copyTexture(ormHistoryTex,    nvrhi::TextureSlice{}, ormTex,      nvrhi::TextureSlice{});
-        if (m_DepthHistoryIsNew)
-            commandList->copyTexture(depthHistoryTex,  nvrhi::TextureSlice{}, depthTex,    nvrhi::TextureSlice{});
-        if (m_NormalsHistoryIsNew)
-            commandList->copyTexture(normalsHistoryTex,nvrhi::TextureSlice{}, normalsTex,  nvrhi::TextureSlice{});
-        if (m_GeoNormalsHistoryIsNew)
-            commandList->copyTexture(geoNormalsHistTex, nvrhi::TextureSlice{}, geoNormalsTex, nvrhi::TextureSlice{});
-
         // ------------------------------------------------------------------
         // Initialize neighbor offsets buffer on first allocation
         // ------------------------------------------------------------------
@@ -1703,8 +1633,9 @@ public:
         {
             if (m_PDFMipCount > 1u)
             {
-                nvrhi::BufferHandle spdAtomicCounter = renderGraph.GetBuffer(m_RG_SPDAtomicCounter, RGResourceAccessMode::Write);
-                g_Renderer.GenerateMipsUsingSPD(localLightPDFTex, spdAtomicCounter, commandList, "Generate Local Light PDF Mips", srrhi::CommonConsts::SPD_REDUCTION_AVERAGE);
+                nvrhi::BufferRange spdAtomicCounterRange;
+                nvrhi::BufferHandle spdAtomicCounter = renderGraph.GetBuffer(m_RG_SPDAtomicCounter, RGResourceAccessMode::Write, spdAtomicCounterRange);
+                g_Renderer.GenerateMipsUsingSPD(localLightPDFTex, spdAtomicCounter, spdAtomicCounterRange, commandList, "Generate Local Light PDF Mips", srrhi::CommonConsts::SPD_REDUCTION_AVERAGE);
             }
 
             {
@@ -1731,8 +1662,9 @@ public:
         {
             if (m_EnvPDFMipCount > 1u)
             {
-                nvrhi::BufferHandle spdEnvCounter = renderGraph.GetBuffer(m_RG_SPDEnvAtomicCounter, RGResourceAccessMode::Write);
-                g_Renderer.GenerateMipsUsingSPD(envLightPDFTex, spdEnvCounter, commandList, "Generate Env Light PDF Mips", srrhi::CommonConsts::SPD_REDUCTION_AVERAGE);
+                nvrhi::BufferRange spdEnvCounterRange;
+                nvrhi::BufferHandle spdEnvCounter = renderGraph.GetBuffer(m_RG_SPDEnvAtomicCounter, RGResourceAccessMode::Write, spdEnvCounterRange);
+                g_Renderer.GenerateMipsUsingSPD(envLightPDFTex, spdEnvCounter, spdEnvCounterRange, commandList, "Generate Env Light PDF Mips", srrhi::CommonConsts::SPD_REDUCTION_AVERAGE);
             }
 
             {
@@ -2011,22 +1943,12 @@ public:
         }
 
         // ------------------------------------------------------------------
-        // Copy current G-buffer to history textures for next frame
+        // Copy current TLAS to history for next frame (the G-buffer history is double-buffered by the render graph)
         // ------------------------------------------------------------------
+        if (m_TLASHistory && g_Renderer.m_Scene.m_TLAS)
         {
-            PROFILE_GPU_SCOPED("Copy resources to History", commandList);
-
-            commandList->copyTexture(albedoHistoryTex, nvrhi::TextureSlice{}, albedoTex, nvrhi::TextureSlice{});
-            commandList->copyTexture(ormHistoryTex, nvrhi::TextureSlice{}, ormTex, nvrhi::TextureSlice{});
-            commandList->copyTexture(depthHistoryTex, nvrhi::TextureSlice{}, depthTex, nvrhi::TextureSlice{});
-            commandList->copyTexture(normalsHistoryTex, nvrhi::TextureSlice{}, normalsTex, nvrhi::TextureSlice{});
-            commandList->copyTexture(geoNormalsHistTex, nvrhi::TextureSlice{}, geoNormalsTex, nvrhi::TextureSlice{});
-
-            // Copy current TLAS to history for next frame
-            if (m_TLASHistory && g_Renderer.m_Scene.m_TLAS)
-            {
-                commandList->copyRaytracingAccelerationStructure(m_TLASHistory, g_Renderer.m_Scene.m_TLAS);
-            }
+            PROFILE_GPU_SCOPED("Copy TLAS to History", commandList);
+            commandList->copyRaytracingAccelerationStructure(m_TLASHistory, g_Renderer.m_Scene.m_TLAS);
         }
     }
 
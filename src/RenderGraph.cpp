@@ -51,6 +51,7 @@ size_t RGBufferDesc::ComputeHash() const
     hash_combine(seed, m_NvrhiDesc.isVertexBuffer);
     hash_combine(seed, m_NvrhiDesc.isIndexBuffer);
     hash_combine(seed, (uint32_t)m_NvrhiDesc.initialState);
+    hash_combine(seed, m_bSuballocate);
     return seed;
 }
 
@@ -154,15 +155,34 @@ void RenderGraph::Shutdown()
 
     m_Textures.clear();
     m_Buffers.clear();
-    m_Heaps.clear();
+    m_FreeTextureSlots.clear();
+    m_FreeBufferSlots.clear();
+    m_FreeSlotListsFrame = UINT64_MAX;
+    if (IsCapturingAllocations())
+        WriteAllocationCapture();
+    m_HeapAllocator.Clear();
+    m_HeapDevice.m_Heaps.clear();
+    m_BufferPools.clear();
+    m_HeapCompactionReserve = 0;
+    m_LastHeapCompactionFrame = UINT64_MAX;
+    m_HeapUsageAfterCompaction = {};
+    m_CompiledGraph = {};
     m_PassNames.clear();
     m_PassAccesses.clear();
     m_PerPassAliasBarriers.clear();
+    m_PerPassStateTransitions.clear();
+    m_PassQueues.clear();
+    m_QueueSyncPoints.clear();
+    m_CommandListFirstJobs.clear();
+    m_PassCommandListStart.clear();
     m_PendingPassAccess = {};
     m_PendingDeclaredTextures.clear();
     m_PendingDeclaredBuffers.clear();
+    m_RecordingJobs.clear();
+    m_QueuedSetupRenderers.clear();
     m_Stats = {};
     m_IsInsideSetup = false;
+    m_bParallelSetup = false;
     m_IsCompiled = false;
     m_CurrentPassIndex = 0;
     t_ActivePassIndex = 0;
@@ -186,16 +206,30 @@ void RenderGraph::Reset()
     FlushDeferredReleases();
 
     m_AliasingEnabled = Config::Get().m_EnableRenderGraphAliasing;
+    m_PassCullingEnabled = Config::Get().m_EnableRenderGraphPassCulling;
+    m_AsyncComputeEnabled = Config::Get().m_EnableAsyncCompute && g_Renderer.m_RHI->m_NvrhiDevice->queryFeatureSupport(nvrhi::Feature::ComputeQueue);
+    m_StructureHash = 0;
+    hash_combine(m_StructureHash, m_AliasingEnabled);
+    hash_combine(m_StructureHash, m_AsyncComputeEnabled);
     
     const uint32_t kMaxTransientResourceLifetimeFrames = 3;
 
     m_CurrentPassIndex = 0;
     m_IsCompiled = false;
     m_IsInsideSetup = false; // safety: ensure setup state is clean at frame start
+    m_bParallelSetup = false;
+    m_QueuedSetupRenderers.clear();
     m_Stats = Stats{};
+    SDL_assert(m_RecordingJobs.empty() && "Recording jobs from the previous frame were never submitted - call SubmitRecordingJobs() after Compile()");
+    m_RecordingJobs.clear();
     m_PassNames.clear();
     m_PassAccesses.clear();
     m_PerPassAliasBarriers.clear();
+    m_PerPassStateTransitions.clear();
+    m_PassQueues.clear();
+    m_QueueSyncPoints.clear();
+    m_CommandListFirstJobs.clear();
+    m_PassCommandListStart.clear();
     // Clear any pending state that may have been left over if a previous frame
     // was interrupted (e.g. a renderer's Setup() threw or returned early after
     // declaring resources).  BeginSetup() also clears these, but Reset() is the
@@ -204,6 +238,7 @@ void RenderGraph::Reset()
     m_PendingPassAccess = {};
     m_PendingDeclaredTextures.clear();
     m_PendingDeclaredBuffers.clear();
+    m_FreeSlotListsFrame = UINT64_MAX;
 
     // Mark all resources as not declared this frame and reset lifetimes
     for (TransientTexture& texture : m_Textures)
@@ -213,6 +248,8 @@ void RenderGraph::Reset()
         texture.m_AliasedFromIndex = UINT32_MAX;
         texture.m_PhysicalLastPass = 0;
         texture.m_DeclarationPass = 0;
+        texture.m_bUsedOnAsyncCompute = false;
+        texture.m_SubresourceLifetimes.clear();
 
         // Cleanup physical resources not used for > 3 frames
         if (texture.m_PhysicalTexture && (g_Renderer.m_FrameNumber - texture.m_LastFrameUsed > kMaxTransientResourceLifetimeFrames))
@@ -227,7 +264,7 @@ void RenderGraph::Reset()
                     (int)texture.m_IsPhysicalOwner);
             if (texture.m_IsPhysicalOwner)
             {
-                FreeBlock(texture.m_HeapIndex, texture.m_BlockOffset);
+                m_HeapAllocator.Free(texture.m_HeapIndex, texture.m_BlockOffset);
             }
             // Defer the handle drop — FlushDeferredReleases() (called at the
             // top of the *next* Reset()) will wait for GPU idle before the
@@ -248,6 +285,7 @@ void RenderGraph::Reset()
         buffer.m_AliasedFromIndex = UINT32_MAX;
         buffer.m_PhysicalLastPass = 0;
         buffer.m_DeclarationPass = 0;
+        buffer.m_bUsedOnAsyncCompute = false;
 
         if (buffer.m_PhysicalBuffer && (g_Renderer.m_FrameNumber - buffer.m_LastFrameUsed > kMaxTransientResourceLifetimeFrames))
         {
@@ -261,11 +299,13 @@ void RenderGraph::Reset()
                     (int)buffer.m_IsPhysicalOwner);
             if (buffer.m_IsPhysicalOwner)
             {
-                FreeBlock(buffer.m_HeapIndex, buffer.m_BlockOffset);
+                m_HeapAllocator.Free(buffer.m_HeapIndex, buffer.m_BlockOffset);
             }
-            // Defer the handle drop — same reasoning as for textures above.
-            m_DeferredReleaseBuffers.push_back(std::move(buffer.m_PhysicalBuffer));
+            // Defer the handle drop — same reasoning as for textures above. A pool buffer is kept alive by its pool.
+            if (!buffer.m_bSuballocated)
+                m_DeferredReleaseBuffers.push_back(std::move(buffer.m_PhysicalBuffer));
             buffer.m_PhysicalBuffer = nullptr;
+            buffer.m_bSuballocated = false;
             buffer.m_Heap = nullptr;
             buffer.m_HeapIndex = UINT32_MAX;
             buffer.m_IsAllocated = false;
@@ -273,17 +313,16 @@ void RenderGraph::Reset()
         }
     }
 
-    // Heaps are kept in the vector for index stability
-    for (HeapEntry& heapEntry : m_Heaps)
+    for (BufferPool& pool : m_BufferPools)
     {
-        if (heapEntry.m_Heap && (g_Renderer.m_FrameNumber - heapEntry.m_LastFrameUsed > kMaxTransientResourceLifetimeFrames))
-        {
-            //SDL_Log("[RenderGraph] Freeing heap slot %u due to inactivity", heapEntry.m_HeapIdx);
-            heapEntry.m_Heap = nullptr;
-            heapEntry.m_Blocks.clear();
-            heapEntry.m_Size = 0;
-        }
+        if (g_Renderer.m_FrameNumber - pool.m_LastFrameUsed > kMaxTransientResourceLifetimeFrames)
+            m_DeferredReleaseBuffers.push_back(std::move(pool.m_Buffer));
     }
+    m_BufferPools.erase(
+        std::remove_if(m_BufferPools.begin(), m_BufferPools.end(), [](const BufferPool& pool) { return !pool.m_Buffer; }),
+        m_BufferPools.end());
+
+    m_HeapAllocator.ReleaseIdleHeaps(g_Renderer.m_FrameNumber, kMaxTransientResourceLifetimeFrames);
 }
 
 void RenderGraph::BeginPass(const char* name)
@@ -291,9 +330,52 @@ void RenderGraph::BeginPass(const char* name)
     PROFILE_FUNCTION();
     
     SDL_assert(name);
+    SDL_assert(m_QueuedSetupRenderers.empty() && "BeginPass() called while renderers are queued for parallel setup - passes would be out of scheduling order");
     m_CurrentPassIndex++;
     m_PassNames.push_back(name);
-    m_PassAccesses.push_back(m_PendingPassAccess); // Copy pending accesses from Setup
+    m_PassAccesses.push_back(std::move(m_PendingPassAccess)); // Take over pending accesses from Setup
+
+    // Fold the pass into the frame's structure hash: its name, what it declares and what it accesses
+    hash_combine(m_StructureHash, std::string_view(name));
+    hash_combine(m_StructureHash, m_PassAccesses.back().m_bCullable);
+    hash_combine(m_StructureHash, m_PassAccesses.back().m_bHasSideEffects);
+    hash_combine(m_StructureHash, m_PassAccesses.back().m_bPrefersAsyncCompute);
+    for (uint32_t texIdx : m_PendingDeclaredTextures)
+    {
+        hash_combine(m_StructureHash, texIdx);
+        hash_combine(m_StructureHash, m_Textures[texIdx].m_Hash);
+        hash_combine(m_StructureHash, m_Textures[texIdx].m_IsPersistent);
+        hash_combine(m_StructureHash, m_Textures[texIdx].m_bDeadAfterLastPass);
+    }
+    hash_combine(m_StructureHash, m_PendingDeclaredTextures.size());
+    for (uint32_t bufIdx : m_PendingDeclaredBuffers)
+    {
+        hash_combine(m_StructureHash, bufIdx);
+        hash_combine(m_StructureHash, m_Buffers[bufIdx].m_Hash);
+        hash_combine(m_StructureHash, m_Buffers[bufIdx].m_IsPersistent);
+    }
+    hash_combine(m_StructureHash, m_PendingDeclaredBuffers.size());
+    for (const std::vector<uint32_t>* indices : { &m_PassAccesses.back().m_ReadTextures, &m_PassAccesses.back().m_WriteTextures,
+                                                  &m_PassAccesses.back().m_ReadBuffers, &m_PassAccesses.back().m_WriteBuffers })
+    {
+        for (uint32_t idx : *indices)
+        {
+            hash_combine(m_StructureHash, idx);
+        }
+        hash_combine(m_StructureHash, indices->size());
+    }
+    for (const std::vector<PassAccess::TextureRange>* ranges : { &m_PassAccesses.back().m_ReadTextureRanges, &m_PassAccesses.back().m_WriteTextureRanges })
+    {
+        for (const PassAccess::TextureRange& range : *ranges)
+        {
+            hash_combine(m_StructureHash, range.m_Index);
+            hash_combine(m_StructureHash, range.m_Subresources.baseMipLevel);
+            hash_combine(m_StructureHash, range.m_Subresources.numMipLevels);
+            hash_combine(m_StructureHash, range.m_Subresources.baseArraySlice);
+            hash_combine(m_StructureHash, range.m_Subresources.numArraySlices);
+        }
+        hash_combine(m_StructureHash, ranges->size());
+    }
     
     // Update resources declared in Setup with the correct pass index
     for (uint32_t texIdx : m_PendingDeclaredTextures)
@@ -307,11 +389,13 @@ void RenderGraph::BeginPass(const char* name)
         UpdateResourceLifetime(m_Buffers[bufIdx].m_Lifetime, m_CurrentPassIndex);
     }
     
-    // Also update any read/write resources that were just registered in Setup
-    for (uint32_t texIdx : m_PendingPassAccess.m_ReadTextures) UpdateResourceLifetime(m_Textures[texIdx].m_Lifetime, m_CurrentPassIndex);
-    for (uint32_t texIdx : m_PendingPassAccess.m_WriteTextures) UpdateResourceLifetime(m_Textures[texIdx].m_Lifetime, m_CurrentPassIndex);
-    for (uint32_t bufIdx : m_PendingPassAccess.m_ReadBuffers) UpdateResourceLifetime(m_Buffers[bufIdx].m_Lifetime, m_CurrentPassIndex);
-    for (uint32_t bufIdx : m_PendingPassAccess.m_WriteBuffers) UpdateResourceLifetime(m_Buffers[bufIdx].m_Lifetime, m_CurrentPassIndex);
+    // Also update any read/write resources that were just registered in Setup.
+    // Lifetimes grow pass by pass here, so Compile() never has to scan passes x resources for them.
+    const PassAccess& access = m_PassAccesses.back();
+    for (uint32_t texIdx : access.m_ReadTextures) UpdateResourceLifetime(m_Textures[texIdx].m_Lifetime, m_CurrentPassIndex);
+    for (uint32_t texIdx : access.m_WriteTextures) UpdateResourceLifetime(m_Textures[texIdx].m_Lifetime, m_CurrentPassIndex);
+    for (uint32_t bufIdx : access.m_ReadBuffers) UpdateResourceLifetime(m_Buffers[bufIdx].m_Lifetime, m_CurrentPassIndex);
+    for (uint32_t bufIdx : access.m_WriteBuffers) UpdateResourceLifetime(m_Buffers[bufIdx].m_Lifetime, m_CurrentPassIndex);
 
     m_PendingPassAccess = {};
     m_PendingDeclaredTextures.clear();
@@ -322,17 +406,30 @@ void RenderGraph::ScheduleRenderer(IRenderer* pRenderer)
 {
     SDL_assert(m_IsInsideSetup && "ScheduleRenderer() called outside of BeginSetup()/EndSetup() block");
 
-    const int readIndex = g_Renderer.m_FrameNumber % 2;
-    const int writeIndex = (g_Renderer.m_FrameNumber + 1) % 2;
-
     pRenderer->m_bPassEnabled = false;
+    if (m_bParallelSetup)
+    {
+        m_QueuedSetupRenderers.push_back(pRenderer); // set up in EndSetup()
+        return;
+    }
+    SetupRenderer(pRenderer);
+}
+
+void RenderGraph::SetupRenderer(IRenderer* pRenderer)
+{
     {
         PROFILE_SCOPED("SetupRenderer");
         pRenderer->m_bPassEnabled = pRenderer->Setup(*this);
     }
+    CommitRendererSetup(pRenderer);
+}
 
+void RenderGraph::CommitRendererSetup(IRenderer* pRenderer)
+{
     if (pRenderer->m_bPassEnabled)
     {
+        m_PendingPassAccess.m_bCullable = m_PassCullingEnabled;
+        m_PendingPassAccess.m_bPrefersAsyncCompute = pRenderer->PrefersAsyncCompute();
         BeginPass(pRenderer->GetName());
     }
     else
@@ -370,33 +467,217 @@ void RenderGraph::ScheduleRenderer(IRenderer* pRenderer)
     // pRenderer->m_bPassEnabled is true here (disabled path returned early above).
     const uint16_t passIndex = GetCurrentPassIndex();
 
-    nvrhi::CommandListHandle cmd = g_Renderer.AcquireCommandList();
+    // Recording waits until the graph is compiled and dead passes are culled, see SubmitRecordingJobs()
+    m_RecordingJobs.push_back({ pRenderer, nullptr, passIndex });
+}
+
+void RenderGraph::MarkSideEffects()
+{
+    SDL_assert(m_IsInsideSetup && "MarkSideEffects must be called during Setup phase");
+    if (SetupBuilder* builder = t_ActiveSetupBuilder)
+    {
+        builder->RecordAccess(SetupBuilder::OpType::MarkSideEffects, {});
+        return;
+    }
+    m_PendingPassAccess.m_bHasSideEffects = true;
+}
+
+bool RenderGraph::IsPassCulled(uint16_t passIndex) const
+{
+    if (passIndex == 0 || passIndex > m_PassAccesses.size())
+        return false;
+    return m_PassAccesses[passIndex - 1].m_bCulled;
+}
+
+nvrhi::CommandQueue RenderGraph::GetPassQueue(uint16_t passIndex) const
+{
+    if (passIndex == 0 || passIndex > m_PassQueues.size())
+        return nvrhi::CommandQueue::Graphics;
+    return m_PassQueues[passIndex - 1];
+}
+
+std::vector<uint32_t> RenderGraph::ComputeRecordingOrder(std::span<const float> cpuTimeHistory)
+{
+    std::vector<uint32_t> order(cpuTimeHistory.size());
+    for (uint32_t i = 0; i < (uint32_t)order.size(); ++i)
+    {
+        order[i] = i;
+    }
+
+    // Longest-processing-time-first: with more passes than workers this keeps an expensive pass from being
+    // picked up last and dominating the tail. Stable so passes without history keep declaration order.
+    std::stable_sort(order.begin(), order.end(), [&cpuTimeHistory](uint32_t a, uint32_t b)
+    {
+        return cpuTimeHistory[a] > cpuTimeHistory[b];
+    });
+    return order;
+}
+
+std::vector<uint32_t> RenderGraph::ComputeCommandListBatches(std::span<const CommandListJobInfo> jobs, float maxBatchCPUTimeMs)
+{
+    std::vector<uint32_t> firstJobs;
+    float batchCPUTime = 0.0f;
+    for (uint32_t i = 0; i < (uint32_t)jobs.size(); ++i)
+    {
+        const CommandListJobInfo& job = jobs[i];
+
+        // A pass without history may be expensive, so it neither joins a list nor lets one join it. The budget keeps
+        // batches short enough that recording one serially doesn't cost more than the lists it saves.
+        const bool bJoinsPrevious = !firstJobs.empty() && maxBatchCPUTimeMs > 0.0f &&
+            !job.m_bStartsList && !jobs[i - 1].m_bEndsList && job.m_Queue == jobs[i - 1].m_Queue &&
+            job.m_CPUTimeHistory > 0.0f && jobs[i - 1].m_CPUTimeHistory > 0.0f &&
+            batchCPUTime + job.m_CPUTimeHistory <= maxBatchCPUTimeMs;
+
+        if (bJoinsPrevious)
+        {
+            batchCPUTime += job.m_CPUTimeHistory;
+        }
+        else
+        {
+            firstJobs.push_back(i);
+            batchCPUTime = job.m_CPUTimeHistory;
+        }
+    }
+    return firstJobs;
+}
+
+void RenderGraph::SubmitRecordingJobs()
+{
+    PROFILE_FUNCTION();
+
+    SDL_assert(m_IsCompiled && "SubmitRecordingJobs() called before Compile()");
+    SDL_assert(m_CommandListFirstJobs.empty() == m_RecordingJobs.empty() && "Recording jobs changed after Compile() grouped them into command lists");
+
+    const int readIndex = g_Renderer.m_FrameNumber % 2;
+    const int writeIndex = (g_Renderer.m_FrameNumber + 1) % 2;
+
+    // Jobs of each command list: [first job, first job of the next list)
+    struct CommandListBatch
+    {
+        uint32_t m_FirstJob = 0;
+        uint32_t m_EndJob = 0;
+        nvrhi::CommandListHandle m_CommandList;
+    };
+    std::vector<CommandListBatch> batches(m_CommandListFirstJobs.size());
+
+    // Acquire in declaration order: that is the GPU submission order, whatever order the batches record in below
+    std::vector<nvrhi::ICommandList*> passCommandLists(m_PassAccesses.size() + 1, nullptr);
+    uint32_t numComputePasses = 0;
+    for (uint32_t batchIdx = 0; batchIdx < (uint32_t)batches.size(); ++batchIdx)
+    {
+        CommandListBatch& batch = batches[batchIdx];
+        batch.m_FirstJob = m_CommandListFirstJobs[batchIdx];
+        batch.m_EndJob = (batchIdx + 1 < batches.size()) ? m_CommandListFirstJobs[batchIdx + 1] : (uint32_t)m_RecordingJobs.size();
+        const nvrhi::CommandQueue queue = GetPassQueue(m_RecordingJobs[batch.m_FirstJob].m_PassIndex);
+        batch.m_CommandList = g_Renderer.AcquireCommandList(true, queue);
+        for (uint32_t jobIdx = batch.m_FirstJob; jobIdx < batch.m_EndJob; ++jobIdx)
+        {
+            m_RecordingJobs[jobIdx].m_CommandList = batch.m_CommandList;
+            passCommandLists[m_RecordingJobs[jobIdx].m_PassIndex] = batch.m_CommandList.Get();
+        }
+        if (queue == nvrhi::CommandQueue::Compute)
+            numComputePasses += batch.m_EndJob - batch.m_FirstJob;
+    }
+
+    // What actually went to the compute queue, as opposed to what Compile() planned
+    m_AsyncComputePassesRecorded += numComputePasses;
+    if (numComputePasses != m_LastFrameComputePasses)
+    {
+        SDL_Log("[RenderGraph] Async compute: %u pass(es) recorded on the compute queue this frame (was %u)", numComputePasses, m_LastFrameComputePasses);
+        m_LastFrameComputePasses = numComputePasses;
+    }
+
+    // Cross-queue waits placed by Compile(), applied when the command lists are executed. Waiting passes start a list
+    // and signalling passes end one, so each wait still covers exactly the work it was placed for.
+    for (const QueueSyncPoint& syncPoint : m_QueueSyncPoints)
+    {
+        nvrhi::ICommandList* waitingList = passCommandLists[syncPoint.m_WaitingPass];
+        nvrhi::ICommandList* signalList = passCommandLists[syncPoint.m_SignalPass];
+        if (waitingList && signalList)
+        {
+            g_Renderer.AddCommandListWait(waitingList, signalList);
+        }
+    }
 
-    const bool bImmediateExecute = false; /* defer execution until after render graph compiles */
-    g_Renderer.m_TaskScheduler->ScheduleTask([pRenderer, cmd, readIndex, writeIndex, passIndex]() {
-        PROFILE_SCOPED(pRenderer->GetName());
-        SimpleTimer cpuTimer;
-        ScopedCommandList scopedCmd{ cmd, pRenderer->GetName() };
-        PROFILE_GPU_SCOPED(pRenderer->GetName(), cmd);
+    // Only the order the batches start recording in changes: each batch writes into its own command list,
+    // so GPU submission order stays the declaration order.
+    std::vector<uint32_t> order;
+    if (Config::Get().m_EnableCriticalPathRecordingOrder)
+    {
+        std::vector<float> cpuTimeHistory(batches.size(), 0.0f);
+        for (uint32_t batchIdx = 0; batchIdx < (uint32_t)batches.size(); ++batchIdx)
+        {
+            for (uint32_t jobIdx = batches[batchIdx].m_FirstJob; jobIdx < batches[batchIdx].m_EndJob; ++jobIdx)
+            {
+                cpuTimeHistory[batchIdx] += m_RecordingJobs[jobIdx].m_Renderer->m_CPUTimeHistory;
+            }
+        }
+        order = ComputeRecordingOrder(cpuTimeHistory);
+    }
+    else
+    {
+        order.resize(batches.size());
+        for (uint32_t i = 0; i < (uint32_t)order.size(); ++i)
+        {
+            order[i] = i;
+        }
+    }
 
-        g_Renderer.m_RenderGraph.SetActivePass(passIndex);
+    for (uint32_t batchIdx : order)
+    {
+        const CommandListBatch& batch = batches[batchIdx];
+        std::vector<RecordingJob> jobs(m_RecordingJobs.begin() + batch.m_FirstJob, m_RecordingJobs.begin() + batch.m_EndJob);
+        nvrhi::CommandListHandle cmd = batch.m_CommandList;
 
-        if (g_Renderer.m_RHI->m_NvrhiDevice->pollTimerQuery(pRenderer->m_GPUQueries[readIndex]))
+        // A shared list is named after its first pass; each pass keeps its own GPU marker and timer query inside it
+        std::string listName = jobs[0].m_Renderer->GetName();
+        if (jobs.size() > 1)
         {
-            pRenderer->m_GPUTime = SimpleTimer::SecondsToMilliseconds(g_Renderer.m_RHI->m_NvrhiDevice->getTimerQueryTime(pRenderer->m_GPUQueries[readIndex]));
+            listName += " +" + std::to_string(jobs.size() - 1);
         }
-        g_Renderer.m_RHI->m_NvrhiDevice->resetTimerQuery(pRenderer->m_GPUQueries[readIndex]);
 
-        g_Renderer.m_RenderGraph.InsertAliasBarriers(passIndex, scopedCmd);
-        scopedCmd->beginTimerQuery(pRenderer->m_GPUQueries[writeIndex]);
-        pRenderer->Render(scopedCmd, g_Renderer.m_RenderGraph);
-        g_Renderer.m_RenderGraph.SetActivePass(0);
-        scopedCmd->endTimerQuery(pRenderer->m_GPUQueries[writeIndex]);
-        pRenderer->m_CPUTime = static_cast<float>(cpuTimer.TotalMilliseconds());
-    }, bImmediateExecute);
+        g_Renderer.m_TaskScheduler->ScheduleTask([jobs = std::move(jobs), listName = std::move(listName), cmd, readIndex, writeIndex]() {
+            ScopedCommandList scopedCmd{ cmd, listName };
+
+            for (const RecordingJob& job : jobs)
+            {
+                IRenderer* pRenderer = job.m_Renderer;
+                const uint16_t passIndex = job.m_PassIndex;
+
+                PROFILE_SCOPED(pRenderer->GetName());
+                SimpleTimer cpuTimer;
+                PROFILE_GPU_SCOPED(pRenderer->GetName(), cmd);
+
+                g_Renderer.m_RenderGraph.SetActivePass(passIndex);
+
+                if (g_Renderer.m_RHI->m_NvrhiDevice->pollTimerQuery(pRenderer->m_GPUQueries[readIndex]))
+                {
+                    pRenderer->m_GPUTime = SimpleTimer::SecondsToMilliseconds(g_Renderer.m_RHI->m_NvrhiDevice->getTimerQueryTime(pRenderer->m_GPUQueries[readIndex]));
+                }
+                g_Renderer.m_RHI->m_NvrhiDevice->resetTimerQuery(pRenderer->m_GPUQueries[readIndex]);
+
+                g_Renderer.m_RenderGraph.InsertAliasBarriers(passIndex, scopedCmd);
+                g_Renderer.m_RenderGraph.InsertStateTransitions(passIndex, scopedCmd);
+                scopedCmd->beginTimerQuery(pRenderer->m_GPUQueries[writeIndex]);
+                pRenderer->Render(scopedCmd, g_Renderer.m_RenderGraph);
+                g_Renderer.m_RenderGraph.SetActivePass(0);
+                scopedCmd->endTimerQuery(pRenderer->m_GPUQueries[writeIndex]);
+                pRenderer->m_CPUTime = static_cast<float>(cpuTimer.TotalMilliseconds());
+
+                // Smoothed so a single hitch doesn't reshuffle next frame's recording order or command list batches
+                static const float kCPUTimeHistoryWeight = 0.2f;
+                pRenderer->m_CPUTimeHistory = (pRenderer->m_CPUTimeHistory == 0.0f)
+                    ? pRenderer->m_CPUTime
+                    : pRenderer->m_CPUTimeHistory + (pRenderer->m_CPUTime - pRenderer->m_CPUTimeHistory) * kCPUTimeHistoryWeight;
+            }
+        }, /*bImmediateExecute=*/true, TaskPriority::FrameCritical);
+    }
+
+    m_RecordingJobs.clear();
+    m_CommandListFirstJobs.clear();
 }
 
-void RenderGraph::BeginSetup()
+void RenderGraph::BeginSetup(bool bParallelSetup)
 {
     SDL_assert(!m_IsInsideSetup);
 
@@ -433,6 +714,7 @@ void RenderGraph::BeginSetup()
     }
 
     m_IsInsideSetup = true;
+    m_bParallelSetup = bParallelSetup;
     m_PendingPassAccess = {};
     m_PendingDeclaredTextures.clear();
     m_PendingDeclaredBuffers.clear();
@@ -441,6 +723,12 @@ void RenderGraph::BeginSetup()
 void RenderGraph::EndSetup()
 {
     SDL_assert(m_IsInsideSetup);
+    if (!m_QueuedSetupRenderers.empty())
+    {
+        RunQueuedSetups();
+    }
+    m_bParallelSetup = false;
+
     // Any pending state that was not committed by a BeginPass() call belongs to
     // a renderer whose Setup() ran but was not followed by BeginPass() (i.e. the
     // renderer was disabled).  Roll it back so those slots are not poisoned.
@@ -482,10 +770,70 @@ uint16_t RenderGraph::GetActivePassIndex() const
     return (t_ActivePassIndex != 0) ? t_ActivePassIndex : m_CurrentPassIndex;
 }
 
+// A slot can be handed to a new declaration once it was not declared this frame or the last one
+template <typename TransientResource>
+static bool IsPoolSlotIdle(const TransientResource& resource)
+{
+    return !resource.m_IsDeclaredThisFrame && (g_Renderer.m_FrameNumber - resource.m_LastFrameUsed > 1);
+}
+
+template <typename TransientResource>
+static void BuildFreeSlotLists(const std::vector<TransientResource>& resources, std::unordered_map<size_t, std::vector<uint32_t>>& freeSlots)
+{
+    // Keep the buckets (and their capacity) around, frames mostly declare the same descs
+    for (auto& [hash, slots] : freeSlots)
+    {
+        slots.clear();
+    }
+
+    // Highest index first so the lowest idle slot is popped first, like the linear scan this replaces
+    for (uint32_t i = (uint32_t)resources.size(); i-- > 0;)
+    {
+        if (IsPoolSlotIdle(resources[i]))
+        {
+            freeSlots[resources[i].m_Hash].push_back(i);
+        }
+    }
+}
+
+template <typename TransientResource>
+static uint32_t AcquireFreeSlot(std::unordered_map<size_t, std::vector<uint32_t>>& freeSlots, const std::vector<TransientResource>& resources, size_t hash)
+{
+    auto it = freeSlots.find(hash);
+    if (it == freeSlots.end())
+        return UINT32_MAX;
+
+    std::vector<uint32_t>& slots = it->second;
+    while (!slots.empty())
+    {
+        const uint32_t slot = slots.back();
+        slots.pop_back();
+
+        // Stale if it was declared through its handle (possibly with a new desc) since the lists were built
+        if (slot < resources.size() && resources[slot].m_Hash == hash && IsPoolSlotIdle(resources[slot]))
+            return slot;
+    }
+    return UINT32_MAX;
+}
+
+void RenderGraph::RebuildFreeSlotLists()
+{
+    PROFILE_FUNCTION();
+
+    BuildFreeSlotLists(m_Textures, m_FreeTextureSlots);
+    BuildFreeSlotLists(m_Buffers, m_FreeBufferSlots);
+    m_FreeSlotListsFrame = g_Renderer.m_FrameNumber;
+}
+
 bool RenderGraph::DeclareTexture(const RGTextureDesc& desc, RGTextureHandle& outputHandle)
 {
     SDL_assert(m_IsInsideSetup && "DeclareTexture must be called during Setup phase");
 
+    if (SetupBuilder* builder = t_ActiveSetupBuilder)
+    {
+        return RecordTextureDeclaration(*builder, desc, outputHandle, false);
+    }
+
     if (m_bForceInvalidateAllResources)
     {
         outputHandle.Invalidate();
@@ -516,9 +864,9 @@ bool RenderGraph::DeclareTexture(const RGTextureDesc& desc, RGTextureHandle& out
         bool isNewlyAllocated = false;
         if (texture.m_Hash != hash)
         {
-            // Desc changed: free the old heap block so SubAllocateResource can reuse
+            // Desc changed: free the old heap block so allocation can reuse
             // it for the new allocation.  Without this the old block stays occupied
-            // and SubAllocateResource is forced to find a different region, causing
+            // and allocation is forced to find a different region, causing
             // the createAndBindResource callback to recreate the nvrhi object even
             // when the caller expects a stable pointer (e.g. MF-03, OC-10).
             if (m_bVerboseLogging)
@@ -532,7 +880,7 @@ bool RenderGraph::DeclareTexture(const RGTextureDesc& desc, RGTextureHandle& out
                         (unsigned long long)texture.m_BlockOffset);
             if (texture.m_IsPhysicalOwner && texture.m_HeapIndex != UINT32_MAX)
             {
-                FreeBlock(texture.m_HeapIndex, texture.m_BlockOffset);
+                m_HeapAllocator.Free(texture.m_HeapIndex, texture.m_BlockOffset);
             }
             // Defer the handle drop so the GPU finishes before the D3D12
             // resource is released (prevents ERROR #921).
@@ -551,6 +899,10 @@ bool RenderGraph::DeclareTexture(const RGTextureDesc& desc, RGTextureHandle& out
         texture.m_IsDeclaredThisFrame = true;
         texture.m_IsPersistent = false;
         texture.m_LastFrameUsed = g_Renderer.m_FrameNumber;
+        texture.m_HistoryPairIndex = UINT32_MAX;
+        texture.m_bIsHistoryCurrent = false;
+        texture.m_bHistoryValid = false;
+        texture.m_bDeadAfterLastPass = false;
         
         m_PendingDeclaredTextures.push_back(outputHandle.m_Index);
         WriteTexture(outputHandle); // Implicitly mark as written in the declaring pass, since they start with undefined contents
@@ -558,32 +910,37 @@ bool RenderGraph::DeclareTexture(const RGTextureDesc& desc, RGTextureHandle& out
     }
 
     // Try to find a matching unused resource in the pool
-    for (uint32_t i = 0; i < m_Textures.size(); ++i)
+    if (m_FreeSlotListsFrame != g_Renderer.m_FrameNumber)
     {
-        if (!m_Textures[i].m_IsDeclaredThisFrame
-            && m_Textures[i].m_Hash == hash
-            && (g_Renderer.m_FrameNumber - m_Textures[i].m_LastFrameUsed > 1))
-        {
-            if (m_bVerboseLogging)
-                SDL_Log("[RenderGraph] POOL-REUSE texture: slot %u (was '%s', isOwner=%d, isAllocated=%d) "
-                        "reassigned to '%s' (frame=%u, lastUsed=%llu)",
-                        i,
-                        m_Textures[i].m_Desc.m_NvrhiDesc.debugName.c_str(),
-                        (int)m_Textures[i].m_IsPhysicalOwner,
-                        (int)m_Textures[i].m_IsAllocated,
-                        desc.m_NvrhiDesc.debugName.c_str(),
-                        g_Renderer.m_FrameNumber,
-                        (unsigned long long)m_Textures[i].m_LastFrameUsed);
-            m_Textures[i].m_Desc = desc; // Ensure metadata like debugName is updated
-            m_Textures[i].m_IsDeclaredThisFrame = true;
-            m_Textures[i].m_IsPersistent = false;
-            m_Textures[i].m_LastFrameUsed = g_Renderer.m_FrameNumber;
-            
-            m_PendingDeclaredTextures.push_back(i);
-            outputHandle = { i };
-            WriteTexture(outputHandle); // Implicitly mark as written in the declaring pass, since they start with undefined contents
-            return true;
-        }
+        RebuildFreeSlotLists();
+    }
+    const uint32_t poolSlot = AcquireFreeSlot(m_FreeTextureSlots, m_Textures, hash);
+    if (poolSlot != UINT32_MAX)
+    {
+        TransientTexture& texture = m_Textures[poolSlot];
+        if (m_bVerboseLogging)
+            SDL_Log("[RenderGraph] POOL-REUSE texture: slot %u (was '%s', isOwner=%d, isAllocated=%d) "
+                    "reassigned to '%s' (frame=%u, lastUsed=%llu)",
+                    poolSlot,
+                    texture.m_Desc.m_NvrhiDesc.debugName.c_str(),
+                    (int)texture.m_IsPhysicalOwner,
+                    (int)texture.m_IsAllocated,
+                    desc.m_NvrhiDesc.debugName.c_str(),
+                    g_Renderer.m_FrameNumber,
+                    (unsigned long long)texture.m_LastFrameUsed);
+        texture.m_Desc = desc; // Ensure metadata like debugName is updated
+        texture.m_IsDeclaredThisFrame = true;
+        texture.m_IsPersistent = false;
+        texture.m_LastFrameUsed = g_Renderer.m_FrameNumber;
+        texture.m_HistoryPairIndex = UINT32_MAX;
+        texture.m_bIsHistoryCurrent = false;
+        texture.m_bHistoryValid = false;
+        texture.m_bDeadAfterLastPass = false;
+
+        m_PendingDeclaredTextures.push_back(poolSlot);
+        outputHandle = { poolSlot };
+        WriteTexture(outputHandle); // Implicitly mark as written in the declaring pass, since they start with undefined contents
+        return true;
     }
 
     RGTextureHandle handle;
@@ -608,6 +965,11 @@ bool RenderGraph::DeclareBuffer(const RGBufferDesc& desc, RGBufferHandle& output
 {
     SDL_assert(m_IsInsideSetup && "DeclareBuffer must be called during Setup phase");
 
+    if (SetupBuilder* builder = t_ActiveSetupBuilder)
+    {
+        return RecordBufferDeclaration(*builder, desc, outputHandle, false);
+    }
+
     if (m_bForceInvalidateAllResources)
     {
         outputHandle.Invalidate();
@@ -624,7 +986,7 @@ bool RenderGraph::DeclareBuffer(const RGBufferDesc& desc, RGBufferHandle& output
         bool isNewlyAllocated = false;
         if (buffer.m_Hash != hash)
         {
-            // Desc changed: free the old heap block so SubAllocateResource can reuse it.
+            // Desc changed: free the old heap block so allocation can reuse it.
             if (m_bVerboseLogging)
                 SDL_Log("[RenderGraph] DESC-CHANGE buffer: slot %u '%s' hash %zu->%zu "
                         "(isOwner=%d heapIdx=%u blockOffset=%llu) - freeing old block",
@@ -636,7 +998,7 @@ bool RenderGraph::DeclareBuffer(const RGBufferDesc& desc, RGBufferHandle& output
                         (unsigned long long)buffer.m_BlockOffset);
             if (buffer.m_IsPhysicalOwner && buffer.m_HeapIndex != UINT32_MAX)
             {
-                FreeBlock(buffer.m_HeapIndex, buffer.m_BlockOffset);
+                m_HeapAllocator.Free(buffer.m_HeapIndex, buffer.m_BlockOffset);
             }
             // Defer the handle drop — same reasoning as for textures above.
             if (buffer.m_PhysicalBuffer)
@@ -660,32 +1022,33 @@ bool RenderGraph::DeclareBuffer(const RGBufferDesc& desc, RGBufferHandle& output
         return isNewlyAllocated;
     }
 
-    for (uint32_t i = 0; i < m_Buffers.size(); ++i)
+    if (m_FreeSlotListsFrame != g_Renderer.m_FrameNumber)
     {
-        if (!m_Buffers[i].m_IsDeclaredThisFrame
-            && m_Buffers[i].m_Hash == hash
-            && (g_Renderer.m_FrameNumber - m_Buffers[i].m_LastFrameUsed > 1))
-        {
-            if (m_bVerboseLogging)
-                SDL_Log("[RenderGraph] POOL-REUSE buffer: slot %u (was '%s', isOwner=%d, isAllocated=%d) "
-                        "reassigned to '%s' (frame=%u, lastUsed=%llu)",
-                        i,
-                        m_Buffers[i].m_Desc.m_NvrhiDesc.debugName.c_str(),
-                        (int)m_Buffers[i].m_IsPhysicalOwner,
-                        (int)m_Buffers[i].m_IsAllocated,
-                        desc.m_NvrhiDesc.debugName.c_str(),
-                        g_Renderer.m_FrameNumber,
-                        (unsigned long long)m_Buffers[i].m_LastFrameUsed);
-            m_Buffers[i].m_Desc = desc; // Ensure metadata like debugName is updated
-            m_Buffers[i].m_IsDeclaredThisFrame = true;
-            m_Buffers[i].m_IsPersistent = false;
-            m_Buffers[i].m_LastFrameUsed = g_Renderer.m_FrameNumber;
+        RebuildFreeSlotLists();
+    }
+    const uint32_t poolSlot = AcquireFreeSlot(m_FreeBufferSlots, m_Buffers, hash);
+    if (poolSlot != UINT32_MAX)
+    {
+        TransientBuffer& buffer = m_Buffers[poolSlot];
+        if (m_bVerboseLogging)
+            SDL_Log("[RenderGraph] POOL-REUSE buffer: slot %u (was '%s', isOwner=%d, isAllocated=%d) "
+                    "reassigned to '%s' (frame=%u, lastUsed=%llu)",
+                    poolSlot,
+                    buffer.m_Desc.m_NvrhiDesc.debugName.c_str(),
+                    (int)buffer.m_IsPhysicalOwner,
+                    (int)buffer.m_IsAllocated,
+                    desc.m_NvrhiDesc.debugName.c_str(),
+                    g_Renderer.m_FrameNumber,
+                    (unsigned long long)buffer.m_LastFrameUsed);
+        buffer.m_Desc = desc; // Ensure metadata like debugName is updated
+        buffer.m_IsDeclaredThisFrame = true;
+        buffer.m_IsPersistent = false;
+        buffer.m_LastFrameUsed = g_Renderer.m_FrameNumber;
 
-            m_PendingDeclaredBuffers.push_back(i);
-            outputHandle = { i };
-            WriteBuffer(outputHandle); // Implicitly mark as written in the declaring pass, since they start with undefined contents
-            return true;
-        }
+        m_PendingDeclaredBuffers.push_back(poolSlot);
+        outputHandle = { poolSlot };
+        WriteBuffer(outputHandle); // Implicitly mark as written in the declaring pass, since they start with undefined contents
+        return true;
     }
 
     RGBufferHandle handle;
@@ -708,13 +1071,93 @@ bool RenderGraph::DeclareBuffer(const RGBufferDesc& desc, RGBufferHandle& output
 
 bool RenderGraph::DeclarePersistentTexture(const RGTextureDesc& desc, RGTextureHandle& outputHandle)
 {
+    if (SetupBuilder* builder = t_ActiveSetupBuilder)
+    {
+        return RecordTextureDeclaration(*builder, desc, outputHandle, true);
+    }
+
     bool newlyAllocated = DeclareTexture(desc, outputHandle);
     m_Textures[outputHandle.m_Index].m_IsPersistent = true;
     return newlyAllocated;
 }
 
+bool RenderGraph::HasUsableHistory(size_t hash, RGTextureHandle current, RGTextureHandle previous) const
+{
+    if (m_bForceInvalidateAllResources || !current.IsValid() || !previous.IsValid() ||
+        current.m_Index >= m_Textures.size() || previous.m_Index >= m_Textures.size())
+    {
+        return false;
+    }
+
+    // 'current' must still be the written half of this very pair, with the same desc and its texture not evicted
+    const TransientTexture& written = m_Textures[current.m_Index];
+    return written.m_HistoryPairIndex == previous.m_Index &&
+           m_Textures[previous.m_Index].m_HistoryPairIndex == current.m_Index &&
+           written.m_bIsHistoryCurrent && written.m_IsAllocated && written.m_Hash == hash;
+}
+
+bool RenderGraph::DeclareHistoryTexture(const RGTextureDesc& desc, RGTextureHandle& outCurrent, RGTextureHandle& outPrevious)
+{
+    if (SetupBuilder* builder = t_ActiveSetupBuilder)
+    {
+        return RecordHistoryTextureDeclaration(*builder, desc, outCurrent, outPrevious);
+    }
+
+    const bool bHasHistory = HasUsableHistory(desc.ComputeHash(), outCurrent, outPrevious);
+
+    // Persistent: each half keeps a heap block of its own, never placed in another resource's memory
+    DeclarePersistentTexture(desc, outCurrent);
+    DeclarePersistentTexture(desc, outPrevious);
+
+    TransientTexture& current = m_Textures[outCurrent.m_Index];
+    TransientTexture& previous = m_Textures[outPrevious.m_Index];
+
+    // Last frame's current texture becomes this frame's previous one. The slots keep their handles (and the compiled
+    // graph its structure), only the physical textures and their heap blocks change hands.
+    std::swap(current.m_PhysicalTexture, previous.m_PhysicalTexture);
+    std::swap(current.m_Heap, previous.m_Heap);
+    std::swap(current.m_HeapIndex, previous.m_HeapIndex);
+    std::swap(current.m_Offset, previous.m_Offset);
+    std::swap(current.m_BlockOffset, previous.m_BlockOffset);
+    std::swap(current.m_IsAllocated, previous.m_IsAllocated);
+    std::swap(current.m_IsPhysicalOwner, previous.m_IsPhysicalOwner);
+
+    current.m_HistoryPairIndex = outPrevious.m_Index;
+    current.m_bIsHistoryCurrent = true;
+    current.m_bHistoryValid = false;
+    previous.m_HistoryPairIndex = outCurrent.m_Index;
+    previous.m_bIsHistoryCurrent = false;
+    previous.m_bHistoryValid = bHasHistory;
+
+    // Only 'current' has to outlive the frame. 'previous' is overwritten as next frame's 'current', so once its last
+    // reader has run the aliasing planner may place transient resources in its memory.
+    previous.m_bDeadAfterLastPass = true;
+
+    // Undo the declaration's implicit write: 'previous' keeps its contents, its readers depend on the pass that wrote it last frame
+    std::vector<uint32_t>& writes = m_PendingPassAccess.m_WriteTextures;
+    auto it = std::lower_bound(writes.begin(), writes.end(), outPrevious.m_Index);
+    if (it != writes.end() && *it == outPrevious.m_Index)
+        writes.erase(it);
+
+    return !bHasHistory;
+}
+
+bool RenderGraph::IsHistoryValid(RGTextureHandle previous) const
+{
+    if (!previous.IsValid() || previous.m_Index >= m_Textures.size())
+        return false;
+
+    const TransientTexture& texture = m_Textures[previous.m_Index];
+    return texture.m_IsDeclaredThisFrame && texture.m_bHistoryValid;
+}
+
 bool RenderGraph::DeclarePersistentBuffer(const RGBufferDesc& desc, RGBufferHandle& outputHandle)
 {
+    if (SetupBuilder* builder = t_ActiveSetupBuilder)
+    {
+        return RecordBufferDeclaration(*builder, desc, outputHandle, true);
+    }
+
     bool newlyAllocated = DeclareBuffer(desc, outputHandle);
     m_Buffers[outputHandle.m_Index].m_IsPersistent = true;
     return newlyAllocated;
@@ -725,9 +1168,20 @@ bool RenderGraph::DeclarePersistentBuffer(const RGBufferDesc& desc, RGBufferHand
 // ============================================================================
 
 void RenderGraph::ReadTexture(RGTextureHandle handle)
+{
+    ReadTexture(handle, nvrhi::AllSubresources);
+}
+
+void RenderGraph::ReadTexture(RGTextureHandle handle, const nvrhi::TextureSubresourceSet& subresources)
 {
     SDL_assert(m_IsInsideSetup && "ReadTexture must be called during Setup phase");
 
+    if (SetupBuilder* builder = t_ActiveSetupBuilder)
+    {
+        builder->RecordAccess(SetupBuilder::OpType::ReadTexture, handle, subresources);
+        return;
+    }
+
     if (!handle.IsValid() || handle.m_Index >= m_Textures.size())
     {
         SDL_assert(false && "Invalid texture handle");
@@ -743,13 +1197,26 @@ void RenderGraph::ReadTexture(RGTextureHandle handle)
         return;
     }
 
-    m_PendingPassAccess.m_ReadTextures.insert(handle.m_Index);
+    const nvrhi::TextureSubresourceSet resolved = subresources.resolve(texture.m_Desc.m_NvrhiDesc, false);
+    PassAccess::AddTexture(m_PendingPassAccess.m_ReadTextures, m_PendingPassAccess.m_ReadTextureRanges, handle.m_Index,
+                           resolved, resolved.isEntireTexture(texture.m_Desc.m_NvrhiDesc));
 }
 
 void RenderGraph::WriteTexture(RGTextureHandle handle)
+{
+    WriteTexture(handle, nvrhi::AllSubresources);
+}
+
+void RenderGraph::WriteTexture(RGTextureHandle handle, const nvrhi::TextureSubresourceSet& subresources)
 {
     SDL_assert(m_IsInsideSetup && "WriteTexture must be called during Setup phase");
 
+    if (SetupBuilder* builder = t_ActiveSetupBuilder)
+    {
+        builder->RecordAccess(SetupBuilder::OpType::WriteTexture, handle, subresources);
+        return;
+    }
+
     if (!handle.IsValid() || handle.m_Index >= m_Textures.size())
     {
         SDL_assert(false && "Invalid texture handle");
@@ -765,13 +1232,21 @@ void RenderGraph::WriteTexture(RGTextureHandle handle)
         return;
     }
 
-    m_PendingPassAccess.m_WriteTextures.insert(handle.m_Index);
+    const nvrhi::TextureSubresourceSet resolved = subresources.resolve(texture.m_Desc.m_NvrhiDesc, false);
+    PassAccess::AddTexture(m_PendingPassAccess.m_WriteTextures, m_PendingPassAccess.m_WriteTextureRanges, handle.m_Index,
+                           resolved, resolved.isEntireTexture(texture.m_Desc.m_NvrhiDesc));
 }
 
 void RenderGraph::ReadBuffer(RGBufferHandle handle)
 {
     SDL_assert(m_IsInsideSetup && "ReadBuffer must be called during Setup phase");
 
+    if (SetupBuilder* builder = t_ActiveSetupBuilder)
+    {
+        builder->RecordAccess(SetupBuilder::OpType::ReadBuffer, handle);
+        return;
+    }
+
     if (!handle.IsValid() || handle.m_Index >= m_Buffers.size())
     {
         SDL_assert(false && "Invalid buffer handle");
@@ -787,13 +1262,19 @@ void RenderGraph::ReadBuffer(RGBufferHandle handle)
         return;
     }
 
-    m_PendingPassAccess.m_ReadBuffers.insert(handle.m_Index);
+    PassAccess::Add(m_PendingPassAccess.m_ReadBuffers, handle.m_Index);
 }
 
 void RenderGraph::WriteBuffer(RGBufferHandle handle)
 {
     SDL_assert(m_IsInsideSetup && "WriteBuffer must be called during Setup phase");
 
+    if (SetupBuilder* builder = t_ActiveSetupBuilder)
+    {
+        builder->RecordAccess(SetupBuilder::OpType::WriteBuffer, handle);
+        return;
+    }
+
     if (!handle.IsValid() || handle.m_Index >= m_Buffers.size())
     {
         SDL_assert(false && "Invalid buffer handle");
@@ -809,84 +1290,868 @@ void RenderGraph::WriteBuffer(RGBufferHandle handle)
         return;
     }
 
-    m_PendingPassAccess.m_WriteBuffers.insert(handle.m_Index);
+    PassAccess::Add(m_PendingPassAccess.m_WriteBuffers, handle.m_Index);
 }
 
 // ============================================================================
-// RenderGraph - Compilation
+// RenderGraph - Parallel Setup
 // ============================================================================
 
-void RenderGraph::UpdateResourceLifetime(RenderGraphInternal::ResourceLifetime& lifetime, uint16_t currentPass)
+bool RenderGraph::RecordTextureDeclaration(SetupBuilder& builder, const RGTextureDesc& desc, RGTextureHandle& outputHandle, bool bPersistent) const
 {
-    if (lifetime.m_FirstPass == UINT16_MAX)
+    SetupBuilder::Op& op = builder.m_Ops.emplace_back();
+    op.m_Type = SetupBuilder::OpType::DeclareTexture;
+    op.m_bPersistent = bPersistent;
+    op.m_DescIndex = static_cast<uint32_t>(builder.m_TextureDescs.size());
+    op.m_pHandle = &outputHandle;
+    builder.m_TextureDescs.push_back(desc);
+
+    // Same answer DeclareTexture() gives for a handle that names a slot: newly allocated only if the desc changed
+    if (!outputHandle.IsValid() || outputHandle.m_Index >= m_Textures.size())
     {
-        lifetime.m_FirstPass = currentPass;
+        builder.m_bNeedsNewSlot = true;
+        return true;
     }
-    else
+    return m_Textures[outputHandle.m_Index].m_Hash != desc.ComputeHash();
+}
+
+bool RenderGraph::RecordBufferDeclaration(SetupBuilder& builder, const RGBufferDesc& desc, RGBufferHandle& outputHandle, bool bPersistent) const
+{
+    SetupBuilder::Op& op = builder.m_Ops.emplace_back();
+    op.m_Type = SetupBuilder::OpType::DeclareBuffer;
+    op.m_bPersistent = bPersistent;
+    op.m_DescIndex = static_cast<uint32_t>(builder.m_BufferDescs.size());
+    op.m_pHandle = &outputHandle;
+    builder.m_BufferDescs.push_back(desc);
+
+    if (!outputHandle.IsValid() || outputHandle.m_Index >= m_Buffers.size())
     {
-        lifetime.m_FirstPass = std::min(lifetime.m_FirstPass, currentPass);
+        builder.m_bNeedsNewSlot = true;
+        return true;
     }
-    lifetime.m_LastPass = std::max(lifetime.m_LastPass, currentPass);
+    return m_Buffers[outputHandle.m_Index].m_Hash != desc.ComputeHash();
 }
 
-void RenderGraph::Compile()
+bool RenderGraph::RecordHistoryTextureDeclaration(SetupBuilder& builder, const RGTextureDesc& desc, RGTextureHandle& outCurrent, RGTextureHandle& outPrevious) const
 {
-    PROFILE_FUNCTION();
-
-    // Resource validation
-    for (uint32_t i = 0; i < (uint32_t)m_Textures.size(); ++i)
+    SetupBuilder::Op& op = builder.m_Ops.emplace_back();
+    op.m_Type = SetupBuilder::OpType::DeclareHistoryTexture;
+    op.m_bPersistent = true;
+    op.m_DescIndex = static_cast<uint32_t>(builder.m_TextureDescs.size());
+    op.m_pHandle = &outCurrent;
+    op.m_pPreviousHandle = &outPrevious;
+    builder.m_TextureDescs.push_back(desc);
+
+    if (!outCurrent.IsValid() || outCurrent.m_Index >= m_Textures.size() ||
+        !outPrevious.IsValid() || outPrevious.m_Index >= m_Textures.size())
     {
-        const TransientTexture& tex = m_Textures[i];
-        if (!tex.m_IsDeclaredThisFrame) continue;
-
-        uint16_t firstAccessPass = UINT16_MAX;
+        builder.m_bNeedsNewSlot = true;
+        return true;
+    }
+    return !HasUsableHistory(desc.ComputeHash(), outCurrent, outPrevious);
+}
 
-        for (uint16_t passIdx = 1; passIdx <= (uint16_t)m_PassAccesses.size(); ++passIdx)
+void RenderGraph::ReplaySetupBuilder(const SetupBuilder& builder)
+{
+    for (const SetupBuilder::Op& op : builder.m_Ops)
+    {
+        switch (op.m_Type)
         {
-            const PassAccess& access = m_PassAccesses[passIdx - 1];
-            if (access.m_ReadTextures.count(i) || access.m_WriteTextures.count(i))
-            {
-                if (firstAccessPass == UINT16_MAX)
-                {
-                    firstAccessPass = passIdx;
-                }
-            }
-        }
-
-        if (firstAccessPass == UINT16_MAX)
+        case SetupBuilder::OpType::DeclareTexture:
         {
-            if (m_bVerboseLogging)
-                SDL_Log("[RenderGraph] ERROR: Texture '%s' (index %u) declared but never accessed", tex.m_Desc.m_NvrhiDesc.debugName.c_str(), i);
-            SDL_assert(false && "Resource declared but never accessed");
+            RGTextureHandle& handle = *static_cast<RGTextureHandle*>(op.m_pHandle);
+            const RGTextureDesc& desc = builder.m_TextureDescs[op.m_DescIndex];
+            if (op.m_bPersistent)
+                DeclarePersistentTexture(desc, handle);
+            else
+                DeclareTexture(desc, handle);
+            break;
         }
-
-        if (tex.m_DeclarationPass > firstAccessPass)
+        case SetupBuilder::OpType::DeclareBuffer:
         {
-            if (m_bVerboseLogging)
-                SDL_Log("[RenderGraph] ERROR: Texture '%s' (index %u) accessed in pass %u but only declared in pass %u", 
-                    tex.m_Desc.m_NvrhiDesc.debugName.c_str(), i, firstAccessPass, tex.m_DeclarationPass);
-            SDL_assert(false && "Resource accessed before it was declared");
+            RGBufferHandle& handle = *static_cast<RGBufferHandle*>(op.m_pHandle);
+            const RGBufferDesc& desc = builder.m_BufferDescs[op.m_DescIndex];
+            if (op.m_bPersistent)
+                DeclarePersistentBuffer(desc, handle);
+            else
+                DeclareBuffer(desc, handle);
+            break;
+        }
+        case SetupBuilder::OpType::DeclareHistoryTexture:
+            DeclareHistoryTexture(builder.m_TextureDescs[op.m_DescIndex], *static_cast<RGTextureHandle*>(op.m_pHandle),
+                                  *static_cast<RGTextureHandle*>(op.m_pPreviousHandle));
+            break;
+        case SetupBuilder::OpType::ReadTexture:  ReadTexture({ op.m_Handle }, op.m_Subresources); break;
+        case SetupBuilder::OpType::WriteTexture: WriteTexture({ op.m_Handle }, op.m_Subresources); break;
+        case SetupBuilder::OpType::ReadBuffer:   ReadBuffer({ op.m_Handle }); break;
+        case SetupBuilder::OpType::WriteBuffer:  WriteBuffer({ op.m_Handle }); break;
+        case SetupBuilder::OpType::MarkSideEffects: MarkSideEffects(); break;
         }
     }
+}
 
-    for (uint32_t i = 0; i < (uint32_t)m_Buffers.size(); ++i)
+void RenderGraph::RunQueuedSetups()
+{
+    PROFILE_FUNCTION();
+
+    // Handles are about to be invalidated, so no declaration can keep its slot
+    bool bReplay = !m_bForceInvalidateAllResources && g_Renderer.m_TaskScheduler;
+
+    std::vector<SetupBuilder> builders(m_QueuedSetupRenderers.size());
+    if (bReplay)
     {
-        const TransientBuffer& buf = m_Buffers[i];
-        if (!buf.m_IsDeclaredThisFrame) continue;
+        g_Renderer.m_TaskScheduler->ParallelFor(static_cast<uint32_t>(builders.size()), [this, &builders](uint32_t index, uint32_t threadIndex)
+        {
+            PROFILE_SCOPED("SetupRenderer");
+            t_ActiveSetupBuilder = &builders[index];
+            builders[index].m_bEnabled = m_QueuedSetupRenderers[index]->Setup(*this);
+            t_ActiveSetupBuilder = nullptr;
+        });
+    }
+
+    if (bReplay)
+    {
+        // Handles that a re-run Setup() moved to a new slot, by their value before it ran. Builders recorded
+        // after them may still name the old value (or nothing), so those renderers are re-run too.
+        std::vector<uint32_t> staleTextures;
+        std::vector<uint32_t> staleBuffers;
+        auto namesStaleHandle = [&staleTextures, &staleBuffers](const SetupBuilder& builder)
+        {
+            for (const SetupBuilder::Op& op : builder.m_Ops)
+            {
+                const std::vector<uint32_t>* stale = nullptr;
+                if (op.m_Type == SetupBuilder::OpType::ReadTexture || op.m_Type == SetupBuilder::OpType::WriteTexture)
+                    stale = &staleTextures;
+                else if (op.m_Type == SetupBuilder::OpType::ReadBuffer || op.m_Type == SetupBuilder::OpType::WriteBuffer)
+                    stale = &staleBuffers;
+                if (stale && std::find(stale->begin(), stale->end(), op.m_Handle.m_Index) != stale->end())
+                    return true;
+            }
+            return false;
+        };
+
+        // Scheduling order, so passes, slots and the structure hash come out as if set up one after another
+        uint32_t numRerun = 0;
+        for (uint32_t i = 0; i < (uint32_t)builders.size(); ++i)
+        {
+            IRenderer* pRenderer = m_QueuedSetupRenderers[i];
+            const SetupBuilder& builder = builders[i];
+            if (!builder.m_bNeedsNewSlot && !namesStaleHandle(builder))
+            {
+                ReplaySetupBuilder(builder);
+                pRenderer->m_bPassEnabled = builder.m_bEnabled;
+                CommitRendererSetup(pRenderer);
+                continue;
+            }
+
+            // Setup() again with the calls going straight through, it hands out the new slots itself
+            struct DeclaredHandle
+            {
+                const RGResourceHandleBase* m_pHandle;
+                uint32_t m_OldIndex;
+                bool m_bIsTexture;
+            };
+            std::vector<DeclaredHandle> declared;
+            for (const SetupBuilder::Op& op : builder.m_Ops)
+            {
+                if (op.m_Type == SetupBuilder::OpType::DeclareBuffer)
+                    declared.push_back({ op.m_pHandle, op.m_pHandle->m_Index, false });
+                else if (op.m_Type == SetupBuilder::OpType::DeclareTexture || op.m_Type == SetupBuilder::OpType::DeclareHistoryTexture)
+                    declared.push_back({ op.m_pHandle, op.m_pHandle->m_Index, true });
+                if (op.m_pPreviousHandle)
+                    declared.push_back({ op.m_pPreviousHandle, op.m_pPreviousHandle->m_Index, true });
+            }
+
+            if (m_bVerboseLogging)
+                SDL_Log("[RenderGraph] Parallel setup: '%s' %s - running its Setup() again serially.", pRenderer->GetName(),
+                        builder.m_bNeedsNewSlot ? "needs new resource slots" : "read a handle that moved to a new slot");
+
+            SetupRenderer(pRenderer);
+            ++numRerun;
+
+            for (const DeclaredHandle& handle : declared)
+            {
+                if (handle.m_pHandle->m_Index != handle.m_OldIndex)
+                    (handle.m_bIsTexture ? staleTextures : staleBuffers).push_back(handle.m_OldIndex);
+            }
+        }
+
+        m_SetupRerunCount += numRerun;
+        if (numRerun > 0)
+            ++m_SerialSetupFallbackCount;
+        else
+            ++m_ParallelSetupCount;
+    }
+    else
+    {
+        // Nothing ran yet: every handle is about to be invalidated, or there is no scheduler to run Setup()s on
+        for (IRenderer* pRenderer : m_QueuedSetupRenderers)
+        {
+            SetupRenderer(pRenderer);
+        }
+        ++m_SerialSetupFallbackCount;
+    }
+
+    m_QueuedSetupRenderers.clear();
+}
+
+// ============================================================================
+// RenderGraph - Compilation
+// ============================================================================
+
+void RenderGraph::UpdateResourceLifetime(RenderGraphInternal::ResourceLifetime& lifetime, uint16_t currentPass)
+{
+    if (lifetime.m_FirstPass == UINT16_MAX)
+    {
+        lifetime.m_FirstPass = currentPass;
+    }
+    else
+    {
+        lifetime.m_FirstPass = std::min(lifetime.m_FirstPass, currentPass);
+    }
+    lifetime.m_LastPass = std::max(lifetime.m_LastPass, currentPass);
+}
+
+void RenderGraph::CullDeadPasses()
+{
+    PROFILE_FUNCTION();
+
+    // Backward sweep with the set of resources some live pass after the current one accesses. Writes count as
+    // accesses too: a pass that writes over part of a resource keeps the passes that wrote it before alive.
+    std::vector<bool> neededTextures(m_Textures.size(), false);
+    std::vector<bool> neededBuffers(m_Buffers.size(), false);
+    uint32_t numCulled = 0;
+    for (uint16_t passIdx = (uint16_t)m_PassAccesses.size(); passIdx >= 1; --passIdx)
+    {
+        PassAccess& access = m_PassAccesses[passIdx - 1];
+
+        bool bLive = !access.m_bCullable || access.m_bHasSideEffects || (access.m_WriteTextures.empty() && access.m_WriteBuffers.empty());
+        for (uint32_t idx : access.m_WriteTextures) bLive = bLive || neededTextures[idx] || m_Textures[idx].m_IsPersistent;
+        for (uint32_t idx : access.m_WriteBuffers) bLive = bLive || neededBuffers[idx] || m_Buffers[idx].m_IsPersistent;
+
+        access.m_bCulled = !bLive;
+        if (!bLive)
+        {
+            ++numCulled;
+            continue;
+        }
+
+        for (uint32_t idx : access.m_ReadTextures) neededTextures[idx] = true;
+        for (uint32_t idx : access.m_WriteTextures) neededTextures[idx] = true;
+        for (uint32_t idx : access.m_ReadBuffers) neededBuffers[idx] = true;
+        for (uint32_t idx : access.m_WriteBuffers) neededBuffers[idx] = true;
+    }
+
+    m_Stats.m_NumCulledPasses = numCulled;
+    if (numCulled == 0)
+        return;
+
+    // Culled renderers are treated like ones whose Setup() returned false: no command list, no recording
+    for (uint32_t jobIdx = 0; jobIdx < (uint32_t)m_RecordingJobs.size();)
+    {
+        const RecordingJob& job = m_RecordingJobs[jobIdx];
+        if (!m_PassAccesses[job.m_PassIndex - 1].m_bCulled)
+        {
+            ++jobIdx;
+            continue;
+        }
+
+        if (m_bVerboseLogging)
+            SDL_Log("[RenderGraph] Culling pass '%s' (pass %u): nothing live reads its outputs", job.m_Renderer->GetName(), job.m_PassIndex);
+
+        job.m_Renderer->m_bPassEnabled = false;
+        job.m_Renderer->m_CPUTime = 0.0f;
+        job.m_Renderer->m_GPUTime = 0.0f;
+        m_RecordingJobs.erase(m_RecordingJobs.begin() + jobIdx);
+    }
+
+    // A resource declared by a culled pass has no live accesses (its declaring pass would have been kept otherwise).
+    // Lifetimes were grown by every pass in BeginPass(); rebuild them from the live passes only.
+    for (TransientTexture& texture : m_Textures)
+    {
+        if (texture.m_IsDeclaredThisFrame && texture.m_DeclarationPass > 0 && m_PassAccesses[texture.m_DeclarationPass - 1].m_bCulled)
+        {
+            texture.m_IsDeclaredThisFrame = false;
+        }
+        texture.m_Lifetime = {};
+    }
+    for (TransientBuffer& buffer : m_Buffers)
+    {
+        if (buffer.m_IsDeclaredThisFrame && buffer.m_DeclarationPass > 0 && m_PassAccesses[buffer.m_DeclarationPass - 1].m_bCulled)
+        {
+            buffer.m_IsDeclaredThisFrame = false;
+        }
+        buffer.m_Lifetime = {};
+    }
+    for (uint16_t passIdx = 1; passIdx <= (uint16_t)m_PassAccesses.size(); ++passIdx)
+    {
+        const PassAccess& access = m_PassAccesses[passIdx - 1];
+        if (access.m_bCulled) continue;
+
+        for (uint32_t idx : access.m_ReadTextures) UpdateResourceLifetime(m_Textures[idx].m_Lifetime, passIdx);
+        for (uint32_t idx : access.m_WriteTextures) UpdateResourceLifetime(m_Textures[idx].m_Lifetime, passIdx);
+        for (uint32_t idx : access.m_ReadBuffers) UpdateResourceLifetime(m_Buffers[idx].m_Lifetime, passIdx);
+        for (uint32_t idx : access.m_WriteBuffers) UpdateResourceLifetime(m_Buffers[idx].m_Lifetime, passIdx);
+    }
+}
+
+// D3D12 compute queues can't transition resources into or out of graphics-only states
+static bool IsComputeQueueState(nvrhi::ResourceStates state)
+{
+    const nvrhi::ResourceStates graphicsOnlyStates = nvrhi::ResourceStates::RenderTarget | nvrhi::ResourceStates::DepthWrite |
+        nvrhi::ResourceStates::DepthRead | nvrhi::ResourceStates::ShaderResource | nvrhi::ResourceStates::IndexBuffer |
+        nvrhi::ResourceStates::StreamOut | nvrhi::ResourceStates::ResolveSource | nvrhi::ResourceStates::ResolveDest |
+        nvrhi::ResourceStates::Present | nvrhi::ResourceStates::ShadingRateSurface;
+    return (state & graphicsOnlyStates) == nvrhi::ResourceStates::Unknown;
+}
+
+void RenderGraph::ScheduleQueues(std::span<const QueuePassInfo> passes, std::vector<nvrhi::CommandQueue>& outPassQueues,
+                                 std::vector<QueueSyncPoint>& outSyncPoints)
+{
+    const uint16_t numPasses = (uint16_t)passes.size();
+    outPassQueues.assign(numPasses, nvrhi::CommandQueue::Graphics);
+    outSyncPoints.clear();
+
+    auto dependsOn = [&passes](uint16_t passIdx, uint16_t dependencyIdx)
+    {
+        const std::vector<uint16_t>& dependencies = passes[passIdx - 1].m_Dependencies;
+        return std::find(dependencies.begin(), dependencies.end(), dependencyIdx) != dependencies.end();
+    };
+    auto isAsyncCandidate = [&passes](uint16_t passIdx)
+    {
+        const QueuePassInfo& info = passes[passIdx - 1];
+        return !info.m_bCulled && info.m_bPrefersAsyncCompute && info.m_bComputeCompatible;
+    };
+
+    for (uint16_t passIdx = 1; passIdx <= numPasses; ++passIdx)
+    {
+        if (!isAsyncCandidate(passIdx))
+            continue;
+
+        // Nearest graphics passes on either side. Graphics runs in order, so if the pass needs the one before it
+        // and the one after needs it, nothing on the graphics queue can run alongside it.
+        uint16_t prevGraphicsPass = 0;
+        for (uint16_t i = passIdx - 1; i >= 1 && prevGraphicsPass == 0; --i)
+        {
+            if (!passes[i - 1].m_bCulled && !isAsyncCandidate(i)) prevGraphicsPass = i;
+        }
+        uint16_t nextGraphicsPass = 0;
+        for (uint16_t i = passIdx + 1; i <= numPasses && nextGraphicsPass == 0; ++i)
+        {
+            if (!passes[i - 1].m_bCulled && !isAsyncCandidate(i)) nextGraphicsPass = i;
+        }
+
+        const bool bOverlapsPrev = prevGraphicsPass != 0 && !dependsOn(passIdx, prevGraphicsPass);
+        const bool bOverlapsNext = nextGraphicsPass != 0 && !dependsOn(nextGraphicsPass, passIdx);
+        if (bOverlapsPrev || bOverlapsNext)
+        {
+            outPassQueues[passIdx - 1] = nvrhi::CommandQueue::Compute;
+        }
+    }
+
+    // Latest pass on the other queue each queue has waited for; queues run in order, so that covers every earlier one
+    uint16_t lastWaitedPass[(size_t)nvrhi::CommandQueue::Count] = {};
+    for (uint16_t passIdx = 1; passIdx <= numPasses; ++passIdx)
+    {
+        const QueuePassInfo& info = passes[passIdx - 1];
+        if (info.m_bCulled)
+            continue;
+
+        const nvrhi::CommandQueue queue = outPassQueues[passIdx - 1];
+        uint16_t signalPass = 0;
+        for (uint16_t dependencyIdx : info.m_Dependencies)
+        {
+            if (!passes[dependencyIdx - 1].m_bCulled && outPassQueues[dependencyIdx - 1] != queue)
+                signalPass = std::max(signalPass, dependencyIdx);
+        }
+
+        if (signalPass > lastWaitedPass[(size_t)queue])
+        {
+            outSyncPoints.push_back({ signalPass, passIdx });
+            lastWaitedPass[(size_t)queue] = signalPass;
+        }
+    }
+}
 
-        uint16_t firstAccessPass = UINT16_MAX;
+void RenderGraph::AssignQueues()
+{
+    PROFILE_FUNCTION();
+
+    const uint16_t numPasses = (uint16_t)m_PassAccesses.size();
+    m_PassQueues.assign(numPasses, nvrhi::CommandQueue::Graphics);
+    m_QueueSyncPoints.clear();
+    m_Stats.m_NumAsyncComputePasses = m_Stats.m_NumQueueSyncPoints = 0;
+
+    const bool bAnyPreference = std::any_of(m_PassAccesses.begin(), m_PassAccesses.end(),
+        [](const PassAccess& access) { return access.m_bPrefersAsyncCompute && !access.m_bCulled; });
+    if (!m_AsyncComputeEnabled || !bAnyPreference)
+        return;
+
+    // Dependencies: a read needs the last writer; a write needs the last writer and every reader since it,
+    // which may end up on either queue
+    std::vector<QueuePassInfo> passes(numPasses);
+    std::vector<uint16_t> lastTextureWriter(m_Textures.size(), 0);
+    std::vector<uint16_t> lastBufferWriter(m_Buffers.size(), 0);
+    std::vector<std::vector<uint16_t>> textureReaders(m_Textures.size());
+    std::vector<std::vector<uint16_t>> bufferReaders(m_Buffers.size());
 
-        for (uint16_t passIdx = 1; passIdx <= (uint16_t)m_PassAccesses.size(); ++passIdx)
+    for (uint16_t passIdx = 1; passIdx <= numPasses; ++passIdx)
+    {
+        const PassAccess& access = m_PassAccesses[passIdx - 1];
+        QueuePassInfo& info = passes[passIdx - 1];
+        info.m_bCulled = access.m_bCulled;
+        info.m_bPrefersAsyncCompute = access.m_bPrefersAsyncCompute;
+        if (access.m_bCulled)
+            continue;
+
+        auto addDependency = [&info, passIdx](uint16_t dependencyIdx)
+        {
+            if (dependencyIdx != 0 && dependencyIdx != passIdx)
+                info.m_Dependencies.push_back(dependencyIdx);
+        };
+        auto visit = [&](const std::vector<uint32_t>& indices, bool bWrite, std::vector<uint16_t>& lastWriter, std::vector<std::vector<uint16_t>>& readers)
         {
-            const PassAccess& access = m_PassAccesses[passIdx - 1];
-            if (access.m_ReadBuffers.count(i) || access.m_WriteBuffers.count(i))
+            for (uint32_t idx : indices)
             {
-                if (firstAccessPass == UINT16_MAX)
+                addDependency(lastWriter[idx]);
+                if (bWrite)
                 {
-                    firstAccessPass = passIdx;
+                    for (uint16_t readerIdx : readers[idx]) addDependency(readerIdx);
+                    readers[idx].clear();
+                    lastWriter[idx] = passIdx;
+                }
+                else
+                {
+                    readers[idx].push_back(passIdx);
                 }
             }
+        };
+        visit(access.m_ReadTextures, false, lastTextureWriter, textureReaders);
+        visit(access.m_ReadBuffers, false, lastBufferWriter, bufferReaders);
+        visit(access.m_WriteTextures, true, lastTextureWriter, textureReaders);
+        visit(access.m_WriteBuffers, true, lastBufferWriter, bufferReaders);
+
+        std::sort(info.m_Dependencies.begin(), info.m_Dependencies.end());
+        info.m_Dependencies.erase(std::unique(info.m_Dependencies.begin(), info.m_Dependencies.end()), info.m_Dependencies.end());
+
+        if (access.m_bPrefersAsyncCompute)
+        {
+            for (uint32_t idx : access.m_ReadTextures) info.m_bComputeCompatible &= IsComputeQueueState(m_Textures[idx].m_Desc.m_NvrhiDesc.initialState);
+            for (uint32_t idx : access.m_WriteTextures) info.m_bComputeCompatible &= IsComputeQueueState(m_Textures[idx].m_Desc.m_NvrhiDesc.initialState);
+            for (uint32_t idx : access.m_ReadBuffers) info.m_bComputeCompatible &= IsComputeQueueState(m_Buffers[idx].m_Desc.m_NvrhiDesc.initialState);
+            for (uint32_t idx : access.m_WriteBuffers) info.m_bComputeCompatible &= IsComputeQueueState(m_Buffers[idx].m_Desc.m_NvrhiDesc.initialState);
         }
+    }
+
+    ScheduleQueues(passes, m_PassQueues, m_QueueSyncPoints);
+    m_Stats.m_NumQueueSyncPoints = (uint32_t)m_QueueSyncPoints.size();
+
+    for (uint16_t passIdx = 1; passIdx <= numPasses; ++passIdx)
+    {
+        const PassAccess& access = m_PassAccesses[passIdx - 1];
+        if (m_PassQueues[passIdx - 1] != nvrhi::CommandQueue::Compute)
+        {
+            if (m_bVerboseLogging && access.m_bPrefersAsyncCompute && !access.m_bCulled)
+                SDL_Log("[RenderGraph] Pass '%s' kept on the graphics queue: %s", m_PassNames[passIdx - 1],
+                        passes[passIdx - 1].m_bComputeCompatible ? "no graphics work to overlap with" : "accesses a resource in a graphics-only state");
+            continue;
+        }
+
+        m_Stats.m_NumAsyncComputePasses++;
+        for (uint32_t idx : access.m_ReadTextures) m_Textures[idx].m_bUsedOnAsyncCompute = true;
+        for (uint32_t idx : access.m_WriteTextures) m_Textures[idx].m_bUsedOnAsyncCompute = true;
+        for (uint32_t idx : access.m_ReadBuffers) m_Buffers[idx].m_bUsedOnAsyncCompute = true;
+        for (uint32_t idx : access.m_WriteBuffers) m_Buffers[idx].m_bUsedOnAsyncCompute = true;
+    }
+}
+
+void RenderGraph::PlanCommandLists()
+{
+    PROFILE_FUNCTION();
+
+    // Per-pass submission is for debugging GPU work pass by pass, so every pass keeps its own list there
+    const Config& config = Config::Get();
+    const bool bExecutePerPass = config.ExecutePerPass || config.ExecutePerPassAndWait;
+    const float maxBatchCPUTimeMs = bExecutePerPass ? 0.0f : config.m_CommandListBatchMaxCPUTimeMs;
+
+    const uint16_t numPasses = (uint16_t)m_PassAccesses.size();
+    std::vector<bool> bPassWaits(numPasses + 1, false);
+    std::vector<bool> bPassSignals(numPasses + 1, false);
+    for (const QueueSyncPoint& syncPoint : m_QueueSyncPoints)
+    {
+        bPassWaits[syncPoint.m_WaitingPass] = true;
+        bPassSignals[syncPoint.m_SignalPass] = true;
+    }
+
+    std::vector<CommandListJobInfo> jobs(m_RecordingJobs.size());
+    uint16_t prevPass = 0;
+    for (uint32_t jobIdx = 0; jobIdx < (uint32_t)m_RecordingJobs.size(); ++jobIdx)
+    {
+        const RecordingJob& job = m_RecordingJobs[jobIdx];
+        CommandListJobInfo& info = jobs[jobIdx];
+        info.m_CPUTimeHistory = job.m_Renderer->m_CPUTimeHistory;
+        info.m_Queue = GetPassQueue(job.m_PassIndex);
+        info.m_bStartsList = bPassWaits[job.m_PassIndex];
+        info.m_bEndsList = bPassSignals[job.m_PassIndex];
+
+        // A live pass begun outside ScheduleRenderer() records elsewhere; a list spanning it would reorder the two
+        if (prevPass != 0)
+        {
+            for (uint16_t passIdx = prevPass + 1; passIdx < job.m_PassIndex; ++passIdx)
+            {
+                info.m_bStartsList = info.m_bStartsList || !m_PassAccesses[passIdx - 1].m_bCulled;
+            }
+        }
+        prevPass = job.m_PassIndex;
+    }
+
+    m_CommandListFirstJobs = ComputeCommandListBatches(jobs, maxBatchCPUTimeMs);
+
+    // Passes without a recording job count as a list of their own
+    m_PassCommandListStart.resize(numPasses + 1);
+    for (uint16_t passIdx = 0; passIdx <= numPasses; ++passIdx)
+    {
+        m_PassCommandListStart[passIdx] = passIdx;
+    }
+    for (uint32_t listIdx = 0; listIdx < (uint32_t)m_CommandListFirstJobs.size(); ++listIdx)
+    {
+        const uint32_t firstJob = m_CommandListFirstJobs[listIdx];
+        const uint32_t endJob = (listIdx + 1 < m_CommandListFirstJobs.size()) ? m_CommandListFirstJobs[listIdx + 1] : (uint32_t)m_RecordingJobs.size();
+        for (uint32_t jobIdx = firstJob; jobIdx < endJob; ++jobIdx)
+        {
+            m_PassCommandListStart[m_RecordingJobs[jobIdx].m_PassIndex] = m_RecordingJobs[firstJob].m_PassIndex;
+        }
+    }
+
+    m_Stats.m_NumRecordedPasses = (uint32_t)m_RecordingJobs.size();
+    m_Stats.m_NumPassCommandLists = (uint32_t)m_CommandListFirstJobs.size();
+}
+
+// State a pass's access needs the resource in, or Unknown when the desc alone can't tell (left to nvrhi's tracking)
+static nvrhi::ResourceStates GetPlannedTextureState(const nvrhi::TextureDesc& desc, bool bWrite)
+{
+    if (!bWrite)
+    {
+        // Depth is sampled as ShaderResource or bound read-only as DepthRead
+        return nvrhi::getFormatInfo(desc.format).hasDepth ? nvrhi::ResourceStates::Unknown : nvrhi::ResourceStates::ShaderResource;
+    }
+    if (desc.isRenderTarget && desc.isUAV)
+        return nvrhi::ResourceStates::Unknown;
+    if (desc.isRenderTarget)
+        return nvrhi::getFormatInfo(desc.format).hasDepth ? nvrhi::ResourceStates::DepthWrite : nvrhi::ResourceStates::RenderTarget;
+    return desc.isUAV ? nvrhi::ResourceStates::UnorderedAccess : nvrhi::ResourceStates::CopyDest;
+}
+
+static nvrhi::ResourceStates GetPlannedBufferState(const nvrhi::BufferDesc& desc, bool bWrite)
+{
+    if (bWrite)
+        return desc.canHaveUAVs ? nvrhi::ResourceStates::UnorderedAccess : nvrhi::ResourceStates::CopyDest;
+    if (desc.isVertexBuffer || desc.isIndexBuffer || desc.isConstantBuffer || desc.isDrawIndirectArgs || desc.isAccelStructBuildInput)
+        return nvrhi::ResourceStates::Unknown;
+    return nvrhi::ResourceStates::ShaderResource;
+}
+
+void RenderGraph::PlanStateTransitions()
+{
+    PROFILE_FUNCTION();
+
+    const uint16_t numPasses = (uint16_t)m_PassAccesses.size();
+    m_PerPassStateTransitions.clear();
+    m_PerPassStateTransitions.resize(numPasses + 1); // pass indices are 1-based
+    m_Stats.m_NumStateTransitions = m_Stats.m_NumBarrierBatches = m_Stats.m_NumSplitTransitions = 0;
+
+    // State each buffer / texture subresource was left in by the last live pass that accessed it (Unknown if that
+    // access wasn't planned), and the passes it was used in
+    struct TrackedState
+    {
+        nvrhi::ResourceStates m_State = nvrhi::ResourceStates::Unknown;
+        uint16_t m_FirstAccessPass = 0;
+        uint16_t m_LastAccessPass = 0;
+    };
+    std::vector<TrackedState> bufferStates(m_Buffers.size());
+    std::vector<std::vector<TrackedState>> textureStates(m_Textures.size()); // per subresource, sized on first access
+    std::vector<bool> bTexturePartiallyAccessed(m_Textures.size(), false);
+
+    // What the pass being planned needs of each subresource of one texture, and the transitions of one mip
+    struct SubresourceNeed
+    {
+        bool m_bTouched = false;
+        nvrhi::ResourceStates m_State = nvrhi::ResourceStates::Unknown;
+    };
+    std::vector<SubresourceNeed> needs;
+    std::vector<StateTransition> mipTransitions;
+
+    for (uint16_t passIdx = 1; passIdx <= numPasses; ++passIdx)
+    {
+        const PassAccess& access = m_PassAccesses[passIdx - 1];
+        if (access.m_bCulled)
+            continue;
+
+        const nvrhi::CommandQueue queue = GetPassQueue(passIdx);
+        std::vector<StateTransition>& transitions = m_PerPassStateTransitions[passIdx];
+
+        auto getPlannedState = [queue](nvrhi::ResourceStates state)
+        {
+            return (queue == nvrhi::CommandQueue::Compute && !IsComputeQueueState(state)) ? nvrhi::ResourceStates::Unknown : state;
+        };
+
+        // The transition could begin right after the previous access, on the same queue. Not for resources used
+        // on the compute queue (pass order doesn't bound when those run), nor before an aliased resource's first
+        // use (its memory belongs to another resource until the aliasing barrier).
+        auto getBeginPass = [&](const TransientResourceBase& resource, uint16_t lastAccessPass)
+        {
+            if (resource.m_bUsedOnAsyncCompute || (lastAccessPass == 0 && resource.m_AliasedFromIndex != UINT32_MAX))
+                return passIdx;
+            uint16_t beginPass = lastAccessPass + 1;
+            while (beginPass < passIdx && (m_PassAccesses[beginPass - 1].m_bCulled || GetPassQueue(beginPass) != queue))
+                ++beginPass;
+            return beginPass;
+        };
+
+        // Passes batched into one command list see each other's states, keepInitialState or not
+        auto isSameCommandList = [&](uint16_t lastAccessPass)
+        {
+            return lastAccessPass != 0 && m_PassCommandListStart[lastAccessPass] == m_PassCommandListStart[passIdx];
+        };
+
+        auto addTransition = [&](const StateTransition& transition)
+        {
+            transitions.push_back(transition);
+            if (transition.m_BeginPass < passIdx)
+                m_Stats.m_NumSplitTransitions++;
+        };
+
+        auto planBuffer = [&](uint32_t idx, bool bWrite)
+        {
+            const TransientBuffer& buffer = m_Buffers[idx];
+            if (buffer.m_bSuballocated)
+                return; // its pool buffer stays in its initial state
+
+            const nvrhi::BufferDesc& desc = buffer.m_Desc.m_NvrhiDesc;
+            const nvrhi::ResourceStates after = getPlannedState(GetPlannedBufferState(desc, bWrite));
+            TrackedState& tracked = bufferStates[idx];
+
+            // nvrhi puts keepInitialState resources back into their initial state at the end of every command list
+            const bool bResetsToInitial = desc.keepInitialState && !isSameCommandList(tracked.m_LastAccessPass);
+            const nvrhi::ResourceStates before = (bResetsToInitial || tracked.m_LastAccessPass == 0) ? desc.initialState : tracked.m_State;
+            const uint16_t lastAccessPass = tracked.m_LastAccessPass;
+            tracked.m_State = after;
+            tracked.m_LastAccessPass = passIdx;
+
+            if (after != nvrhi::ResourceStates::Unknown && after != before)
+            {
+                addTransition({ idx, true, before, after, getBeginPass(buffer, lastAccessPass) });
+            }
+        };
+
+        auto planTexture = [&](uint32_t idx)
+        {
+            TransientTexture& texture = m_Textures[idx];
+            const nvrhi::TextureDesc& desc = texture.m_Desc.m_NvrhiDesc;
+            const uint32_t numMips = desc.mipLevels;
+            const uint32_t numSlices = desc.arraySize;
+            std::vector<TrackedState>& tracked = textureStates[idx];
+            tracked.resize(numMips * numSlices);
+
+            needs.assign(numMips * numSlices, {});
+            auto markNeeds = [&](const std::vector<uint32_t>& indices, const std::vector<PassAccess::TextureRange>& ranges, bool bWrite)
+            {
+                if (!PassAccess::Contains(indices, idx))
+                    return;
+                const nvrhi::TextureSubresourceSet subresources = PassAccess::GetTextureRange(ranges, idx).resolve(desc, false);
+                if (!subresources.isEntireTexture(desc))
+                    bTexturePartiallyAccessed[idx] = true;
+                const nvrhi::ResourceStates state = getPlannedState(GetPlannedTextureState(desc, bWrite));
+                for (uint32_t mip = subresources.baseMipLevel; mip < subresources.baseMipLevel + subresources.numMipLevels; ++mip)
+                {
+                    for (uint32_t slice = subresources.baseArraySlice; slice < subresources.baseArraySlice + subresources.numArraySlices; ++slice)
+                    {
+                        needs[mip * numSlices + slice] = { true, state };
+                    }
+                }
+            };
+            markNeeds(access.m_ReadTextures, access.m_ReadTextureRanges, false);
+            markNeeds(access.m_WriteTextures, access.m_WriteTextureRanges, true); // a write wins where both touch a subresource
+
+            // Runs of slices with the same transition within a mip; a mip whose single run matches the previous mip's
+            // extends that transition instead (m_BeginPass holds the latest last access until the run is emitted)
+            StateTransition pending;
+            bool bHasPending = false;
+            auto flushPending = [&]()
+            {
+                if (bHasPending)
+                {
+                    pending.m_BeginPass = getBeginPass(texture, pending.m_BeginPass);
+                    addTransition(pending);
+                    bHasPending = false;
+                }
+            };
+
+            for (uint32_t mip = 0; mip < numMips; ++mip)
+            {
+                mipTransitions.clear();
+                bool bExtendsRun = false;
+                for (uint32_t slice = 0; slice < numSlices; ++slice)
+                {
+                    const SubresourceNeed& need = needs[mip * numSlices + slice];
+                    if (!need.m_bTouched)
+                    {
+                        bExtendsRun = false;
+                        continue;
+                    }
+
+                    TrackedState& subresource = tracked[mip * numSlices + slice];
+                    const bool bResetsToInitial = desc.keepInitialState && !isSameCommandList(subresource.m_LastAccessPass);
+                    const nvrhi::ResourceStates before = (bResetsToInitial || subresource.m_LastAccessPass == 0) ? desc.initialState : subresource.m_State;
+                    const uint16_t lastAccessPass = subresource.m_LastAccessPass;
+                    subresource.m_State = need.m_State;
+                    subresource.m_LastAccessPass = passIdx;
+                    if (subresource.m_FirstAccessPass == 0)
+                        subresource.m_FirstAccessPass = passIdx;
+
+                    if (need.m_State == nvrhi::ResourceStates::Unknown || need.m_State == before)
+                    {
+                        bExtendsRun = false;
+                        continue;
+                    }
+
+                    if (bExtendsRun && mipTransitions.back().m_Before == before && mipTransitions.back().m_After == need.m_State)
+                    {
+                        mipTransitions.back().m_Subresources.numArraySlices++;
+                        mipTransitions.back().m_BeginPass = std::max(mipTransitions.back().m_BeginPass, lastAccessPass);
+                    }
+                    else
+                    {
+                        mipTransitions.push_back({ idx, false, before, need.m_State, lastAccessPass, nvrhi::TextureSubresourceSet(mip, 1, slice, 1) });
+                    }
+                    bExtendsRun = true;
+                }
+
+                if (mipTransitions.size() == 1 && bHasPending &&
+                    pending.m_Subresources.baseMipLevel + pending.m_Subresources.numMipLevels == mip &&
+                    pending.m_Subresources.baseArraySlice == mipTransitions[0].m_Subresources.baseArraySlice &&
+                    pending.m_Subresources.numArraySlices == mipTransitions[0].m_Subresources.numArraySlices &&
+                    pending.m_Before == mipTransitions[0].m_Before && pending.m_After == mipTransitions[0].m_After)
+                {
+                    pending.m_Subresources.numMipLevels++;
+                    pending.m_BeginPass = std::max(pending.m_BeginPass, mipTransitions[0].m_BeginPass);
+                    continue;
+                }
+
+                flushPending();
+                if (mipTransitions.size() == 1)
+                {
+                    pending = mipTransitions[0];
+                    bHasPending = true;
+                }
+                else
+                {
+                    for (StateTransition& transition : mipTransitions)
+                    {
+                        transition.m_BeginPass = getBeginPass(texture, transition.m_BeginPass);
+                        addTransition(transition);
+                    }
+                }
+            }
+            flushPending();
+        };
+
+        for (uint32_t idx : access.m_WriteTextures)
+        {
+            planTexture(idx);
+        }
+        for (uint32_t idx : access.m_ReadTextures)
+        {
+            if (!PassAccess::Contains(access.m_WriteTextures, idx))
+                planTexture(idx);
+        }
+        for (uint32_t idx : access.m_WriteBuffers)
+        {
+            planBuffer(idx, true);
+        }
+        for (uint32_t idx : access.m_ReadBuffers)
+        {
+            if (!PassAccess::Contains(access.m_WriteBuffers, idx))
+                planBuffer(idx, false);
+        }
+
+        if (!transitions.empty())
+        {
+            m_Stats.m_NumStateTransitions += (uint32_t)transitions.size();
+            m_Stats.m_NumBarrierBatches++;
+        }
+    }
+
+    for (uint32_t i = 0; i < (uint32_t)m_Textures.size(); ++i)
+    {
+        std::vector<ResourceLifetime>& lifetimes = m_Textures[i].m_SubresourceLifetimes;
+        lifetimes.clear();
+        if (!bTexturePartiallyAccessed[i])
+            continue;
+
+        lifetimes.resize(textureStates[i].size());
+        for (size_t sub = 0; sub < lifetimes.size(); ++sub)
+        {
+            if (textureStates[i][sub].m_FirstAccessPass != 0)
+            {
+                lifetimes[sub].m_FirstPass = textureStates[i][sub].m_FirstAccessPass;
+                lifetimes[sub].m_LastPass = textureStates[i][sub].m_LastAccessPass;
+            }
+        }
+    }
+}
+
+void RenderGraph::Compile()
+{
+    PROFILE_FUNCTION();
+
+    CullDeadPasses();
+    AssignQueues();
+
+    // Resource validation. First access per resource comes from one sweep over the passes' access lists,
+    // O(passes + accesses + resources) rather than a lookup for every (resource, pass) pair.
+    std::vector<uint16_t> firstTextureAccess(m_Textures.size(), UINT16_MAX);
+    std::vector<uint16_t> firstBufferAccess(m_Buffers.size(), UINT16_MAX);
+    for (uint16_t passIdx = (uint16_t)m_PassAccesses.size(); passIdx >= 1; --passIdx)
+    {
+        // Walk passes backwards so the earliest pass writes last
+        const PassAccess& access = m_PassAccesses[passIdx - 1];
+        if (access.m_bCulled) continue;
+        for (uint32_t idx : access.m_ReadTextures) firstTextureAccess[idx] = passIdx;
+        for (uint32_t idx : access.m_WriteTextures) firstTextureAccess[idx] = passIdx;
+        for (uint32_t idx : access.m_ReadBuffers) firstBufferAccess[idx] = passIdx;
+        for (uint32_t idx : access.m_WriteBuffers) firstBufferAccess[idx] = passIdx;
+    }
+
+    for (uint32_t i = 0; i < (uint32_t)m_Textures.size(); ++i)
+    {
+        const TransientTexture& tex = m_Textures[i];
+        if (!tex.m_IsDeclaredThisFrame) continue;
+
+        const uint16_t firstAccessPass = firstTextureAccess[i];
+
+        if (firstAccessPass == UINT16_MAX)
+        {
+            if (m_bVerboseLogging)
+                SDL_Log("[RenderGraph] ERROR: Texture '%s' (index %u) declared but never accessed", tex.m_Desc.m_NvrhiDesc.debugName.c_str(), i);
+            SDL_assert(false && "Resource declared but never accessed");
+        }
+
+        if (tex.m_DeclarationPass > firstAccessPass)
+        {
+            if (m_bVerboseLogging)
+                SDL_Log("[RenderGraph] ERROR: Texture '%s' (index %u) accessed in pass %u but only declared in pass %u", 
+                    tex.m_Desc.m_NvrhiDesc.debugName.c_str(), i, firstAccessPass, tex.m_DeclarationPass);
+            SDL_assert(false && "Resource accessed before it was declared");
+        }
+    }
+
+    for (uint32_t i = 0; i < (uint32_t)m_Buffers.size(); ++i)
+    {
+        const TransientBuffer& buf = m_Buffers[i];
+        if (!buf.m_IsDeclaredThisFrame) continue;
+
+        const uint16_t firstAccessPass = firstBufferAccess[i];
 
         if (firstAccessPass == UINT16_MAX)
         {
@@ -910,141 +2175,161 @@ void RenderGraph::Compile()
     for (const TransientTexture& tex : m_Textures) if (tex.m_IsDeclaredThisFrame) m_Stats.m_NumTextures++;
     for (const TransientBuffer& buf : m_Buffers) if (buf.m_IsDeclaredThisFrame) m_Stats.m_NumBuffers++;
 
-    AllocateResourcesInternal(
-        false,  // bIsBuffer
-        [this, device](uint32_t idx, nvrhi::HeapHandle heap, uint64_t offset)
+    // Create the virtual resource and bind it at (heap, offset). Physical owners already bound there keep their handle.
+    auto createAndBindTexture = [this, device](uint32_t idx, nvrhi::HeapHandle heap, uint64_t offset)
+    {
+        TransientTexture& texture = m_Textures[idx];
+
+        // Aliased (non-owner) resources must ALWAYS recreate their nvrhi handle
+        // each frame.  They are virtual textures re-bound to the owner's heap
+        // region, and callers must not cache raw pointers across frames.
+        // Only physical owners may use the stable-pointer fast path.
+        const bool isAliased = !texture.m_IsPhysicalOwner;
+
+        if (!isAliased &&
+            texture.m_PhysicalTexture && 
+            texture.m_Heap == heap && 
+            texture.m_Offset == offset)
         {
-            TransientTexture& texture = m_Textures[idx];
+            // Physical owner already bound correctly — reuse the existing handle.
+            return;
+        }
 
-            // Aliased (non-owner) resources must ALWAYS recreate their nvrhi handle
-            // each frame.  They are virtual textures re-bound to the owner's heap
-            // region, and callers must not cache raw pointers across frames.
-            // Only physical owners may use the stable-pointer fast path.
-            const bool isAliased = !texture.m_IsPhysicalOwner;
+        PROFILE_SCOPED("CreateTextureAndBindMemory");
 
-            if (!isAliased &&
-                texture.m_PhysicalTexture && 
-                texture.m_Heap == heap && 
-                texture.m_Offset == offset)
-            {
-                // Physical owner already bound correctly — reuse the existing handle.
-                return;
-            }
+        // Capture old pointer so we can assert it changed for aliased resources.
+        const nvrhi::ITexture* oldRawPtr = texture.m_PhysicalTexture
+                                            ? texture.m_PhysicalTexture.Get() : nullptr;
 
-            PROFILE_SCOPED("CreateTextureAndBindMemory");
+        if (m_bVerboseLogging)
+            SDL_Log("[RenderGraph] CREATE-TEXTURE slot %u '%s': isAliased=%d "
+                    "oldPtr=%p heap=%p offset=%llu",
+                    idx,
+                    texture.m_Desc.m_NvrhiDesc.debugName.c_str(),
+                    (int)isAliased,
+                    (void*)oldRawPtr,
+                    (void*)heap.Get(),
+                    (unsigned long long)offset);
+
+        texture.m_Desc.m_NvrhiDesc.isVirtual = true;
+        // Defer the old handle before overwriting — the move-assign would
+        // otherwise drop the refcount inline, potentially triggering a
+        // final-release while the GPU is still in-flight (ERROR #921).
+        // INVARIANT: after this push_back, texture.m_PhysicalTexture must be
+        // null so the subsequent assignment cannot double-release.
+        if (texture.m_PhysicalTexture)
+        {
+            SDL_assert(texture.m_PhysicalTexture.Get() != nullptr &&
+                       "Compile: texture handle is non-null but Get() returns null — "
+                       "RefCountPtr is in an inconsistent state");
+            m_DeferredReleaseTextures.push_back(std::move(texture.m_PhysicalTexture));
+            // After std::move the source must be null.
+            SDL_assert(texture.m_PhysicalTexture == nullptr &&
+                       "Compile: std::move did not null the source texture handle — "
+                       "deferred-release invariant violated; old handle may be double-freed");
+        }
+        texture.m_PhysicalTexture = device->createTexture(texture.m_Desc.m_NvrhiDesc);
+        SDL_assert(texture.m_PhysicalTexture != nullptr &&
+                   "Compile: device->createTexture returned null — "
+                   "out of GPU memory or invalid texture descriptor");
+        device->bindTextureMemory(texture.m_PhysicalTexture, heap, offset);
+        texture.m_Heap = heap;
+        texture.m_Offset = offset;
+
+        // Aliased resources must always produce a fresh handle — if the pointer
+        // is identical to the previous frame's handle the driver may have
+        // returned a cached object, which violates the aliasing contract.
+        SDL_assert((!isAliased || texture.m_PhysicalTexture.Get() != oldRawPtr ||
+                    oldRawPtr == nullptr)
+                   && "Aliased texture: nvrhi returned the same pointer as last frame "
+                      "(handle was not recreated)");
+    };
+
+    auto createAndBindBuffer = [this, device](uint32_t idx, nvrhi::HeapHandle heap, uint64_t offset)
+    {
+        TransientBuffer& buffer = m_Buffers[idx];
 
-            // Capture old pointer so we can assert it changed for aliased resources.
-            const nvrhi::ITexture* oldRawPtr = texture.m_PhysicalTexture
-                                                ? texture.m_PhysicalTexture.Get() : nullptr;
+        // Aliased (non-owner) resources must ALWAYS recreate their nvrhi handle
+        // each frame — same reasoning as for textures above.
+        const bool isAliased = !buffer.m_IsPhysicalOwner;
 
-            if (m_bVerboseLogging)
-                SDL_Log("[RenderGraph] CREATE-TEXTURE slot %u '%s': isAliased=%d "
-                        "oldPtr=%p heap=%p offset=%llu",
-                        idx,
-                        texture.m_Desc.m_NvrhiDesc.debugName.c_str(),
-                        (int)isAliased,
-                        (void*)oldRawPtr,
-                        (void*)heap.Get(),
-                        (unsigned long long)offset);
-
-            texture.m_Desc.m_NvrhiDesc.isVirtual = true;
-            // Defer the old handle before overwriting — the move-assign would
-            // otherwise drop the refcount inline, potentially triggering a
-            // final-release while the GPU is still in-flight (ERROR #921).
-            // INVARIANT: after this push_back, texture.m_PhysicalTexture must be
-            // null so the subsequent assignment cannot double-release.
-            if (texture.m_PhysicalTexture)
-            {
-                SDL_assert(texture.m_PhysicalTexture.Get() != nullptr &&
-                           "Compile: texture handle is non-null but Get() returns null — "
-                           "RefCountPtr is in an inconsistent state");
-                m_DeferredReleaseTextures.push_back(std::move(texture.m_PhysicalTexture));
-                // After std::move the source must be null.
-                SDL_assert(texture.m_PhysicalTexture == nullptr &&
-                           "Compile: std::move did not null the source texture handle — "
-                           "deferred-release invariant violated; old handle may be double-freed");
-            }
-            texture.m_PhysicalTexture = device->createTexture(texture.m_Desc.m_NvrhiDesc);
-            SDL_assert(texture.m_PhysicalTexture != nullptr &&
-                       "Compile: device->createTexture returned null — "
-                       "out of GPU memory or invalid texture descriptor");
-            device->bindTextureMemory(texture.m_PhysicalTexture, heap, offset);
-            texture.m_Heap = heap;
-            texture.m_Offset = offset;
-
-            // Aliased resources must always produce a fresh handle — if the pointer
-            // is identical to the previous frame's handle the driver may have
-            // returned a cached object, which violates the aliasing contract.
-            SDL_assert((!isAliased || texture.m_PhysicalTexture.Get() != oldRawPtr ||
-                        oldRawPtr == nullptr)
-                       && "Aliased texture: nvrhi returned the same pointer as last frame "
-                          "(handle was not recreated)");
-        }
-    );
-
-    AllocateResourcesInternal(
-        true,  // bIsBuffer
-        [this, device](uint32_t idx, nvrhi::HeapHandle heap, uint64_t offset)
-        {
-            TransientBuffer& buffer = m_Buffers[idx];
-
-            // Aliased (non-owner) resources must ALWAYS recreate their nvrhi handle
-            // each frame — same reasoning as for textures above.
-            const bool isAliased = !buffer.m_IsPhysicalOwner;
-
-            if (!isAliased &&
-                buffer.m_PhysicalBuffer && 
-                buffer.m_Heap == heap && 
-                buffer.m_Offset == offset)
-            {
-                // Physical owner already bound correctly — reuse the existing handle.
-                return;
-            }
+        if (!isAliased &&
+            buffer.m_PhysicalBuffer && 
+            buffer.m_Heap == heap && 
+            buffer.m_Offset == offset)
+        {
+            // Physical owner already bound correctly — reuse the existing handle.
+            return;
+        }
+
+        PROFILE_SCOPED("CreateBufferAndBindMemory");
 
-            PROFILE_SCOPED("CreateBufferAndBindMemory");
+        // Capture old pointer so we can assert it changed for aliased resources.
+        const nvrhi::IBuffer* oldRawPtr = buffer.m_PhysicalBuffer
+                                           ? buffer.m_PhysicalBuffer.Get() : nullptr;
 
-            // Capture old pointer so we can assert it changed for aliased resources.
-            const nvrhi::IBuffer* oldRawPtr = buffer.m_PhysicalBuffer
-                                               ? buffer.m_PhysicalBuffer.Get() : nullptr;
+        if (m_bVerboseLogging)
+            SDL_Log("[RenderGraph] CREATE-BUFFER slot %u '%s': isAliased=%d "
+                    "oldPtr=%p heap=%p offset=%llu",
+                    idx,
+                    buffer.m_Desc.m_NvrhiDesc.debugName.c_str(),
+                    (int)isAliased,
+                    (void*)oldRawPtr,
+                    (void*)heap.Get(),
+                    (unsigned long long)offset);
+
+        buffer.m_Desc.m_NvrhiDesc.isVirtual = true;
+        // Defer the old handle before overwriting — same reasoning as for
+        // textures above.
+        if (buffer.m_PhysicalBuffer)
+        {
+            SDL_assert(buffer.m_PhysicalBuffer.Get() != nullptr &&
+                       "Compile: buffer handle is non-null but Get() returns null — "
+                       "RefCountPtr is in an inconsistent state");
+            m_DeferredReleaseBuffers.push_back(std::move(buffer.m_PhysicalBuffer));
+            SDL_assert(buffer.m_PhysicalBuffer == nullptr &&
+                       "Compile: std::move did not null the source buffer handle — "
+                       "deferred-release invariant violated; old handle may be double-freed");
+        }
+        buffer.m_PhysicalBuffer = device->createBuffer(buffer.m_Desc.m_NvrhiDesc);
+        SDL_assert(buffer.m_PhysicalBuffer != nullptr &&
+                   "Compile: device->createBuffer returned null — "
+                   "out of GPU memory or invalid buffer descriptor");
+        device->bindBufferMemory(buffer.m_PhysicalBuffer, heap, offset);
+        buffer.m_Heap = heap;
+        buffer.m_Offset = offset;
+
+        // Aliased resources must always produce a fresh handle.
+        SDL_assert((!isAliased || buffer.m_PhysicalBuffer.Get() != oldRawPtr ||
+                    oldRawPtr == nullptr)
+                   && "Aliased buffer: nvrhi returned the same pointer as last frame "
+                      "(handle was not recreated)");
+    };
+
+    // Re-packing drops the cached compile, so this goes first
+    const bool bCompactedHeaps = CompactHeapsIfNeeded();
+
+    // Pool buffers aren't part of the cached compile: small buffers are packed every frame
+    SuballocateSmallBuffers();
+
+    // Same passes, declarations and accesses as the previous frame: its allocation and alias barriers still hold
+    if (TryReuseCompiledGraph(createAndBindTexture, createAndBindBuffer))
+    {
+        UpdateHeapStats(false);
+        PlanCommandLists();
+        PlanStateTransitions();
+        if (IsCapturingAllocations())
+            RecordAllocationFrame();
+        m_IsCompiled = true;
+        return;
+    }
 
-            if (m_bVerboseLogging)
-                SDL_Log("[RenderGraph] CREATE-BUFFER slot %u '%s': isAliased=%d "
-                        "oldPtr=%p heap=%p offset=%llu",
-                        idx,
-                        buffer.m_Desc.m_NvrhiDesc.debugName.c_str(),
-                        (int)isAliased,
-                        (void*)oldRawPtr,
-                        (void*)heap.Get(),
-                        (unsigned long long)offset);
-
-            buffer.m_Desc.m_NvrhiDesc.isVirtual = true;
-            // Defer the old handle before overwriting — same reasoning as for
-            // textures above.
-            if (buffer.m_PhysicalBuffer)
-            {
-                SDL_assert(buffer.m_PhysicalBuffer.Get() != nullptr &&
-                           "Compile: buffer handle is non-null but Get() returns null — "
-                           "RefCountPtr is in an inconsistent state");
-                m_DeferredReleaseBuffers.push_back(std::move(buffer.m_PhysicalBuffer));
-                SDL_assert(buffer.m_PhysicalBuffer == nullptr &&
-                           "Compile: std::move did not null the source buffer handle — "
-                           "deferred-release invariant violated; old handle may be double-freed");
-            }
-            buffer.m_PhysicalBuffer = device->createBuffer(buffer.m_Desc.m_NvrhiDesc);
-            SDL_assert(buffer.m_PhysicalBuffer != nullptr &&
-                       "Compile: device->createBuffer returned null — "
-                       "out of GPU memory or invalid buffer descriptor");
-            device->bindBufferMemory(buffer.m_PhysicalBuffer, heap, offset);
-            buffer.m_Heap = heap;
-            buffer.m_Offset = offset;
-
-            // Aliased resources must always produce a fresh handle.
-            SDL_assert((!isAliased || buffer.m_PhysicalBuffer.Get() != oldRawPtr ||
-                        oldRawPtr == nullptr)
-                       && "Aliased buffer: nvrhi returned the same pointer as last frame "
-                          "(handle was not recreated)");
-        }
-    );
+    AllocateResourcesInternal(false, createAndBindTexture);
+    AllocateResourcesInternal(true, createAndBindBuffer);
+    m_HeapCompactionReserve = 0; // unused if everything fit into existing heaps
+
+    UpdateTransientMemoryStats();
+    UpdateHeapStats(bCompactedHeaps);
 
     // Build per-pass aliasing barrier info.
     // For each aliased resource, insert an aliasing barrier at the pass where it's first used.
@@ -1065,13 +2350,13 @@ void RenderGraph::Compile()
             bool hasRead = false;
             if (isBuffer)
             {
-                hasWrite = firstAccess.m_WriteBuffers.count(index) > 0;
-                hasRead = firstAccess.m_ReadBuffers.count(index) > 0;
+                hasWrite = PassAccess::Contains(firstAccess.m_WriteBuffers, index);
+                hasRead = PassAccess::Contains(firstAccess.m_ReadBuffers, index);
             }
             else
             {
-                hasWrite = firstAccess.m_WriteTextures.count(index) > 0;
-                hasRead = firstAccess.m_ReadTextures.count(index) > 0;
+                hasWrite = PassAccess::Contains(firstAccess.m_WriteTextures, index);
+                hasRead = PassAccess::Contains(firstAccess.m_ReadTextures, index);
             }
 
             if (!hasWrite || hasRead)
@@ -1118,9 +2403,100 @@ void RenderGraph::Compile()
         }
     }
 
+    PlanCommandLists();
+    PlanStateTransitions();
+    StoreCompiledGraph();
+    if (IsCapturingAllocations())
+        RecordAllocationFrame();
     m_IsCompiled = true;
 }
 
+bool RenderGraph::TryReuseCompiledGraph(const CreateAndBindFunc& createAndBindTexture, const CreateAndBindFunc& createAndBindBuffer)
+{
+    PROFILE_FUNCTION();
+
+    if (!m_CompiledGraph.m_bValid || m_CompiledGraph.m_StructureHash != m_StructureHash)
+        return false;
+
+    auto getResource = [this](bool bIsBuffer, uint32_t idx) -> TransientResourceBase*
+    {
+        return bIsBuffer ? (TransientResourceBase*)&m_Buffers[idx] : (TransientResourceBase*)&m_Textures[idx];
+    };
+
+    // The structure matching implies the same slots are declared with the same descs, but the physical side could
+    // still have moved underneath (eviction, heap release): only reuse if every recorded placement is still backed
+    for (const CompiledAllocation& allocation : m_CompiledGraph.m_Allocations)
+    {
+        const TransientResourceBase* resource = getResource(allocation.m_bIsBuffer, allocation.m_Index);
+        if (!resource->m_IsDeclaredThisFrame || !resource->m_IsAllocated || resource->m_HeapIndex >= m_HeapDevice.m_Heaps.size() ||
+            m_HeapDevice.m_Heaps[resource->m_HeapIndex] != resource->m_Heap)
+        {
+            return false;
+        }
+        if (allocation.m_AliasedFromIndex == UINT32_MAX && !(allocation.m_bIsBuffer ? m_Buffers[allocation.m_Index].m_PhysicalBuffer != nullptr
+                                                                                      : m_Textures[allocation.m_Index].m_PhysicalTexture != nullptr))
+        {
+            return false;
+        }
+    }
+
+    for (const CompiledAllocation& allocation : m_CompiledGraph.m_Allocations)
+    {
+        TransientResourceBase* resource = getResource(allocation.m_bIsBuffer, allocation.m_Index);
+        resource->m_AliasedFromIndex = allocation.m_AliasedFromIndex;
+        resource->m_PhysicalLastPass = allocation.m_PhysicalLastPass;
+
+        // Aliased resources still get a fresh virtual resource every frame, at the placement recorded last frame. That
+        // placement is relative to the owner, whose block may have changed hands since (history pairs swap every frame).
+        if (allocation.m_AliasedFromIndex != UINT32_MAX)
+        {
+            const TransientResourceBase* owner = getResource(allocation.m_bIsBuffer, allocation.m_AliasedFromIndex);
+            resource->m_HeapIndex = owner->m_HeapIndex;
+            resource->m_BlockOffset = owner->m_BlockOffset;
+            (allocation.m_bIsBuffer ? createAndBindBuffer : createAndBindTexture)(allocation.m_Index, owner->m_Heap, owner->m_Offset + allocation.m_OwnerOffset);
+        }
+        m_HeapAllocator.MarkUsed(resource->m_HeapIndex, g_Renderer.m_FrameNumber);
+    }
+
+    m_Stats = m_CompiledGraph.m_Stats;
+    m_Stats.m_bCompiledFromCache = true;
+    m_PerPassAliasBarriers = m_CompiledGraph.m_PerPassAliasBarriers;
+    ++m_CompileCacheHits;
+    return true;
+}
+
+void RenderGraph::StoreCompiledGraph()
+{
+    m_CompiledGraph.m_bValid = true;
+    m_CompiledGraph.m_StructureHash = m_StructureHash;
+    m_CompiledGraph.m_Stats = m_Stats;
+    m_CompiledGraph.m_PerPassAliasBarriers = m_PerPassAliasBarriers;
+
+    m_CompiledGraph.m_Allocations.clear();
+    auto record = [this](bool bIsBuffer, uint32_t idx, const TransientResourceBase& resource)
+    {
+        if (resource.m_IsDeclaredThisFrame && resource.m_Lifetime.IsValid() && resource.m_IsAllocated)
+        {
+            uint64_t ownerOffset = 0;
+            if (resource.m_AliasedFromIndex != UINT32_MAX)
+            {
+                const TransientResourceBase& owner = bIsBuffer ? (const TransientResourceBase&)m_Buffers[resource.m_AliasedFromIndex]
+                                                               : (const TransientResourceBase&)m_Textures[resource.m_AliasedFromIndex];
+                ownerOffset = resource.m_Offset - owner.m_Offset;
+            }
+            m_CompiledGraph.m_Allocations.push_back({ idx, resource.m_AliasedFromIndex, resource.m_PhysicalLastPass, bIsBuffer, ownerOffset });
+        }
+    };
+    for (uint32_t i = 0; i < (uint32_t)m_Textures.size(); ++i) record(false, i, m_Textures[i]);
+    for (uint32_t i = 0; i < (uint32_t)m_Buffers.size(); ++i)
+    {
+        if (!m_Buffers[i].m_bSuballocated)
+            record(true, i, m_Buffers[i]);
+    }
+
+    ++m_CompileCacheMisses;
+}
+
 void RenderGraph::PostRender()
 {
     m_IsCompiled = false;
@@ -1141,7 +2517,7 @@ void RenderGraph::PostRender()
 }
 
 // ============================================================================
-// RenderGraph - Aliasing Barriers
+// RenderGraph - Barriers
 // ============================================================================
 
 void RenderGraph::InsertAliasBarriers(uint16_t passIndex, nvrhi::ICommandList* commandList) const
@@ -1171,159 +2547,307 @@ void RenderGraph::InsertAliasBarriers(uint16_t passIndex, nvrhi::ICommandList* c
     }
 }
 
+void RenderGraph::InsertStateTransitions(uint16_t passIndex, nvrhi::ICommandList* commandList) const
+{
+    if (passIndex >= m_PerPassStateTransitions.size() || m_PerPassStateTransitions[passIndex].empty())
+        return;
+
+    for (const StateTransition& transition : m_PerPassStateTransitions[passIndex])
+    {
+        if (transition.m_bIsBuffer)
+        {
+            const TransientBuffer& buffer = m_Buffers[transition.m_ResourceIndex];
+            if (buffer.m_PhysicalBuffer)
+            {
+                commandList->setBufferState(buffer.m_PhysicalBuffer, transition.m_After);
+            }
+        }
+        else
+        {
+            const TransientTexture& texture = m_Textures[transition.m_ResourceIndex];
+            if (texture.m_PhysicalTexture)
+            {
+                commandList->setTextureState(texture.m_PhysicalTexture, transition.m_Subresources, transition.m_After);
+            }
+        }
+    }
+    commandList->commitBarriers();
+}
+
+const std::vector<StateTransition>& RenderGraph::GetPassStateTransitions(uint16_t passIndex) const
+{
+    static const std::vector<StateTransition> kNoTransitions;
+    if (passIndex >= m_PerPassStateTransitions.size())
+        return kNoTransitions;
+    return m_PerPassStateTransitions[passIndex];
+}
+
 // ============================================================================
 // RenderGraph - Memory Management
 // ============================================================================
 
-nvrhi::HeapHandle RenderGraph::CreateHeap(size_t size)
+void RenderGraph::NvrhiHeapDevice::CreateHeap(uint32_t heapIdx, uint64_t size)
 {
     PROFILE_FUNCTION();
 
-    nvrhi::IDevice* device = g_Renderer.m_RHI->m_NvrhiDevice.Get();
-    
     nvrhi::HeapDesc heapDesc;
     heapDesc.capacity = size;
     heapDesc.debugName = "RenderGraph Managed Heap";
     heapDesc.type = nvrhi::HeapType::DeviceLocal;
-    
-    nvrhi::HeapHandle heap = device->createHeap(heapDesc);
-
-    // Try to reuse an empty slot
-    for (uint32_t i = 0; i < m_Heaps.size(); ++i)
-    {
-        if (!m_Heaps[i].m_Heap)
-        {
-            m_Heaps[i].m_Heap = heap;
-            m_Heaps[i].m_Size = size;
-            m_Heaps[i].m_LastFrameUsed = g_Renderer.m_FrameNumber;
-            m_Heaps[i].m_HeapIdx = i;
-            
-            HeapBlock block;
-            block.m_Offset = 0;
-            block.m_Size = size;
-            block.m_IsFree = true;
-            m_Heaps[i].m_Blocks.push_back(block);
-            
-            //SDL_Log("[RenderGraph] Reused heap slot %u for new heap of size %.2f MB", i, size / (1024.0 * 1024.0));
-            return heap;
-        }
-    }
-
-    HeapEntry entry;
-    entry.m_Heap = heap;
-    entry.m_Size = size;
-    entry.m_LastFrameUsed = g_Renderer.m_FrameNumber;
-    entry.m_HeapIdx = static_cast<uint32_t>(m_Heaps.size());
-    
-    HeapBlock block;
-    block.m_Offset = 0;
-    block.m_Size = size;
-    block.m_IsFree = true;
-    entry.m_Blocks.push_back(block);
-    
-    m_Heaps.push_back(entry);
-    
-    //SDL_Log("[RenderGraph] Allocated new heap of size %.2f MB", size / (1024.0 * 1024.0));
-    
-    return heap;
+
+    if (heapIdx >= m_Heaps.size())
+        m_Heaps.resize(heapIdx + 1);
+    m_Heaps[heapIdx] = g_Renderer.m_RHI->m_NvrhiDevice->createHeap(heapDesc);
 }
 
-void RenderGraph::SubAllocateResource(RenderGraphInternal::TransientResourceBase* resource, uint64_t alignment)
+void RenderGraph::NvrhiHeapDevice::ReleaseHeap(uint32_t heapIdx)
 {
-    const nvrhi::MemoryRequirements memReq = resource->GetMemoryRequirements();
-    size_t size = memReq.size;
+    // Placed resources hold their own reference, so a heap that still backs a deferred-release handle stays alive
+    m_Heaps[heapIdx] = nullptr;
+}
 
-    // 1. Try to find a free block in existing heaps
-    for (HeapEntry& heapEntry : m_Heaps)
+void RenderGraph::UpdateHeapStats(bool bCompacted)
+{
+    const HeapAllocator::Usage usage = m_HeapAllocator.GetUsage();
+    m_Stats.m_NumHeaps = usage.m_NumHeaps;
+    m_Stats.m_TotalHeapMemory = usage.m_TotalSize;
+    m_Stats.m_FreeHeapMemory = usage.m_FreeSize;
+    m_Stats.m_HeapFragmentationPercent = usage.GetFragmentationPercent();
+    m_Stats.m_bHeapsCompacted = bCompacted;
+
+    if (bCompacted)
     {
-        if (!heapEntry.m_Heap) continue;
+        m_HeapUsageAfterCompaction = { m_Stats.m_TotalHeapMemory, m_Stats.m_FreeHeapMemory };
+    }
+}
 
-        for (size_t i = 0; i < heapEntry.m_Blocks.size(); ++i)
-        {
-            HeapBlock& block = heapEntry.m_Blocks[i];
-            if (block.m_IsFree)
-            {
-                uint64_t alignedOffset = (block.m_Offset + alignment - 1) & ~(alignment - 1);
-                uint64_t blockEnd = block.m_Offset + block.m_Size;
+bool RenderGraph::CompactHeapsIfNeeded()
+{
+    PROFILE_FUNCTION();
 
-                if (alignedOffset + size <= blockEnd)
-                {
-                    uint64_t blockOriginalOffset = block.m_Offset;
-                    uint64_t blockOriginalSize = block.m_Size;
+    // Less free memory than this isn't worth recreating every transient resource for
+    const size_t kMinCompactableFreeMemory = 16 * 1024 * 1024;
+    // Re-packing recreates every transient resource: don't do it more often than this, even if still over budget
+    const uint64_t kMinFramesBetweenCompactions = 60;
 
-                    // Prefix block if needed
-                    if (alignedOffset > blockOriginalOffset)
-                    {
-                        HeapBlock prefix;
-                        prefix.m_Offset = blockOriginalOffset;
-                        prefix.m_Size = alignedOffset - blockOriginalOffset;
-                        prefix.m_IsFree = true;
-                        heapEntry.m_Blocks.insert(heapEntry.m_Blocks.begin() + i, prefix);
-                        i++; // Current block is now at i+1
-                    }
+    const size_t budget = size_t(Config::Get().m_RenderGraphHeapBudgetMB) * 1024 * 1024;
 
-                    heapEntry.m_Blocks[i].m_Offset = alignedOffset;
-                    heapEntry.m_Blocks[i].m_Size = size;
-                    heapEntry.m_Blocks[i].m_IsFree = false;
+    HeapAllocator::Usage usage = m_HeapAllocator.GetUsage();
 
-                    resource->m_Heap = heapEntry.m_Heap;
-                    resource->m_HeapIndex = heapEntry.m_HeapIdx;
-                    resource->m_Offset = alignedOffset;
-                    resource->m_BlockOffset = alignedOffset;
+    // Trimming first: empty heaps hold no placements, so releasing them early costs nothing
+    if (budget != 0 && usage.m_TotalSize > budget)
+    {
+        m_HeapAllocator.ReleaseEmptyHeaps();
+        usage = m_HeapAllocator.GetUsage();
+    }
 
-                    // Suffix block if needed
-                    uint64_t suffixStart = alignedOffset + size;
-                    if (suffixStart < blockEnd)
-                    {
-                        HeapBlock suffix;
-                        suffix.m_Offset = suffixStart;
-                        suffix.m_Size = blockEnd - suffixStart;
-                        suffix.m_IsFree = true;
-                        heapEntry.m_Blocks.insert(heapEntry.m_Blocks.begin() + i + 1, suffix);
-                    }
+    const size_t totalSize = usage.m_TotalSize;
+    const size_t freeSize = usage.m_FreeSize;
+    const bool bOverBudget = budget != 0 && totalSize > budget;
+    const float fragmentation = usage.GetFragmentationPercent();
+    const bool bFragmented = fragmentation > float(Config::Get().m_RenderGraphHeapFragmentationThreshold);
+
+    if ((!bOverBudget && !bFragmented) || freeSize < kMinCompactableFreeMemory)
+        return false;
+    if (m_LastHeapCompactionFrame != UINT64_MAX && g_Renderer.m_FrameNumber - m_LastHeapCompactionFrame < kMinFramesBetweenCompactions)
+        return false;
+    // Nothing moved since the last compaction left the heaps like this (e.g. persistent resources pin the holes)
+    if (m_HeapUsageAfterCompaction.first == totalSize && m_HeapUsageAfterCompaction.second == freeSize)
+        return false;
+
+    // Give up every non-persistent placement. Old handles go through deferred release like any other relocation.
+    size_t repackSize = 0;
+    uint64_t maxAlignment = 1;
+    auto releasePlacement = [&](TransientResourceBase& resource)
+    {
+        if (resource.m_IsPhysicalOwner && resource.m_HeapIndex != UINT32_MAX)
+        {
+            m_HeapAllocator.Free(resource.m_HeapIndex, resource.m_BlockOffset);
 
-                    heapEntry.m_LastFrameUsed = g_Renderer.m_FrameNumber;
-                    return;
-                }
+            // Owners declared this frame come straight back; the rest are idle and only return if declared again
+            if (resource.m_IsDeclaredThisFrame)
+            {
+                const uint64_t alignment = std::max<uint64_t>(resource.m_MemReq.m_Alignment, 1);
+                repackSize += (resource.m_MemReq.m_Size + alignment - 1) / alignment * alignment;
+                maxAlignment = std::max(maxAlignment, alignment);
             }
         }
+        resource.m_Heap = nullptr;
+        resource.m_HeapIndex = UINT32_MAX;
+        resource.m_IsAllocated = false;
+        resource.m_IsPhysicalOwner = false;
+    };
+
+    for (TransientTexture& texture : m_Textures)
+    {
+        if (texture.m_IsPersistent || !texture.m_IsAllocated)
+            continue;
+        releasePlacement(texture);
+        if (texture.m_PhysicalTexture)
+            m_DeferredReleaseTextures.push_back(std::move(texture.m_PhysicalTexture));
+        texture.m_PhysicalTexture = nullptr;
+    }
+    for (TransientBuffer& buffer : m_Buffers)
+    {
+        if (buffer.m_IsPersistent || !buffer.m_IsAllocated || buffer.m_bSuballocated)
+            continue;
+        releasePlacement(buffer);
+        if (buffer.m_PhysicalBuffer)
+            m_DeferredReleaseBuffers.push_back(std::move(buffer.m_PhysicalBuffer));
+        buffer.m_PhysicalBuffer = nullptr;
     }
 
-    // 2. No fit found, create a new heap (at least 1 MB)
-    size_t heapSize = NextPow2(std::max(size_t(1024 * 1024), memReq.size));
-    CreateHeap(heapSize);
+    m_HeapAllocator.ReleaseEmptyHeaps();
+
+    // Heap capacity must stay a multiple of the 64 KB placement alignment
+    const size_t kHeapGranularity = 64 * 1024;
+    m_HeapCompactionReserve = repackSize > 0 ? (repackSize + maxAlignment + kHeapGranularity - 1) / kHeapGranularity * kHeapGranularity : 0;
+
+    m_CompiledGraph = {};
+    m_LastHeapCompactionFrame = g_Renderer.m_FrameNumber;
+    ++m_HeapCompactionCount;
 
-    // Retry allocation now that we have a new heap
-    SubAllocateResource(resource, alignment);
+    if (m_bVerboseLogging)
+        SDL_Log("[RenderGraph] HEAP-COMPACT: %u heap(s), %.2f MB (%.2f MB free, %.1f%% fragmented%s) - re-packing %.2f MB",
+                usage.m_NumHeaps, totalSize / (1024.0 * 1024.0), freeSize / (1024.0 * 1024.0), fragmentation,
+                bOverBudget ? ", over budget" : "", repackSize / (1024.0 * 1024.0));
+    return true;
 }
 
-void RenderGraph::FreeBlock(uint32_t heapIdx, uint64_t blockOffset)
+// ============================================================================
+// RenderGraph - Buffer Suballocation
+// ============================================================================
+
+void RenderGraph::SuballocateSmallBuffers()
 {
-    if (heapIdx >= m_Heaps.size()) return;
+    PROFILE_FUNCTION();
+
+    // Past the 64 KB placement alignment a buffer wastes no more in a heap than it would in a pool
+    const uint64_t kMaxSuballocatedBufferSize = 64 * 1024;
+    const uint64_t kSuballocationAlignment = 256;
+    const uint64_t kMinPoolBufferSize = 64 * 1024;
+
+    m_Stats.m_NumSuballocatedBuffers = 0;
+    m_Stats.m_NumBufferPools = 0;
+    m_Stats.m_BufferPoolMemory = 0;
 
-    HeapEntry& heapEntry = m_Heaps[heapIdx];
-    for (size_t i = 0; i < heapEntry.m_Blocks.size(); ++i)
+    // Pack this frame's buffers: pool per buffer, and each pool's size and first member (for the pool buffer desc)
+    std::vector<uint32_t> bufferPool(m_Buffers.size(), UINT32_MAX);
+    std::vector<uint64_t> poolSizes(m_BufferPools.size(), 0);
+    std::vector<uint32_t> poolFirstBuffer(m_BufferPools.size(), UINT32_MAX);
+    for (uint32_t i = 0; i < (uint32_t)m_Buffers.size(); ++i)
     {
-        if (heapEntry.m_Blocks[i].m_Offset == blockOffset)
-        {
-            heapEntry.m_Blocks[i].m_IsFree = true;
+        TransientBuffer& buffer = m_Buffers[i];
+        if (!buffer.m_IsDeclaredThisFrame)
+            continue;
 
-            // Coalesce with next block if free
-            if (i + 1 < heapEntry.m_Blocks.size() && heapEntry.m_Blocks[i + 1].m_IsFree)
+        const nvrhi::BufferDesc& desc = buffer.m_Desc.m_NvrhiDesc;
+        const bool bEligible = buffer.m_Desc.m_bSuballocate && !buffer.m_IsPersistent && buffer.m_Lifetime.IsValid() &&
+                               !buffer.m_bUsedOnAsyncCompute && desc.byteSize <= kMaxSuballocatedBufferSize;
+        if (!bEligible)
+        {
+            // Placed again by AllocateResourcesInternal(); its pool keeps the old handle's buffer alive
+            if (buffer.m_bSuballocated)
             {
-                heapEntry.m_Blocks[i].m_Size += heapEntry.m_Blocks[i + 1].m_Size;
-                heapEntry.m_Blocks.erase(heapEntry.m_Blocks.begin() + i + 1);
+                buffer.m_PhysicalBuffer = nullptr;
+                buffer.m_bSuballocated = false;
+                buffer.m_IsAllocated = false;
             }
+            continue;
+        }
 
-            // Coalesce with previous block if free
-            if (i > 0 && heapEntry.m_Blocks[i - 1].m_IsFree)
-            {
-                heapEntry.m_Blocks[i - 1].m_Size += heapEntry.m_Blocks[i].m_Size;
-                heapEntry.m_Blocks.erase(heapEntry.m_Blocks.begin() + i);
-            }
+        size_t key = 0;
+        hash_combine(key, desc.structStride);
+        hash_combine(key, (uint32_t)desc.format);
+        hash_combine(key, desc.canHaveUAVs);
+        hash_combine(key, desc.canHaveTypedViews);
+        hash_combine(key, desc.canHaveRawViews);
+        hash_combine(key, desc.isVertexBuffer);
+        hash_combine(key, desc.isIndexBuffer);
+        hash_combine(key, desc.isConstantBuffer);
+        hash_combine(key, desc.isDrawIndirectArgs);
+        hash_combine(key, (uint32_t)desc.initialState);
+
+        uint32_t poolIdx = 0;
+        while (poolIdx < m_BufferPools.size() && m_BufferPools[poolIdx].m_Key != key)
+            ++poolIdx;
+        if (poolIdx == m_BufferPools.size())
+        {
+            m_BufferPools.push_back({ key, nullptr, 0 });
+            poolSizes.push_back(0);
+            poolFirstBuffer.push_back(UINT32_MAX);
+        }
 
-            return;
+        // Structured views address whole elements, so offsets stay multiples of the stride too
+        uint64_t offset = (poolSizes[poolIdx] + kSuballocationAlignment - 1) & ~(kSuballocationAlignment - 1);
+        if (desc.structStride > 0)
+            offset = (offset + desc.structStride - 1) / desc.structStride * desc.structStride;
+
+        buffer.m_SuballocationOffset = offset;
+        poolSizes[poolIdx] = offset + desc.byteSize;
+        bufferPool[i] = poolIdx;
+        if (poolFirstBuffer[poolIdx] == UINT32_MAX)
+            poolFirstBuffer[poolIdx] = i;
+    }
+
+    // Grow pools that no longer fit. The old buffer may still be in flight, so it goes through deferred release.
+    nvrhi::IDevice* device = g_Renderer.m_RHI->m_NvrhiDevice.Get();
+    for (uint32_t poolIdx = 0; poolIdx < (uint32_t)m_BufferPools.size(); ++poolIdx)
+    {
+        BufferPool& pool = m_BufferPools[poolIdx];
+        if (poolSizes[poolIdx] == 0)
+            continue;
+
+        if (!pool.m_Buffer || pool.m_Buffer->getDesc().byteSize < poolSizes[poolIdx])
+        {
+            PROFILE_SCOPED("CreateBufferPool");
+
+            nvrhi::BufferDesc poolDesc = m_Buffers[poolFirstBuffer[poolIdx]].m_Desc.m_NvrhiDesc;
+            poolDesc.byteSize = NextPow2((uint32_t)std::max(kMinPoolBufferSize, poolSizes[poolIdx]));
+            poolDesc.debugName = "RenderGraph Buffer Pool";
+            poolDesc.isVirtual = false;
+            // Command lists recorded in parallel each touch their own ranges: every one starts and ends in this state
+            poolDesc.keepInitialState = true;
+            if (poolDesc.initialState == nvrhi::ResourceStates::Unknown)
+                poolDesc.initialState = nvrhi::ResourceStates::Common;
+
+            if (pool.m_Buffer)
+                m_DeferredReleaseBuffers.push_back(std::move(pool.m_Buffer));
+            pool.m_Buffer = device->createBuffer(poolDesc);
+            SDL_assert(pool.m_Buffer != nullptr && "Failed to create render graph buffer pool");
+        }
+        pool.m_LastFrameUsed = g_Renderer.m_FrameNumber;
+
+        m_Stats.m_NumBufferPools++;
+        m_Stats.m_BufferPoolMemory += pool.m_Buffer->getDesc().byteSize;
+    }
+
+    for (uint32_t i = 0; i < (uint32_t)m_Buffers.size(); ++i)
+    {
+        if (bufferPool[i] == UINT32_MAX)
+            continue;
+
+        TransientBuffer& buffer = m_Buffers[i];
+
+        // Was a placed resource until now
+        if (!buffer.m_bSuballocated)
+        {
+            if (buffer.m_IsPhysicalOwner && buffer.m_HeapIndex != UINT32_MAX)
+                m_HeapAllocator.Free(buffer.m_HeapIndex, buffer.m_BlockOffset);
+            if (buffer.m_PhysicalBuffer)
+                m_DeferredReleaseBuffers.push_back(std::move(buffer.m_PhysicalBuffer));
         }
+
+        buffer.m_PhysicalBuffer = m_BufferPools[bufferPool[i]].m_Buffer;
+        buffer.m_bSuballocated = true;
+        buffer.m_IsAllocated = true;
+        buffer.m_IsPhysicalOwner = false;
+        buffer.m_AliasedFromIndex = UINT32_MAX;
+        buffer.m_Heap = nullptr;
+        buffer.m_HeapIndex = UINT32_MAX;
+        buffer.m_PhysicalLastPass = buffer.m_Lifetime.m_LastPass;
+
+        m_Stats.m_NumSuballocatedBuffers++;
     }
 }
 
@@ -1331,240 +2855,234 @@ void RenderGraph::FreeBlock(uint32_t heapIdx, uint64_t blockOffset)
 // RenderGraph - Resource Aliasing & Allocation
 // ============================================================================
 
-// Helper for generic resource allocation - abstracts over textures and buffers
-void RenderGraph::AllocateResourcesInternal(bool bIsBuffer, std::function<void(uint32_t, nvrhi::HeapHandle, uint64_t)> createAndBindResource)
+void RenderGraph::UpdateTransientMemoryStats()
 {
-    nvrhi::IDevice* device = g_Renderer.m_RHI->m_NvrhiDevice.Get();
+    std::vector<int64_t> liveBytesDelta(m_CurrentPassIndex + 2, 0);
+
+    auto accumulate = [&](const TransientResourceBase& resource)
+    {
+        if (!resource.m_IsDeclaredThisFrame || !resource.m_Lifetime.IsValid() || resource.m_IsPersistent)
+            return;
 
-    std::vector<uint32_t> sortedIndices;
+        const size_t size = resource.m_MemReq.m_Size;
+        m_Stats.m_TransientMemoryUnaliased += size;
+        if (resource.m_IsPhysicalOwner)
+            m_Stats.m_TransientMemoryAliased += size;
+
+        liveBytesDelta[resource.m_Lifetime.m_FirstPass] += (int64_t)size;
+        liveBytesDelta[resource.m_Lifetime.m_LastPass + 1] -= (int64_t)size;
+    };
+
+    for (const TransientTexture& texture : m_Textures) accumulate(texture);
+    for (const TransientBuffer& buffer : m_Buffers)
+    {
+        if (!buffer.m_bSuballocated)
+            accumulate(buffer);
+    }
+
+    int64_t liveBytes = 0;
+    for (int64_t delta : liveBytesDelta)
+    {
+        liveBytes += delta;
+        m_Stats.m_TransientMemoryPeakLive = std::max(m_Stats.m_TransientMemoryPeakLive, (size_t)liveBytes);
+    }
+}
+
+// Helper for generic resource allocation - abstracts over textures and buffers. PlanAllocations() decides where every
+// resource goes; this creates and binds the nvrhi resources for its decisions.
+void RenderGraph::AllocateResourcesInternal(bool bIsBuffer, std::function<void(uint32_t, nvrhi::HeapHandle, uint64_t)> createAndBindResource)
+{
+    std::vector<uint32_t> indices;
     for (uint32_t i = 0; i < (bIsBuffer ? m_Buffers.size() : m_Textures.size()); ++i)
     {
         if ((bIsBuffer ? m_Buffers[i].m_IsDeclaredThisFrame : m_Textures[i].m_IsDeclaredThisFrame) &&
-            (bIsBuffer ? m_Buffers[i].m_Lifetime.IsValid() : m_Textures[i].m_Lifetime.IsValid()))
+            (bIsBuffer ? m_Buffers[i].m_Lifetime.IsValid() : m_Textures[i].m_Lifetime.IsValid()) &&
+            !(bIsBuffer && m_Buffers[i].m_bSuballocated))
         {
-            sortedIndices.push_back(i);
+            indices.push_back(i);
         }
     }
 
-    std::sort(sortedIndices.begin(), sortedIndices.end(), [this, bIsBuffer](uint32_t a, uint32_t b) {
-        return (bIsBuffer ? m_Buffers[a].m_Lifetime.m_FirstPass : m_Textures[a].m_Lifetime.m_FirstPass) <
-            (bIsBuffer ? m_Buffers[b].m_Lifetime.m_FirstPass : m_Textures[b].m_Lifetime.m_FirstPass);
-        });
-    
-    // Attempt aliasing and allocate
-    for (uint32_t idx : sortedIndices)
+    auto getResource = [this, bIsBuffer](uint32_t idx) -> TransientResourceBase*
     {
-        TransientResourceBase* resource = bIsBuffer ? (TransientResourceBase*)&m_Buffers[idx] : (TransientResourceBase*)&m_Textures[idx];
-        const nvrhi::MemoryRequirements memReq = resource->GetMemoryRequirements();
-        
-        // Trivial reuse: if already allocated and was an owner, skip logic.
-        // Non-owners (aliased resources) must go through the aliasing/allocation
-        // path each frame because their nvrhi handle is recreated against the
-        // owner's heap region.
-        if (resource->m_IsAllocated && resource->m_IsPhysicalOwner && resource->m_HeapIndex != UINT32_MAX)
-        {
-            HeapEntry& heapEntry = m_Heaps[resource->m_HeapIndex];
+        return bIsBuffer ? (TransientResourceBase*)&m_Buffers[idx] : (TransientResourceBase*)&m_Textures[idx];
+    };
+    auto getDebugName = [this, bIsBuffer](uint32_t idx)
+    {
+        return bIsBuffer ? m_Buffers[idx].m_Desc.m_NvrhiDesc.debugName.c_str() : m_Textures[idx].m_Desc.m_NvrhiDesc.debugName.c_str();
+    };
 
+    // Query once per resource: GetMemoryRequirements() creates a throwaway virtual resource
+    for (uint32_t idx : indices)
+    {
+        const nvrhi::MemoryRequirements memReq = getResource(idx)->GetMemoryRequirements();
+        getResource(idx)->m_MemReq = { memReq.size, memReq.alignment };
+    }
+
+    // Called before the resource's heap index and offset are updated, so they still say where it was last frame
+    auto onPlaced = [&](const PlacementDecision& decision)
+    {
+        const uint32_t idx = decision.m_Index;
+        TransientResourceBase* resource = getResource(idx);
+        const nvrhi::HeapHandle heap = m_HeapDevice.m_Heaps[decision.m_HeapIndex];
+
+        if (decision.m_bKept)
+        {
             // Heap handle must match what the resource recorded at allocation time.
-            // A mismatch means the heap vector was reallocated or the index is stale.
-            if (heapEntry.m_Heap != resource->m_Heap)
+            // A mismatch means the heap was released or replaced under a resource still placed in it.
+            if (heap != resource->m_Heap)
             {
                 if (m_bVerboseLogging)
                     SDL_Log("[RenderGraph] HEAP-MISMATCH %s slot %u ('%s'): "
-                            "heapEntry.m_Heap=%p resource->m_Heap=%p heapIdx=%u "
-                            "(heap vector may have been reallocated)",
+                            "heap=%p resource->m_Heap=%p heapIdx=%u",
                             bIsBuffer ? "buffer" : "texture",
                             idx,
-                            bIsBuffer ? m_Buffers[idx].m_Desc.m_NvrhiDesc.debugName.c_str()
-                                      : m_Textures[idx].m_Desc.m_NvrhiDesc.debugName.c_str(),
-                            (void*)heapEntry.m_Heap.Get(),
+                            getDebugName(idx),
+                            (void*)heap.Get(),
                             (void*)resource->m_Heap.Get(),
                             resource->m_HeapIndex);
                 SDL_assert(false && "Heap handle mismatch in trivial-reuse path - "
-                           "resource->m_HeapIndex is stale or heap vector was reallocated");
+                           "resource->m_HeapIndex is stale or its heap was released");
             }
-
-            heapEntry.m_LastFrameUsed = g_Renderer.m_FrameNumber;
-            resource->m_PhysicalLastPass = resource->m_Lifetime.m_LastPass;
-
-            if (bIsBuffer) m_Stats.m_NumAllocatedBuffers++;
-            else m_Stats.m_NumAllocatedTextures++;
-
-            const size_t bufferMemory = bIsBuffer ? memReq.size : 0;
-            const size_t textureMemory = !bIsBuffer ? memReq.size : 0;
-
-            m_Stats.m_TotalBufferMemory += bufferMemory;
-            m_Stats.m_TotalTextureMemory += textureMemory;
-            continue;
+            return;
         }
 
-        bool aliased = false;
-        if (m_AliasingEnabled && !resource->m_IsPersistent)
+        SDL_assert(heap != nullptr && "PlanAllocations placed a resource in a released heap");
+
+        // Log placement decisions so they are visible in test output and
+        // can be correlated with pool-reuse logs when debugging pointer
+        // stability failures.
+        if (m_bVerboseLogging)
         {
-            for (uint32_t candidateIdx : sortedIndices)
+            const bool sameLocation = resource->m_HeapIndex == decision.m_HeapIndex && resource->m_Offset == decision.m_Offset;
+            if (!resource->m_IsPhysicalOwner)
             {
-                if (candidateIdx == idx) break;
-                TransientResourceBase* candidate = bIsBuffer ? (TransientResourceBase*)&m_Buffers[candidateIdx] : (TransientResourceBase*)&m_Textures[candidateIdx];
-                if (!candidate->m_IsAllocated || !candidate->m_IsPhysicalOwner || candidate->m_IsPersistent)
-                    continue;
-
-                bool bCanAlias = resource->m_Lifetime.m_FirstPass > candidate->m_PhysicalLastPass;
-                if (bCanAlias)
-                {
-                    const nvrhi::MemoryRequirements candidateMemReq = candidate->GetMemoryRequirements();
-                    bCanAlias = memReq.size <= candidateMemReq.size;
-
-                    if (bCanAlias && memReq.alignment > 0)
-                    {
-                        bCanAlias = (candidate->m_Offset % memReq.alignment) == 0;
-                    }
-                }
-                
-                if (bCanAlias)
-                {
-                    // Store candidate's heap info in locals BEFORE overwriting resource fields,
-                    // so the createAndBindResource callback can correctly detect if the physical
-                    // resource needs to be recreated (by comparing old m_Heap/m_Offset with new).
-                    nvrhi::HeapHandle aliasHeap = candidate->m_Heap;
-                    uint64_t aliasOffset = candidate->m_Offset;
-                    uint32_t aliasHeapIndex = candidate->m_HeapIndex;
-                    uint64_t aliasBlockOffset = candidate->m_BlockOffset;
-
-                resource->m_AliasedFromIndex = candidateIdx;
-                resource->m_IsAllocated = true;
-                resource->m_IsPhysicalOwner = false;
-                
-                candidate->m_PhysicalLastPass = std::max(candidate->m_PhysicalLastPass, resource->m_Lifetime.m_LastPass);
-
-                // Log aliasing decisions so they are visible in test output and
-                // can be correlated with pool-reuse logs when debugging pointer
-                // stability failures.
-                if (m_bVerboseLogging)
-                    SDL_Log("[RenderGraph] ALIAS %s: slot %u ('%s') aliases slot %u ('%s') "
-                            "at heap=%u offset=%llu (passes %u-%u over %u-%u)",
-                            bIsBuffer ? "buffer" : "texture",
-                            idx,
-                            bIsBuffer ? m_Buffers[idx].m_Desc.m_NvrhiDesc.debugName.c_str()
-                                      : m_Textures[idx].m_Desc.m_NvrhiDesc.debugName.c_str(),
-                            candidateIdx,
-                            bIsBuffer ? m_Buffers[candidateIdx].m_Desc.m_NvrhiDesc.debugName.c_str()
-                                      : m_Textures[candidateIdx].m_Desc.m_NvrhiDesc.debugName.c_str(),
-                            aliasHeapIndex,
-                            (unsigned long long)aliasOffset,
-                            resource->m_Lifetime.m_FirstPass,
-                            resource->m_Lifetime.m_LastPass,
-                            bIsBuffer ? m_Buffers[candidateIdx].m_Lifetime.m_FirstPass
-                                      : m_Textures[candidateIdx].m_Lifetime.m_FirstPass,
-                            bIsBuffer ? m_Buffers[candidateIdx].m_Lifetime.m_LastPass
-                                      : m_Textures[candidateIdx].m_Lifetime.m_LastPass);
-
-                createAndBindResource(idx, aliasHeap, aliasOffset);
-
-                // Update resource's heap/offset AFTER the callback so the callback
-                // could compare old values against new to decide if rebinding is needed.
-                resource->m_Heap = aliasHeap;
-                resource->m_Offset = aliasOffset;
-                resource->m_HeapIndex = aliasHeapIndex;
-                resource->m_BlockOffset = aliasBlockOffset;
-
-                // Sanity: aliased resource must have a valid physical handle after binding.
-                SDL_assert((bIsBuffer ? (m_Buffers[idx].m_PhysicalBuffer != nullptr)
-                                      : (m_Textures[idx].m_PhysicalTexture != nullptr))
-                           && "Aliased resource has null physical handle after createAndBindResource");
-
-                if (bIsBuffer) m_Stats.m_NumAliasedBuffers++;
-                else m_Stats.m_NumAliasedTextures++;
-                    
-                    aliased = true;
-                    break;
-                }
+                const TransientResourceBase* owner = getResource(resource->m_AliasedFromIndex);
+                SDL_Log("[RenderGraph] ALIAS %s: slot %u ('%s') aliases slot %u ('%s') "
+                        "at heap=%u offset=%llu (passes %u-%u over %u-%u)",
+                        bIsBuffer ? "buffer" : "texture",
+                        idx,
+                        getDebugName(idx),
+                        resource->m_AliasedFromIndex,
+                        getDebugName(resource->m_AliasedFromIndex),
+                        decision.m_HeapIndex,
+                        (unsigned long long)decision.m_Offset,
+                        resource->m_Lifetime.m_FirstPass,
+                        resource->m_Lifetime.m_LastPass,
+                        owner->m_Lifetime.m_FirstPass,
+                        owner->m_Lifetime.m_LastPass);
             }
-        }
-        
-        if (!aliased)
-        {
-            // Save old heap/offset so the callback can detect changes after SubAllocateResource
-            // overwrites them. This ensures the callback correctly recreates the physical resource
-            // when the allocation location changes.
-            nvrhi::HeapHandle oldHeap = resource->m_Heap;
-            uint64_t oldOffset = resource->m_Offset;
-            const bool wasPreviouslyAllocated = resource->m_IsAllocated;
-
-            SubAllocateResource(resource, memReq.alignment);
-
-            // SubAllocateResource must always produce a valid heap assignment.
-            SDL_assert(resource->m_HeapIndex != UINT32_MAX
-                       && "SubAllocateResource failed to assign a heap slot");
-            SDL_assert(resource->m_Heap != nullptr
-                       && "SubAllocateResource produced a null heap handle");
-
-            resource->m_IsAllocated = true;
-            resource->m_IsPhysicalOwner = true;
-            resource->m_AliasedFromIndex = UINT32_MAX;
-            resource->m_PhysicalLastPass = resource->m_Lifetime.m_LastPass;
-
-            // Pass new heap/offset from SubAllocateResource. The callback compares against
-            // the resource's stored values, but SubAllocateResource already overwrote them.
-            // We need to temporarily restore old values so the callback can detect changes.
-            nvrhi::HeapHandle newHeap = resource->m_Heap;
-            uint64_t newOffset = resource->m_Offset;
-            resource->m_Heap = oldHeap;
-            resource->m_Offset = oldOffset;
-
-            const bool sameLocation = (oldHeap == newHeap && oldOffset == newOffset);
-            if (m_bVerboseLogging)
+            else if (decision.m_bWasAllocated && sameLocation)
             {
-                if (wasPreviouslyAllocated && sameLocation)
-                {
-                    // Trivial re-bind: same heap block reused after a desc change that freed
-                    // and immediately re-allocated the same region.  The callback's early-return
-                    // guard will fire and the nvrhi handle will be preserved.
-                    SDL_Log("[RenderGraph] TRIVIAL-REBIND %s slot %u ('%s'): "
-                            "same heap=%u offset=%llu after desc change",
-                            bIsBuffer ? "buffer" : "texture",
-                            idx,
-                            bIsBuffer ? m_Buffers[idx].m_Desc.m_NvrhiDesc.debugName.c_str()
-                                      : m_Textures[idx].m_Desc.m_NvrhiDesc.debugName.c_str(),
-                            resource->m_HeapIndex,
-                            (unsigned long long)newOffset);
-                }
-                else if (wasPreviouslyAllocated && !sameLocation)
-                {
-                    // Location changed: the callback will recreate the nvrhi object.
-                    SDL_Log("[RenderGraph] RELOC %s slot %u ('%s'): "
-                            "heap %u->%u offset %llu->%llu (desc change or heap pressure)",
-                            bIsBuffer ? "buffer" : "texture",
-                            idx,
-                            bIsBuffer ? m_Buffers[idx].m_Desc.m_NvrhiDesc.debugName.c_str()
-                                      : m_Textures[idx].m_Desc.m_NvrhiDesc.debugName.c_str(),
-                            (oldHeap ? UINT32_MAX : UINT32_MAX), // heap identity logged via index below
-                            resource->m_HeapIndex,
-                            (unsigned long long)oldOffset,
-                            (unsigned long long)newOffset);
-                }
+                // Trivial re-bind: same heap block reused after a desc change that freed
+                // and immediately re-allocated the same region.  The callback's early-return
+                // guard will fire and the nvrhi handle will be preserved.
+                SDL_Log("[RenderGraph] TRIVIAL-REBIND %s slot %u ('%s'): "
+                        "same heap=%u offset=%llu after desc change",
+                        bIsBuffer ? "buffer" : "texture",
+                        idx,
+                        getDebugName(idx),
+                        decision.m_HeapIndex,
+                        (unsigned long long)decision.m_Offset);
+            }
+            else if (decision.m_bWasAllocated)
+            {
+                // Location changed: the callback will recreate the nvrhi object.
+                SDL_Log("[RenderGraph] RELOC %s slot %u ('%s'): "
+                        "heap %u->%u offset %llu->%llu (desc change or heap pressure)",
+                        bIsBuffer ? "buffer" : "texture",
+                        idx,
+                        getDebugName(idx),
+                        resource->m_HeapIndex,
+                        decision.m_HeapIndex,
+                        (unsigned long long)resource->m_Offset,
+                        (unsigned long long)decision.m_Offset);
             }
+        }
 
-            createAndBindResource(idx, newHeap, newOffset);
-            resource->m_Heap = newHeap;
-            resource->m_Offset = newOffset;
+        createAndBindResource(idx, heap, decision.m_Offset);
 
-            // After createAndBindResource the physical handle must be non-null.
-            SDL_assert((bIsBuffer ? (m_Buffers[idx].m_PhysicalBuffer  != nullptr)
-                                  : (m_Textures[idx].m_PhysicalTexture != nullptr))
-                       && "Physical handle is null after createAndBindResource (non-aliased path)");
+        // After createAndBindResource the physical handle must be non-null.
+        SDL_assert((bIsBuffer ? (m_Buffers[idx].m_PhysicalBuffer != nullptr)
+                              : (m_Textures[idx].m_PhysicalTexture != nullptr))
+                   && "Physical handle is null after createAndBindResource");
+    };
 
-            if (bIsBuffer)
-                m_Stats.m_NumAllocatedBuffers++;
-            else
-                m_Stats.m_NumAllocatedTextures++;
+    const PlanStats stats = PlanAllocations(m_HeapAllocator, std::move(indices), (uint32_t)(bIsBuffer ? m_Buffers.size() : m_Textures.size()),
+                                            [&getResource](uint32_t idx) -> ResourcePlacement& { return *getResource(idx); },
+                                            m_AliasingEnabled, g_Renderer.m_FrameNumber, m_HeapCompactionReserve, onPlaced);
+
+    if (bIsBuffer)
+    {
+        m_Stats.m_NumAllocatedBuffers += stats.m_NumAllocated;
+        m_Stats.m_NumAliasedBuffers += stats.m_NumAliased;
+        m_Stats.m_TotalBufferMemory += stats.m_AllocatedMemory;
+    }
+    else
+    {
+        m_Stats.m_NumAllocatedTextures += stats.m_NumAllocated;
+        m_Stats.m_NumAliasedTextures += stats.m_NumAliased;
+        m_Stats.m_TotalTextureMemory += stats.m_AllocatedMemory;
+    }
+}
+
+// ============================================================================
+// RenderGraph - Allocation Capture
+// ============================================================================
+
+void RenderGraph::BeginAllocationCapture(const std::filesystem::path& path, uint32_t frameCount)
+{
+    if (IsCapturingAllocations())
+        WriteAllocationCapture();
 
-            const size_t bufferMemory = bIsBuffer ? memReq.size : 0;
-            const size_t textureMemory = !bIsBuffer ? memReq.size : 0;
+    m_AllocationCapturePath = path;
+    m_AllocationCaptureFramesRemaining = frameCount;
+    m_CapturedFrames.clear();
+}
+
+void RenderGraph::RecordAllocationFrame()
+{
+    RecordedFrame& frame = m_CapturedFrames.emplace_back();
+    frame.m_FrameNumber = g_Renderer.m_FrameNumber;
+    frame.m_bAliasingEnabled = m_AliasingEnabled;
 
-            m_Stats.m_TotalBufferMemory += bufferMemory;
-            m_Stats.m_TotalTextureMemory += textureMemory;
+    // Same set AllocateResourcesInternal() places
+    auto record = [&frame](bool bIsBuffer, uint32_t idx, const TransientResourceBase& resource, const std::string& name)
+    {
+        if (resource.m_IsDeclaredThisFrame && resource.m_Lifetime.IsValid())
+        {
+            frame.m_Resources.push_back({ idx, bIsBuffer, name, resource.m_Hash, resource.m_MemReq, resource.m_Lifetime,
+                                          resource.m_IsPersistent, resource.m_bUsedOnAsyncCompute });
         }
+    };
+    for (uint32_t i = 0; i < (uint32_t)m_Textures.size(); ++i) record(false, i, m_Textures[i], m_Textures[i].m_Desc.m_NvrhiDesc.debugName);
+    for (uint32_t i = 0; i < (uint32_t)m_Buffers.size(); ++i)
+    {
+        if (!m_Buffers[i].m_bSuballocated)
+            record(true, i, m_Buffers[i], m_Buffers[i].m_Desc.m_NvrhiDesc.debugName);
+    }
+
+    if (--m_AllocationCaptureFramesRemaining == 0)
+        WriteAllocationCapture();
+}
+
+void RenderGraph::WriteAllocationCapture()
+{
+    PROFILE_FUNCTION();
+
+    m_AllocationCaptureFramesRemaining = 0;
+
+    std::ofstream file(m_AllocationCapturePath, std::ios::out | std::ios::trunc);
+    if (file)
+    {
+        WriteFrameDump(file, m_CapturedFrames);
+        SDL_Log("[RenderGraph] Wrote %zu frame(s) of allocations to %s", m_CapturedFrames.size(), m_AllocationCapturePath.string().c_str());
     }
+    else
+    {
+        SDL_Log("[RenderGraph] Failed to open allocation capture file: %s", m_AllocationCapturePath.string().c_str());
+    }
+    m_CapturedFrames.clear();
 }
 
 // ============================================================================
@@ -1599,12 +3117,12 @@ nvrhi::TextureHandle RenderGraph::GetTexture(RGTextureHandle handle, RGResourceA
         
         if (access == RGResourceAccessMode::Read)
         {
-            found = passAccess.m_ReadTextures.count(handle.m_Index) > 0;
-            found |= passAccess.m_WriteTextures.count(handle.m_Index) > 0; // Allow read access if the pass declared write access, since that implies read access as well
+            found = PassAccess::Contains(passAccess.m_ReadTextures, handle.m_Index);
+            found |= PassAccess::Contains(passAccess.m_WriteTextures, handle.m_Index); // Allow read access if the pass declared write access, since that implies read access as well
         }
         else if (access == RGResourceAccessMode::Write)
         {
-            found = passAccess.m_WriteTextures.count(handle.m_Index) > 0;
+            found = PassAccess::Contains(passAccess.m_WriteTextures, handle.m_Index);
         }
 
         if (!found)
@@ -1624,6 +3142,14 @@ nvrhi::TextureHandle RenderGraph::GetTexture(RGTextureHandle handle, RGResourceA
 }
 
 nvrhi::BufferHandle RenderGraph::GetBuffer(RGBufferHandle handle, RGResourceAccessMode access) const
+{
+    nvrhi::BufferRange range;
+    nvrhi::BufferHandle buffer = GetBuffer(handle, access, range);
+    SDL_assert((!buffer || !m_Buffers[handle.m_Index].m_bSuballocated) && "Buffer shares a pool buffer - use the GetBuffer() overload that returns its range");
+    return buffer;
+}
+
+nvrhi::BufferHandle RenderGraph::GetBuffer(RGBufferHandle handle, RGResourceAccessMode access, nvrhi::BufferRange& outRange) const
 {
     SDL_assert(m_IsCompiled && "GetBuffer cannot be called before Compile() or after PostRender()");
 
@@ -1651,12 +3177,12 @@ nvrhi::BufferHandle RenderGraph::GetBuffer(RGBufferHandle handle, RGResourceAcce
 
         if (access == RGResourceAccessMode::Read)
         {
-            found = passAccess.m_ReadBuffers.count(handle.m_Index) > 0;
-            found |= passAccess.m_WriteBuffers.count(handle.m_Index) > 0; // Allow read access if the pass declared write access, since that implies read access as well
+            found = PassAccess::Contains(passAccess.m_ReadBuffers, handle.m_Index);
+            found |= PassAccess::Contains(passAccess.m_WriteBuffers, handle.m_Index); // Allow read access if the pass declared write access, since that implies read access as well
         }
         else if (access == RGResourceAccessMode::Write)
         {
-            found = passAccess.m_WriteBuffers.count(handle.m_Index) > 0;
+            found = PassAccess::Contains(passAccess.m_WriteBuffers, handle.m_Index);
         }
 
         if (!found)
@@ -1671,7 +3197,8 @@ nvrhi::BufferHandle RenderGraph::GetBuffer(RGBufferHandle handle, RGResourceAcce
 
     SDL_assert(buffer.m_PhysicalBuffer);
     SDL_assert(buffer.m_IsAllocated && "Buffer not allocated");
-    
+
+    outRange = nvrhi::BufferRange(buffer.m_bSuballocated ? buffer.m_SuballocationOffset : 0, buffer.m_Desc.m_NvrhiDesc.byteSize);
     return buffer.m_PhysicalBuffer;
 }
 
@@ -1725,5 +3252,6 @@ RGBufferDesc RenderGraph::GetSPDAtomicCounterDesc(const char* debugName)
     desc.m_NvrhiDesc.canHaveUAVs = true;
     desc.m_NvrhiDesc.debugName = debugName;
     desc.m_NvrhiDesc.initialState = nvrhi::ResourceStates::UnorderedAccess;
+    desc.m_bSuballocate = true;
     return desc;
 }
@@ -2,6 +2,7 @@
 
 
 #include "GraphicRHI.h"
+#include "RenderGraphAllocator.h"
 
 class RenderGraph;
 
@@ -43,6 +44,10 @@ struct RGTextureDesc : public RGResourceDescBase
 struct RGBufferDesc : public RGResourceDescBase
 {
     nvrhi::BufferDesc m_NvrhiDesc;
+
+    // Small transient buffers with this set share a render graph pool buffer instead of each getting a placed resource
+    // (and its 64 KB alignment). Fetch them with the GetBuffer() overload that returns their range.
+    bool m_bSuballocate = false;
     
     size_t ComputeHash() const override;
     nvrhi::MemoryRequirements GetMemoryRequirements() const override;
@@ -65,35 +70,50 @@ enum class RGResourceAccessMode : uint8_t
 namespace RenderGraphInternal
 {
 
-struct ResourceLifetime
+// Queue scheduling input for one pass, see RenderGraph::ScheduleQueues()
+struct QueuePassInfo
 {
-    uint16_t m_FirstPass = UINT16_MAX;
-    uint16_t m_LastPass = 0;
-    
-    bool IsValid() const { return m_FirstPass != UINT16_MAX; }
-    bool Overlaps(const ResourceLifetime& other) const
-    {
-        if (!IsValid() || !other.IsValid())
-            return false;
-        return !(m_LastPass < other.m_FirstPass || other.m_LastPass < m_FirstPass);
-    }
+    bool m_bPrefersAsyncCompute = false;
+    bool m_bComputeCompatible = true; // every resource it accesses starts in a state a compute queue can transition
+    bool m_bCulled = false;
+    std::vector<uint16_t> m_Dependencies; // earlier passes (1-based) whose results it reads or overwrites
+};
+
+// Command list batching input for one recording job, see RenderGraph::ComputeCommandListBatches()
+struct CommandListJobInfo
+{
+    float m_CPUTimeHistory = 0.0f; // 0 = not measured yet
+    nvrhi::CommandQueue m_Queue = nvrhi::CommandQueue::Graphics;
+    bool m_bStartsList = false; // waits for another queue, or follows a live pass that has no recording job
+    bool m_bEndsList = false;   // another queue waits for it
+};
+
+// 'm_WaitingPass' must not start before 'm_SignalPass', which runs on the other queue, has finished
+struct QueueSyncPoint
+{
+    uint16_t m_SignalPass = 0;
+    uint16_t m_WaitingPass = 0;
 };
 
-struct TransientResourceBase
+// A state transition Compile() planned for a graph resource at the start of a pass. m_Before is what the graph expects
+// the resource to be in going into the pass; a transition whose m_BeginPass is earlier than the pass it is planned for
+// could start (split barrier) as soon as that pass begins, because nothing touches the resource in between.
+struct StateTransition
+{
+    uint32_t m_ResourceIndex = UINT32_MAX;
+    bool m_bIsBuffer = false;
+    nvrhi::ResourceStates m_Before = nvrhi::ResourceStates::Unknown;
+    nvrhi::ResourceStates m_After = nvrhi::ResourceStates::Unknown;
+    uint16_t m_BeginPass = 0;
+    nvrhi::TextureSubresourceSet m_Subresources = nvrhi::AllSubresources; // textures only
+};
+
+struct TransientResourceBase : public ResourcePlacement
 {
     size_t m_Hash = 0;
-    ResourceLifetime m_Lifetime;
-    uint32_t m_AliasedFromIndex = UINT32_MAX;
-    uint16_t m_PhysicalLastPass = 0;
     uint16_t m_DeclarationPass = 0;
     uint64_t m_LastFrameUsed = 0;
-    uint64_t m_Offset = 0;
-    uint64_t m_BlockOffset = 0;
-    uint32_t m_HeapIndex = UINT32_MAX;
-    bool m_IsAllocated = false;
     bool m_IsDeclaredThisFrame = false;
-    bool m_IsPersistent = false;
-    bool m_IsPhysicalOwner = false;
     nvrhi::HeapHandle m_Heap;
 
     virtual nvrhi::MemoryRequirements GetMemoryRequirements() const = 0;
@@ -104,6 +124,14 @@ struct TransientTexture : public TransientResourceBase
 {
     RGTextureDesc m_Desc;
     nvrhi::TextureHandle m_PhysicalTexture;
+    // Passes each subresource (mip-major: mip * arraySize + slice) is used in. Only filled by Compile() when a live pass
+    // accesses part of the texture; memory is still aliased per texture, over m_Lifetime.
+    std::vector<ResourceLifetime> m_SubresourceLifetimes;
+
+    // Set by DeclareHistoryTexture(), cleared by any other declaration of the slot
+    uint32_t m_HistoryPairIndex = UINT32_MAX; // the other half of the pair
+    bool m_bIsHistoryCurrent = false;          // the half written this frame
+    bool m_bHistoryValid = false;              // previous half: holds what the current half had at the last declaration
 
     nvrhi::MemoryRequirements GetMemoryRequirements() const override
     {
@@ -114,7 +142,9 @@ struct TransientTexture : public TransientResourceBase
 struct TransientBuffer : public TransientResourceBase
 {
     RGBufferDesc m_Desc;
-    nvrhi::BufferHandle m_PhysicalBuffer;
+    nvrhi::BufferHandle m_PhysicalBuffer; // the pool buffer when m_bSuballocated
+    bool m_bSuballocated = false;
+    uint64_t m_SuballocationOffset = 0;
 
     nvrhi::MemoryRequirements GetMemoryRequirements() const override
     {
@@ -147,29 +177,78 @@ public:
     bool DeclarePersistentTexture(const RGTextureDesc& desc, RGTextureHandle& outputHandle);
     bool DeclarePersistentBuffer(const RGBufferDesc& desc, RGBufferHandle& outputHandle);
 
+    // Double-buffered persistent texture for temporal effects: 'outCurrent' is this frame's copy, 'outPrevious' holds
+    // what was written to 'outCurrent' at the last declaration. The two slots trade physical textures every time they
+    // are declared, so keeping last frame's contents costs no copy; pass the same pair of handles every frame.
+    // Unlike the other declarations, 'outPrevious' is not implicitly written by the declaring pass. Once its last reader
+    // has run it is dead for the aliasing planner, so 'outCurrent' starts every frame with undefined contents.
+    // Returns true when 'outPrevious' holds nothing usable (first declaration, desc change, eviction).
+    bool DeclareHistoryTexture(const RGTextureDesc& desc, RGTextureHandle& outCurrent, RGTextureHandle& outPrevious);
+    // Whether the previous half of a history pair declared this frame holds last frame's contents, for passes that read
+    // a history another renderer declares
+    bool IsHistoryValid(RGTextureHandle previous) const;
+
     // Resource Access Registration (called during Setup phase)
     void ReadTexture(RGTextureHandle handle);
     void WriteTexture(RGTextureHandle handle);
+
+    // Access only some mips / array slices of a texture: state transitions and subresource lifetimes then cover just
+    // that range. Several partial accesses to one texture in a pass merge into their bounding range.
+    void ReadTexture(RGTextureHandle handle, const nvrhi::TextureSubresourceSet& subresources);
+    void WriteTexture(RGTextureHandle handle, const nvrhi::TextureSubresourceSet& subresources);
     
     void ReadBuffer(RGBufferHandle handle);
     void WriteBuffer(RGBufferHandle handle);
+
+    // Mark the pass being set up as having effects outside the graph (presenting, readback, writes to engine-owned
+    // resources), so pass culling keeps it even when nothing in the graph reads what it writes
+    void MarkSideEffects();
     
     // Pass management (internal use by render loop)
     // BeginSetup() is called exactly once per frame (after Reset()), before any
     // ScheduleRenderer() calls.  EndSetup() is called once after all renderers
     // have been scheduled, before Compile().
-    void BeginSetup();
+    // With bParallelSetup, ScheduleRenderer() only queues the renderer and EndSetup() runs the queued Setup()s on the
+    // task scheduler, each recording into its own SetupBuilder, then replays the builders in scheduling order. Setup()
+    // may then only touch the graph through the declaration / access calls above, must declare into handles that
+    // outlive EndSetup() (globals or renderer members), and may run twice in a frame when it needs new slots.
+    void BeginSetup(bool bParallelSetup = false);
     void EndSetup();
     void BeginPass(const char* name);
     
     void ScheduleRenderer(class IRenderer* pRenderer);
     
     void Compile();
+
+    // Acquires a command list for each batch of recording jobs Compile() grouped together (see PlanCommandLists()), in
+    // declaration order, and hands each batch to the task scheduler as one task recording its passes one after another.
+    // Called once per frame after Compile().
+    // With Config::m_EnableCriticalPathRecordingOrder the most expensive batches (by CPU recording-time history) are
+    // submitted first, so they don't end up starting last and stretching ExecuteAllScheduledTasks().
+    void SubmitRecordingJobs();
+
+    // Submission order for recording jobs given each job's CPU time history: indices, longest first, ties in declaration order
+    static std::vector<uint32_t> ComputeRecordingOrder(std::span<const float> cpuTimeHistory);
+
+    // Groups recording jobs, in declaration order, into command lists: returns the first job of each list. A job joins
+    // the previous job's list if both are on the same queue with no cross-queue wait between them, both have a CPU time
+    // history and the list's summed history stays within maxBatchCPUTimeMs. Heavy and unmeasured passes record alone.
+    static std::vector<uint32_t> ComputeCommandListBatches(std::span<const RenderGraphInternal::CommandListJobInfo> jobs, float maxBatchCPUTimeMs);
+
+    // Queue for each pass (indexed by pass index - 1) and the cross-queue waits between them, ordered by waiting pass.
+    // A pass preferring async compute goes to the compute queue if it can run there and has graphics work next to it
+    // to overlap with (it doesn't directly depend on the graphics pass before it, or the one after doesn't depend on it).
+    // A pass waits for the latest pass it depends on on the other queue, unless its queue already waited for one as late.
+    static void ScheduleQueues(std::span<const RenderGraphInternal::QueuePassInfo> passes, std::vector<nvrhi::CommandQueue>& outPassQueues,
+                               std::vector<RenderGraphInternal::QueueSyncPoint>& outSyncPoints);
     void PostRender();
     
     // Resource Retrieval (only valid after Compile and before Cleanup)
     nvrhi::TextureHandle GetTexture(RGTextureHandle handle, RGResourceAccessMode access) const;
     nvrhi::BufferHandle GetBuffer(RGBufferHandle handle, RGResourceAccessMode access) const;
+    // Same, plus the bytes of the returned buffer that belong to this handle. Required for buffers declared with
+    // RGBufferDesc::m_bSuballocate, which may be a range of a shared pool buffer; bind and clear only that range.
+    nvrhi::BufferHandle GetBuffer(RGBufferHandle handle, RGResourceAccessMode access, nvrhi::BufferRange& outRange) const;
 
     // Raw retrieval without access validation (only for internal use by render loop or unit tests, not safe for general use)
     nvrhi::TextureHandle GetTextureRaw(RGTextureHandle handle) const;
@@ -188,9 +267,22 @@ public:
     // Must be called at the start of each pass's command list recording, before any GPU work.
     void InsertAliasBarriers(uint16_t passIndex, nvrhi::ICommandList* commandList) const;
 
+    // Apply the state transitions Compile() planned for a pass as a single barrier batch.
+    // Called right after InsertAliasBarriers(), so the pass's own draws and dispatches find the graph's resources
+    // already in place instead of each one flushing its own barriers.
+    void InsertStateTransitions(uint16_t passIndex, nvrhi::ICommandList* commandList) const;
+    const std::vector<RenderGraphInternal::StateTransition>& GetPassStateTransitions(uint16_t passIndex) const;
+
     // Returns the pass index for the current pass (valid after BeginPass, before Compile)
     uint16_t GetCurrentPassIndex() const { return m_CurrentPassIndex; }
 
+    // True if Compile() culled the pass because nothing live reads its outputs (valid after Compile)
+    bool IsPassCulled(uint16_t passIndex) const;
+
+    // Queue Compile() assigned the pass to, and the cross-queue waits it placed (valid after Compile)
+    nvrhi::CommandQueue GetPassQueue(uint16_t passIndex) const;
+    const std::vector<RenderGraphInternal::QueueSyncPoint>& GetQueueSyncPoints() const { return m_QueueSyncPoints; }
+
     // Debug & Stats
     struct Stats
     {
@@ -202,37 +294,151 @@ public:
         uint32_t m_NumAliasedBuffers = 0;
         size_t m_TotalTextureMemory = 0;
         size_t m_TotalBufferMemory = 0;
+        // Transient (non-persistent) resources: memory they would take without aliasing, the physical memory backing
+        // them after aliasing, and the most that is alive at any one pass (lower bound for any packing)
+        size_t m_TransientMemoryUnaliased = 0;
+        size_t m_TransientMemoryAliased = 0;
+        size_t m_TransientMemoryPeakLive = 0;
+        // Scheduled passes skipped this frame because none of their outputs reach a marked output
+        uint32_t m_NumCulledPasses = 0;
+        uint32_t m_NumAsyncComputePasses = 0;
+        uint32_t m_NumQueueSyncPoints = 0;
+        // Passes recorded through ScheduleRenderer() and the command lists they were grouped into (fewer than the
+        // passes when cheap ones share a list)
+        uint32_t m_NumRecordedPasses = 0;
+        uint32_t m_NumPassCommandLists = 0;
+        // Planned state transitions, the passes that open with a batch of them, and the transitions that could be split
+        uint32_t m_NumStateTransitions = 0;
+        uint32_t m_NumBarrierBatches = 0;
+        uint32_t m_NumSplitTransitions = 0;
+        // Small buffers packed into shared pool buffers, the pools in use and their total size
+        uint32_t m_NumSuballocatedBuffers = 0;
+        uint32_t m_NumBufferPools = 0;
+        size_t m_BufferPoolMemory = 0;
+        // Transient heaps after allocation: how many, their total and free size, and the share of the free memory
+        // outside the largest free block (0 = every free byte is in one block, 100 = scattered in small holes)
+        uint32_t m_NumHeaps = 0;
+        size_t m_TotalHeapMemory = 0;
+        size_t m_FreeHeapMemory = 0;
+        float m_HeapFragmentationPercent = 0.0f;
+        // Allocation and alias barriers were reused from the previous frame's compile (same graph structure)
+        bool m_bCompiledFromCache = false;
+        // Compile() re-packed the transient heaps this frame
+        bool m_bHeapsCompacted = false;
     };
     
+    // Compiles that reused the previous frame's result vs. compiled from scratch, since startup
+    uint64_t GetCompileCacheHits() const { return m_CompileCacheHits; }
+    uint64_t GetCompileCacheMisses() const { return m_CompileCacheMisses; }
+
+    // Heap compactions run by Compile() since startup
+    uint64_t GetHeapCompactionCount() const { return m_HeapCompactionCount; }
+
+    // Passes recorded into compute queue command lists, since startup
+    uint64_t GetAsyncComputePassesRecorded() const { return m_AsyncComputePassesRecorded; }
+
+    // Frames whose queued Setup()s were replayed from parallel builders vs. re-run one after another, since startup
+    uint64_t GetParallelSetupCount() const { return m_ParallelSetupCount; }
+    uint64_t GetSerialSetupFallbackCount() const { return m_SerialSetupFallbackCount; }
+    uint64_t GetSetupRerunCount() const { return m_SetupRerunCount; }
+
     void RenderDebugUI();
     std::string ExportToString() const;
 
+    // Records the heap-placed resources of the next 'frameCount' compiled frames (memory requirements, lifetimes, flags)
+    // and writes them to 'path' as a frame dump (RenderGraphInternal::WriteFrameDump), for the offline allocator
+    // simulator in RenderGraphSim/. A capture already running, or still running at Shutdown(), is written with the
+    // frames recorded so far.
+    void BeginAllocationCapture(const std::filesystem::path& path, uint32_t frameCount);
+    bool IsCapturingAllocations() const { return m_AllocationCaptureFramesRemaining > 0; }
+
     static RGBufferDesc GetSPDAtomicCounterDesc(const char* debugName);
     
 private:
     // Generic resource allocation helper (avoids code duplication)
     void AllocateResourcesInternal(bool bIsBuffer, std::function<void(uint32_t, nvrhi::HeapHandle, uint64_t)> createAndBindResource);
+    void UpdateTransientMemoryStats();
+
+    // Dead-pass culling, run at the start of Compile(). Roots are passes that can't be culled (begun directly rather
+    // than through ScheduleRenderer(), MarkSideEffects(), writing a persistent resource or nothing in the graph);
+    // walking back from them, a pass stays live if a later live pass accesses something it writes. Culled passes
+    // drop their recording job, their declared resources and their share of resource lifetimes.
+    void CullDeadPasses();
+
+    // Runs after culling: builds each live pass's dependencies from the access lists and runs ScheduleQueues().
+    // Resources touched on the compute queue are kept out of aliasing, since pass order no longer bounds when they're used.
+    void AssignQueues();
+    std::vector<nvrhi::CommandQueue> m_PassQueues; // indexed by pass index - 1
+    std::vector<RenderGraphInternal::QueueSyncPoint> m_QueueSyncPoints;
+
+    // Runs after AssignQueues(), on compile-cache hits too since CPU times drift: groups the recording jobs into command
+    // lists with ComputeCommandListBatches(). Off under Config::ExecutePerPass(AndWait), which submit pass by pass.
+    void PlanCommandLists();
+    std::vector<uint32_t> m_CommandListFirstJobs; // index into m_RecordingJobs of each command list's first job
+    std::vector<uint16_t> m_PassCommandListStart; // first pass of the command list each pass records into, indexed by pass index
+
+    // Runs after PlanCommandLists(): walks the live passes in order and plans, per pass, the transitions its accesses need.
+    // A write goes to the resource's render target / depth / UAV / copy state, a read to ShaderResource; accesses
+    // whose state the desc can't pin down (render target + UAV, depth reads, vertex/index/indirect buffer reads, or
+    // graphics-only states on the compute queue) are left to nvrhi's automatic tracking.
+    // Textures are tracked per subresource; transitions cover runs of slices and mips that share before/after states.
+    // The same sweep fills m_SubresourceLifetimes for textures some pass only partly accesses.
+    void PlanStateTransitions();
+    std::vector<std::vector<RenderGraphInternal::StateTransition>> m_PerPassStateTransitions; // indexed by pass index
+
+    // Compiled-graph cache. BeginPass() folds each pass (name, declared slots and desc hashes, accesses) into
+    // m_StructureHash; when a frame ends up with the same hash as the last compiled one, Compile() restores that
+    // frame's allocation decisions, alias barriers and stats instead of running aliasing again.
+    using CreateAndBindFunc = std::function<void(uint32_t, nvrhi::HeapHandle, uint64_t)>;
+    bool TryReuseCompiledGraph(const CreateAndBindFunc& createAndBindTexture, const CreateAndBindFunc& createAndBindBuffer);
+    void StoreCompiledGraph();
     
-    // Heap management
-    struct HeapBlock
+    // Heap management. The block lists live in m_HeapAllocator (RenderGraphAllocator.h); this backs its heaps with
+    // nvrhi heaps, indexed the same way.
+    class NvrhiHeapDevice : public RenderGraphInternal::IHeapDevice
     {
-        size_t m_Offset = 0;
-        size_t m_Size = 0;
-        bool m_IsFree = true;
-    };
+    public:
+        void CreateHeap(uint32_t heapIdx, uint64_t size) override;
+        void ReleaseHeap(uint32_t heapIdx) override;
 
-    struct HeapEntry
+        std::vector<nvrhi::HeapHandle> m_Heaps;
+    };
+    NvrhiHeapDevice m_HeapDevice;
+    RenderGraphInternal::HeapAllocator m_HeapAllocator{ m_HeapDevice };
+
+    // Small-buffer pools. Every frame, before allocation, declared transient buffers with RGBufferDesc::m_bSuballocate
+    // (up to 64 KB, not touched on the compute queue) are packed one after another into a pool buffer shared with the
+    // other buffers whose views look the same. Pool buffers keep their initial state, so state planning skips these
+    // buffers; they grow on demand and are released after going unused for a few frames.
+    struct BufferPool
     {
-        nvrhi::HeapHandle m_Heap;
-        size_t m_Size = 0;
+        size_t m_Key = 0; // view-relevant desc fields of the buffers it holds
+        nvrhi::BufferHandle m_Buffer;
         uint64_t m_LastFrameUsed = 0;
-        uint32_t m_HeapIdx = UINT32_MAX;
-        std::vector<HeapBlock> m_Blocks;
     };
-    std::vector<HeapEntry> m_Heaps;
-    nvrhi::HeapHandle CreateHeap(size_t size);
-    void SubAllocateResource(RenderGraphInternal::TransientResourceBase* resource, uint64_t alignment);
-    void FreeBlock(uint32_t heapIdx, uint64_t blockOffset);
+    std::vector<BufferPool> m_BufferPools;
+    void SuballocateSmallBuffers();
+
+    void UpdateHeapStats(bool bCompacted);
+
+    // Allocation capture, see BeginAllocationCapture(). Runs at the end of Compile().
+    void RecordAllocationFrame();
+    void WriteAllocationCapture();
+    std::filesystem::path m_AllocationCapturePath;
+    uint32_t m_AllocationCaptureFramesRemaining = 0;
+    std::vector<RenderGraphInternal::RecordedFrame> m_CapturedFrames;
+
+    // Runs in Compile() before allocation. Over Config::m_RenderGraphHeapBudgetMB, empty heaps are released right away
+    // instead of after several idle frames. If the heaps are still over budget, or their free memory is
+    // too scattered (Config::m_RenderGraphHeapFragmentationThreshold), every non-persistent resource gives up its
+    // placement, emptied heaps are released, and allocation re-packs this frame's resources, the first new heap sized
+    // to take all of them. Persistent resources keep their contents, so they stay where they are.
+    // Returns true if it compacted; that drops the compiled-graph cache.
+    bool CompactHeapsIfNeeded();
+    uint64_t m_HeapCompactionReserve = 0; // minimum size of the next heap HeapAllocator::Allocate() creates
+    uint64_t m_LastHeapCompactionFrame = UINT64_MAX;
+    std::pair<size_t, size_t> m_HeapUsageAfterCompaction; // total and free heap size the last compaction left
+    uint64_t m_HeapCompactionCount = 0;
     
     // Helper for updating resource lifetimes
     void UpdateResourceLifetime(RenderGraphInternal::ResourceLifetime& lifetime, uint16_t currentPass);
@@ -244,21 +450,119 @@ private:
         uint32_t m_ResourceIndex = UINT32_MAX;
     };
     std::vector<std::vector<AliasBarrierEntry>> m_PerPassAliasBarriers; // indexed by pass index
+
+    struct CompiledAllocation
+    {
+        uint32_t m_Index = UINT32_MAX;
+        uint32_t m_AliasedFromIndex = UINT32_MAX;
+        uint16_t m_PhysicalLastPass = 0;
+        bool m_bIsBuffer = false;
+        uint64_t m_OwnerOffset = 0; // aliased: where it sits in the owner's memory
+    };
+    struct CompiledGraph
+    {
+        bool m_bValid = false;
+        size_t m_StructureHash = 0;
+        std::vector<CompiledAllocation> m_Allocations;
+        std::vector<std::vector<AliasBarrierEntry>> m_PerPassAliasBarriers;
+        Stats m_Stats;
+    };
+    CompiledGraph m_CompiledGraph;
+    size_t m_StructureHash = 0;
+    uint64_t m_CompileCacheHits = 0;
+    uint64_t m_CompileCacheMisses = 0;
+    uint64_t m_AsyncComputePassesRecorded = 0;
+    uint32_t m_LastFrameComputePasses = 0;
     
 private:
     uint16_t GetActivePassIndex() const;
 
+    // Resource indices accessed by a pass, each list sorted and unique. A pass touches a handful of resources,
+    // so binary search over a flat vector beats hashing, and iterating it needs no hash table walk.
+    // A culled pass keeps its lists for the debug UI, but Compile() ignores them.
     struct PassAccess
     {
-        std::unordered_set<uint32_t> m_ReadTextures;
-        std::unordered_set<uint32_t> m_WriteTextures;
-        std::unordered_set<uint32_t> m_ReadBuffers;
-        std::unordered_set<uint32_t> m_WriteBuffers;
+        std::vector<uint32_t> m_ReadTextures;
+        std::vector<uint32_t> m_WriteTextures;
+        std::vector<uint32_t> m_ReadBuffers;
+        std::vector<uint32_t> m_WriteBuffers;
+
+        // Textures accessed only in part, sorted by index. A texture in m_ReadTextures / m_WriteTextures without an
+        // entry here is accessed whole.
+        struct TextureRange
+        {
+            uint32_t m_Index = UINT32_MAX;
+            nvrhi::TextureSubresourceSet m_Subresources;
+        };
+        std::vector<TextureRange> m_ReadTextureRanges;
+        std::vector<TextureRange> m_WriteTextureRanges;
+        bool m_bCullable = false;
+        bool m_bHasSideEffects = false;
+        bool m_bCulled = false;
+        bool m_bPrefersAsyncCompute = false;
+
+        static void Add(std::vector<uint32_t>& indices, uint32_t index)
+        {
+            auto it = std::lower_bound(indices.begin(), indices.end(), index);
+            if (it == indices.end() || *it != index)
+                indices.insert(it, index);
+        }
+        static bool Contains(const std::vector<uint32_t>& indices, uint32_t index)
+        {
+            return std::binary_search(indices.begin(), indices.end(), index);
+        }
+
+        // 'subresources' must already be resolved against the texture's desc
+        static void AddTexture(std::vector<uint32_t>& indices, std::vector<TextureRange>& ranges, uint32_t index,
+                               const nvrhi::TextureSubresourceSet& subresources, bool bEntireTexture)
+        {
+            auto it = std::lower_bound(indices.begin(), indices.end(), index);
+            const bool bNewAccess = it == indices.end() || *it != index;
+            if (bNewAccess)
+                indices.insert(it, index);
+
+            auto rangeIt = std::lower_bound(ranges.begin(), ranges.end(), index, [](const TextureRange& range, uint32_t idx) { return range.m_Index < idx; });
+            const bool bHasRange = rangeIt != ranges.end() && rangeIt->m_Index == index;
+            if (bEntireTexture)
+            {
+                if (bHasRange)
+                    ranges.erase(rangeIt);
+            }
+            else if (bNewAccess)
+            {
+                ranges.insert(rangeIt, { index, subresources });
+            }
+            else if (bHasRange)
+            {
+                nvrhi::TextureSubresourceSet& merged = rangeIt->m_Subresources;
+                const nvrhi::MipLevel mipEnd = std::max(merged.baseMipLevel + merged.numMipLevels, subresources.baseMipLevel + subresources.numMipLevels);
+                const nvrhi::ArraySlice sliceEnd = std::max(merged.baseArraySlice + merged.numArraySlices, subresources.baseArraySlice + subresources.numArraySlices);
+                merged.baseMipLevel = std::min(merged.baseMipLevel, subresources.baseMipLevel);
+                merged.numMipLevels = mipEnd - merged.baseMipLevel;
+                merged.baseArraySlice = std::min(merged.baseArraySlice, subresources.baseArraySlice);
+                merged.numArraySlices = sliceEnd - merged.baseArraySlice;
+            }
+            // else: already accessed whole in this pass
+        }
+        static nvrhi::TextureSubresourceSet GetTextureRange(const std::vector<TextureRange>& ranges, uint32_t index)
+        {
+            auto rangeIt = std::lower_bound(ranges.begin(), ranges.end(), index, [](const TextureRange& range, uint32_t idx) { return range.m_Index < idx; });
+            return (rangeIt != ranges.end() && rangeIt->m_Index == index) ? rangeIt->m_Subresources : nvrhi::AllSubresources;
+        }
     };
     std::vector<PassAccess> m_PassAccesses;
 
     std::vector<RenderGraphInternal::TransientTexture> m_Textures;
     std::vector<RenderGraphInternal::TransientBuffer> m_Buffers;
+
+    // Idle pool slots (not declared this or last frame) by desc hash, lowest slot index at the back, so declarations
+    // without a handle find a reusable slot without scanning the pool. Rebuilt on the first declaration of each frame;
+    // entries that were claimed through their handle since then are skipped when popped.
+    using FreeSlotLists = std::unordered_map<size_t, std::vector<uint32_t>>;
+    FreeSlotLists m_FreeTextureSlots;
+    FreeSlotLists m_FreeBufferSlots;
+    uint64_t m_FreeSlotListsFrame = UINT64_MAX;
+    void RebuildFreeSlotLists();
     std::vector<const char*> m_PassNames;
 
     // ── Deferred-release lists ────────────────────────────────────────────────
@@ -277,14 +581,90 @@ private:
     // run garbage collection, then clear both lists.
     void FlushDeferredReleases();
     
+    // Render pass recording jobs queued by ScheduleRenderer(), in declaration order. The command list is acquired in
+    // SubmitRecordingJobs(), so passes culled by Compile() never take one; jobs batched together share it.
+    struct RecordingJob
+    {
+        class IRenderer* m_Renderer = nullptr;
+        nvrhi::CommandListHandle m_CommandList;
+        uint16_t m_PassIndex = 0;
+    };
+    std::vector<RecordingJob> m_RecordingJobs;
+
     // Setup state
     bool m_IsInsideSetup = false;
     PassAccess m_PendingPassAccess;
     std::vector<uint32_t> m_PendingDeclaredTextures;
     std::vector<uint32_t> m_PendingDeclaredBuffers;
 
+    // Runs a renderer's Setup() on the calling thread, then begins its pass (or rolls back what it declared if disabled)
+    void SetupRenderer(class IRenderer* pRenderer);
+    void CommitRendererSetup(class IRenderer* pRenderer);
+
+    // Parallel setup. The graph is read-only while the queued Setup()s run: the declaration / access calls of a thread
+    // with an active builder only append to it. A declaration through a handle that already names a slot keeps that
+    // slot, so its result is known up front. One that needs a new slot could hand out a handle a renderer set up
+    // concurrently has already read, so that renderer's Setup() runs again serially in its turn, and so does every
+    // later one whose builder names a handle the re-run moved; the rest still replay. Hence Setup() must be safe to
+    // call twice in a frame (see IRenderer::Setup).
+    // Ops keep pointers to the caller's handles until EndSetup(), so the handles passed to the Declare*() calls must
+    // be globals or renderer members, never locals of Setup().
+    struct SetupBuilder
+    {
+        enum class OpType : uint8_t
+        {
+            DeclareTexture,
+            DeclareBuffer,
+            DeclareHistoryTexture,
+            ReadTexture,
+            WriteTexture,
+            ReadBuffer,
+            WriteBuffer,
+            MarkSideEffects
+        };
+        struct Op
+        {
+            OpType m_Type = OpType::MarkSideEffects;
+            bool m_bPersistent = false;
+            uint32_t m_DescIndex = UINT32_MAX;          // declarations: into m_TextureDescs / m_BufferDescs
+            RGResourceHandleBase* m_pHandle = nullptr;  // declarations: the caller's handle
+            RGResourceHandleBase* m_pPreviousHandle = nullptr; // history declarations: the caller's previous handle
+            RGResourceHandleBase m_Handle;              // accesses
+            nvrhi::TextureSubresourceSet m_Subresources = nvrhi::AllSubresources;
+        };
+        std::vector<Op> m_Ops; // in call order
+        std::vector<RGTextureDesc> m_TextureDescs;
+        std::vector<RGBufferDesc> m_BufferDescs;
+        bool m_bEnabled = false;
+        bool m_bNeedsNewSlot = false;
+
+        void RecordAccess(OpType type, RGResourceHandleBase handle, const nvrhi::TextureSubresourceSet& subresources = nvrhi::AllSubresources)
+        {
+            Op& op = m_Ops.emplace_back();
+            op.m_Type = type;
+            op.m_Handle = handle;
+            op.m_Subresources = subresources;
+        }
+    };
+    inline static thread_local SetupBuilder* t_ActiveSetupBuilder = nullptr;
+    bool m_bParallelSetup = false;
+    std::vector<class IRenderer*> m_QueuedSetupRenderers; // in scheduling order
+    uint64_t m_ParallelSetupCount = 0;
+    uint64_t m_SerialSetupFallbackCount = 0; // frames where at least one Setup() ran serially
+    uint64_t m_SetupRerunCount = 0;          // Setup()s run a second time because they needed new slots
+    void RunQueuedSetups();
+    void ReplaySetupBuilder(const SetupBuilder& builder);
+    bool RecordTextureDeclaration(SetupBuilder& builder, const RGTextureDesc& desc, RGTextureHandle& outputHandle, bool bPersistent) const;
+    bool RecordBufferDeclaration(SetupBuilder& builder, const RGBufferDesc& desc, RGBufferHandle& outputHandle, bool bPersistent) const;
+    bool RecordHistoryTextureDeclaration(SetupBuilder& builder, const RGTextureDesc& desc, RGTextureHandle& outCurrent, RGTextureHandle& outPrevious) const;
+
+    // Whether the pair as left by its last DeclareHistoryTexture() still has 'current' holding last frame's contents
+    bool HasUsableHistory(size_t hash, RGTextureHandle current, RGTextureHandle previous) const;
+
     Stats m_Stats;
     bool m_AliasingEnabled = true;
+    bool m_PassCullingEnabled = true;
+    bool m_AsyncComputeEnabled = false;
     bool m_IsCompiled = false;
     uint16_t m_CurrentPassIndex = 0;
     bool m_bForceInvalidateAllResources = false;
@@ -311,6 +691,7 @@ public:
 
     const std::vector<RenderGraphInternal::TransientTexture>& GetTextures() const { return m_Textures; }
     const std::vector<RenderGraphInternal::TransientBuffer>& GetBuffers() const { return m_Buffers; }
-    const std::vector<HeapEntry>& GetHeaps() const { return m_Heaps; }
+    const std::vector<RenderGraphInternal::HeapEntry>& GetHeaps() const { return m_HeapAllocator.GetHeaps(); }
+    std::vector<RenderGraphInternal::HeapBlock> GetHeapBlocks(uint32_t heapIdx) const { return m_HeapAllocator.GetBlocks(heapIdx); }
     const Stats& GetStats() const { return m_Stats; }
 };
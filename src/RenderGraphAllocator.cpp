@@ -0,0 +1,898 @@
+#include "RenderGraphAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <istream>
+#include <map>
+#include <ostream>
+
+namespace RenderGraphInternal
+{
+
+// ============================================================================
+// HeapAllocator
+// ============================================================================
+
+static uint64_t NextPow2(uint64_t v)
+{
+    uint64_t result = 1;
+    while (result < v) result <<= 1;
+    return result;
+}
+
+HeapAllocator::HeapAllocator(IHeapDevice& device)
+    : m_Device(device)
+{
+    for (auto& lists : m_FreeLists)
+        std::fill(std::begin(lists), std::end(lists), UINT32_MAX);
+}
+
+// Size class holding 'size': (floor(log2(size)), next kSLBits bits), with the classes below kSLCount one byte wide
+void HeapAllocator::MapSize(uint64_t size, uint32_t& outFL, uint32_t& outSL)
+{
+    if (size < kSLCount)
+    {
+        outFL = 0;
+        outSL = (uint32_t)size;
+        return;
+    }
+    const uint32_t log2 = (uint32_t)std::bit_width(size) - 1;
+    outFL = log2 - kSLBits + 1;
+    outSL = (uint32_t)(size >> (log2 - kSLBits)) - kSLCount;
+}
+
+bool HeapAllocator::FindFreeClass(uint32_t& ioFL, uint32_t& ioSL) const
+{
+    uint32_t slMap = m_SLBitmaps[ioFL] & (~0u << ioSL);
+    if (slMap == 0)
+    {
+        const uint64_t flMap = ioFL + 1 < kFLCount ? m_FLBitmap & (~0ull << (ioFL + 1)) : 0;
+        if (flMap == 0)
+            return false;
+        ioFL = (uint32_t)std::countr_zero(flMap);
+        slMap = m_SLBitmaps[ioFL];
+    }
+    ioSL = (uint32_t)std::countr_zero(slMap);
+    return true;
+}
+
+uint32_t HeapAllocator::FindFreeBlock(uint64_t size, uint64_t alignment, uint64_t& outAlignedOffset) const
+{
+    // Start at the first class whose blocks are all at least 'size' bytes. Only each class's head is tried: a head that
+    // loses to alignment moves the search up a class, and once classes are 'size + alignment - 1' bytes every head fits.
+    uint64_t searchSize = size;
+    if (size >= kSLCount)
+        searchSize += (1ull << (std::bit_width(size) - 1 - kSLBits)) - 1;
+
+    uint32_t fl, sl;
+    MapSize(searchSize, fl, sl);
+    while (FindFreeClass(fl, sl))
+    {
+        const uint32_t nodeIdx = m_FreeLists[fl][sl];
+        const BlockNode& node = m_Nodes[nodeIdx];
+        const uint64_t alignedOffset = (node.m_Offset + alignment - 1) / alignment * alignment;
+        if (alignedOffset + size <= node.m_Offset + node.m_Size)
+        {
+            outAlignedOffset = alignedOffset;
+            return nodeIdx;
+        }
+
+        if (++sl == kSLCount)
+        {
+            sl = 0;
+            if (++fl == kFLCount)
+                break;
+        }
+    }
+    return UINT32_MAX;
+}
+
+uint32_t HeapAllocator::NewNode(const BlockNode& node)
+{
+    if (!m_RecycledNodes.empty())
+    {
+        const uint32_t nodeIdx = m_RecycledNodes.back();
+        m_RecycledNodes.pop_back();
+        m_Nodes[nodeIdx] = node;
+        return nodeIdx;
+    }
+    m_Nodes.push_back(node);
+    return (uint32_t)m_Nodes.size() - 1;
+}
+
+void HeapAllocator::RecycleNode(uint32_t nodeIdx)
+{
+    m_Nodes[nodeIdx] = BlockNode{};
+    m_RecycledNodes.push_back(nodeIdx);
+}
+
+void HeapAllocator::InsertFree(uint32_t nodeIdx)
+{
+    BlockNode& node = m_Nodes[nodeIdx];
+    node.m_IsFree = true;
+
+    uint32_t fl, sl;
+    MapSize(node.m_Size, fl, sl);
+    const uint32_t head = m_FreeLists[fl][sl];
+    node.m_PrevFree = UINT32_MAX;
+    node.m_NextFree = head;
+    if (head != UINT32_MAX)
+        m_Nodes[head].m_PrevFree = nodeIdx;
+    m_FreeLists[fl][sl] = nodeIdx;
+
+    m_FLBitmap |= 1ull << fl;
+    m_SLBitmaps[fl] |= 1u << sl;
+}
+
+void HeapAllocator::RemoveFree(uint32_t nodeIdx)
+{
+    BlockNode& node = m_Nodes[nodeIdx];
+    assert(node.m_IsFree);
+
+    uint32_t fl, sl;
+    MapSize(node.m_Size, fl, sl);
+    if (node.m_PrevFree != UINT32_MAX)
+        m_Nodes[node.m_PrevFree].m_NextFree = node.m_NextFree;
+    else
+        m_FreeLists[fl][sl] = node.m_NextFree;
+    if (node.m_NextFree != UINT32_MAX)
+        m_Nodes[node.m_NextFree].m_PrevFree = node.m_PrevFree;
+
+    if (m_FreeLists[fl][sl] == UINT32_MAX)
+    {
+        m_SLBitmaps[fl] &= ~(1u << sl);
+        if (m_SLBitmaps[fl] == 0)
+            m_FLBitmap &= ~(1ull << fl);
+    }
+
+    node.m_PrevFree = UINT32_MAX;
+    node.m_NextFree = UINT32_MAX;
+    node.m_IsFree = false;
+}
+
+uint32_t HeapAllocator::CreateHeap(uint64_t size, uint64_t frame)
+{
+    assert(size > 0);
+
+    uint32_t heapIdx = 0;
+    while (heapIdx < m_Heaps.size() && m_Heaps[heapIdx].IsLive())
+        ++heapIdx;
+    if (heapIdx == m_Heaps.size())
+        m_Heaps.emplace_back();
+
+    const uint32_t firstBlock = NewNode(BlockNode{ 0, size, heapIdx });
+    InsertFree(firstBlock);
+
+    HeapEntry& heapEntry = m_Heaps[heapIdx];
+    heapEntry.m_Size = size;
+    heapEntry.m_LastFrameUsed = frame;
+    heapEntry.m_FreeSize = size;
+    heapEntry.m_FirstBlock = firstBlock;
+    heapEntry.m_UsedBlocks.clear();
+
+    m_Device.CreateHeap(heapIdx, size);
+    return heapIdx;
+}
+
+void HeapAllocator::Allocate(uint64_t size, uint64_t alignment, uint64_t frame, uint64_t& ioMinNewHeapSize, uint32_t& outHeapIdx, uint64_t& outOffset)
+{
+    alignment = std::max<uint64_t>(alignment, 1);
+
+    // 1. Try to find a free block in existing heaps
+    uint64_t alignedOffset = 0;
+    uint32_t nodeIdx = FindFreeBlock(size, alignment, alignedOffset);
+
+    // 2. No fit found, create a new heap (at least 1 MB) and place the resource at its start
+    if (nodeIdx == UINT32_MAX)
+    {
+        const uint64_t heapSize = std::max(NextPow2(std::max<uint64_t>(1024 * 1024, size)), ioMinNewHeapSize);
+        ioMinNewHeapSize = 0;
+        nodeIdx = m_Heaps[CreateHeap(heapSize, frame)].m_FirstBlock;
+        alignedOffset = 0;
+    }
+
+    RemoveFree(nodeIdx);
+    const BlockNode block = m_Nodes[nodeIdx];
+    HeapEntry& heapEntry = m_Heaps[block.m_HeapIndex];
+
+    // Prefix block if needed. Neighbours of a free block are never free, so the leftovers don't merge with anything.
+    if (alignedOffset > block.m_Offset)
+    {
+        const uint32_t prefix = NewNode(BlockNode{ block.m_Offset, alignedOffset - block.m_Offset, block.m_HeapIndex, block.m_PrevPhysical, nodeIdx });
+        if (block.m_PrevPhysical != UINT32_MAX)
+            m_Nodes[block.m_PrevPhysical].m_NextPhysical = prefix;
+        else
+            heapEntry.m_FirstBlock = prefix;
+        m_Nodes[nodeIdx].m_PrevPhysical = prefix;
+        InsertFree(prefix);
+    }
+
+    // Suffix block if needed
+    const uint64_t blockEnd = block.m_Offset + block.m_Size;
+    if (alignedOffset + size < blockEnd)
+    {
+        const uint32_t suffix = NewNode(BlockNode{ alignedOffset + size, blockEnd - (alignedOffset + size), block.m_HeapIndex, nodeIdx, block.m_NextPhysical });
+        if (block.m_NextPhysical != UINT32_MAX)
+            m_Nodes[block.m_NextPhysical].m_PrevPhysical = suffix;
+        m_Nodes[nodeIdx].m_NextPhysical = suffix;
+        InsertFree(suffix);
+    }
+
+    BlockNode& node = m_Nodes[nodeIdx];
+    node.m_Offset = alignedOffset;
+    node.m_Size = size;
+
+    heapEntry.m_FreeSize -= size;
+    heapEntry.m_UsedBlocks[alignedOffset] = nodeIdx;
+    heapEntry.m_LastFrameUsed = frame;
+    outHeapIdx = block.m_HeapIndex;
+    outOffset = alignedOffset;
+}
+
+void HeapAllocator::Free(uint32_t heapIdx, uint64_t blockOffset)
+{
+    if (heapIdx >= m_Heaps.size()) return;
+
+    HeapEntry& heapEntry = m_Heaps[heapIdx];
+    const auto it = heapEntry.m_UsedBlocks.find(blockOffset);
+    if (it == heapEntry.m_UsedBlocks.end()) return;
+
+    uint32_t nodeIdx = it->second;
+    heapEntry.m_UsedBlocks.erase(it);
+    heapEntry.m_FreeSize += m_Nodes[nodeIdx].m_Size;
+
+    // Coalesce with next block if free
+    const uint32_t next = m_Nodes[nodeIdx].m_NextPhysical;
+    if (next != UINT32_MAX && m_Nodes[next].m_IsFree)
+    {
+        RemoveFree(next);
+        BlockNode& node = m_Nodes[nodeIdx];
+        node.m_Size += m_Nodes[next].m_Size;
+        node.m_NextPhysical = m_Nodes[next].m_NextPhysical;
+        if (node.m_NextPhysical != UINT32_MAX)
+            m_Nodes[node.m_NextPhysical].m_PrevPhysical = nodeIdx;
+        RecycleNode(next);
+    }
+
+    // Coalesce with previous block if free
+    const uint32_t prev = m_Nodes[nodeIdx].m_PrevPhysical;
+    if (prev != UINT32_MAX && m_Nodes[prev].m_IsFree)
+    {
+        RemoveFree(prev);
+        BlockNode& prevNode = m_Nodes[prev];
+        prevNode.m_Size += m_Nodes[nodeIdx].m_Size;
+        prevNode.m_NextPhysical = m_Nodes[nodeIdx].m_NextPhysical;
+        if (prevNode.m_NextPhysical != UINT32_MAX)
+            m_Nodes[prevNode.m_NextPhysical].m_PrevPhysical = prev;
+        RecycleNode(nodeIdx);
+        nodeIdx = prev;
+    }
+
+    InsertFree(nodeIdx);
+}
+
+void HeapAllocator::MarkUsed(uint32_t heapIdx, uint64_t frame)
+{
+    if (heapIdx < m_Heaps.size())
+        m_Heaps[heapIdx].m_LastFrameUsed = frame;
+}
+
+void HeapAllocator::ReleaseHeap(uint32_t heapIdx)
+{
+    HeapEntry& heapEntry = m_Heaps[heapIdx];
+    for (uint32_t nodeIdx = heapEntry.m_FirstBlock; nodeIdx != UINT32_MAX;)
+    {
+        const uint32_t next = m_Nodes[nodeIdx].m_NextPhysical;
+        if (m_Nodes[nodeIdx].m_IsFree)
+            RemoveFree(nodeIdx);
+        RecycleNode(nodeIdx);
+        nodeIdx = next;
+    }
+
+    heapEntry.m_Size = 0;
+    heapEntry.m_FreeSize = 0;
+    heapEntry.m_FirstBlock = UINT32_MAX;
+    heapEntry.m_UsedBlocks.clear();
+    m_Device.ReleaseHeap(heapIdx);
+}
+
+void HeapAllocator::ReleaseEmptyHeaps()
+{
+    for (uint32_t heapIdx = 0; heapIdx < m_Heaps.size(); ++heapIdx)
+    {
+        if (m_Heaps[heapIdx].IsLive() && m_Heaps[heapIdx].m_UsedBlocks.empty())
+            ReleaseHeap(heapIdx);
+    }
+}
+
+void HeapAllocator::ReleaseIdleHeaps(uint64_t frame, uint64_t maxIdleFrames)
+{
+    for (uint32_t heapIdx = 0; heapIdx < m_Heaps.size(); ++heapIdx)
+    {
+        if (m_Heaps[heapIdx].IsLive() && frame - m_Heaps[heapIdx].m_LastFrameUsed > maxIdleFrames)
+            ReleaseHeap(heapIdx);
+    }
+}
+
+void HeapAllocator::Clear()
+{
+    for (uint32_t heapIdx = 0; heapIdx < m_Heaps.size(); ++heapIdx)
+    {
+        if (m_Heaps[heapIdx].IsLive())
+            ReleaseHeap(heapIdx);
+    }
+    m_Heaps.clear();
+    m_Nodes.clear();
+    m_RecycledNodes.clear();
+}
+
+HeapAllocator::Usage HeapAllocator::GetUsage() const
+{
+    Usage usage;
+    for (const HeapEntry& heapEntry : m_Heaps)
+    {
+        if (!heapEntry.IsLive())
+            continue;
+
+        usage.m_NumHeaps++;
+        usage.m_TotalSize += heapEntry.m_Size;
+        usage.m_FreeSize += heapEntry.m_FreeSize;
+    }
+
+    // The largest free block is in the highest non-empty size class
+    if (m_FLBitmap != 0)
+    {
+        const uint32_t fl = 63 - (uint32_t)std::countl_zero(m_FLBitmap);
+        const uint32_t sl = 31 - (uint32_t)std::countl_zero(m_SLBitmaps[fl]);
+        for (uint32_t nodeIdx = m_FreeLists[fl][sl]; nodeIdx != UINT32_MAX; nodeIdx = m_Nodes[nodeIdx].m_NextFree)
+            usage.m_LargestFreeBlock = std::max(usage.m_LargestFreeBlock, m_Nodes[nodeIdx].m_Size);
+    }
+    return usage;
+}
+
+std::vector<HeapBlock> HeapAllocator::GetBlocks(uint32_t heapIdx) const
+{
+    std::vector<HeapBlock> blocks;
+    if (heapIdx >= m_Heaps.size())
+        return blocks;
+
+    for (uint32_t nodeIdx = m_Heaps[heapIdx].m_FirstBlock; nodeIdx != UINT32_MAX; nodeIdx = m_Nodes[nodeIdx].m_NextPhysical)
+        blocks.push_back(HeapBlock{ m_Nodes[nodeIdx].m_Offset, m_Nodes[nodeIdx].m_Size, m_Nodes[nodeIdx].m_IsFree });
+    return blocks;
+}
+
+// ============================================================================
+// Aliasing & Allocation Planning
+// ============================================================================
+
+uint64_t FindAliasOffset(std::span<const AliasPlacement> placements, uint64_t regionBase, uint64_t regionSize,
+                         uint64_t size, uint64_t alignment, ResourceLifetime lifetime, uint64_t& outGapSize)
+{
+    // Only placements alive at the same time block memory; sweep them by offset and look at the gaps in between
+    std::vector<const AliasPlacement*> blockers;
+    for (const AliasPlacement& placement : placements)
+    {
+        if (placement.m_Lifetime.Overlaps(lifetime))
+        {
+            blockers.push_back(&placement);
+        }
+    }
+    std::sort(blockers.begin(), blockers.end(), [](const AliasPlacement* a, const AliasPlacement* b) { return a->m_Offset < b->m_Offset; });
+
+    alignment = std::max<uint64_t>(alignment, 1);
+    uint64_t bestOffset = UINT64_MAX;
+    uint64_t bestGapSize = UINT64_MAX;
+    auto tryGap = [&](uint64_t gapBegin, uint64_t gapEnd)
+    {
+        // Alignment applies to the heap offset, not the offset within the region
+        const uint64_t alignedOffset = ((regionBase + gapBegin + alignment - 1) / alignment) * alignment - regionBase;
+        if (alignedOffset + size <= gapEnd && gapEnd - gapBegin < bestGapSize)
+        {
+            bestOffset = alignedOffset;
+            bestGapSize = gapEnd - gapBegin;
+        }
+    };
+
+    uint64_t cursor = 0;
+    for (const AliasPlacement* blocker : blockers)
+    {
+        if (blocker->m_Offset > cursor)
+        {
+            tryGap(cursor, blocker->m_Offset);
+        }
+        cursor = std::max(cursor, blocker->m_Offset + blocker->m_Size);
+    }
+    if (cursor < regionSize)
+    {
+        tryGap(cursor, regionSize);
+    }
+
+    outGapSize = bestGapSize;
+    return bestOffset;
+}
+
+PlanStats PlanAllocations(HeapAllocator& heaps, std::vector<uint32_t> indices, uint32_t numSlots, const GetPlacementFunc& getPlacement,
+                          bool bAliasingEnabled, uint64_t frame, uint64_t& ioMinNewHeapSize, const OnPlacedFunc& onPlaced)
+{
+    std::sort(indices.begin(), indices.end(), [&getPlacement](uint32_t a, uint32_t b) {
+        const ResourcePlacement& resourceA = getPlacement(a);
+        const ResourcePlacement& resourceB = getPlacement(b);
+        if (resourceA.m_Lifetime.m_FirstPass != resourceB.m_Lifetime.m_FirstPass)
+            return resourceA.m_Lifetime.m_FirstPass < resourceB.m_Lifetime.m_FirstPass;
+        if (resourceA.m_MemReq.m_Size != resourceB.m_MemReq.m_Size)
+            return resourceA.m_MemReq.m_Size > resourceB.m_MemReq.m_Size;
+        return a < b;
+        });
+
+    // What has been placed in each physical owner's memory this frame, indexed by owner slot
+    std::vector<std::vector<AliasPlacement>> ownerPlacements(numSlots);
+
+    PlanStats stats;
+    for (uint32_t idx : indices)
+    {
+        ResourcePlacement& resource = getPlacement(idx);
+        const MemoryRequirements memReq = resource.m_MemReq;
+
+        PlacementDecision decision;
+        decision.m_Index = idx;
+        decision.m_bWasAllocated = resource.m_IsAllocated;
+
+        // Trivial reuse: an owner keeps its block. Non-owners (aliased resources) go through aliasing again every
+        // frame, since their owner may have moved or not be dead in time any more.
+        if (resource.m_IsAllocated && resource.m_IsPhysicalOwner && resource.m_HeapIndex != UINT32_MAX)
+        {
+            heaps.MarkUsed(resource.m_HeapIndex, frame);
+            resource.m_PhysicalLastPass = resource.m_Lifetime.m_LastPass;
+
+            decision.m_HeapIndex = resource.m_HeapIndex;
+            decision.m_Offset = resource.m_Offset;
+            decision.m_bKept = true;
+            onPlaced(decision);
+
+            stats.m_NumAllocated++;
+            stats.m_AllocatedMemory += memReq.m_Size;
+            continue;
+        }
+
+        uint32_t bestCandidateIdx = UINT32_MAX;
+        uint64_t bestRegionOffset = 0;
+        if (bAliasingEnabled && !resource.m_IsPersistent && !resource.m_bUsedOnAsyncCompute)
+        {
+            // Best fit over every dead owner: the smallest free gap (in bytes, among the resources already placed in
+            // that owner's memory with overlapping lifetimes) that takes this resource. Several small resources can
+            // share one large owner this way, instead of each needing an owner at least as large as itself.
+            uint64_t bestGapSize = UINT64_MAX;
+            for (uint32_t candidateIdx : indices)
+            {
+                if (candidateIdx == idx) break;
+                const ResourcePlacement& candidate = getPlacement(candidateIdx);
+                if (!candidate.m_IsAllocated || !candidate.m_IsPhysicalOwner || candidate.m_bUsedOnAsyncCompute)
+                    continue;
+                if (candidate.m_IsPersistent && !candidate.m_bDeadAfterLastPass)
+                    continue;
+
+                // The owner's own contents are live until its last pass
+                if (resource.m_Lifetime.m_FirstPass <= candidate.m_Lifetime.m_LastPass)
+                    continue;
+
+                std::vector<AliasPlacement>& placements = ownerPlacements[candidateIdx];
+                if (placements.empty())
+                {
+                    placements.push_back({ 0, candidate.m_MemReq.m_Size, candidate.m_Lifetime });
+                }
+
+                uint64_t gapSize = 0;
+                const uint64_t regionOffset = FindAliasOffset(placements, candidate.m_Offset, candidate.m_MemReq.m_Size,
+                                                              memReq.m_Size, memReq.m_Alignment, resource.m_Lifetime, gapSize);
+                if (regionOffset != UINT64_MAX && gapSize < bestGapSize)
+                {
+                    bestCandidateIdx = candidateIdx;
+                    bestRegionOffset = regionOffset;
+                    bestGapSize = gapSize;
+                }
+            }
+        }
+
+        uint64_t blockOffset = 0;
+        if (bestCandidateIdx != UINT32_MAX)
+        {
+            ResourcePlacement& candidate = getPlacement(bestCandidateIdx);
+            candidate.m_PhysicalLastPass = std::max(candidate.m_PhysicalLastPass, resource.m_Lifetime.m_LastPass);
+            ownerPlacements[bestCandidateIdx].push_back({ bestRegionOffset, memReq.m_Size, resource.m_Lifetime });
+
+            resource.m_AliasedFromIndex = bestCandidateIdx;
+            resource.m_IsAllocated = true;
+            resource.m_IsPhysicalOwner = false;
+
+            decision.m_HeapIndex = candidate.m_HeapIndex;
+            decision.m_Offset = candidate.m_Offset + bestRegionOffset;
+            blockOffset = candidate.m_BlockOffset;
+            stats.m_NumAliased++;
+        }
+        else
+        {
+            heaps.Allocate(memReq.m_Size, memReq.m_Alignment, frame, ioMinNewHeapSize, decision.m_HeapIndex, decision.m_Offset);
+
+            resource.m_AliasedFromIndex = UINT32_MAX;
+            resource.m_IsAllocated = true;
+            resource.m_IsPhysicalOwner = true;
+            resource.m_PhysicalLastPass = resource.m_Lifetime.m_LastPass;
+
+            blockOffset = decision.m_Offset;
+            stats.m_NumAllocated++;
+            stats.m_AllocatedMemory += memReq.m_Size;
+        }
+
+        onPlaced(decision);
+
+        resource.m_HeapIndex = decision.m_HeapIndex;
+        resource.m_Offset = decision.m_Offset;
+        resource.m_BlockOffset = blockOffset;
+    }
+    return stats;
+}
+
+// ============================================================================
+// Frame Dumps
+// ============================================================================
+
+static void WriteJsonString(std::ostream& stream, const std::string& text)
+{
+    stream << '"';
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            stream << '\\' << c;
+        else if ((unsigned char)c < 0x20)
+            stream << ' ';
+        else
+            stream << c;
+    }
+    stream << '"';
+}
+
+void WriteFrameDump(std::ostream& stream, std::span<const RecordedFrame> frames)
+{
+    stream << "{\n  \"frames\": [";
+    for (size_t frameIdx = 0; frameIdx < frames.size(); ++frameIdx)
+    {
+        const RecordedFrame& frame = frames[frameIdx];
+        stream << (frameIdx ? ",\n" : "\n") << "    { \"frame\": " << frame.m_FrameNumber
+               << ", \"aliasing\": " << (frame.m_bAliasingEnabled ? "true" : "false") << ", \"resources\": [";
+        for (size_t i = 0; i < frame.m_Resources.size(); ++i)
+        {
+            const RecordedResource& resource = frame.m_Resources[i];
+            stream << (i ? ",\n" : "\n") << "      { \"slot\": " << resource.m_Slot
+                   << ", \"buffer\": " << (resource.m_bIsBuffer ? "true" : "false") << ", \"name\": ";
+            WriteJsonString(stream, resource.m_Name);
+            stream << ", \"hash\": " << resource.m_DescHash
+                   << ", \"size\": " << resource.m_MemReq.m_Size << ", \"alignment\": " << resource.m_MemReq.m_Alignment
+                   << ", \"firstPass\": " << resource.m_Lifetime.m_FirstPass << ", \"lastPass\": " << resource.m_Lifetime.m_LastPass
+                   << ", \"persistent\": " << (resource.m_bPersistent ? "true" : "false")
+                   << ", \"asyncCompute\": " << (resource.m_bAsyncCompute ? "true" : "false") << " }";
+        }
+        stream << (frame.m_Resources.empty() ? "] }" : "\n    ] }");
+    }
+    stream << "\n  ]\n}\n";
+}
+
+namespace
+{
+
+// Just enough JSON for frame dumps: objects, arrays, strings, booleans and unsigned integers
+struct JsonValue
+{
+    enum class Type { Null, Bool, Number, String, Array, Object } m_Type = Type::Null;
+    bool m_Bool = false;
+    uint64_t m_Number = 0;
+    std::string m_String;
+    std::vector<JsonValue> m_Array;
+    std::map<std::string, JsonValue> m_Object;
+
+    const JsonValue* Find(const char* key) const
+    {
+        const auto it = m_Object.find(key);
+        return it != m_Object.end() ? &it->second : nullptr;
+    }
+};
+
+class JsonReader
+{
+public:
+    explicit JsonReader(std::string text) : m_Text(std::move(text)) {}
+
+    bool Parse(JsonValue& outValue, std::string& outError)
+    {
+        if (!ParseValue(outValue, 0))
+        {
+            outError = m_Error + " at offset " + std::to_string(m_Pos);
+            return false;
+        }
+        SkipWhitespace();
+        if (m_Pos != m_Text.size())
+        {
+            outError = "trailing characters at offset " + std::to_string(m_Pos);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    void SkipWhitespace()
+    {
+        while (m_Pos < m_Text.size() && (m_Text[m_Pos] == ' ' || m_Text[m_Pos] == '\t' || m_Text[m_Pos] == '\n' || m_Text[m_Pos] == '\r'))
+            ++m_Pos;
+    }
+
+    bool Fail(const char* error)
+    {
+        m_Error = error;
+        return false;
+    }
+
+    bool Consume(char c)
+    {
+        SkipWhitespace();
+        if (m_Pos < m_Text.size() && m_Text[m_Pos] == c)
+        {
+            ++m_Pos;
+            return true;
+        }
+        return false;
+    }
+
+    bool ParseString(std::string& outString)
+    {
+        if (!Consume('"'))
+            return Fail("expected string");
+        outString.clear();
+        while (m_Pos < m_Text.size() && m_Text[m_Pos] != '"')
+        {
+            if (m_Text[m_Pos] == '\\' && m_Pos + 1 < m_Text.size())
+                ++m_Pos;
+            outString += m_Text[m_Pos++];
+        }
+        if (m_Pos == m_Text.size())
+            return Fail("unterminated string");
+        ++m_Pos;
+        return true;
+    }
+
+    bool ParseValue(JsonValue& outValue, uint32_t depth)
+    {
+        if (depth > 16)
+            return Fail("nested too deeply");
+
+        SkipWhitespace();
+        if (m_Pos == m_Text.size())
+            return Fail("unexpected end of input");
+
+        const char c = m_Text[m_Pos];
+        if (c == '{')
+        {
+            ++m_Pos;
+            outValue.m_Type = JsonValue::Type::Object;
+            if (Consume('}'))
+                return true;
+            do
+            {
+                std::string key;
+                if (!ParseString(key))
+                    return false;
+                if (!Consume(':'))
+                    return Fail("expected ':'");
+                if (!ParseValue(outValue.m_Object[key], depth + 1))
+                    return false;
+            } while (Consume(','));
+            return Consume('}') || Fail("expected '}'");
+        }
+        if (c == '[')
+        {
+            ++m_Pos;
+            outValue.m_Type = JsonValue::Type::Array;
+            if (Consume(']'))
+                return true;
+            do
+            {
+                outValue.m_Array.emplace_back();
+                if (!ParseValue(outValue.m_Array.back(), depth + 1))
+                    return false;
+            } while (Consume(','));
+            return Consume(']') || Fail("expected ']'");
+        }
+        if (c == '"')
+        {
+            outValue.m_Type = JsonValue::Type::String;
+            return ParseString(outValue.m_String);
+        }
+        if (m_Text.compare(m_Pos, 4, "true") == 0 || m_Text.compare(m_Pos, 5, "false") == 0)
+        {
+            outValue.m_Type = JsonValue::Type::Bool;
+            outValue.m_Bool = m_Text[m_Pos] == 't';
+            m_Pos += outValue.m_Bool ? 4 : 5;
+            return true;
+        }
+        if (m_Text.compare(m_Pos, 4, "null") == 0)
+        {
+            m_Pos += 4;
+            return true;
+        }
+        if (c >= '0' && c <= '9')
+        {
+            outValue.m_Type = JsonValue::Type::Number;
+            while (m_Pos < m_Text.size() && m_Text[m_Pos] >= '0' && m_Text[m_Pos] <= '9')
+                outValue.m_Number = outValue.m_Number * 10 + uint64_t(m_Text[m_Pos++] - '0');
+            return true;
+        }
+        return Fail("unexpected character");
+    }
+
+    std::string m_Text;
+    size_t m_Pos = 0;
+    std::string m_Error;
+};
+
+uint64_t GetNumber(const JsonValue& object, const char* key)
+{
+    const JsonValue* value = object.Find(key);
+    return value && value->m_Type == JsonValue::Type::Number ? value->m_Number : 0;
+}
+
+bool GetBool(const JsonValue& object, const char* key, bool bDefault)
+{
+    const JsonValue* value = object.Find(key);
+    return value && value->m_Type == JsonValue::Type::Bool ? value->m_Bool : bDefault;
+}
+
+} // namespace
+
+bool ReadFrameDump(std::istream& stream, std::vector<RecordedFrame>& outFrames, std::string& outError)
+{
+    const std::string text{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+
+    JsonValue root;
+    if (!JsonReader(text).Parse(root, outError))
+        return false;
+
+    const JsonValue* frames = root.Find("frames");
+    if (!frames || frames->m_Type != JsonValue::Type::Array)
+    {
+        outError = "no \"frames\" array";
+        return false;
+    }
+
+    outFrames.clear();
+    for (const JsonValue& frameValue : frames->m_Array)
+    {
+        const JsonValue* resources = frameValue.Find("resources");
+        if (!resources || resources->m_Type != JsonValue::Type::Array)
+        {
+            outError = "frame without a \"resources\" array";
+            return false;
+        }
+
+        RecordedFrame& frame = outFrames.emplace_back();
+        frame.m_FrameNumber = GetNumber(frameValue, "frame");
+        frame.m_bAliasingEnabled = GetBool(frameValue, "aliasing", true);
+        for (const JsonValue& resourceValue : resources->m_Array)
+        {
+            RecordedResource& resource = frame.m_Resources.emplace_back();
+            resource.m_Slot = (uint32_t)GetNumber(resourceValue, "slot");
+            resource.m_bIsBuffer = GetBool(resourceValue, "buffer", false);
+            if (const JsonValue* name = resourceValue.Find("name"))
+                resource.m_Name = name->m_String;
+            resource.m_DescHash = GetNumber(resourceValue, "hash");
+            resource.m_MemReq.m_Size = GetNumber(resourceValue, "size");
+            resource.m_MemReq.m_Alignment = GetNumber(resourceValue, "alignment");
+            resource.m_Lifetime.m_FirstPass = (uint16_t)GetNumber(resourceValue, "firstPass");
+            resource.m_Lifetime.m_LastPass = (uint16_t)GetNumber(resourceValue, "lastPass");
+            resource.m_bPersistent = GetBool(resourceValue, "persistent", false);
+            resource.m_bAsyncCompute = GetBool(resourceValue, "asyncCompute", false);
+
+            if (resource.m_MemReq.m_Size == 0 || !resource.m_Lifetime.IsValid() || resource.m_Lifetime.m_FirstPass > resource.m_Lifetime.m_LastPass)
+            {
+                outError = "resource '" + resource.m_Name + "' has no size or lifetime";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// AllocationSimulator
+// ============================================================================
+
+AllocationSimulator::FrameResult AllocationSimulator::SimulateFrame(const RecordedFrame& frame)
+{
+    FrameResult result;
+    const uint64_t frameNumber = frame.m_FrameNumber;
+
+    // RenderGraph::Reset(): per-frame state goes, placements unused for too long are evicted
+    for (std::vector<SimulatedSlot>& slots : m_Slots)
+    {
+        for (SimulatedSlot& slot : slots)
+        {
+            slot.m_bDeclared = false;
+            slot.m_Lifetime = {};
+            slot.m_AliasedFromIndex = UINT32_MAX;
+            slot.m_PhysicalLastPass = 0;
+            slot.m_bUsedOnAsyncCompute = false;
+
+            if (slot.m_IsAllocated && frameNumber - slot.m_LastFrameUsed > kMaxTransientResourceLifetimeFrames)
+            {
+                if (slot.m_IsPhysicalOwner)
+                    m_Heaps.Free(slot.m_HeapIndex, slot.m_BlockOffset);
+                slot.m_HeapIndex = UINT32_MAX;
+                slot.m_IsAllocated = false;
+                slot.m_IsPhysicalOwner = false;
+            }
+        }
+    }
+    m_Heaps.ReleaseIdleHeaps(frameNumber, kMaxTransientResourceLifetimeFrames);
+
+    // Declarations: a slot whose desc changed gives up its block
+    std::vector<uint32_t> indices[2];
+    for (const RecordedResource& resource : frame.m_Resources)
+    {
+        std::vector<SimulatedSlot>& slots = m_Slots[resource.m_bIsBuffer];
+        if (resource.m_Slot >= slots.size())
+            slots.resize(resource.m_Slot + 1);
+
+        SimulatedSlot& slot = slots[resource.m_Slot];
+        if (slot.m_bKnown && slot.m_DescHash != resource.m_DescHash && slot.m_IsAllocated)
+        {
+            if (slot.m_IsPhysicalOwner && slot.m_HeapIndex != UINT32_MAX)
+                m_Heaps.Free(slot.m_HeapIndex, slot.m_BlockOffset);
+            slot.m_HeapIndex = UINT32_MAX;
+            slot.m_IsAllocated = false;
+            slot.m_IsPhysicalOwner = false;
+        }
+
+        slot.m_bKnown = true;
+        slot.m_bDeclared = true;
+        slot.m_DescHash = resource.m_DescHash;
+        slot.m_LastFrameUsed = frameNumber;
+        slot.m_MemReq = resource.m_MemReq;
+        slot.m_Lifetime = resource.m_Lifetime;
+        slot.m_IsPersistent = resource.m_bPersistent;
+        slot.m_bUsedOnAsyncCompute = resource.m_bAsyncCompute;
+        indices[resource.m_bIsBuffer].push_back(resource.m_Slot);
+    }
+
+    // Peak live transient memory, as in RenderGraph::UpdateTransientMemoryStats()
+    std::map<uint16_t, int64_t> liveBytesDelta;
+    for (const RecordedResource& resource : frame.m_Resources)
+    {
+        if (resource.m_bPersistent)
+            continue;
+        liveBytesDelta[resource.m_Lifetime.m_FirstPass] += (int64_t)resource.m_MemReq.m_Size;
+        liveBytesDelta[resource.m_Lifetime.m_LastPass + 1] -= (int64_t)resource.m_MemReq.m_Size;
+    }
+    int64_t liveBytes = 0;
+    for (const auto& [pass, delta] : liveBytesDelta)
+    {
+        liveBytes += delta;
+        result.m_PeakLiveMemory = std::max(result.m_PeakLiveMemory, (uint64_t)liveBytes);
+    }
+
+    // Compile(): textures, then buffers
+    const auto planStart = std::chrono::steady_clock::now();
+    uint64_t minNewHeapSize = 0;
+    for (uint32_t type = 0; type < 2; ++type)
+    {
+        std::vector<SimulatedSlot>& slots = m_Slots[type];
+        const PlanStats stats = PlanAllocations(m_Heaps, indices[type], (uint32_t)slots.size(),
+                                                [&slots](uint32_t idx) -> ResourcePlacement& { return slots[idx]; },
+                                                frame.m_bAliasingEnabled, frameNumber, minNewHeapSize, [](const PlacementDecision&) {});
+        (type ? result.m_Buffers : result.m_Textures) = stats;
+    }
+    result.m_PlanTimeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - planStart).count();
+
+    result.m_Heaps = m_Heaps.GetUsage();
+    return result;
+}
+
+} // namespace RenderGraphInternal
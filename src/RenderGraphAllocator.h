@@ -0,0 +1,289 @@
+#pragma once
+
+// Device-independent half of the render graph's transient memory management: the heap block model, the aliasing and
+// allocation planner, and the frame dump the offline simulator (RenderGraphSim/) replays. RenderGraph drives it
+// against nvrhi heaps; nothing in here touches nvrhi or SDL, so it also builds on its own, outside the renderer.
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RenderGraphInternal
+{
+
+struct ResourceLifetime
+{
+    uint16_t m_FirstPass = UINT16_MAX;
+    uint16_t m_LastPass = 0;
+
+    bool IsValid() const { return m_FirstPass != UINT16_MAX; }
+    bool Overlaps(const ResourceLifetime& other) const
+    {
+        if (!IsValid() || !other.IsValid())
+            return false;
+        return !(m_LastPass < other.m_FirstPass || other.m_LastPass < m_FirstPass);
+    }
+};
+
+// A resource placed inside a physical owner's memory: byte range relative to the owner's offset, and the passes it is alive
+struct AliasPlacement
+{
+    uint64_t m_Offset = 0;
+    uint64_t m_Size = 0;
+    ResourceLifetime m_Lifetime;
+};
+
+struct MemoryRequirements
+{
+    uint64_t m_Size = 0;
+    uint64_t m_Alignment = 0;
+};
+
+// Where a transient resource slot lives in the heaps. Kept across frames: a physical owner stays put until its desc
+// changes, it is evicted or the heaps are compacted.
+struct ResourcePlacement
+{
+    ResourceLifetime m_Lifetime;
+    MemoryRequirements m_MemReq; // queried once per frame by Compile()
+    uint32_t m_AliasedFromIndex = UINT32_MAX;
+    uint16_t m_PhysicalLastPass = 0;
+    uint64_t m_Offset = 0;
+    uint64_t m_BlockOffset = 0;
+    uint32_t m_HeapIndex = UINT32_MAX;
+    bool m_IsAllocated = false;
+    bool m_IsPersistent = false;
+    bool m_bDeadAfterLastPass = false; // persistent, but nothing it holds is needed past its last pass this frame
+    bool m_IsPhysicalOwner = false;
+    bool m_bUsedOnAsyncCompute = false; // accessed by a pass on the compute queue this frame, so never aliased
+};
+
+// ============================================================================
+// Heaps
+// ============================================================================
+
+// Backing memory for HeapAllocator's heaps. RenderGraph creates nvrhi heaps; the simulator has nothing to back.
+class IHeapDevice
+{
+public:
+    virtual ~IHeapDevice() = default;
+
+    // Heap slots are reused once released, so 'heapIdx' may name a slot that held an earlier heap
+    virtual void CreateHeap(uint32_t heapIdx, uint64_t size) = 0;
+    virtual void ReleaseHeap(uint32_t heapIdx) = 0;
+};
+
+struct HeapBlock
+{
+    uint64_t m_Offset = 0;
+    uint64_t m_Size = 0;
+    bool m_IsFree = true;
+};
+
+struct HeapEntry
+{
+    uint64_t m_Size = 0; // 0 = released slot
+    uint64_t m_LastFrameUsed = 0;
+    uint64_t m_FreeSize = 0;
+    uint32_t m_FirstBlock = UINT32_MAX; // HeapAllocator node at offset 0; the rest follow by offset
+    std::unordered_map<uint64_t, uint32_t> m_UsedBlocks; // block offset -> node, for Free()
+
+    bool IsLive() const { return m_Size != 0; }
+};
+
+// Block lists for the transient heaps, with a two-level segregated-fit (TLSF) index over the free blocks of every heap:
+// a first level per power of two, 2^kSLBits linear subdivisions below it, and a bitmap over each level so finding a
+// non-empty size class is a couple of bit scans. Allocation takes the smallest class guaranteed to fit and splits the
+// block; freeing merges with free neighbours. Heaps keep their index for as long as they live, released ones leave an
+// empty slot behind.
+class HeapAllocator
+{
+public:
+    struct Usage
+    {
+        uint32_t m_NumHeaps = 0;
+        uint64_t m_TotalSize = 0;
+        uint64_t m_FreeSize = 0;
+        uint64_t m_LargestFreeBlock = 0;
+
+        // Share of the free memory outside the largest free block (0 = every free byte is in one block)
+        float GetFragmentationPercent() const { return m_FreeSize > 0 ? 100.0f * float(m_FreeSize - m_LargestFreeBlock) / float(m_FreeSize) : 0.0f; }
+    };
+
+    explicit HeapAllocator(IHeapDevice& device);
+
+    uint32_t CreateHeap(uint64_t size, uint64_t frame);
+
+    // Good fit over the free blocks of every live heap. When nothing fits, creates a heap of max(1 MB, size) rounded up
+    // to a power of two, or ioMinNewHeapSize if that is larger (which is then consumed).
+    void Allocate(uint64_t size, uint64_t alignment, uint64_t frame, uint64_t& ioMinNewHeapSize, uint32_t& outHeapIdx, uint64_t& outOffset);
+    void Free(uint32_t heapIdx, uint64_t blockOffset);
+
+    void MarkUsed(uint32_t heapIdx, uint64_t frame);
+    void ReleaseEmptyHeaps();
+    // Heaps nothing was placed in for more than 'maxIdleFrames' frames
+    void ReleaseIdleHeaps(uint64_t frame, uint64_t maxIdleFrames);
+    void Clear();
+
+    Usage GetUsage() const;
+    const std::vector<HeapEntry>& GetHeaps() const { return m_Heaps; }
+    // A heap's blocks sorted by offset, covering the whole heap (empty for a released slot). Walks the heap: for UI and tests.
+    std::vector<HeapBlock> GetBlocks(uint32_t heapIdx) const;
+
+private:
+    static constexpr uint32_t kSLBits = 4;
+    static constexpr uint32_t kSLCount = 1u << kSLBits;
+    static constexpr uint32_t kFLCount = 64;
+
+    struct BlockNode
+    {
+        uint64_t m_Offset = 0;
+        uint64_t m_Size = 0;
+        uint32_t m_HeapIndex = UINT32_MAX;
+        uint32_t m_PrevPhysical = UINT32_MAX;
+        uint32_t m_NextPhysical = UINT32_MAX;
+        uint32_t m_PrevFree = UINT32_MAX; // free-list links within the block's size class
+        uint32_t m_NextFree = UINT32_MAX;
+        bool m_IsFree = false;
+    };
+
+    static void MapSize(uint64_t size, uint32_t& outFL, uint32_t& outSL);
+    // First non-empty size class at or above (fl, sl); false if there is none
+    bool FindFreeClass(uint32_t& ioFL, uint32_t& ioSL) const;
+    // A free block that holds 'size' bytes at 'alignment', or UINT32_MAX
+    uint32_t FindFreeBlock(uint64_t size, uint64_t alignment, uint64_t& outAlignedOffset) const;
+
+    uint32_t NewNode(const BlockNode& node);
+    void RecycleNode(uint32_t nodeIdx);
+    void InsertFree(uint32_t nodeIdx);
+    void RemoveFree(uint32_t nodeIdx);
+    void ReleaseHeap(uint32_t heapIdx);
+
+    IHeapDevice& m_Device;
+    std::vector<HeapEntry> m_Heaps;
+
+    std::vector<BlockNode> m_Nodes;
+    std::vector<uint32_t> m_RecycledNodes;
+    uint64_t m_FLBitmap = 0;
+    uint32_t m_SLBitmaps[kFLCount] = {};
+    uint32_t m_FreeLists[kFLCount][kSLCount]; // head node of each size class
+};
+
+// ============================================================================
+// Aliasing & Allocation Planning
+// ============================================================================
+
+// Best-fit offset (relative to regionBase) for a resource of 'size' bytes alive over 'lifetime' inside a dead owner's
+// region, given what is already placed there: the smallest free gap among placements whose lifetimes overlap.
+// Returns UINT64_MAX if it doesn't fit; outGapSize receives the size of the gap it lands in.
+uint64_t FindAliasOffset(std::span<const AliasPlacement> placements, uint64_t regionBase, uint64_t regionSize,
+                         uint64_t size, uint64_t alignment, ResourceLifetime lifetime, uint64_t& outGapSize);
+
+// One decision of PlanAllocations(). Reported after the resource's ownership fields are updated but before its
+// m_HeapIndex / m_Offset / m_BlockOffset, so the caller can still see where it was.
+struct PlacementDecision
+{
+    uint32_t m_Index = UINT32_MAX;
+    uint32_t m_HeapIndex = UINT32_MAX;
+    uint64_t m_Offset = 0;
+    bool m_bKept = false;        // physical owner staying where it was: nothing to bind
+    bool m_bWasAllocated = false; // had a placement going into this frame
+};
+
+struct PlanStats
+{
+    uint32_t m_NumAllocated = 0;
+    uint32_t m_NumAliased = 0;
+    uint64_t m_AllocatedMemory = 0;
+};
+
+using GetPlacementFunc = std::function<ResourcePlacement&(uint32_t)>;
+using OnPlacedFunc = std::function<void(const PlacementDecision&)>;
+
+// Places one resource type's slots for this frame. 'indices' are the slots declared this frame with a valid lifetime
+// and their m_MemReq filled in; 'numSlots' bounds the slot indices.
+// Slots are visited by first pass (a resource can only alias an owner placed before it), larger first within a pass so
+// big resources claim dead owners' memory before small ones fragment it. Owners already placed stay where they are.
+// With aliasing, a non-persistent resource outside async compute goes to the best-fit gap over every owner that is
+// dead by its first pass; otherwise it becomes an owner and gets a heap block of its own. Persistent owners only take
+// aliases when m_bDeadAfterLastPass says their contents don't have to outlive the frame.
+PlanStats PlanAllocations(HeapAllocator& heaps, std::vector<uint32_t> indices, uint32_t numSlots, const GetPlacementFunc& getPlacement,
+                          bool bAliasingEnabled, uint64_t frame, uint64_t& ioMinNewHeapSize, const OnPlacedFunc& onPlaced);
+
+// ============================================================================
+// Frame Dumps
+// ============================================================================
+
+// A heap-placed resource as the allocator saw it in one recorded frame
+struct RecordedResource
+{
+    uint32_t m_Slot = UINT32_MAX;
+    bool m_bIsBuffer = false;
+    std::string m_Name;
+    uint64_t m_DescHash = 0;
+    MemoryRequirements m_MemReq;
+    ResourceLifetime m_Lifetime;
+    bool m_bPersistent = false;
+    bool m_bAsyncCompute = false;
+};
+
+struct RecordedFrame
+{
+    uint64_t m_FrameNumber = 0;
+    bool m_bAliasingEnabled = true;
+    std::vector<RecordedResource> m_Resources;
+};
+
+// JSON: { "frames": [ { "frame", "aliasing", "resources": [ { "slot", "buffer", "name", "hash", "size", "alignment",
+// "firstPass", "lastPass", "persistent", "asyncCompute" } ] } ] }
+void WriteFrameDump(std::ostream& stream, std::span<const RecordedFrame> frames);
+// Returns false (with a message in outError) if the stream isn't a frame dump
+bool ReadFrameDump(std::istream& stream, std::vector<RecordedFrame>& outFrames, std::string& outError);
+
+// Replays recorded frames through HeapAllocator and PlanAllocations() the way RenderGraph runs them: slots keep their
+// placement across frames, a desc change frees the owner's block, slots and heaps unused for a few frames are evicted.
+// Not modelled: heap compaction, and resources whose passes were culled (they aren't recorded).
+class AllocationSimulator
+{
+public:
+    struct FrameResult
+    {
+        PlanStats m_Textures;
+        PlanStats m_Buffers;
+        HeapAllocator::Usage m_Heaps; // after allocation
+        uint64_t m_PeakLiveMemory = 0; // most transient memory alive at any one pass: lower bound for any packing
+        double m_PlanTimeMs = 0.0;
+    };
+
+    // Same as RenderGraph::Reset()
+    static constexpr uint64_t kMaxTransientResourceLifetimeFrames = 3;
+
+    AllocationSimulator() : m_Heaps(m_Device) {}
+
+    FrameResult SimulateFrame(const RecordedFrame& frame);
+    const HeapAllocator& GetHeaps() const { return m_Heaps; }
+
+private:
+    class NullHeapDevice : public IHeapDevice
+    {
+    public:
+        void CreateHeap(uint32_t, uint64_t) override {}
+        void ReleaseHeap(uint32_t) override {}
+    };
+
+    struct SimulatedSlot : public ResourcePlacement
+    {
+        uint64_t m_DescHash = 0;
+        uint64_t m_LastFrameUsed = 0;
+        bool m_bDeclared = false;
+        bool m_bKnown = false;
+    };
+
+    NullHeapDevice m_Device;
+    HeapAllocator m_Heaps;
+    std::vector<SimulatedSlot> m_Slots[2]; // textures, buffers
+};
+
+} // namespace RenderGraphInternal
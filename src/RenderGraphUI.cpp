@@ -4,6 +4,46 @@
 
 using namespace RenderGraphInternal;
 
+// " (mips 1-3, slices 0-5)" style suffix for an access or transition covering part of a texture, empty for the whole
+static std::string GetSubresourceRangeString(const nvrhi::TextureSubresourceSet& subresources, const nvrhi::TextureDesc& desc)
+{
+    const nvrhi::TextureSubresourceSet resolved = subresources.resolve(desc, false);
+    if (resolved.isEntireTexture(desc))
+        return {};
+
+    std::stringstream ss;
+    ss << " (mips " << resolved.baseMipLevel << "-" << resolved.baseMipLevel + resolved.numMipLevels - 1;
+    if (desc.arraySize > 1)
+        ss << ", slices " << resolved.baseArraySlice << "-" << resolved.baseArraySlice + resolved.numArraySlices - 1;
+    ss << ")";
+    return ss.str();
+}
+
+// Names for the single states the barrier plan uses; combined masks (e.g. initial states) fall back to hex
+static std::string GetResourceStateName(nvrhi::ResourceStates state)
+{
+    switch (state)
+    {
+    case nvrhi::ResourceStates::Unknown:          return "Unknown";
+    case nvrhi::ResourceStates::Common:           return "Common";
+    case nvrhi::ResourceStates::ShaderResource:   return "ShaderResource";
+    case nvrhi::ResourceStates::UnorderedAccess:  return "UnorderedAccess";
+    case nvrhi::ResourceStates::RenderTarget:     return "RenderTarget";
+    case nvrhi::ResourceStates::DepthWrite:       return "DepthWrite";
+    case nvrhi::ResourceStates::DepthRead:        return "DepthRead";
+    case nvrhi::ResourceStates::CopyDest:         return "CopyDest";
+    case nvrhi::ResourceStates::CopySource:       return "CopySource";
+    case nvrhi::ResourceStates::IndexBuffer:      return "IndexBuffer";
+    case nvrhi::ResourceStates::IndirectArgument: return "IndirectArgument";
+    default:
+    {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "0x%x", (uint32_t)state);
+        return buffer;
+    }
+    }
+}
+
 void RenderGraph::RenderDebugUI()
 {
     nvrhi::IDevice* device = g_Renderer.m_RHI->m_NvrhiDevice.Get();
@@ -20,6 +60,16 @@ void RenderGraph::RenderDebugUI()
         {
             ImGui::SetClipboardText(ExportToString().c_str());
         }
+        ImGui::SameLine();
+        if (IsCapturingAllocations())
+        {
+            ImGui::Text("Capturing allocations...");
+        }
+        else if (ImGui::Button("Capture Allocations"))
+        {
+            // Replay with RenderGraphSim
+            BeginAllocationCapture("rendergraph_frames.json", 300);
+        }
         
         ImGui::Text("Textures: %u (Allocated: %u, Aliased: %u)", 
                    m_Stats.m_NumTextures, 
@@ -37,6 +87,50 @@ void RenderGraph::RenderDebugUI()
         ImGui::Text("Buffer Memory: %.2f MB", 
                    m_Stats.m_TotalBufferMemory / (1024.0 * 1024.0));
         
+        ImGui::Text("Transient Memory: %.2f MB -> %.2f MB aliased (peak live: %.2f MB)", 
+                   m_Stats.m_TransientMemoryUnaliased / (1024.0 * 1024.0),
+                   m_Stats.m_TransientMemoryAliased / (1024.0 * 1024.0),
+                   m_Stats.m_TransientMemoryPeakLive / (1024.0 * 1024.0));
+        
+        ImGui::Text("Compile Cache: %llu hits, %llu misses (this frame: %s)", 
+                   (unsigned long long)m_CompileCacheHits,
+                   (unsigned long long)m_CompileCacheMisses,
+                   m_Stats.m_bCompiledFromCache ? "hit" : "miss");
+        
+        ImGui::Text("Parallel Setup: %llu frames, %llu serial fallbacks (%llu Setup()s re-run)", 
+                   (unsigned long long)m_ParallelSetupCount,
+                   (unsigned long long)m_SerialSetupFallbackCount,
+                   (unsigned long long)m_SetupRerunCount);
+        
+        ImGui::Text("Culled Passes: %u", m_Stats.m_NumCulledPasses);
+        
+        ImGui::Text("Async Compute: %u passes, %u cross-queue syncs (%llu passes recorded since startup)", 
+                   m_Stats.m_NumAsyncComputePasses,
+                   m_Stats.m_NumQueueSyncPoints,
+                   (unsigned long long)m_AsyncComputePassesRecorded);
+        
+        ImGui::Text("Command Lists: %u for %u passes", 
+                   m_Stats.m_NumPassCommandLists,
+                   m_Stats.m_NumRecordedPasses);
+        
+        ImGui::Text("State Transitions: %u in %u batches (%u splittable)", 
+                   m_Stats.m_NumStateTransitions,
+                   m_Stats.m_NumBarrierBatches,
+                   m_Stats.m_NumSplitTransitions);
+        
+        ImGui::Text("Buffer Pools: %u buffers in %u pools (%.2f KB)", 
+                   m_Stats.m_NumSuballocatedBuffers,
+                   m_Stats.m_NumBufferPools,
+                   m_Stats.m_BufferPoolMemory / 1024.0);
+        
+        ImGui::Text("Heaps: %u, %.2f MB (%.2f MB free, %.1f%% fragmented), %llu compactions%s", 
+                   m_Stats.m_NumHeaps,
+                   m_Stats.m_TotalHeapMemory / (1024.0 * 1024.0),
+                   m_Stats.m_FreeHeapMemory / (1024.0 * 1024.0),
+                   m_Stats.m_HeapFragmentationPercent,
+                   (unsigned long long)m_HeapCompactionCount,
+                   m_Stats.m_bHeapsCompacted ? " (compacted this frame)" : "");
+        
         if (ImGui::TreeNode("Lifetime Visualization"))
         {
             visFilter.Draw("Filter Resources");
@@ -351,6 +445,11 @@ void RenderGraph::RenderDebugUI()
 
                         ImGui::TableNextColumn();
                         bool nodeOpen = ImGui::TreeNodeEx(passName, ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_FramePadding);
+                        if (GetPassQueue((uint16_t)i) == nvrhi::CommandQueue::Compute)
+                        {
+                            ImGui::SameLine();
+                            ImGui::TextDisabled("[async compute]");
+                        }
                         
                         ImGui::TableNextColumn();
                         ImGui::Text("T: %zu/%zu, B: %zu/%zu", 
@@ -365,14 +464,15 @@ void RenderGraph::RenderDebugUI()
 
                         ImGui::TableNextColumn();
                         int numBarriers = (i < m_PerPassAliasBarriers.size()) ? (int)m_PerPassAliasBarriers[i].size() : 0;
-                        if (numBarriers > 0) ImGui::Text("%d barriers", numBarriers);
+                        if (access.m_bCulled) ImGui::TextDisabled("culled");
+                        else if (numBarriers > 0) ImGui::Text("%d barriers", numBarriers);
                         else ImGui::Text("-");
 
                         if (nodeOpen)
                         {
                             if (ImGui::TreeNodeEx("Resource Accesses", ImGuiTreeNodeFlags_DefaultOpen))
                             {
-                                auto listAccesses = [&](const std::unordered_set<uint32_t>& indices, bool isBuffer, const char* mode, ImVec4 color) {
+                                auto listAccesses = [&](const std::vector<uint32_t>& indices, bool isBuffer, const char* mode, ImVec4 color) {
                                     if (indices.empty()) return;
                                     ImGui::TextColored(color, "%s %s:", mode, isBuffer ? "Buffers" : "Textures");
                                     for (uint32_t idx : indices) {
@@ -416,10 +516,11 @@ void RenderGraph::RenderDebugUI()
         if (ImGui::TreeNode("Heaps"))
         {
             heapFilter.Draw("Filter Heaps/Resources");
-            for (size_t i = 0; i < m_Heaps.size(); ++i)
+            const std::vector<HeapEntry>& heaps = m_HeapAllocator.GetHeaps();
+            for (size_t i = 0; i < heaps.size(); ++i)
             {
-                const HeapEntry& heap = m_Heaps[i];
-                if (!heap.m_Heap) continue;
+                const HeapEntry& heap = heaps[i];
+                if (!heap.IsLive()) continue;
 
                 if (ImGui::TreeNode((void*)(intptr_t)i, "Heap %zu (%.2f MB)", i, heap.m_Size / (1024.0 * 1024.0)))
                 {
@@ -430,7 +531,7 @@ void RenderGraph::RenderDebugUI()
                         ImGui::TableSetupColumn("Status");
                         ImGui::TableSetupColumn("Resource");
                         ImGui::TableHeadersRow();
-                        for (const HeapBlock& block : heap.m_Blocks)
+                        for (const HeapBlock& block : m_HeapAllocator.GetBlocks((uint32_t)i))
                         {
                             const char* resourceName = "-";
                             if (!block.m_IsFree)
@@ -492,21 +593,46 @@ std::string RenderGraph::ExportToString() const
     ss << "- Textures: " << m_Stats.m_NumTextures << " (Allocated: " << m_Stats.m_NumAllocatedTextures << ", Aliased: " << m_Stats.m_NumAliasedTextures << ")\n";
     ss << "- Buffers: " << m_Stats.m_NumBuffers << " (Allocated: " << m_Stats.m_NumAllocatedBuffers << ", Aliased: " << m_Stats.m_NumAliasedBuffers << ")\n";
     ss << "- Texture Memory: " << m_Stats.m_TotalTextureMemory / (1024.0 * 1024.0) << " MB\n";
-    ss << "- Buffer Memory: " << m_Stats.m_TotalBufferMemory / (1024.0 * 1024.0) << " MB\n\n";
+    ss << "- Buffer Memory: " << m_Stats.m_TotalBufferMemory / (1024.0 * 1024.0) << " MB\n";
+    ss << "- Transient Memory: " << m_Stats.m_TransientMemoryUnaliased / (1024.0 * 1024.0) << " MB unaliased, "
+       << m_Stats.m_TransientMemoryAliased / (1024.0 * 1024.0) << " MB aliased, "
+       << m_Stats.m_TransientMemoryPeakLive / (1024.0 * 1024.0) << " MB peak live\n";
+    ss << "- Compile Cache: " << m_CompileCacheHits << " hits, " << m_CompileCacheMisses << " misses (this frame: "
+       << (m_Stats.m_bCompiledFromCache ? "hit" : "miss") << ")\n";
+    ss << "- Parallel Setup: " << m_ParallelSetupCount << " frames, " << m_SerialSetupFallbackCount << " serial fallbacks (" << m_SetupRerunCount << " Setup()s re-run)\n";
+    ss << "- Culled Passes: " << m_Stats.m_NumCulledPasses << "\n";
+    ss << "- Async Compute: " << m_Stats.m_NumAsyncComputePasses << " passes, " << m_Stats.m_NumQueueSyncPoints << " cross-queue syncs\n";
+    ss << "- Command Lists: " << m_Stats.m_NumPassCommandLists << " for " << m_Stats.m_NumRecordedPasses << " passes\n";
+    ss << "- State Transitions: " << m_Stats.m_NumStateTransitions << " in " << m_Stats.m_NumBarrierBatches << " batches, "
+       << m_Stats.m_NumSplitTransitions << " splittable\n";
+    ss << "- Buffer Pools: " << m_Stats.m_NumSuballocatedBuffers << " buffers in " << m_Stats.m_NumBufferPools << " pools ("
+       << m_Stats.m_BufferPoolMemory / 1024.0 << " KB)\n";
+    ss << "- Heaps: " << m_Stats.m_NumHeaps << ", " << m_Stats.m_TotalHeapMemory / (1024.0 * 1024.0) << " MB ("
+       << m_Stats.m_FreeHeapMemory / (1024.0 * 1024.0) << " MB free, " << m_Stats.m_HeapFragmentationPercent << "% fragmented), "
+       << m_HeapCompactionCount << " compactions" << (m_Stats.m_bHeapsCompacted ? " (compacted this frame)" : "") << "\n\n";
 
     ss << "## Render Passes\n";
     for (uint32_t i = 0; i < (uint32_t)m_PassNames.size(); ++i)
     {
         uint32_t passID = i + 1;
-        ss << passID << ". " << m_PassNames[i] << "\n";
-        
         const PassAccess& access = m_PassAccesses[i];
+        ss << passID << ". " << m_PassNames[i] << (access.m_bCulled ? " (culled)" : "")
+           << (GetPassQueue((uint16_t)passID) == nvrhi::CommandQueue::Compute ? " [async compute]" : "") << "\n";
+        for (const QueueSyncPoint& syncPoint : m_QueueSyncPoints)
+        {
+            if (syncPoint.m_WaitingPass == passID)
+                ss << "   - Waits for: " << m_PassNames[syncPoint.m_SignalPass - 1] << " (other queue)\n";
+        }
         
         if (!access.m_ReadTextures.empty() || !access.m_WriteTextures.empty())
         {
             ss << "   - Textures:";
-            for (uint32_t idx : access.m_ReadTextures) ss << " [R]" << m_Textures[idx].m_Desc.m_NvrhiDesc.debugName;
-            for (uint32_t idx : access.m_WriteTextures) ss << " [W]" << m_Textures[idx].m_Desc.m_NvrhiDesc.debugName;
+            for (uint32_t idx : access.m_ReadTextures)
+                ss << " [R]" << m_Textures[idx].m_Desc.m_NvrhiDesc.debugName
+                   << GetSubresourceRangeString(PassAccess::GetTextureRange(access.m_ReadTextureRanges, idx), m_Textures[idx].m_Desc.m_NvrhiDesc);
+            for (uint32_t idx : access.m_WriteTextures)
+                ss << " [W]" << m_Textures[idx].m_Desc.m_NvrhiDesc.debugName
+                   << GetSubresourceRangeString(PassAccess::GetTextureRange(access.m_WriteTextureRanges, idx), m_Textures[idx].m_Desc.m_NvrhiDesc);
             ss << "\n";
         }
 
@@ -528,6 +654,18 @@ std::string RenderGraph::ExportToString() const
             }
             ss << "\n";
         }
+
+        for (const StateTransition& transition : GetPassStateTransitions((uint16_t)passID))
+        {
+            const char* name = transition.m_bIsBuffer ? m_Buffers[transition.m_ResourceIndex].m_Desc.m_NvrhiDesc.debugName.c_str() : m_Textures[transition.m_ResourceIndex].m_Desc.m_NvrhiDesc.debugName.c_str();
+            ss << "   - Transition: " << name;
+            if (!transition.m_bIsBuffer)
+                ss << GetSubresourceRangeString(transition.m_Subresources, m_Textures[transition.m_ResourceIndex].m_Desc.m_NvrhiDesc);
+            ss << " " << GetResourceStateName(transition.m_Before) << " -> " << GetResourceStateName(transition.m_After);
+            if (transition.m_BeginPass < passID)
+                ss << " (split, begins at pass " << transition.m_BeginPass << ")";
+            ss << "\n";
+        }
     }
     ss << "\n";
 
@@ -543,6 +681,23 @@ std::string RenderGraph::ExportToString() const
         {
             ss << "  - Aliased from: " << m_Textures[tex.m_AliasedFromIndex].m_Desc.m_NvrhiDesc.debugName << "\n";
         }
+        if (!tex.m_SubresourceLifetimes.empty())
+        {
+            ss << "  - Subresource Lifetimes:";
+            const uint32_t numSlices = tex.m_Desc.m_NvrhiDesc.arraySize;
+            for (uint32_t sub = 0; sub < (uint32_t)tex.m_SubresourceLifetimes.size(); ++sub)
+            {
+                const ResourceLifetime& lifetime = tex.m_SubresourceLifetimes[sub];
+                ss << " [mip " << sub / numSlices;
+                if (numSlices > 1)
+                    ss << " slice " << sub % numSlices;
+                if (lifetime.IsValid())
+                    ss << ": " << lifetime.m_FirstPass << "-" << lifetime.m_LastPass << "]";
+                else
+                    ss << ": unused]";
+            }
+            ss << "\n";
+        }
     }
     ss << "\n";
 
@@ -553,7 +708,10 @@ std::string RenderGraph::ExportToString() const
         ss << "  - Size: " << buf.m_Desc.m_NvrhiDesc.byteSize << " bytes (Stride: " << buf.m_Desc.m_NvrhiDesc.structStride << ")\n";
         ss << "  - Lifetime: Pass " << buf.m_Lifetime.m_FirstPass << " to " << buf.m_Lifetime.m_LastPass << "\n";
         ss << "  - Memory: " << buf.m_Desc.GetMemoryRequirements().size / (1024.0 * 1024.0) << " MB\n";
-        ss << "  - Physical: Heap " << (buf.m_HeapIndex != UINT32_MAX ? (int)buf.m_HeapIndex : -1) << ", Offset " << buf.m_Offset << "\n";
+        if (buf.m_bSuballocated)
+            ss << "  - Physical: Buffer Pool, Offset " << buf.m_SuballocationOffset << "\n";
+        else
+            ss << "  - Physical: Heap " << (buf.m_HeapIndex != UINT32_MAX ? (int)buf.m_HeapIndex : -1) << ", Offset " << buf.m_Offset << "\n";
         if (buf.m_AliasedFromIndex != UINT32_MAX)
         {
             ss << "  - Aliased from: " << m_Buffers[buf.m_AliasedFromIndex].m_Desc.m_NvrhiDesc.debugName << "\n";
@@ -562,12 +720,13 @@ std::string RenderGraph::ExportToString() const
     ss << "\n";
 
     ss << "## Heaps\n";
-    for (size_t i = 0; i < m_Heaps.size(); ++i)
+    const std::vector<HeapEntry>& heaps = m_HeapAllocator.GetHeaps();
+    for (size_t i = 0; i < heaps.size(); ++i)
     {
-        const HeapEntry& heap = m_Heaps[i];
-        if (!heap.m_Heap) continue;
+        const HeapEntry& heap = heaps[i];
+        if (!heap.IsLive()) continue;
         ss << "### Heap " << i << " (" << heap.m_Size / (1024.0 * 1024.0) << " MB)\n";
-        for (const HeapBlock& block : heap.m_Blocks)
+        for (const HeapBlock& block : m_HeapAllocator.GetBlocks((uint32_t)i))
         {
             const char* resourceName = "[Free]";
             if (!block.m_IsFree)
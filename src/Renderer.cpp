@@ -356,6 +356,18 @@ bool Renderer::InitializeGPUStack(SDL_Window* window)
     return true;
 }
 
+void Renderer::ApplyTaskSchedulerConfig()
+{
+    const Config& config = Config::Get();
+    if (config.m_WorkerThreadCount > 0)
+    {
+        m_TaskScheduler->SetThreadCount(config.m_WorkerThreadCount);
+    }
+    m_TaskScheduler->SetWorkerPinning(config.m_PinWorkerThreads);
+
+    SDL_Log("[TaskScheduler] %u worker threads%s", m_TaskScheduler->GetThreadCount(), config.m_PinWorkerThreads ? ", pinned" : "");
+}
+
 void Renderer::Initialize()
 {
     ScopedTimerLog initScope{"[Timing] Init phase:"};
@@ -367,6 +379,7 @@ void Renderer::Initialize()
     PROFILE_FUNCTION();
 
     m_TaskScheduler = std::make_unique<TaskScheduler>();
+    ApplyTaskSchedulerConfig();
 
     InitSDL();
 
@@ -433,6 +446,7 @@ void Renderer::InitializeForTests()
     MicroProfileSetForceMetaCounters(true);
 
     m_TaskScheduler = std::make_unique<TaskScheduler>();
+    ApplyTaskSchedulerConfig();
 
     // Create a minimal hidden window so DXGI can create a swapchain.
     // SDL_WINDOW_HIDDEN keeps it off-screen; 320×240 is the smallest
@@ -520,98 +534,37 @@ void Renderer::Run()
             ReloadShaders();
         }
 
+        const Config& config = Config::Get();
+        if (!config.m_SchedulerTracePath.empty() && m_FrameNumber == config.m_SchedulerTraceFrame)
+        {
+            m_SchedulerTracePath = config.m_SchedulerTracePath;
+        }
+        const bool bCaptureSchedulerTrace = !m_SchedulerTracePath.empty();
+        if (bCaptureSchedulerTrace)
+        {
+            m_TaskScheduler->BeginTraceCapture();
+        }
+
         const bool bSwapChainImageAcquireSuccess = m_RHI->AcquireNextSwapchainImage(&m_AcquiredSwapchainImageIdx);
         
         m_TaskScheduler->ScheduleTask([this]() {
             PROFILE_SCOPED("Garbage Collection");
             m_RHI->m_NvrhiDevice->runGarbageCollection();
-        });
+        }, /*bImmediateExecute=*/true, TaskPriority::Background);
 
         // Prepare ImGui UI (NewFrame + UI creation + ImGui::Render)
         m_ImGuiLayer.UpdateFrame();
 
-        // Update animations
-        if (m_EnableAnimations)
-        {
-            m_Scene.Update(static_cast<float>(m_FrameTime / 1000.0));
-        }
-
-        // Upload any dirty instance transforms before the renderers run.
-        // UploadDirtyInstanceTransforms() is also called by RunOneFrame() in the
-        // unit-test path, so the logic lives in one place.
-        UploadDirtyInstanceTransforms();
-
-        if (m_Scene.m_LightsDirty)
-        {
-            SceneLoader::CreateAndUploadLightBuffer(m_Scene);
-            m_Scene.m_LightsDirty = false;
-        }
-
-        // Upload material constants for materials changed by emissive intensity animations.
-        // Logic lives in UploadDirtyMaterialConstants() so the unit-test path
-        // (RunOneFrame) exercises the same code as the main game loop.
-        UploadDirtyMaterialConstants();
-
-        // Update camera (camera retrieves frame time internally)
-        m_Scene.m_ViewPrev = m_Scene.m_View;
-        m_Scene.m_Camera.Update();
-
-        // Handle debug mode settings
-        if (m_DebugMode != m_ActiveDebugMode)
+        // Scene update, dirty uploads, camera update and render graph setup. Runs after the UI so nothing it
+        // mutates is read concurrently; the main thread helps until the graph completes.
+        // Window queries stay on the main thread; the setup node reads the size from here.
+        SDL_GetWindowSize(m_Window, &m_FrameWindowWidth, &m_FrameWindowHeight);
+        if (m_FrameTaskGraph.GetNodeCount() == 0)
         {
-            if (m_DebugMode != srrhi::CommonConsts::DEBUG_MODE_NONE && m_ActiveDebugMode == srrhi::CommonConsts::DEBUG_MODE_NONE)
-            {
-                // Entering debug mode: save current state
-                m_DebugBackup.m_EnableBloom = m_EnableBloom;
-                m_DebugBackup.m_EnableAutoExposure = m_EnableAutoExposure;
-                m_DebugBackup.m_ExposureValue = m_Scene.m_Camera.m_ExposureValue;
-                m_DebugBackup.m_ExposureCompensation = m_Scene.m_Camera.m_ExposureCompensation;
-
-                // Set debug defaults
-                m_EnableBloom = false;
-                m_EnableAutoExposure = false;
-            }
-            else if (m_DebugMode == srrhi::CommonConsts::DEBUG_MODE_NONE && m_ActiveDebugMode != srrhi::CommonConsts::DEBUG_MODE_NONE)
-            {
-                // Leaving debug mode: restore state
-                m_EnableBloom = m_DebugBackup.m_EnableBloom;
-                m_EnableAutoExposure = m_DebugBackup.m_EnableAutoExposure;
-                m_Scene.m_Camera.m_ExposureValue = m_DebugBackup.m_ExposureValue;
-                m_Scene.m_Camera.m_ExposureCompensation = m_DebugBackup.m_ExposureCompensation;
-            }
-            m_ActiveDebugMode = m_DebugMode;
-        }
-
-        if (m_DebugMode != srrhi::CommonConsts::DEBUG_MODE_NONE)
-        {
-            // Lock settings in debug mode for consistent raw output
-            m_EnableBloom = false;
-            m_EnableAutoExposure = false;
-            m_Scene.m_Camera.m_Exposure = 1.0f;
-        }
-
-        int windowW, windowH;
-        SDL_GetWindowSize(m_Window, &windowW, &windowH);
-        m_Scene.m_ViewPrev = m_Scene.m_View;
-        m_Scene.m_Camera.FillPlanarViewConstants(m_Scene.m_View, (float)windowW, (float)windowH);
-
-        // must disable restir renderer while async mesh loads are pending to avoid GPU synchronization stalls
-        {
-            const uint32_t pendingMeshLoads = m_AsyncMeshQueue.GetPendingCount();
-            if (pendingMeshLoads > 0)
-            {
-                if (m_EnableReSTIRDI)
-                {
-                    m_EnableReSTIRDI = false;
-                    m_bRestoreReSTIRDIAfterAsyncMeshLoad = true;
-                }
-            }
-            else if (m_bRestoreReSTIRDIAfterAsyncMeshLoad)
-            {
-                m_EnableReSTIRDI = true;
-                m_bRestoreReSTIRDIAfterAsyncMeshLoad = false;
-            }
+            BuildFrameTaskGraph();
         }
+        m_TaskScheduler->RunTaskGraph(m_FrameTaskGraph);
+        m_TaskScheduler->WaitForTaskGraph(m_FrameTaskGraph);
 
         const int readIndex = m_FrameNumber % 2;
         const int writeIndex = (m_FrameNumber + 1) % 2;
@@ -626,7 +579,8 @@ void Renderer::Run()
             scopedCmd->beginTimerQuery(m_GPUQueries[writeIndex]);
         }
 
-        ScheduleAndRunAllRenderers();
+        // The renderers were set up by the frame task graph; the uploads it ran are queued ahead of their command lists
+        CompileAndRecordAllRenderers();
 
         // GPU query for frame timer is super expensive on the CPU for some reason. i give up using it
         if constexpr (false)
@@ -650,6 +604,12 @@ void Renderer::Run()
         }
         m_SwapChainImageIdx = 1 - m_SwapChainImageIdx;
 
+        if (bCaptureSchedulerTrace)
+        {
+            m_TaskScheduler->EndTraceCapture(m_SchedulerTracePath);
+            m_SchedulerTracePath.clear();
+        }
+
         const uint64_t workTimeNs = SDL_GetTicksNS() - frameStart;
 
         // Sleep to maintain target framerate (if needed)
@@ -690,7 +650,11 @@ void Renderer::Shutdown()
 
     m_InFlightCommandLists.clear();
     m_PendingCommandLists.clear();
-    m_CommandListFreeList.clear();
+    m_PendingCommandListWaits.clear();
+    for (std::vector<nvrhi::CommandListHandle>& freeList : m_CommandListFreeLists)
+    {
+        freeList.clear();
+    }
 
     m_ImGuiLayer.Shutdown();
     CommonResources::GetInstance().Shutdown();
@@ -734,6 +698,126 @@ void Renderer::Shutdown()
     SDL_Log("[Shutdown] Clean exit");
 }
 
+void Renderer::BuildFrameTaskGraph()
+{
+    // The scene update feeds everything after it: the uploads consume the dirty ranges and node transforms it writes.
+    // The three uploads touch disjoint scene data and AcquireCommandList() is thread-safe, so they run side by side,
+    // next to the render graph setup. Setup reads the frame's view and settings, so it also waits for the camera,
+    // which only touches its own state and starts alongside the scene update.
+    m_FrameTaskGraph.SetPriority(TaskPriority::FrameCritical);
+    const TaskGraph::NodeHandle sceneUpdate = m_FrameTaskGraph.AddNode("Scene Update", [this](uint32_t)
+    {
+        PROFILE_SCOPED("Scene Update");
+        if (m_EnableAnimations)
+        {
+            m_Scene.Update(static_cast<float>(m_FrameTime / 1000.0));
+        }
+    });
+
+    // Upload any dirty instance transforms before the renderers record.
+    // UploadDirtyInstanceTransforms() is also called by RunOneFrame() in the
+    // unit-test path, so the logic lives in one place.
+    m_FrameTaskGraph.Then(sceneUpdate, "Upload Dirty Instances", [this](uint32_t)
+    {
+        PROFILE_SCOPED("Upload Dirty Instances");
+        UploadDirtyInstanceTransforms();
+    });
+
+    m_FrameTaskGraph.Then(sceneUpdate, "Upload Lights", [this](uint32_t)
+    {
+        PROFILE_SCOPED("Upload Lights");
+        if (m_Scene.m_LightsDirty)
+        {
+            SceneLoader::CreateAndUploadLightBuffer(m_Scene);
+            m_Scene.m_LightsDirty = false;
+        }
+    });
+
+    // Upload material constants for materials changed by emissive intensity animations.
+    // Logic lives in UploadDirtyMaterialConstants() so the unit-test path
+    // (RunOneFrame) exercises the same code as the main game loop.
+    m_FrameTaskGraph.Then(sceneUpdate, "Upload Dirty Materials", [this](uint32_t)
+    {
+        PROFILE_SCOPED("Upload Dirty Materials");
+        UploadDirtyMaterialConstants();
+    });
+
+    // Update camera (camera retrieves frame time internally)
+    const TaskGraph::NodeHandle cameraUpdate = m_FrameTaskGraph.AddNode("Camera Update", [this](uint32_t)
+    {
+        PROFILE_SCOPED("Camera Update");
+        m_Scene.m_ViewPrev = m_Scene.m_View;
+        m_Scene.m_Camera.Update();
+    });
+
+    // Renderers' Setup() only declares graph resources and accesses; Compile() and recording wait for the uploads
+    const TaskGraph::NodeHandle renderGraphSetup = m_FrameTaskGraph.Then(sceneUpdate, "Render Graph Setup", [this](uint32_t)
+    {
+        PROFILE_SCOPED("Render Graph Setup");
+        ApplyFrameSettings();
+        SetupAllRenderers();
+    });
+    m_FrameTaskGraph.AddDependency(cameraUpdate, renderGraphSetup);
+}
+
+void Renderer::ApplyFrameSettings()
+{
+    // Handle debug mode settings
+    if (m_DebugMode != m_ActiveDebugMode)
+    {
+        if (m_DebugMode != srrhi::CommonConsts::DEBUG_MODE_NONE && m_ActiveDebugMode == srrhi::CommonConsts::DEBUG_MODE_NONE)
+        {
+            // Entering debug mode: save current state
+            m_DebugBackup.m_EnableBloom = m_EnableBloom;
+            m_DebugBackup.m_EnableAutoExposure = m_EnableAutoExposure;
+            m_DebugBackup.m_ExposureValue = m_Scene.m_Camera.m_ExposureValue;
+            m_DebugBackup.m_ExposureCompensation = m_Scene.m_Camera.m_ExposureCompensation;
+
+            // Set debug defaults
+            m_EnableBloom = false;
+            m_EnableAutoExposure = false;
+        }
+        else if (m_DebugMode == srrhi::CommonConsts::DEBUG_MODE_NONE && m_ActiveDebugMode != srrhi::CommonConsts::DEBUG_MODE_NONE)
+        {
+            // Leaving debug mode: restore state
+            m_EnableBloom = m_DebugBackup.m_EnableBloom;
+            m_EnableAutoExposure = m_DebugBackup.m_EnableAutoExposure;
+            m_Scene.m_Camera.m_ExposureValue = m_DebugBackup.m_ExposureValue;
+            m_Scene.m_Camera.m_ExposureCompensation = m_DebugBackup.m_ExposureCompensation;
+        }
+        m_ActiveDebugMode = m_DebugMode;
+    }
+
+    if (m_DebugMode != srrhi::CommonConsts::DEBUG_MODE_NONE)
+    {
+        // Lock settings in debug mode for consistent raw output
+        m_EnableBloom = false;
+        m_EnableAutoExposure = false;
+        m_Scene.m_Camera.m_Exposure = 1.0f;
+    }
+
+    m_Scene.m_ViewPrev = m_Scene.m_View;
+    m_Scene.m_Camera.FillPlanarViewConstants(m_Scene.m_View, (float)m_FrameWindowWidth, (float)m_FrameWindowHeight);
+
+    // must disable restir renderer while async mesh loads are pending to avoid GPU synchronization stalls
+    {
+        const uint32_t pendingMeshLoads = m_AsyncMeshQueue.GetPendingCount();
+        if (pendingMeshLoads > 0)
+        {
+            if (m_EnableReSTIRDI)
+            {
+                m_EnableReSTIRDI = false;
+                m_bRestoreReSTIRDIAfterAsyncMeshLoad = true;
+            }
+        }
+        else if (m_bRestoreReSTIRDIAfterAsyncMeshLoad)
+        {
+            m_EnableReSTIRDI = true;
+            m_bRestoreReSTIRDIAfterAsyncMeshLoad = false;
+        }
+    }
+}
+
 void Renderer::UploadDirtyInstanceTransforms()
 {
     // Upload dirty instance transforms and reset the dirty range.
@@ -847,6 +931,12 @@ void Renderer::UploadDirtyMaterialConstants()
 }
 
 void Renderer::ScheduleAndRunAllRenderers()
+{
+    SetupAllRenderers();
+    CompileAndRecordAllRenderers();
+}
+
+void Renderer::SetupAllRenderers()
 {
     for (const std::shared_ptr<IRenderer>& renderer : m_Renderers)
     {
@@ -855,11 +945,18 @@ void Renderer::ScheduleAndRunAllRenderers()
 
     m_RenderGraph.Reset();
 
+    const Config& config = Config::Get();
+    if (!config.m_RenderGraphCapturePath.empty() && m_FrameNumber == 0 && config.m_RenderGraphCaptureFrames > 0)
+    {
+        m_RenderGraph.BeginAllocationCapture(config.m_RenderGraphCapturePath, config.m_RenderGraphCaptureFrames);
+    }
+
     extern IRenderer* g_TLASRenderer;
     extern IRenderer* g_ClearRenderer;
     extern IRenderer* g_OpaqueRenderer;
     extern IRenderer* g_MaskedPassRenderer;
     extern IRenderer* g_HZBGeneratorPhase2;
+    extern IRenderer* g_HZBMipsPhase2;
     extern IRenderer* g_RTXDIRenderer;
     extern IRenderer* g_DeferredRenderer;
     extern IRenderer* g_SkyRenderer;
@@ -870,7 +967,8 @@ void Renderer::ScheduleAndRunAllRenderers()
     extern IRenderer* g_ImGuiRenderer;
     extern IRenderer* g_PathTracerRenderer;
 
-    m_RenderGraph.BeginSetup();
+    // With parallel setup the renderers' Setup() run concurrently in EndSetup(), merged back in the order scheduled here
+    m_RenderGraph.BeginSetup(config.m_EnableParallelRenderGraphSetup);
 
     m_RenderGraph.ScheduleRenderer(g_ClearRenderer);
 
@@ -883,6 +981,7 @@ void Renderer::ScheduleAndRunAllRenderers()
         m_RenderGraph.ScheduleRenderer(g_OpaqueRenderer);
         m_RenderGraph.ScheduleRenderer(g_MaskedPassRenderer);
         m_RenderGraph.ScheduleRenderer(g_HZBGeneratorPhase2);
+        m_RenderGraph.ScheduleRenderer(g_HZBMipsPhase2);
         m_RenderGraph.ScheduleRenderer(g_TLASRenderer);
         m_RenderGraph.ScheduleRenderer(g_RTXDIRenderer);
         m_RenderGraph.ScheduleRenderer(g_DeferredRenderer);
@@ -896,10 +995,16 @@ void Renderer::ScheduleAndRunAllRenderers()
     m_RenderGraph.ScheduleRenderer(g_ImGuiRenderer);
 
     m_RenderGraph.EndSetup();
+}
 
+void Renderer::CompileAndRecordAllRenderers()
+{
     // Compile render graph: compute lifetimes and allocate resources
     m_RenderGraph.Compile();
 
+    // Start recording render passes now that their resources exist
+    m_RenderGraph.SubmitRecordingJobs();
+
     // Wait for all render passes to finish recording
     m_TaskScheduler->ExecuteAllScheduledTasks();
 
@@ -1451,7 +1556,7 @@ void Renderer::AddComputePass(const RenderPassParams& params)
     }
 }
 
-void Renderer::GenerateMipsUsingSPD(nvrhi::TextureHandle texture, nvrhi::BufferHandle spdAtomicCounter, nvrhi::CommandListHandle commandList, const char* markerName, uint32_t reductionType)
+void Renderer::GenerateMipsUsingSPD(nvrhi::TextureHandle texture, nvrhi::BufferHandle spdAtomicCounter, const nvrhi::BufferRange& spdAtomicCounterRange, nvrhi::CommandListHandle commandList, const char* markerName, uint32_t reductionType)
 {
     PROFILE_FUNCTION();
     PROFILE_GPU_SCOPED(markerName, commandList);
@@ -1494,10 +1599,16 @@ void Renderer::GenerateMipsUsingSPD(nvrhi::TextureHandle texture, nvrhi::BufferH
     inputs.SetOut11(numMips > 11 ? texture : CommonResources::GetInstance().DummyUAVTexture, numMips > 11 ? 11 : 0);
     inputs.SetOut12(numMips > 12 ? texture : CommonResources::GetInstance().DummyUAVTexture, numMips > 12 ? 12 : 0);
 
-    // Clear atomic counter
-    commandList->clearBufferUInt(spdAtomicCounter, 0);
+    // Clear atomic counter. It may be a range of a render graph pool buffer, so only its own bytes are touched.
+    const uint32_t zero = 0;
+    commandList->writeBuffer(spdAtomicCounter, &zero, sizeof(zero), spdAtomicCounterRange.byteOffset);
 
     nvrhi::BindingSetDesc spdBset = CreateBindingSetDesc(inputs);
+    for (nvrhi::BindingSetItem& item : spdBset.bindings)
+    {
+        if (item.resourceHandle == spdAtomicCounter.Get())
+            item.range = spdAtomicCounterRange;
+    }
 
     const uint32_t spdShaderID = (numChannels == 3)
         ? ShaderID::SPD_SPD_CSMAIN_SPD_NUM_CHANNELS_3
@@ -1515,21 +1626,22 @@ void Renderer::GenerateMipsUsingSPD(nvrhi::TextureHandle texture, nvrhi::BufferH
     AddComputePass(params);
 }
 
-nvrhi::CommandListHandle Renderer::AcquireCommandList(bool bImmediatelyQueue)
+nvrhi::CommandListHandle Renderer::AcquireCommandList(bool bImmediatelyQueue, nvrhi::CommandQueue queue)
 {
     PROFILE_FUNCTION();
-    SINGLE_THREAD_GUARD();
+    std::lock_guard<std::mutex> lock(m_CommandListMutex);
 
     nvrhi::CommandListHandle handle;
 
-    if (!m_CommandListFreeList.empty())
+    std::vector<nvrhi::CommandListHandle>& freeList = m_CommandListFreeLists[(size_t)queue];
+    if (!freeList.empty())
     {
-        handle = m_CommandListFreeList.back();
-        m_CommandListFreeList.pop_back();
+        handle = freeList.back();
+        freeList.pop_back();
     }
     else
     {
-        const nvrhi::CommandListParameters params{ .enableImmediateExecution = false, .queueType = nvrhi::CommandQueue::Graphics };
+        const nvrhi::CommandListParameters params{ .enableImmediateExecution = false, .queueType = queue };
         handle = m_RHI->m_NvrhiDevice->createCommandList(params);
     }
 
@@ -1543,6 +1655,14 @@ nvrhi::CommandListHandle Renderer::AcquireCommandList(bool bImmediatelyQueue)
     return handle;
 }
 
+void Renderer::AddCommandListWait(nvrhi::ICommandList* waitingList, nvrhi::ICommandList* signalList)
+{
+    SINGLE_THREAD_GUARD();
+    SDL_assert(waitingList && signalList);
+    SDL_assert(waitingList->getDesc().queueType != signalList->getDesc().queueType && "Command lists on the same queue already execute in order");
+    m_PendingCommandListWaits.push_back({ waitingList, signalList });
+}
+
 void Renderer::ExecutePendingCommandLists()
 {
     PROFILE_FUNCTION();
@@ -1554,7 +1674,10 @@ void Renderer::ExecutePendingCommandLists()
         m_RHI->m_NvrhiDevice->waitForIdle();
      }
 
-    m_CommandListFreeList.insert(m_CommandListFreeList.end(), m_InFlightCommandLists.begin(), m_InFlightCommandLists.end());
+    for (const nvrhi::CommandListHandle& handle : m_InFlightCommandLists)
+    {
+        m_CommandListFreeLists[(size_t)handle->getDesc().queueType].push_back(handle);
+    }
     m_InFlightCommandLists.clear();
 
     if (!m_PendingCommandLists.empty())
@@ -1571,29 +1694,68 @@ void Renderer::ExecutePendingCommandLists()
             }
         }
 
-        if (Config::Get().ExecutePerPass || Config::Get().ExecutePerPassAndWait)
+        // Consecutive lists on the same queue are executed as one batch, split where a list first has to wait for
+        // another queue (a queue-level wait would otherwise hold back the lists before it too)
+        const bool bExecutePerPass = Config::Get().ExecutePerPass || Config::Get().ExecutePerPassAndWait;
+        std::unordered_map<const nvrhi::ICommandList*, uint64_t> submittedInstances;
+        std::vector<nvrhi::ICommandList*> batch;
+        batch.reserve(m_PendingCommandLists.size());
+        nvrhi::CommandQueue batchQueue = nvrhi::CommandQueue::Graphics;
+
+        auto executeBatch = [&]()
         {
-            for (const nvrhi::CommandListHandle& handle : m_PendingCommandLists)
-            {
-                m_RHI->m_NvrhiDevice->executeCommandList(handle);
+            if (batch.empty())
+                return;
 
-                if (Config::Get().ExecutePerPassAndWait)
+            const uint64_t instance = m_RHI->m_NvrhiDevice->executeCommandLists(batch.data(), batch.size(), batchQueue);
+            if (!m_PendingCommandListWaits.empty())
+            {
+                for (const nvrhi::ICommandList* list : batch)
                 {
-                    m_RHI->m_NvrhiDevice->waitForIdle();
+                    submittedInstances[list] = instance;
                 }
             }
-        }
-        else
+            batch.clear();
+
+            if (Config::Get().ExecutePerPassAndWait)
+            {
+                m_RHI->m_NvrhiDevice->waitForIdle();
+            }
+        };
+
+        for (const nvrhi::CommandListHandle& handle : m_PendingCommandLists)
         {
-            std::vector<nvrhi::ICommandList*> rawLists;
-            rawLists.reserve(m_PendingCommandLists.size());
-            for (const nvrhi::CommandListHandle& handle : m_PendingCommandLists)
+            const nvrhi::CommandQueue queue = handle->getDesc().queueType;
+            const bool bHasWaits = std::any_of(m_PendingCommandListWaits.begin(), m_PendingCommandListWaits.end(),
+                [&handle](const CommandListWait& wait) { return wait.m_WaitingList == handle.Get(); });
+
+            if (queue != batchQueue || bHasWaits)
             {
-                rawLists.push_back(handle.Get());
+                executeBatch();
             }
+            batchQueue = queue;
 
-            m_RHI->m_NvrhiDevice->executeCommandLists(rawLists.data(), rawLists.size());
+            for (const CommandListWait& wait : m_PendingCommandListWaits)
+            {
+                if (wait.m_WaitingList != handle.Get())
+                    continue;
+
+                auto it = submittedInstances.find(wait.m_SignalList);
+                SDL_assert(it != submittedInstances.end() && "Command list waits for one that was not submitted before it");
+                if (it != submittedInstances.end())
+                {
+                    m_RHI->m_NvrhiDevice->queueWaitForCommandList(queue, wait.m_SignalList->getDesc().queueType, it->second);
+                }
+            }
+
+            batch.push_back(handle.Get());
+            if (bExecutePerPass)
+            {
+                executeBatch();
+            }
         }
+        executeBatch();
+        m_PendingCommandListWaits.clear();
 
         m_InFlightCommandLists.insert(m_InFlightCommandLists.end(), m_PendingCommandLists.begin(), m_PendingCommandLists.end());
         m_PendingCommandLists.clear();
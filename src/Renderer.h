@@ -17,13 +17,20 @@ public:
     virtual ~IRenderer() = default;
     virtual void Initialize() {}
     virtual void PostSceneLoad() {}
+    // With parallel setup this can run twice in a frame (RenderGraph::RunQueuedSetups), so anything it changes besides
+    // its declarations must come out the same the second time: derive members from the frame state, don't toggle or count.
     virtual bool Setup(RenderGraph& renderGraph) { return false; }
     virtual void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) {}
     virtual const char* GetName() const { return "Unnamed Renderer"; }
 
     virtual bool IsBasePassRenderer() const { return false; }
 
+    // Compute-only passes may ask for the async compute queue. The render graph decides (RenderGraph::ScheduleQueues),
+    // but can't see resources outside the graph: those must already be in states the compute queue can use.
+    virtual bool PrefersAsyncCompute() const { return false; }
+
     float m_CPUTime = 0.0f;
+    float m_CPUTimeHistory = 0.0f; // smoothed m_CPUTime, orders next frame's recording jobs (RenderGraph::SubmitRecordingJobs)
     float m_GPUTime = 0.0f;
     nvrhi::TimerQueryHandle m_GPUQueries[2];
     bool m_bPassEnabled = false;
@@ -98,10 +105,17 @@ struct Renderer
     void InitializeForTests(); // Headless init for --run-tests: RHI + CommonResources, no scene/renderers
     void Run();
     void Shutdown();
+    // SetupAllRenderers() then CompileAndRecordAllRenderers(). Run() does the setup inside m_FrameTaskGraph instead,
+    // overlapped with the frame's uploads.
     void ScheduleAndRunAllRenderers();
+    void SetupAllRenderers();
+    void CompileAndRecordAllRenderers();
+
+    // Applies Config's worker count and pinning to the freshly created m_TaskScheduler
+    void ApplyTaskSchedulerConfig();
 
     // Upload any dirty instance transforms to the GPU and reset the dirty range.
-    // Must be called once per frame before ScheduleAndRunAllRenderers() so that
+    // Must be called once per frame before the renderers record (CompileAndRecordAllRenderers()) so that
     // the TLAS rebuild sees up-to-date RT instance descriptors.  Called explicitly
     // by both RenderFrame() (main loop) and RunOneFrame() (unit-test path).
     void UploadDirtyInstanceTransforms();
@@ -114,8 +128,18 @@ struct Renderer
     // by tests.
     void UploadDirtyMaterialConstants();
 
+    // Builds m_FrameTaskGraph: the per-frame CPU work in Run() (scene update, dirty uploads, camera update, render
+    // graph setup) expressed as dependencies so independent parts overlap on the task scheduler.
+    void BuildFrameTaskGraph();
+    // Debug-mode overrides, view constants and the ReSTIR DI async-load toggle, read by the renderers' Setup()
+    void ApplyFrameSettings();
+
     // Command List Management
-    nvrhi::CommandListHandle AcquireCommandList(bool bImmediatelyQueue = true);
+    // Thread-safe; lists are executed in the order they were acquired
+    nvrhi::CommandListHandle AcquireCommandList(bool bImmediatelyQueue = true, nvrhi::CommandQueue queue = nvrhi::CommandQueue::Graphics);
+    // Make 'waitingList' (on another queue) wait for 'signalList' at the next ExecutePendingCommandLists().
+    // Both must be pending, with 'signalList' acquired first.
+    void AddCommandListWait(nvrhi::ICommandList* waitingList, nvrhi::ICommandList* signalList);
     void ExecutePendingCommandLists();
 
     // Swapchain / Backbuffer
@@ -164,7 +188,7 @@ struct Renderer
 
     void AddComputePass(const RenderPassParams& params);
     void AddFullScreenPass(const RenderPassParams& params);
-    void GenerateMipsUsingSPD(nvrhi::TextureHandle texture, nvrhi::BufferHandle spdAtomicCounter, nvrhi::CommandListHandle commandList, const char* markerName, uint32_t reductionType);
+    void GenerateMipsUsingSPD(nvrhi::TextureHandle texture, nvrhi::BufferHandle spdAtomicCounter, const nvrhi::BufferRange& spdAtomicCounterRange, nvrhi::CommandListHandle commandList, const char* markerName, uint32_t reductionType);
     nvrhi::ShaderHandle GetShaderHandle(uint32_t shaderID) const;
 
     // Shared GPU stack init used by both Initialize() and InitializeForTests().
@@ -188,6 +212,8 @@ struct Renderer
 
     // Public Methods
     double GetFrameTimeMs() const { return m_FrameTime; }
+    // Whether ClearRenderer keeps last frame's depth and G-buffer (g_RG_*History) this frame, for ReSTIR DI
+    bool KeepsGBufferHistory() const { return m_EnableReSTIRDI && m_Mode != RenderingMode::ReferencePathTracer; }
     void SetCameraFromSceneCamera(const Scene::Camera& sceneCam);
 
     // Returns the swapchain extent (width, height) as a pair.
@@ -218,6 +244,12 @@ struct Renderer
 
     // Parallel processing
     std::unique_ptr<TaskScheduler> m_TaskScheduler;
+    TaskGraph m_FrameTaskGraph;
+    // Window size sampled on the main thread for the frame task graph's setup node
+    int m_FrameWindowWidth = 0;
+    int m_FrameWindowHeight = 0;
+    // Non-empty: the next frame's task scheduler activity is written to this path as a Chrome trace
+    std::string m_SchedulerTracePath;
 
     // Scene
     Scene m_Scene;
@@ -288,8 +320,15 @@ struct Renderer
     std::string m_BRDFLutTexture = "brdf_lut.dds";
 
     // Internal State
-    std::vector<nvrhi::CommandListHandle> m_CommandListFreeList;
+    std::vector<nvrhi::CommandListHandle> m_CommandListFreeLists[(size_t)nvrhi::CommandQueue::Count]; // by queue type
     std::vector<nvrhi::CommandListHandle> m_PendingCommandLists;
+    std::mutex m_CommandListMutex; // AcquireCommandList() runs on the frame task graph's upload nodes concurrently
+    struct CommandListWait
+    {
+        nvrhi::ICommandList* m_WaitingList = nullptr;
+        nvrhi::ICommandList* m_SignalList = nullptr;
+    };
+    std::vector<CommandListWait> m_PendingCommandListWaits;
     std::vector<nvrhi::CommandListHandle> m_InFlightCommandLists;
 
     // Caches
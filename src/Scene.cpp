@@ -778,9 +778,22 @@ void Scene::Update(float deltaTime)
 	ApplyPendingUpdates();
 
 	// Save current worlds as previous worlds for all instances (always, for motion vectors).
-	for (srrhi::PerInstanceData& inst : m_InstanceData)
+	// Chunked so that large instance counts spread over the workers while small scenes run inline.
+	auto SavePrevWorlds = [this](uint32_t begin, uint32_t end, uint32_t /*threadIndex*/)
 	{
-		inst.m_PrevWorld = inst.m_World;
+		for (uint32_t i = begin; i < end; ++i)
+		{
+			m_InstanceData[i].m_PrevWorld = m_InstanceData[i].m_World;
+		}
+	};
+	if (g_Renderer.m_TaskScheduler)
+	{
+		static const uint32_t kPrevWorldGrainSize = 4096;
+		g_Renderer.m_TaskScheduler->ParallelForChunks(0, (uint32_t)m_InstanceData.size(), kPrevWorldGrainSize, SavePrevWorlds);
+	}
+	else
+	{
+		SavePrevWorlds(0, (uint32_t)m_InstanceData.size(), 0);
 	}
 
 	// Respect the global animations toggle.  The Renderer already gates this call,
@@ -1735,7 +1735,13 @@ void SceneLoader::ProcessMeshes(const cgltf_data* data, Scene& scene, std::vecto
 	}
 
 	
-	g_Renderer.m_TaskScheduler->ParallelFor((uint32_t)jobs.size(), [&](uint32_t jobIdx, uint32_t threadIndex)
+	// Vertices per chunk for the per-vertex loops inside a primitive. Small primitives stay on one thread.
+	static const uint32_t kVertexGrainSize = 4096;
+
+	// One coroutine per primitive: primitives are coarse and vary wildly in size, and the big ones split their
+	// per-vertex work further with ParallelForAsync, suspending instead of holding a worker while that runs
+	TaskScheduler& scheduler = *g_Renderer.m_TaskScheduler;
+	auto processPrimitive = [&](uint32_t jobIdx) -> AsyncTask
 	{
 		const PrimitiveJob& job = jobs[jobIdx];
 		const cgltf_primitive& prim = *job.prim;
@@ -1760,7 +1766,7 @@ void SceneLoader::ProcessMeshes(const cgltf_data* data, Scene& scene, std::vecto
 		}
 
 		if (!posAcc)
-			return;
+			co_return;
 
 		if (!tangAcc)
 		{
@@ -1774,7 +1780,7 @@ void SceneLoader::ProcessMeshes(const cgltf_data* data, Scene& scene, std::vecto
 		const cgltf_size vertCount = posAcc->count;
 
 		std::vector<srrhi::Vertex> rawVertices(vertCount);
-		for (cgltf_size v = 0; v < vertCount; ++v)
+		co_await scheduler.ParallelForAsync(0, (uint32_t)vertCount, kVertexGrainSize, [&](uint32_t v, uint32_t)
 		{
 			srrhi::Vertex vx{};
 			float pos[4] = { 0,0,0,0 };
@@ -1807,7 +1813,7 @@ void SceneLoader::ProcessMeshes(const cgltf_data* data, Scene& scene, std::vecto
 			vx.m_Tangent.x = tang[0]; vx.m_Tangent.y = tang[1]; vx.m_Tangent.z = -tang[2]; vx.m_Tangent.w = -tang[3]; // glTF RH -> LH: negate Z and W
 
 			rawVertices[v] = vx;
-		}
+		});
 
 		std::vector<uint32_t> rawIndices;
 		if (prim.indices)
@@ -1842,9 +1848,10 @@ void SceneLoader::ProcessMeshes(const cgltf_data* data, Scene& scene, std::vecto
 		meshopt_optimizeVertexCache(localIndices.data(), localIndices.data(), localIndices.size(), uniqueVertices);
 		meshopt_optimizeVertexFetch(optimizedVertices.data(), localIndices.data(), localIndices.size(), optimizedVertices.data(), uniqueVertices, sizeof(srrhi::Vertex));
 
-		res.vertices.reserve(uniqueVertices);
-		for (const srrhi::Vertex& v : optimizedVertices)
+		res.vertices.resize(uniqueVertices);
+		co_await scheduler.ParallelForAsync(0, (uint32_t)uniqueVertices, kVertexGrainSize, [&](uint32_t vertexIdx, uint32_t)
 		{
+			const srrhi::Vertex& v = optimizedVertices[vertexIdx];
 			srrhi::VertexQuantized vq{};
 			vq.m_Pos = v.m_Pos;
 			vq.m_Normal = (meshopt_quantizeSnorm(v.m_Normal.x, 10) + 511) |
@@ -1870,12 +1877,17 @@ void SceneLoader::ProcessMeshes(const cgltf_data* data, Scene& scene, std::vecto
 				vq.m_Tangent = 0;
 			}
 
-			res.vertices.push_back(vq);
-		}
+			res.vertices[vertexIdx] = vq;
+		});
 
 		uint32_t baseIndexCount = static_cast<uint32_t>(localIndices.size());
 		if (baseIndexCount > 0)
 		{
+			// LOD/meshlet scratch goes to the arena of whichever thread resumed us. No co_await below this point,
+			// so the scope can't straddle two threads.
+			ScratchArena& arena = scheduler.GetScratchArena();
+			ScratchArena::Scope scratchScope{ arena };
+
 			const size_t max_vertices = srrhi::CommonConsts::kMaxMeshletVertices;
 			const size_t max_triangles = srrhi::CommonConsts::kMaxMeshletTriangles;
 			const float cone_weight = 0.25f;
@@ -1889,12 +1901,12 @@ void SceneLoader::ProcessMeshes(const cgltf_data* data, Scene& scene, std::vecto
 
 			const float simplifyScale = meshopt_simplifyScale(&optimizedVertices[0].m_Pos.x, uniqueVertices, sizeof(srrhi::Vertex));
 
-			std::vector<uint32_t> currentLodIndices = localIndices;
+			std::pmr::vector<uint32_t> currentLodIndices(localIndices.begin(), localIndices.end(), &arena);
 			float accumulatedError = 0.0f;
 
 			for (uint32_t lod = 0; lod < srrhi::CommonConsts::MAX_LOD_COUNT; ++lod)
 			{
-				std::vector<uint32_t> lodIndices;
+				std::pmr::vector<uint32_t> lodIndices(&arena);
 				float lodError = 0.0f;
 
 				if (lod == 0)
@@ -1953,9 +1965,9 @@ void SceneLoader::ProcessMeshes(const cgltf_data* data, Scene& scene, std::vecto
 				}
 
 				size_t max_meshlets = meshopt_buildMeshletsBound(lodIndices.size(), max_vertices, max_triangles);
-				std::vector<meshopt_Meshlet> localMeshlets(max_meshlets);
-				std::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices);
-				std::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3);
+				std::pmr::vector<meshopt_Meshlet> localMeshlets(max_meshlets, &arena);
+				std::pmr::vector<unsigned int> meshlet_vertices(max_meshlets * max_vertices, &arena);
+				std::pmr::vector<unsigned char> meshlet_triangles(max_meshlets * max_triangles * 3, &arena);
 
 				const size_t meshlet_count = meshopt_buildMeshlets(localMeshlets.data(), meshlet_vertices.data(), meshlet_triangles.data(),
 					lodIndices.data(), lodIndices.size(), &optimizedVertices[0].m_Pos.x, uniqueVertices, sizeof(srrhi::Vertex),
@@ -2014,7 +2026,19 @@ void SceneLoader::ProcessMeshes(const cgltf_data* data, Scene& scene, std::vecto
 
 		// SDL_Log("[Scene] Processed Mesh %u Primitive %u: %zu vertices, %zu indices, %zu meshlets",
 		// 	job.meshIdx, job.primIdx, res.vertices.size(), res.indices.size(), res.meshlets.size());
-	});
+	};
+
+	std::vector<AsyncTask> primitiveTasks;
+	primitiveTasks.reserve(jobs.size());
+	for (uint32_t jobIdx = 0; jobIdx < (uint32_t)jobs.size(); ++jobIdx)
+	{
+		primitiveTasks.push_back(processPrimitive(jobIdx));
+		scheduler.RunAsync(primitiveTasks.back());
+	}
+	for (AsyncTask& primitiveTask : primitiveTasks)
+	{
+		scheduler.WaitForAsync(primitiveTask);
+	}
 
 	// Merging results
 	uint32_t currentVertexOffset = (uint32_t)outVerticesQuantized.size();
@@ -0,0 +1,107 @@
+#include "ScratchArena.h"
+
+ScratchArena::ScratchArena(size_t blockSize, std::pmr::memory_resource* upstream)
+    : m_Upstream(upstream)
+    , m_BlockSize(blockSize)
+{
+}
+
+ScratchArena::~ScratchArena()
+{
+    for (const Block& block : m_Blocks)
+    {
+        m_Upstream->deallocate(block.m_Memory, block.m_Size, alignof(std::max_align_t));
+    }
+}
+
+namespace
+{
+    size_t AlignOffset(const std::byte* memory, size_t offset, size_t alignment)
+    {
+        const uintptr_t address = reinterpret_cast<uintptr_t>(memory) + offset;
+        return offset + ((alignment - address % alignment) % alignment);
+    }
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment)
+{
+    m_Allocations.fetch_add(1, std::memory_order_relaxed);
+
+    // Try the current block, then the blocks after it that earlier scopes left behind
+    for (; m_CurrentBlock < m_Blocks.size(); ++m_CurrentBlock, m_Offset = 0)
+    {
+        const Block& block = m_Blocks[m_CurrentBlock];
+        const size_t alignedOffset = AlignOffset(block.m_Memory, m_Offset, alignment);
+        if (alignedOffset + bytes <= block.m_Size)
+        {
+            m_Offset = alignedOffset + bytes;
+            m_HighWaterBytes.store(std::max(m_HighWaterBytes.load(std::memory_order_relaxed), GetUsedBytes()), std::memory_order_relaxed);
+            return block.m_Memory + alignedOffset;
+        }
+    }
+
+    // Out of blocks: grow. Oversized requests get a block of their own size.
+    Block block;
+    block.m_Size = std::max(m_BlockSize, bytes + alignment);
+    block.m_Memory = static_cast<std::byte*>(m_Upstream->allocate(block.m_Size, alignof(std::max_align_t)));
+    m_Blocks.push_back(block);
+    m_BlockAllocations.fetch_add(1, std::memory_order_relaxed);
+    m_CapacityBytes.fetch_add(block.m_Size, std::memory_order_relaxed);
+
+    m_CurrentBlock = static_cast<uint32_t>(m_Blocks.size() - 1);
+    const size_t alignedOffset = AlignOffset(block.m_Memory, 0, alignment);
+    m_Offset = alignedOffset + bytes;
+    m_HighWaterBytes.store(std::max(m_HighWaterBytes.load(std::memory_order_relaxed), GetUsedBytes()), std::memory_order_relaxed);
+    return block.m_Memory + alignedOffset;
+}
+
+void ScratchArena::Rewind(Marker marker)
+{
+    SDL_assert((marker.m_Block < m_CurrentBlock || (marker.m_Block == m_CurrentBlock && marker.m_Offset <= m_Offset)) && "ScratchArena: scopes must be closed in reverse order");
+
+    m_CurrentBlock = marker.m_Block;
+    m_Offset = marker.m_Offset;
+
+    if (m_CurrentBlock == 0 && m_Offset == 0)
+    {
+        ReleaseBlocksOverBudget();
+    }
+}
+
+size_t ScratchArena::GetUsedBytes() const
+{
+    size_t used = m_Offset;
+    for (uint32_t i = 0; i < m_CurrentBlock; ++i)
+    {
+        used += m_Blocks[i].m_Size;
+    }
+    return used;
+}
+
+void ScratchArena::ReleaseBlocksOverBudget()
+{
+    // One huge mesh shouldn't pin hundreds of MB per thread for the rest of the session
+    size_t retained = 0;
+    size_t keepCount = 0;
+    for (; keepCount < m_Blocks.size() && retained + m_Blocks[keepCount].m_Size <= kMaxRetainedBytes; ++keepCount)
+    {
+        retained += m_Blocks[keepCount].m_Size;
+    }
+
+    for (size_t i = keepCount; i < m_Blocks.size(); ++i)
+    {
+        m_Upstream->deallocate(m_Blocks[i].m_Memory, m_Blocks[i].m_Size, alignof(std::max_align_t));
+    }
+    m_Blocks.resize(keepCount);
+    m_CapacityBytes.store(retained, std::memory_order_relaxed);
+}
+
+ScratchArena::Stats ScratchArena::GetStats() const
+{
+    Stats stats;
+    stats.m_Allocations = m_Allocations.load(std::memory_order_relaxed);
+    stats.m_BlockAllocations = m_BlockAllocations.load(std::memory_order_relaxed);
+    stats.m_HighWaterBytes = m_HighWaterBytes.load(std::memory_order_relaxed);
+    stats.m_CapacityBytes = m_CapacityBytes.load(std::memory_order_relaxed);
+    return stats;
+}
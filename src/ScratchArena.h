@@ -0,0 +1,84 @@
+#pragma once
+
+// Resettable linear (bump) allocator for short-lived per-job scratch memory. The TaskScheduler keeps one per thread,
+// see TaskScheduler::GetScratchArena(). It is a std::pmr::memory_resource, so std::pmr containers can sit on top:
+//
+//   ScratchArena::Scope scratchScope{ arena };
+//   std::pmr::vector<uint32_t> remap(indexCount, &arena);
+//
+// deallocate() is a no-op: memory is reclaimed when the Scope that was open at allocation time ends. Blocks are kept
+// across scopes, so in steady state nothing hits the heap. Only the owning thread may allocate from an arena, and a
+// Scope must not be held across a co_await (the coroutine may resume on another thread).
+class ScratchArena : public std::pmr::memory_resource
+{
+public:
+    static const size_t kDefaultBlockSize = 1 << 20;         // 1 MiB
+    static const size_t kMaxRetainedBytes = 64ull << 20;     // blocks beyond this are freed once the arena is empty
+
+    struct Stats
+    {
+        uint64_t m_Allocations = 0;      // requests served
+        uint64_t m_BlockAllocations = 0; // requests that had to go to the upstream (heap) allocator
+        size_t m_HighWaterBytes = 0;     // most bytes in use at once
+        size_t m_CapacityBytes = 0;      // bytes currently held in blocks
+    };
+
+    struct Marker
+    {
+        uint32_t m_Block = 0;
+        size_t m_Offset = 0;
+    };
+
+    // Rewinds the arena to where it was at construction
+    class Scope
+    {
+    public:
+        explicit Scope(ScratchArena& arena) : m_Arena(arena), m_Marker(arena.GetMarker()) {}
+        ~Scope() { m_Arena.Rewind(m_Marker); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ScratchArena& m_Arena;
+        Marker m_Marker;
+    };
+
+    explicit ScratchArena(size_t blockSize = kDefaultBlockSize, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    ~ScratchArena() override;
+
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    Marker GetMarker() const { return { m_CurrentBlock, m_Offset }; }
+    void Rewind(Marker marker);
+    void Reset() { Rewind({}); }
+
+    // Safe to call from other threads (UI), values may be slightly stale
+    Stats GetStats() const;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    size_t GetUsedBytes() const;
+    void ReleaseBlocksOverBudget();
+
+    struct Block
+    {
+        std::byte* m_Memory = nullptr;
+        size_t m_Size = 0;
+    };
+
+    std::pmr::memory_resource* m_Upstream;
+    size_t m_BlockSize;
+    std::vector<Block> m_Blocks;
+    uint32_t m_CurrentBlock = 0;
+    size_t m_Offset = 0;
+
+    std::atomic<uint64_t> m_Allocations{ 0 };
+    std::atomic<uint64_t> m_BlockAllocations{ 0 };
+    std::atomic<size_t> m_HighWaterBytes{ 0 };
+    std::atomic<size_t> m_CapacityBytes{ 0 };
+};
@@ -1,160 +1,1202 @@
+#include "TaskScheduler.h"
+#include "Utilities.h"
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    constexpr uint32_t kExternalThread = UINT32_MAX;
+    constexpr int64_t kInitialDequeCapacity = 256;
+
+    // Which scheduler (if any) owns the calling thread, and its worker index within it
+    thread_local TaskScheduler* t_Scheduler = nullptr;
+    thread_local uint32_t t_WorkerIndex = kExternalThread;
+    // Priority of the task currently executing on this thread; work it spawns (ParallelFor runners) inherits it
+    thread_local TaskPriority t_CurrentPriority = TaskPriority::Normal;
+
+    // Trace thread id of non-worker threads, handed out on first use after the worker ids
+    thread_local uint32_t t_ExternalTraceThreadId = kExternalThread;
+    std::atomic<uint32_t> g_NextExternalTraceThreadId{ TaskScheduler::kMaxThreadCount };
+
+    const char* const kPriorityTraceCategories[] = { "FrameCritical", "Normal", "Background" };
+    static_assert(std::size(kPriorityTraceCategories) == TaskScheduler::kPriorityCount);
+
+    void UpdateHighWater(std::atomic<uint32_t>& highWater, uint32_t value)
+    {
+        uint32_t current = highWater.load(std::memory_order_relaxed);
+        while (value > current && !highWater.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    uint64_t TicksToNanoseconds(uint64_t ticks)
+    {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * 1e9 / static_cast<double>(SDL_GetPerformanceFrequency()));
+    }
+}
+
+// ─── WorkStealingDeque ──────────────────────────────────────────────────────
+// Lê, Pop, Cohen, Zappa Nardelli - "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP'13)
+
+TaskScheduler::WorkStealingDeque::WorkStealingDeque()
+{
+    m_Buffers.push_back(std::make_unique<RingBuffer>(kInitialDequeCapacity));
+    m_Buffer.store(m_Buffers.back().get(), std::memory_order_relaxed);
+}
+
+TaskScheduler::WorkStealingDeque::RingBuffer* TaskScheduler::WorkStealingDeque::Grow(RingBuffer* buffer, int64_t top, int64_t bottom)
+{
+    m_Buffers.push_back(std::make_unique<RingBuffer>(buffer->m_Capacity * 2));
+    RingBuffer* newBuffer = m_Buffers.back().get();
+    for (int64_t i = top; i < bottom; ++i)
+    {
+        newBuffer->Store(i, buffer->Load(i));
+    }
+    m_Buffer.store(newBuffer, std::memory_order_release);
+    return newBuffer;
+}
+
+void TaskScheduler::WorkStealingDeque::Push(Task* task)
+{
+    const int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_Top.load(std::memory_order_acquire);
+    RingBuffer* buffer = m_Buffer.load(std::memory_order_relaxed);
+    if (bottom - top > buffer->m_Capacity - 1)
+    {
+        buffer = Grow(buffer, top, bottom);
+    }
+    buffer->Store(bottom, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+TaskScheduler::Task* TaskScheduler::WorkStealingDeque::Pop()
+{
+    const int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    RingBuffer* buffer = m_Buffer.load(std::memory_order_relaxed);
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_Top.load(std::memory_order_relaxed);
+
+    if (top > bottom)
+    {
+        // empty
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task* task = buffer->Load(bottom);
+    if (top == bottom)
+    {
+        // last element: race against thieves for it
+        if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            task = nullptr;
+        }
+        m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+TaskScheduler::Task* TaskScheduler::WorkStealingDeque::Steal()
+{
+    int64_t top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+
+    if (top >= bottom)
+    {
+        return nullptr;
+    }
+
+    RingBuffer* buffer = m_Buffer.load(std::memory_order_acquire);
+    Task* task = buffer->Load(top);
+    if (!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        // lost the race to another thief or the owner
+        return nullptr;
+    }
+    return task;
+}
+
+bool TaskScheduler::WorkStealingDeque::IsEmpty() const
+{
+    return m_Top.load(std::memory_order_relaxed) >= m_Bottom.load(std::memory_order_relaxed);
+}
+
+uint32_t TaskScheduler::WorkStealingDeque::GetSize() const
+{
+    const int64_t size = m_Bottom.load(std::memory_order_relaxed) - m_Top.load(std::memory_order_relaxed);
+    return size > 0 ? static_cast<uint32_t>(size) : 0;
+}
+
+// ─── CpuTopology ────────────────────────────────────────────────────────────
+
+namespace
+{
+    // Fills in core/SMT/E-core bookkeeping once every logical processor has its m_CoreIndex and efficiency flag
+    void FinalizeTopology(CpuTopology& topology)
+    {
+        std::unordered_set<uint32_t> seenCores;
+        std::unordered_set<uint32_t> efficiencyCores;
+        std::unordered_set<uint32_t> numaNodes;
+        for (CpuTopology::LogicalProcessor& processor : topology.m_LogicalProcessors)
+        {
+            processor.m_bPrimaryThread = seenCores.insert(processor.m_CoreIndex).second;
+            if (processor.m_bEfficiencyCore)
+            {
+                efficiencyCores.insert(processor.m_CoreIndex);
+            }
+            numaNodes.insert(processor.m_NumaNode);
+        }
+        topology.m_PhysicalCoreCount = static_cast<uint32_t>(seenCores.size());
+        topology.m_EfficiencyCoreCount = static_cast<uint32_t>(efficiencyCores.size());
+        topology.m_NumaNodeCount = std::max(1u, static_cast<uint32_t>(numaNodes.size()));
+    }
+
+#ifndef _WIN32
+    // Parses a sysfs cpu list such as "0-3,8-11"
+    std::vector<uint32_t> ReadCpuList(const char* path)
+    {
+        std::vector<uint32_t> cpus;
+        std::ifstream file{ path };
+        std::string list;
+        if (!file || !std::getline(file, list))
+        {
+            return cpus;
+        }
+
+        std::stringstream stream{ list };
+        std::string range;
+        while (std::getline(stream, range, ','))
+        {
+            uint32_t first = 0;
+            uint32_t last = 0;
+            const int parsed = std::sscanf(range.c_str(), "%u-%u", &first, &last);
+            if (parsed < 1)
+            {
+                continue;
+            }
+            for (uint32_t cpu = first; cpu <= (parsed == 2 ? last : first); ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    bool ReadSysfsValue(const std::string& path, uint32_t& value)
+    {
+        std::ifstream file{ path };
+        return static_cast<bool>(file >> value);
+    }
+#endif
+}
+
+CpuTopology CpuTopology::Detect()
+{
+    CpuTopology topology;
+
+#ifdef _WIN32
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+    std::vector<uint8_t> buffer(length);
+    if (length > 0 && GetLogicalProcessorInformationEx(RelationAll, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length))
+    {
+        // EfficiencyClass is relative: on hybrid CPUs the P-cores have the highest class
+        BYTE maxEfficiencyClass = 0;
+        std::vector<BYTE> coreEfficiencyClasses;
+        std::vector<std::pair<DWORD, GROUP_AFFINITY>> numaNodes;
+
+        for (DWORD offset = 0; offset < length;)
+        {
+            const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+            if (info->Relationship == RelationProcessorCore)
+            {
+                const uint32_t coreIndex = static_cast<uint32_t>(coreEfficiencyClasses.size());
+                coreEfficiencyClasses.push_back(info->Processor.EfficiencyClass);
+                maxEfficiencyClass = std::max(maxEfficiencyClass, info->Processor.EfficiencyClass);
+
+                for (WORD g = 0; g < info->Processor.GroupCount; ++g)
+                {
+                    const GROUP_AFFINITY& affinity = info->Processor.GroupMask[g];
+                    for (uint32_t bit = 0; bit < sizeof(KAFFINITY) * 8; ++bit)
+                    {
+                        if (affinity.Mask & (KAFFINITY(1) << bit))
+                        {
+                            LogicalProcessor& processor = topology.m_LogicalProcessors.emplace_back();
+                            processor.m_Id = bit;
+                            processor.m_Group = affinity.Group;
+                            processor.m_CoreIndex = coreIndex;
+                        }
+                    }
+                }
+            }
+            else if (info->Relationship == RelationNumaNode)
+            {
+                numaNodes.push_back({ info->NumaNode.NodeNumber, info->NumaNode.GroupMask });
+            }
+            offset += info->Size;
+        }
+
+        for (LogicalProcessor& processor : topology.m_LogicalProcessors)
+        {
+            processor.m_bEfficiencyCore = coreEfficiencyClasses[processor.m_CoreIndex] < maxEfficiencyClass;
+            for (const auto& [node, affinity] : numaNodes)
+            {
+                if (affinity.Group == processor.m_Group && (affinity.Mask & (KAFFINITY(1) << processor.m_Id)))
+                {
+                    processor.m_NumaNode = node;
+                }
+            }
+        }
+    }
+#else
+    std::vector<uint32_t> onlineCpus = ReadCpuList("/sys/devices/system/cpu/online");
+    const std::vector<uint32_t> atomCpus = ReadCpuList("/sys/devices/cpu_atom/cpus"); // Intel hybrid E-cores
+
+    std::unordered_map<uint32_t, uint32_t> cpuToNode;
+    for (uint32_t node : ReadCpuList("/sys/devices/system/node/online"))
+    {
+        const std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+        for (uint32_t cpu : ReadCpuList(path.c_str()))
+        {
+            cpuToNode[cpu] = node;
+        }
+    }
+
+    // (package, core_id) pairs identify a physical core; core_id alone repeats across sockets
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> coreIndices;
+    for (uint32_t cpu : onlineCpus)
+    {
+        const std::string topologyPath = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/";
+        uint32_t package = 0;
+        uint32_t coreId = cpu;
+        ReadSysfsValue(topologyPath + "physical_package_id", package);
+        ReadSysfsValue(topologyPath + "core_id", coreId);
+
+        LogicalProcessor& processor = topology.m_LogicalProcessors.emplace_back();
+        processor.m_Id = cpu;
+        processor.m_CoreIndex = coreIndices.try_emplace({ package, coreId }, static_cast<uint32_t>(coreIndices.size())).first->second;
+        processor.m_NumaNode = cpuToNode.count(cpu) ? cpuToNode[cpu] : 0;
+        processor.m_bEfficiencyCore = std::find(atomCpus.begin(), atomCpus.end(), cpu) != atomCpus.end();
+    }
+#endif
+
+    if (topology.m_LogicalProcessors.empty())
+    {
+        // Detection failed: treat every hardware thread as its own core
+        const uint32_t processorCount = std::max(1u, std::thread::hardware_concurrency());
+        for (uint32_t i = 0; i < processorCount; ++i)
+        {
+            LogicalProcessor& processor = topology.m_LogicalProcessors.emplace_back();
+            processor.m_Id = i;
+            processor.m_CoreIndex = i;
+        }
+    }
+
+    FinalizeTopology(topology);
+
+    SDL_Log("[TaskScheduler] CPU topology: %u logical processors, %u physical cores (%u efficiency), %u NUMA node%s",
+        static_cast<uint32_t>(topology.m_LogicalProcessors.size()), topology.m_PhysicalCoreCount, topology.m_EfficiencyCoreCount,
+        topology.m_NumaNodeCount, topology.m_NumaNodeCount == 1 ? "" : "s");
+
+    return topology;
+}
+
+const CpuTopology& CpuTopology::Get()
+{
+    static const CpuTopology s_Topology = Detect();
+    return s_Topology;
+}
+
+std::vector<uint32_t> CpuTopology::GetWorkerProcessors() const
+{
+    std::vector<uint32_t> processors;
+    const uint32_t processorCount = static_cast<uint32_t>(m_LogicalProcessors.size());
+
+    // Ranks: P-core primary threads, P-core SMT siblings, E-cores. Within a rank, OS order keeps NUMA nodes together.
+    for (uint32_t rank = 0; rank < 3; ++rank)
+    {
+        for (uint32_t i = 0; i < processorCount; ++i)
+        {
+            const LogicalProcessor& processor = m_LogicalProcessors[i];
+            const uint32_t processorRank = processor.m_bEfficiencyCore ? 2 : (processor.m_bPrimaryThread ? 0 : 1);
+            if (processorRank == rank)
+            {
+                processors.push_back(i);
+            }
+        }
+    }
+    return processors;
+}
+
+bool CpuTopology::SetCurrentThreadAffinity(std::span<const uint32_t> processors) const
+{
+    std::vector<uint32_t> allProcessors;
+    if (processors.empty())
+    {
+        allProcessors.resize(m_LogicalProcessors.size());
+        for (uint32_t i = 0; i < static_cast<uint32_t>(allProcessors.size()); ++i)
+        {
+            allProcessors[i] = i;
+        }
+        processors = allProcessors;
+    }
+
+#ifdef _WIN32
+    // A thread's affinity can only span one processor group: use the group of the first processor
+    GROUP_AFFINITY affinity{};
+    affinity.Group = static_cast<WORD>(m_LogicalProcessors[processors[0]].m_Group);
+    for (uint32_t index : processors)
+    {
+        const LogicalProcessor& processor = m_LogicalProcessors[index];
+        if (processor.m_Group == affinity.Group)
+        {
+            affinity.Mask |= KAFFINITY(1) << processor.m_Id;
+        }
+    }
+    return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#else
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (uint32_t index : processors)
+    {
+        CPU_SET(m_LogicalProcessors[index].m_Id, &cpuSet);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#endif
+}
+
+// ─── TaskScheduler ──────────────────────────────────────────────────────────
+
+TaskScheduler::TaskScheduler()
+    : m_WorkerStates(new WorkerState[kMaxThreadCount])
+    , m_ScratchArenas(new ScratchArena[kMaxThreadCount])
+{
+    for (uint32_t i = 0; i < kMaxThreadCount; ++i)
+    {
+        m_WorkerStates[i].m_StealSeed = i * 2654435761u + 1;
+    }
+
+    SetThreadCount(GetDefaultThreadCount());
+}
+
+uint32_t TaskScheduler::GetDefaultThreadCount()
+{
+    const CpuTopology& topology = CpuTopology::Get();
+    const uint32_t performanceCoreCount = topology.GetPerformanceCoreCount() > 0 ? topology.GetPerformanceCoreCount() : topology.m_PhysicalCoreCount;
+    return std::clamp(performanceCoreCount, 2u, kMaxThreadCount + 1) - 1;
+}
+
+ScratchArena& TaskScheduler::GetScratchArena(uint32_t threadIndex)
+{
+    const bool bIsWorker = t_Scheduler == this && t_WorkerIndex != kExternalThread;
+    SDL_assert((!bIsWorker || threadIndex == t_WorkerIndex) && "GetScratchArena: threadIndex belongs to another thread");
+
+    if (bIsWorker)
+    {
+        return m_ScratchArenas[threadIndex];
+    }
+
+    // The main thread and other non-worker threads all share the same external threadIndex, so they can't share an arena
+    thread_local ScratchArena t_ExternalScratchArena;
+    return t_ExternalScratchArena;
+}
+
+ScratchArena& TaskScheduler::GetScratchArena()
+{
+    const bool bIsWorker = t_Scheduler == this && t_WorkerIndex != kExternalThread;
+    return GetScratchArena(bIsWorker ? t_WorkerIndex : GetThreadCount());
+}
+
+ScratchArena::Stats TaskScheduler::GetScratchArenaStats() const
+{
+    ScratchArena::Stats total;
+    for (uint32_t i = 0; i < kMaxThreadCount; ++i)
+    {
+        const ScratchArena::Stats stats = m_ScratchArenas[i].GetStats();
+        total.m_Allocations += stats.m_Allocations;
+        total.m_BlockAllocations += stats.m_BlockAllocations;
+        total.m_HighWaterBytes = std::max(total.m_HighWaterBytes, stats.m_HighWaterBytes);
+        total.m_CapacityBytes += stats.m_CapacityBytes;
+    }
+    return total;
+}
+
+void TaskScheduler::SetWorkerPinning(bool bEnabled)
+{
+    m_bPinWorkers = bEnabled;
+    WakeWorkers(UINT32_MAX);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    m_Stop = true;
+    WakeWorkers(UINT32_MAX);
+
+    for (std::thread& worker : m_Workers)
+    {
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+}
+
+void TaskScheduler::SetThreadCount(uint32_t count)
+{
+    count = std::min(count, kMaxThreadCount);
+
+    const uint32_t currentCount = static_cast<uint32_t>(m_Workers.size());
+    if (count > currentCount)
+    {
+        m_TargetThreadCount = count;
+        m_ThreadCount = count;
+        for (uint32_t i = currentCount; i < count; ++i)
+        {
+            m_Workers.emplace_back(&TaskScheduler::WorkerThread, this, i);
+        }
+    }
+    else if (count < currentCount)
+    {
+        // Retiring workers hand their remaining local tasks back to the inject queue before exiting
+        m_TargetThreadCount = count;
+        WakeWorkers(UINT32_MAX);
+
+        for (uint32_t i = count; i < currentCount; ++i)
+        {
+            if (m_Workers[i].joinable())
+            {
+                m_Workers[i].join();
+            }
+        }
+        m_Workers.resize(count);
+        m_ThreadCount = count;
+    }
+}
+
+void TaskScheduler::WakeWorkers(uint32_t count)
+{
+    m_WakeEpoch.fetch_add(1);
+    if (m_SleepingCount.load() == 0)
+    {
+        return;
+    }
+
+    if (count == 1)
+    {
+        m_WakeEpoch.notify_one();
+    }
+    else
+    {
+        m_WakeEpoch.notify_all();
+    }
+}
+
+void TaskScheduler::SubmitTasks(Task* const* tasks, uint32_t count, TaskPriority priority)
+{
+    const uint32_t p = static_cast<uint32_t>(priority);
+    uint32_t attachedCount = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        tasks[i]->m_Priority = priority;
+        attachedCount += tasks[i]->m_bDetached ? 0 : 1;
+    }
+
+    m_RemainingTasks.fetch_add(attachedCount);
+    m_PriorityCounters[p].m_Submitted.fetch_add(count, std::memory_order_relaxed);
+
+    if (t_Scheduler == this && t_WorkerIndex != kExternalThread)
+    {
+        // Submissions from our own workers go straight into their local deque, no lock taken
+        WorkStealingDeque& deque = m_WorkerStates[t_WorkerIndex].m_Deques[p];
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            deque.Push(tasks[i]);
+        }
+        UpdateHighWater(m_WorkerStates[t_WorkerIndex].m_Counters.m_QueueDepthHighWater, deque.GetSize());
+    }
+    else
+    {
+        std::unique_lock<std::mutex> lock = LockInjectQueues();
+        m_InjectQueues[p].insert(m_InjectQueues[p].end(), tasks, tasks + count);
+        m_InjectCounts[p].fetch_add(count);
+        UpdateHighWater(m_ExternalCounters.m_QueueDepthHighWater, static_cast<uint32_t>(m_InjectQueues[p].size()));
+    }
+
+    WakeWorkers(count);
+}
+
+TaskScheduler::Task* TaskScheduler::PopInjectedTask(uint32_t threadIndex, uint32_t priority)
+{
+    if (m_InjectCounts[priority].load(std::memory_order_relaxed) == 0)
+    {
+        return nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock = LockInjectQueues();
+    std::deque<Task*>& queue = m_InjectQueues[priority];
+    if (queue.empty())
+    {
+        return nullptr;
+    }
+
+    Task* task = queue.front();
+    queue.pop_front();
+    uint32_t taken = 1;
+
+    // Workers grab a fair share of the inject queue in one lock so the rest of the batch can be
+    // stolen from their deque instead of everyone contending on m_InjectMutex
+    if (threadIndex != kExternalThread)
+    {
+        const uint32_t share = static_cast<uint32_t>(queue.size()) / std::max(1u, m_ThreadCount.load(std::memory_order_relaxed));
+        WorkStealingDeque& deque = m_WorkerStates[threadIndex].m_Deques[priority];
+        for (uint32_t i = 0; i < share; ++i)
+        {
+            deque.Push(queue.front());
+            queue.pop_front();
+        }
+        taken += share;
+    }
+
+    m_InjectCounts[priority].fetch_sub(taken);
+    return task;
+}
+
+TaskScheduler::Task* TaskScheduler::StealTask(uint32_t threadIndex, uint32_t priority)
+{
+    const uint32_t threadCount = m_ThreadCount.load(std::memory_order_relaxed);
+    if (threadCount == 0)
+    {
+        return nullptr;
+    }
+
+    // Random start so thieves spread out over victims instead of all hammering worker 0
+    uint32_t start = 0;
+    if (threadIndex != kExternalThread)
+    {
+        uint32_t& seed = m_WorkerStates[threadIndex].m_StealSeed;
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        start = seed % threadCount;
+    }
+
+    for (uint32_t i = 0; i < threadCount; ++i)
+    {
+        const uint32_t victim = (start + i) % threadCount;
+        if (victim == threadIndex)
+        {
+            continue;
+        }
+
+        WorkStealingDeque& deque = m_WorkerStates[victim].m_Deques[priority];
+        if (deque.IsEmpty())
+        {
+            continue;
+        }
+
+        if (Task* task = deque.Steal())
+        {
+            GetCounters().m_Steals.fetch_add(1, std::memory_order_relaxed);
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+TaskScheduler::Task* TaskScheduler::FindTaskAtPriority(uint32_t threadIndex, uint32_t priority)
+{
+    if (threadIndex != kExternalThread)
+    {
+        if (Task* task = m_WorkerStates[threadIndex].m_Deques[priority].Pop())
+        {
+            return task;
+        }
+    }
+
+    if (Task* task = PopInjectedTask(threadIndex, priority))
+    {
+        return task;
+    }
+
+    return StealTask(threadIndex, priority);
+}
+
+TaskScheduler::Task* TaskScheduler::FindTask(uint32_t threadIndex)
+{
+    // Starvation guard: every kStarvationInterval picks a worker serves the lowest non-empty class first,
+    // bounding how long background work can be held off by a steady stream of higher-priority tasks.
+    // Only scans that dequeue something count as picks, so an idle worker polling empty queues doesn't bring it forward.
+    uint32_t* picksSinceCheck = (threadIndex != kExternalThread) ? &m_WorkerStates[threadIndex].m_PicksSinceStarvationCheck : nullptr;
+    if (picksSinceCheck && *picksSinceCheck + 1 >= kStarvationInterval)
+    {
+        for (uint32_t p = kPriorityCount - 1; p > 0; --p)
+        {
+            if (Task* task = FindTaskAtPriority(threadIndex, p))
+            {
+                *picksSinceCheck = 0;
+                m_PriorityCounters[p].m_StarvationPicks.fetch_add(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+    }
+
+    // Threads that only help while they wait (the main thread) leave Background work to the workers, so a long
+    // streaming task can't be picked up in the middle of a frame. With no workers they have to take it themselves.
+    const uint32_t priorityCount = (threadIndex == kExternalThread && GetThreadCount() > 0) ? kPriorityCount - 1 : kPriorityCount;
+    for (uint32_t p = 0; p < priorityCount; ++p)
+    {
+        if (Task* task = FindTaskAtPriority(threadIndex, p))
+        {
+            // A guard pick with nothing lower-priority waiting still ends the interval
+            if (picksSinceCheck)
+                *picksSinceCheck = (*picksSinceCheck + 1 >= kStarvationInterval) ? 0 : *picksSinceCheck + 1;
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void TaskScheduler::ExecuteTask(Task* task, uint32_t threadIndex)
+{
+    const TaskPriority priority = task->m_Priority;
+    const bool bDetached = task->m_bDetached;
+    const char* name = task->m_Name;
+    const TaskPriority previousPriority = t_CurrentPriority;
+    t_CurrentPriority = priority;
+
+    const bool bTrace = IsTraceCaptureActive();
+    const uint64_t startTicks = bTrace ? SDL_GetPerformanceCounter() : 0;
+
+    task->m_Func(threadIndex);
+    delete task;
+
+    if (bTrace)
+    {
+        RecordTraceEvent(name, kPriorityTraceCategories[static_cast<uint32_t>(priority)], startTicks, SDL_GetPerformanceCounter());
+    }
+
+    t_CurrentPriority = previousPriority;
+    m_PriorityCounters[static_cast<uint32_t>(priority)].m_Executed.fetch_add(1, std::memory_order_relaxed);
+    GetCounters().m_TasksExecuted.fetch_add(1, std::memory_order_relaxed);
+
+    if (!bDetached && m_RemainingTasks.fetch_sub(1) == 1)
+    {
+        std::lock_guard<std::mutex> lock(m_CompletionMutex);
+        m_CompletionCondition.notify_all();
+    }
+}
+
+TaskScheduler::PriorityStats TaskScheduler::GetPriorityStats(TaskPriority priority) const
+{
+    const PriorityCounters& counters = m_PriorityCounters[static_cast<uint32_t>(priority)];
+
+    PriorityStats stats;
+    stats.m_Submitted = counters.m_Submitted.load(std::memory_order_relaxed);
+    stats.m_Executed = counters.m_Executed.load(std::memory_order_relaxed);
+    stats.m_StarvationPicks = counters.m_StarvationPicks.load(std::memory_order_relaxed);
+    return stats;
+}
 
-#include "TaskScheduler.h"
+TaskScheduler::WorkerCounters& TaskScheduler::GetCounters()
+{
+    const bool bIsWorker = t_Scheduler == this && t_WorkerIndex != kExternalThread;
+    return bIsWorker ? m_WorkerStates[t_WorkerIndex].m_Counters : m_ExternalCounters;
+}
 
-TaskScheduler::TaskScheduler()
+std::unique_lock<std::mutex> TaskScheduler::LockInjectQueues()
 {
-    SetThreadCount(kRuntimeThreadCount);
+    // Only contended acquisitions pay for the timestamps
+    std::unique_lock<std::mutex> lock(m_InjectMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        const uint64_t waitStart = SDL_GetPerformanceCounter();
+        lock.lock();
+        GetCounters().m_LockWaitTicks.fetch_add(SDL_GetPerformanceCounter() - waitStart, std::memory_order_relaxed);
+    }
+    return lock;
 }
 
-TaskScheduler::~TaskScheduler()
+TaskScheduler::WorkerStats TaskScheduler::GetWorkerStats(uint32_t threadIndex) const
 {
+    const WorkerCounters& counters = threadIndex < GetThreadCount() ? m_WorkerStates[threadIndex].m_Counters : m_ExternalCounters;
+
+    WorkerStats stats;
+    stats.m_TasksExecuted = counters.m_TasksExecuted.load(std::memory_order_relaxed);
+    stats.m_Steals = counters.m_Steals.load(std::memory_order_relaxed);
+    stats.m_IdleNs = TicksToNanoseconds(counters.m_IdleTicks.load(std::memory_order_relaxed));
+    stats.m_LockWaitNs = TicksToNanoseconds(counters.m_LockWaitTicks.load(std::memory_order_relaxed));
+    stats.m_QueueDepthHighWater = counters.m_QueueDepthHighWater.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void TaskScheduler::ResetWorkerStats()
+{
+    auto reset = [](WorkerCounters& counters)
     {
-        std::lock_guard<std::mutex> lock(m_QueueMutex);
-        m_Stop = true;
+        counters.m_TasksExecuted.store(0, std::memory_order_relaxed);
+        counters.m_Steals.store(0, std::memory_order_relaxed);
+        counters.m_IdleTicks.store(0, std::memory_order_relaxed);
+        counters.m_LockWaitTicks.store(0, std::memory_order_relaxed);
+        counters.m_QueueDepthHighWater.store(0, std::memory_order_relaxed);
+    };
+
+    for (uint32_t i = 0; i < kMaxThreadCount; ++i)
+    {
+        reset(m_WorkerStates[i].m_Counters);
     }
-    m_Condition.notify_all();
-    for (std::thread& worker : m_Workers)
+    reset(m_ExternalCounters);
+}
+
+void TaskScheduler::RecordTraceEvent(const char* name, const char* category, uint64_t startTicks, uint64_t endTicks)
+{
+    uint32_t threadId = t_WorkerIndex;
+    if (t_Scheduler != this || t_WorkerIndex == kExternalThread)
     {
-        if (worker.joinable())
+        if (t_ExternalTraceThreadId == kExternalThread)
         {
-            worker.join();
+            t_ExternalTraceThreadId = g_NextExternalTraceThreadId.fetch_add(1, std::memory_order_relaxed);
         }
+        threadId = t_ExternalTraceThreadId;
+    }
+
+    // Only taken while a capture is running
+    std::lock_guard<std::mutex> lock(m_TraceMutex);
+    if (m_bTraceCapture.load(std::memory_order_relaxed))
+    {
+        m_TraceEvents.push_back({ name ? name : "Task", category, threadId, startTicks, endTicks });
     }
 }
 
-void TaskScheduler::SetThreadCount(uint32_t count)
+void TaskScheduler::BeginTraceCapture()
 {
-    std::vector<std::thread> threadsToJoin;
+    std::lock_guard<std::mutex> lock(m_TraceMutex);
+    m_TraceEvents.clear();
+    m_bTraceCapture.store(true, std::memory_order_relaxed);
+}
+
+bool TaskScheduler::EndTraceCapture(const std::filesystem::path& path)
+{
+    PROFILE_FUNCTION();
+
+    std::vector<TraceEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(m_TraceMutex);
+        m_bTraceCapture.store(false, std::memory_order_relaxed);
+        events.swap(m_TraceEvents);
+    }
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file)
     {
-        std::lock_guard<std::mutex> lock(m_QueueMutex);
-        
-        if (count > m_Workers.size())
+        SDL_Log("[TaskScheduler] Failed to open trace file: %s", path.string().c_str());
+        return false;
+    }
+
+    uint64_t baseTicks = UINT64_MAX;
+    std::vector<uint32_t> threadIds;
+    for (const TraceEvent& event : events)
+    {
+        baseTicks = std::min(baseTicks, event.m_StartTicks);
+        threadIds.push_back(event.m_ThreadId);
+    }
+    std::sort(threadIds.begin(), threadIds.end());
+    threadIds.erase(std::unique(threadIds.begin(), threadIds.end()), threadIds.end());
+
+    auto writeEscaped = [&file](const char* text)
+    {
+        for (; *text; ++text)
         {
-            uint32_t startIdx = static_cast<uint32_t>(m_Workers.size());
-            m_TargetThreadCount = count;
-            for (uint32_t i = startIdx; i < count; ++i)
+            if (*text == '"' || *text == '\\')
             {
-                m_Workers.emplace_back(&TaskScheduler::WorkerThread, this, i);
+                file << '\\';
             }
+            file << *text;
+        }
+    };
+
+    // Trace Event Format: complete ("X") events with microsecond timestamps, plus a name per thread
+    const double ticksToMicroseconds = 1e6 / static_cast<double>(SDL_GetPerformanceFrequency());
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool bFirst = true;
+    for (uint32_t threadId : threadIds)
+    {
+        file << (bFirst ? "" : ",\n");
+        bFirst = false;
+        if (threadId < kMaxThreadCount)
+        {
+            file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId << ",\"args\":{\"name\":\"Worker " << threadId << "\"}}";
+        }
+        else
+        {
+            file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadId << ",\"args\":{\"name\":\"External " << threadId - kMaxThreadCount << "\"}}";
         }
-        else if (count < m_Workers.size())
+    }
+
+    file << std::fixed << std::setprecision(3);
+    for (const TraceEvent& event : events)
+    {
+        file << (bFirst ? "" : ",\n");
+        bFirst = false;
+        file << "{\"name\":\"";
+        writeEscaped(event.m_Name);
+        file << "\",\"cat\":\"" << event.m_Category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.m_ThreadId
+             << ",\"ts\":" << (event.m_StartTicks - baseTicks) * ticksToMicroseconds
+             << ",\"dur\":" << (event.m_EndTicks - event.m_StartTicks) * ticksToMicroseconds << "}";
+    }
+    file << "\n]}\n";
+
+    if (!file)
+    {
+        SDL_Log("[TaskScheduler] Failed to write trace file: %s", path.string().c_str());
+        return false;
+    }
+
+    SDL_Log("[TaskScheduler] Wrote %zu trace events to %s", events.size(), path.string().c_str());
+    return true;
+}
+
+void TaskScheduler::ParallelFor(uint32_t count, const std::function<void(uint32_t index, uint32_t threadIndex)>& func)
+{
+    // One item per chunk: callers of this overload hand out coarse jobs (e.g. whole mesh primitives)
+    ParallelFor(0, count, 1, func);
+}
+
+uint32_t TaskScheduler::ResolveGrainSize(uint32_t itemCount, uint32_t grainSize, uint32_t participantCount)
+{
+    if (grainSize != 0)
+    {
+        return grainSize;
+    }
+    // ~4 chunks per participant: enough slack for stealing to even out uneven items without paying for tiny chunks
+    return std::max(1u, DivideAndRoundUp(itemCount, participantCount * 4));
+}
+
+void TaskScheduler::ParallelForRange(uint32_t begin, uint32_t end, uint32_t grainSize, void* context, RangeFunc rangeFunc)
+{
+    if (begin >= end) return;
+
+    const bool bIsWorker = t_Scheduler == this && t_WorkerIndex != kExternalThread;
+    const uint32_t callerIndex = bIsWorker ? t_WorkerIndex : GetThreadCount();
+    const uint32_t itemCount = end - begin;
+    const uint32_t participantCount = GetThreadCount() + 1;
+
+    grainSize = ResolveGrainSize(itemCount, grainSize, participantCount);
+    const uint32_t chunkCount = DivideAndRoundUp(itemCount, grainSize);
+    if (chunkCount == 1 || participantCount == 1)
+    {
+        rangeFunc(context, begin, end, callerIndex);
+        return;
+    }
+
+    // Chunks are claimed dynamically from a shared counter by a handful of runner tasks rather than
+    // pre-assigned, so a slow chunk on one thread does not hold up the others
+    struct RangeJob
+    {
+        void* m_Context;
+        RangeFunc m_RangeFunc;
+        uint32_t m_Begin;
+        uint32_t m_End;
+        uint32_t m_GrainSize;
+        uint32_t m_ChunkCount;
+        std::atomic<uint32_t> m_NextChunk{ 0 };
+        std::atomic<uint32_t> m_RemainingRunners{ 0 };
+        std::mutex m_CompletionMutex;
+        std::condition_variable m_CompletionCondition;
+        bool m_bDone = false;
+
+        void Run(uint32_t threadIndex)
         {
-            m_TargetThreadCount = count;
-            m_Condition.notify_all();
-            
-            for (uint32_t i = count; i < m_Workers.size(); ++i)
+            for (uint32_t chunk = m_NextChunk.fetch_add(1); chunk < m_ChunkCount; chunk = m_NextChunk.fetch_add(1))
             {
-                threadsToJoin.push_back(std::move(m_Workers[i]));
+                const uint32_t chunkBegin = m_Begin + chunk * m_GrainSize;
+                const uint32_t chunkEnd = std::min(m_End, chunkBegin + m_GrainSize);
+                m_RangeFunc(m_Context, chunkBegin, chunkEnd, threadIndex);
             }
-            m_Workers.resize(count);
         }
-        else
+
+        void RunnerFinished()
         {
-            m_TargetThreadCount = count;
+            // last runner to finish signals completion
+            if (m_RemainingRunners.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(m_CompletionMutex);
+                m_bDone = true;
+                m_CompletionCondition.notify_all();
+            }
         }
+    };
+
+    RangeJob job;
+    job.m_Context = context;
+    job.m_RangeFunc = rangeFunc;
+    job.m_Begin = begin;
+    job.m_End = end;
+    job.m_GrainSize = grainSize;
+    job.m_ChunkCount = chunkCount;
+
+    // The caller is one of the runners, so only spawn tasks for the others
+    const uint32_t runnerCount = std::min(chunkCount, participantCount) - 1;
+    job.m_RemainingRunners = runnerCount + 1;
+
+    Task* runners[kMaxThreadCount];
+    for (uint32_t i = 0; i < runnerCount; ++i)
+    {
+        runners[i] = new Task{ [&job](uint32_t threadIndex)
+            {
+                job.Run(threadIndex);
+                job.RunnerFinished();
+            } };
+        runners[i]->m_Name = "ParallelFor";
     }
+    SubmitTasks(runners, runnerCount, t_CurrentPriority);
+
+    job.Run(callerIndex);
+    job.RunnerFinished();
+
+    // All chunks are claimed; help with other work until the runners still in flight are done. Runners that
+    // have not started yet are found here too and exit immediately. The caller keeps helping instead of
+    // sleeping so nested ParallelFor calls from worker threads stay deadlock-free.
+    HelpWhilePending(job.m_RemainingRunners);
+
+    std::unique_lock<std::mutex> lock(job.m_CompletionMutex);
+    job.m_CompletionCondition.wait(lock, [&job]() { return job.m_bDone; });
+}
+
+// ─── Coroutines ─────────────────────────────────────────────────────────────
 
-    for (std::thread& t : threadsToJoin)
+AsyncTask& AsyncTask::operator=(AsyncTask&& other) noexcept
+{
+    if (this != &other)
     {
-        if (t.joinable())
+        if (m_Handle)
         {
-            t.join();
+            m_Handle.destroy();
         }
+        m_Handle = std::exchange(other.m_Handle, nullptr);
     }
+    return *this;
 }
 
-void TaskScheduler::ParallelFor(uint32_t count, const std::function<void(uint32_t index, uint32_t threadIndex)>& func)
+AsyncTask::~AsyncTask()
+{
+    // The frame may only go away before the coroutine started or after it finished; destroying a suspended one
+    // would leave its runner tasks resuming freed memory
+    if (m_Handle)
+    {
+        m_Handle.destroy();
+    }
+}
+
+std::coroutine_handle<> AsyncTask::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept
 {
-    if (count == 0) return;
+    promise_type& promise = handle.promise();
 
-    std::atomic<uint32_t> remaining{ count };
-    std::mutex completionMutex;
-    std::condition_variable completionCondition;
+    // Read before signalling: once m_bDone is set the owner may destroy the frame
+    const std::coroutine_handle<> continuation = promise.m_Continuation;
 
+    promise.m_Pending.store(0, std::memory_order_release);
     {
-        std::lock_guard<std::mutex> lock(m_QueueMutex);
-        m_RemainingTasks.fetch_add(count);
-        for (uint32_t i = 0; i < count; ++i)
-        {
-            m_Tasks.push_back([i, &func, &remaining, &completionCondition, &completionMutex](uint32_t threadIndex)
+        std::lock_guard<std::mutex> lock(promise.m_CompletionMutex);
+        promise.m_bDone = true;
+        promise.m_CompletionCondition.notify_all();
+    }
+
+    // Symmetric transfer back into an awaiting parent, so chains of child tasks don't grow the stack
+    return continuation ? continuation : std::noop_coroutine();
+}
+
+bool TaskScheduler::RangeAwaiter::await_ready()
+{
+    if (m_Begin >= m_End)
+    {
+        return true;
+    }
+
+    const uint32_t participantCount = m_Scheduler->GetThreadCount() + 1;
+    m_GrainSize = ResolveGrainSize(m_End - m_Begin, m_GrainSize, participantCount);
+    m_ChunkCount = DivideAndRoundUp(m_End - m_Begin, m_GrainSize);
+    if (m_ChunkCount > 1 && participantCount > 1)
+    {
+        return false;
+    }
+
+    // Not worth suspending for: run it right here
+    const bool bIsWorker = t_Scheduler == m_Scheduler && t_WorkerIndex != kExternalThread;
+    m_RangeFunc(m_Context, m_Begin, m_End, bIsWorker ? t_WorkerIndex : m_Scheduler->GetThreadCount());
+    return true;
+}
+
+void TaskScheduler::RangeAwaiter::RunChunks(uint32_t threadIndex)
+{
+    for (uint32_t chunk = m_NextChunk.fetch_add(1); chunk < m_ChunkCount; chunk = m_NextChunk.fetch_add(1))
+    {
+        const uint32_t chunkBegin = m_Begin + chunk * m_GrainSize;
+        const uint32_t chunkEnd = std::min(m_End, chunkBegin + m_GrainSize);
+        m_RangeFunc(m_Context, chunkBegin, chunkEnd, threadIndex);
+    }
+}
+
+void TaskScheduler::RangeAwaiter::await_suspend(std::coroutine_handle<> continuation)
+{
+    m_Continuation = continuation;
+
+    // The suspended coroutine's thread goes back to its scheduler loop, so it can be one of the runners too
+    TaskScheduler* scheduler = m_Scheduler;
+    const uint32_t runnerCount = std::min(m_ChunkCount, scheduler->GetThreadCount() + 1);
+    m_RemainingRunners.store(runnerCount, std::memory_order_relaxed);
+
+    Task* runners[kMaxThreadCount + 1];
+    for (uint32_t i = 0; i < runnerCount; ++i)
+    {
+        runners[i] = new Task{ [this](uint32_t threadIndex)
+            {
+                RunChunks(threadIndex);
+
+                // Last runner resumes the coroutine, which owns this awaiter: nothing may touch 'this' afterwards
+                if (m_RemainingRunners.fetch_sub(1) == 1)
                 {
-                    func(i, threadIndex);
+                    m_Continuation.resume();
+                }
+            } };
+        runners[i]->m_Name = "ParallelForAsync";
+    }
 
-                    // last task to finish signals completion
-                    if (remaining.fetch_sub(1) == 1)
-                    {
-                        std::lock_guard<std::mutex> lock(completionMutex);
-                        completionCondition.notify_all();
-                    }
-                });
-        }
+    // The coroutine can be resumed (and this awaiter destroyed) before SubmitTasks returns
+    scheduler->SubmitTasks(runners, runnerCount, t_CurrentPriority);
+}
+
+void TaskScheduler::RunAsync(AsyncTask& task, TaskPriority priority)
+{
+    SDL_assert(task.IsValid() && "RunAsync: empty AsyncTask");
+
+    Task* startTask = new Task{ [handle = task.m_Handle](uint32_t)
+        {
+            handle.resume();
+        } };
+    startTask->m_Name = "AsyncTask";
+    SubmitTasks(&startTask, 1, priority);
+}
+
+void TaskScheduler::WaitForAsync(AsyncTask& task)
+{
+    PROFILE_FUNCTION();
+
+    if (!task.IsValid())
+    {
+        return;
     }
-    m_Condition.notify_all();
-    m_CompletionCondition.notify_all();
 
-    std::unique_lock<std::mutex> lock(completionMutex);
-    completionCondition.wait(lock, [&remaining]() { return remaining == 0; });
+    AsyncTask::promise_type& promise = task.m_Handle.promise();
+    HelpWhilePending(promise.m_Pending);
+
+    std::unique_lock<std::mutex> lock(promise.m_CompletionMutex);
+    promise.m_CompletionCondition.wait(lock, [&promise]() { return promise.m_bDone; });
+}
+
+void TaskScheduler::HelpWhilePending(const std::atomic<uint32_t>& pendingCount)
+{
+    const bool bIsWorker = t_Scheduler == this && t_WorkerIndex != kExternalThread;
+    const uint32_t findIndex = bIsWorker ? t_WorkerIndex : kExternalThread;
+    const uint32_t executeIndex = bIsWorker ? t_WorkerIndex : GetThreadCount();
+
+    while (pendingCount.load(std::memory_order_acquire) > 0)
+    {
+        Task* task = FindTask(findIndex);
+        if (!task)
+        {
+            // Whatever is left is already running on other threads
+            return;
+        }
+        ExecuteTask(task, executeIndex);
+    }
 }
 
-void TaskScheduler::ScheduleTask(std::function<void()> func, bool bImmediateExecute)
+void TaskScheduler::ScheduleTask(std::function<void()> func, bool bImmediateExecute, TaskPriority priority)
 {
-    std::lock_guard<std::mutex> lock(m_QueueMutex);
     if (bImmediateExecute)
     {
-        m_RemainingTasks.fetch_add(1);
-        m_Tasks.push_back([func](uint32_t)
+        Task* task = new Task{ [func = std::move(func)](uint32_t)
             {
                 func();
-            });
-
-        m_Condition.notify_one();
+            } };
+        SubmitTasks(&task, 1, priority);
     }
     else
     {
-        m_DeferredTasks.push_back([func]() { func(); });
+        std::lock_guard<std::mutex> lock(m_DeferredMutex);
+        m_DeferredTasks.push_back({ std::move(func), priority });
     }
 }
 
+void TaskScheduler::ScheduleDetachedTask(std::function<void()> func, TaskPriority priority)
+{
+    Task* task = new Task{ [func = std::move(func)](uint32_t)
+        {
+            func();
+        } };
+    task->m_bDetached = true;
+    task->m_Name = "Detached Task";
+    SubmitTasks(&task, 1, priority);
+}
+
 void TaskScheduler::ExecuteAllScheduledTasks()
 {
     PROFILE_FUNCTION();
 
-    m_Condition.notify_all();
-
-    for (std::function<void()>& deferredTask : m_DeferredTasks)
+    std::vector<DeferredTask> deferredTasks;
     {
-        ScheduleTask(std::move(deferredTask));
+        std::lock_guard<std::mutex> lock(m_DeferredMutex);
+        deferredTasks.swap(m_DeferredTasks);
     }
-    m_DeferredTasks.clear();
 
-    while (m_RemainingTasks > 0)
+    if (!deferredTasks.empty())
     {
-        std::function<void(uint32_t)> task;
+        std::vector<Task*> tasks;
+        tasks.reserve(deferredTasks.size());
+        for (uint32_t p = 0; p < kPriorityCount; ++p)
         {
-            std::lock_guard<std::mutex> lock(m_QueueMutex);
-            if (!m_Tasks.empty())
+            tasks.clear();
+            for (DeferredTask& deferredTask : deferredTasks)
             {
-                task = std::move(m_Tasks.back());
-                m_Tasks.pop_back();
+                if (static_cast<uint32_t>(deferredTask.m_Priority) == p)
+                {
+                    tasks.push_back(new Task{ [func = std::move(deferredTask.m_Func)](uint32_t) { func(); } });
+                }
+            }
+            if (!tasks.empty())
+            {
+                SubmitTasks(tasks.data(), static_cast<uint32_t>(tasks.size()), static_cast<TaskPriority>(p));
             }
         }
+    }
 
-        if (task)
+    const uint32_t mainThreadIndex = GetThreadCount();
+    while (m_RemainingTasks > 0)
+    {
+        if (Task* task = FindTask(kExternalThread))
         {
-            task(GetThreadCount());
-
-            if (m_RemainingTasks.fetch_sub(1) == 1)
-            {
-                std::lock_guard<std::mutex> lock(m_CompletionMutex);
-                m_CompletionCondition.notify_all();
-            }
+            ExecuteTask(task, mainThreadIndex);
         }
         else
         {
-            std::unique_lock<std::mutex> lock(m_CompletionMutex);
-            if (m_RemainingTasks > 0)
+            // Nothing left to steal; everything remaining is in flight on workers. Wake up periodically in case
+            // those tasks spawn more work the main thread can help with
+            const uint64_t idleStart = SDL_GetPerformanceCounter();
+            {
+                std::unique_lock<std::mutex> lock(m_CompletionMutex);
+                m_CompletionCondition.wait_for(lock, std::chrono::microseconds(500), [this]() { return m_RemainingTasks == 0; });
+            }
+            const uint64_t idleEnd = SDL_GetPerformanceCounter();
+            m_ExternalCounters.m_IdleTicks.fetch_add(idleEnd - idleStart, std::memory_order_relaxed);
+            if (IsTraceCaptureActive())
             {
-                m_CompletionCondition.wait(lock, [this]() { return m_RemainingTasks == 0 || !m_Tasks.empty(); });
+                RecordTraceEvent("Idle", "Idle", idleStart, idleEnd);
             }
         }
     }
@@ -162,29 +1204,237 @@ void TaskScheduler::ExecuteAllScheduledTasks()
 
 void TaskScheduler::WorkerThread(uint32_t threadIndex)
 {
+    t_Scheduler = this;
+    t_WorkerIndex = threadIndex;
+
+    WorkerState& state = m_WorkerStates[threadIndex];
+    state.m_bPinned = false; // fresh thread, the slot may have been pinned by a retired worker
+
     while (true)
     {
-        std::function<void(uint32_t)> task;
+        if (threadIndex >= m_TargetThreadCount)
+        {
+            // Retiring: hand local work back so the remaining workers (or the main thread) pick it up
+            uint32_t leftoverCount = 0;
+            for (uint32_t p = 0; p < kPriorityCount; ++p)
+            {
+                std::vector<Task*> leftovers;
+                while (Task* task = state.m_Deques[p].Pop())
+                {
+                    leftovers.push_back(task);
+                }
+                if (!leftovers.empty())
+                {
+                    std::unique_lock<std::mutex> lock = LockInjectQueues();
+                    m_InjectQueues[p].insert(m_InjectQueues[p].end(), leftovers.begin(), leftovers.end());
+                    m_InjectCounts[p].fetch_add(static_cast<uint32_t>(leftovers.size()));
+                }
+                leftoverCount += static_cast<uint32_t>(leftovers.size());
+            }
+            WakeWorkers(leftoverCount);
+            return;
+        }
+
+        if (state.m_bPinned != m_bPinWorkers.load(std::memory_order_relaxed))
+        {
+            state.m_bPinned = !state.m_bPinned;
+
+            const CpuTopology& topology = CpuTopology::Get();
+            std::vector<uint32_t> processors;
+            if (state.m_bPinned)
+            {
+                // Slot 0 is the main thread's core
+                const std::vector<uint32_t> workerProcessors = topology.GetWorkerProcessors();
+                processors.push_back(workerProcessors[(threadIndex + 1) % workerProcessors.size()]);
+            }
+            if (!topology.SetCurrentThreadAffinity(processors))
+            {
+                SDL_Log("[TaskScheduler] Failed to %s worker %u", state.m_bPinned ? "pin" : "unpin", threadIndex);
+            }
+        }
+
+        if (Task* task = FindTask(threadIndex))
+        {
+            ExecuteTask(task, threadIndex);
+            continue;
+        }
+
+        // Snapshot the epoch before the final scan, so a push that lands after the scan changes it and the wait returns immediately
+        const uint32_t epoch = m_WakeEpoch.load();
+        if (Task* task = FindTask(threadIndex))
+        {
+            ExecuteTask(task, threadIndex);
+            continue;
+        }
+
+        if (m_Stop)
+        {
+            return;
+        }
+
+        if (threadIndex >= m_TargetThreadCount)
+        {
+            continue;
+        }
+
+        const uint64_t idleStart = SDL_GetPerformanceCounter();
+        m_SleepingCount.fetch_add(1);
+        m_WakeEpoch.wait(epoch);
+        m_SleepingCount.fetch_sub(1);
+        const uint64_t idleEnd = SDL_GetPerformanceCounter();
+
+        state.m_Counters.m_IdleTicks.fetch_add(idleEnd - idleStart, std::memory_order_relaxed);
+        if (IsTraceCaptureActive())
+        {
+            RecordTraceEvent("Idle", "Idle", idleStart, idleEnd);
+        }
+    }
+}
+
+// ─── TaskGraph ──────────────────────────────────────────────────────────────
+
+TaskGraph::NodeHandle TaskGraph::AddNode(const char* name, std::function<void(uint32_t threadIndex)> func)
+{
+    SDL_assert(m_bDone && "TaskGraph: cannot add nodes while the graph is running");
+
+    Node& node = m_Nodes.emplace_back();
+    node.m_Name = name;
+    node.m_Func = std::move(func);
+    return static_cast<NodeHandle>(m_Nodes.size() - 1);
+}
+
+void TaskGraph::AddDependency(NodeHandle predecessor, NodeHandle successor)
+{
+    SDL_assert(m_bDone && "TaskGraph: cannot add dependencies while the graph is running");
+    SDL_assert(predecessor < m_Nodes.size() && successor < m_Nodes.size() && predecessor != successor);
+
+    m_Nodes[predecessor].m_Successors.push_back(successor);
+    m_Nodes[successor].m_PredecessorCount++;
+}
+
+TaskGraph::NodeHandle TaskGraph::Then(NodeHandle predecessor, const char* name, std::function<void(uint32_t threadIndex)> func)
+{
+    const NodeHandle node = AddNode(name, std::move(func));
+    AddDependency(predecessor, node);
+    return node;
+}
+
+void TaskGraph::Clear()
+{
+    SDL_assert(m_bDone && "TaskGraph: cannot clear a running graph");
+
+    m_Nodes.clear();
+    m_OnComplete = nullptr;
+}
+
+TaskScheduler::Task* TaskScheduler::CreateGraphNodeTask(TaskGraph& graph, TaskGraph::NodeHandle nodeHandle)
+{
+    Task* task = new Task{ [this, &graph, nodeHandle](uint32_t threadIndex)
         {
-            std::unique_lock<std::mutex> lock(m_QueueMutex);
-            m_Condition.wait(lock, [this, threadIndex]() { return m_Stop || !m_Tasks.empty() || threadIndex >= m_TargetThreadCount; });
-            
-            if (m_Stop && m_Tasks.empty()) return;
+            TaskGraph::Node& node = graph.m_Nodes[nodeHandle];
+            if (node.m_Func)
+            {
+                node.m_Func(threadIndex);
+            }
+
+            // Release successors whose last input this was. They go to this thread's deque first so a
+            // continuation usually runs right here with warm caches, while siblings can be stolen.
+            std::vector<Task*> readyTasks;
+            for (TaskGraph::NodeHandle successor : node.m_Successors)
+            {
+                if (graph.m_Nodes[successor].m_PendingPredecessors.fetch_sub(1) == 1)
+                {
+                    readyTasks.push_back(CreateGraphNodeTask(graph, successor));
+                }
+            }
+            if (!readyTasks.empty())
+            {
+                SubmitTasks(readyTasks.data(), static_cast<uint32_t>(readyTasks.size()), graph.m_Priority);
+            }
+
+            // last node to finish signals completion. Successors were submitted above, so this can't fire early.
+            if (graph.m_RemainingNodes.fetch_sub(1) == 1)
+            {
+                if (graph.m_OnComplete)
+                {
+                    graph.m_OnComplete();
+                }
+
+                std::lock_guard<std::mutex> lock(graph.m_CompletionMutex);
+                graph.m_bDone = true;
+                graph.m_CompletionCondition.notify_all();
+            }
+        } };
+    task->m_Name = graph.m_Nodes[nodeHandle].m_Name;
+    return task;
+}
+
+void TaskScheduler::RunTaskGraph(TaskGraph& graph)
+{
+    PROFILE_FUNCTION();
 
-            if (threadIndex >= m_TargetThreadCount) return;
+    SDL_assert(graph.m_bDone && "TaskGraph: graph is already running");
 
-            if (m_Tasks.empty()) continue;
+    const uint32_t nodeCount = graph.GetNodeCount();
+    if (nodeCount == 0)
+    {
+        if (graph.m_OnComplete)
+        {
+            graph.m_OnComplete();
+        }
+        return;
+    }
 
-            task = std::move(m_Tasks.back());
-            m_Tasks.pop_back();
+    // Kahn's algorithm: every node must be reachable from a root, otherwise there is a cycle and the graph never completes
+    {
+        std::vector<uint32_t> inDegree(nodeCount);
+        std::vector<TaskGraph::NodeHandle> open;
+        for (uint32_t i = 0; i < nodeCount; ++i)
+        {
+            inDegree[i] = graph.m_Nodes[i].m_PredecessorCount;
+            if (inDegree[i] == 0) open.push_back(i);
         }
-        
-        task(threadIndex);
+        uint32_t visited = 0;
+        while (!open.empty())
+        {
+            const TaskGraph::NodeHandle n = open.back();
+            open.pop_back();
+            ++visited;
+            for (TaskGraph::NodeHandle successor : graph.m_Nodes[n].m_Successors)
+            {
+                if (--inDegree[successor] == 0) open.push_back(successor);
+            }
+        }
+        if (visited != nodeCount)
+        {
+            SDL_LOG_ASSERT_FAIL("TaskGraph contains a cycle", "[TaskGraph] Cycle detected: only %u of %u nodes are reachable from a root", visited, nodeCount);
+            return;
+        }
+    }
 
-        if (m_RemainingTasks.fetch_sub(1) == 1)
+    std::vector<Task*> roots;
+    for (uint32_t i = 0; i < nodeCount; ++i)
+    {
+        TaskGraph::Node& node = graph.m_Nodes[i];
+        node.m_PendingPredecessors.store(node.m_PredecessorCount, std::memory_order_relaxed);
+        if (node.m_PredecessorCount == 0)
         {
-            std::lock_guard<std::mutex> lock(m_CompletionMutex);
-            m_CompletionCondition.notify_all();
+            roots.push_back(CreateGraphNodeTask(graph, i));
         }
     }
+
+    graph.m_bDone = false;
+    graph.m_RemainingNodes.store(nodeCount, std::memory_order_release);
+
+    SubmitTasks(roots.data(), static_cast<uint32_t>(roots.size()), graph.m_Priority);
+}
+
+void TaskScheduler::WaitForTaskGraph(TaskGraph& graph)
+{
+    PROFILE_FUNCTION();
+
+    HelpWhilePending(graph.m_RemainingNodes);
+
+    std::unique_lock<std::mutex> lock(graph.m_CompletionMutex);
+    graph.m_CompletionCondition.wait(lock, [&graph]() { return graph.m_bDone; });
 }
@@ -1,32 +1,457 @@
 #pragma once
 
+#include "ScratchArena.h"
+
+class TaskScheduler;
+
+// Latency class of a task. Workers always look for higher-priority work first; every
+// TaskScheduler::kStarvationInterval picks they serve the lowest non-empty class instead, so background work still drains.
+enum class TaskPriority : uint32_t
+{
+    FrameCritical, // on the frame's critical path (render pass recording, frame task graph)
+    Normal,
+    Background,    // can slip a frame without anyone noticing (garbage collection, streaming)
+    Count
+};
+
+// A DAG of tasks run on a TaskScheduler. A node is submitted the moment its last predecessor finishes, by the
+// thread that finished it, so nothing ever blocks waiting on an input. Build the graph, RunTaskGraph() it, then
+// WaitForTaskGraph() (or let ExecuteAllScheduledTasks() drain it). A graph can be re-run once it has completed.
+class TaskGraph
+{
+public:
+    using NodeHandle = uint32_t;
+
+    NodeHandle AddNode(const char* name, std::function<void(uint32_t threadIndex)> func);
+    void AddDependency(NodeHandle predecessor, NodeHandle successor);
+
+    // Continuation: a new node that runs after 'predecessor'
+    NodeHandle Then(NodeHandle predecessor, const char* name, std::function<void(uint32_t threadIndex)> func);
+
+    // Runs on whichever thread finishes the last node, before waiters are released
+    void SetCompletionCallback(std::function<void()> func) { m_OnComplete = std::move(func); }
+
+    void SetPriority(TaskPriority priority) { m_Priority = priority; }
+
+    void Clear();
+    uint32_t GetNodeCount() const { return static_cast<uint32_t>(m_Nodes.size()); }
+    const char* GetNodeName(NodeHandle node) const { return m_Nodes[node].m_Name; }
+    bool IsComplete() const { return m_RemainingNodes.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class TaskScheduler;
+
+    struct Node
+    {
+        const char* m_Name = nullptr;
+        std::function<void(uint32_t)> m_Func;
+        std::vector<NodeHandle> m_Successors;
+        uint32_t m_PredecessorCount = 0;
+        std::atomic<uint32_t> m_PendingPredecessors{ 0 };
+    };
+
+    std::deque<Node> m_Nodes; // deque: nodes hold atomics and must not move
+    std::function<void()> m_OnComplete;
+    TaskPriority m_Priority = TaskPriority::Normal;
+
+    std::atomic<uint32_t> m_RemainingNodes{ 0 };
+    std::mutex m_CompletionMutex;
+    std::condition_variable m_CompletionCondition;
+    bool m_bDone = true;
+};
+
+// Return type of a coroutine job. The body starts when the task is handed to TaskScheduler::RunAsync() or co_awaited
+// by another AsyncTask. While it co_awaits scheduler work (TaskScheduler::ParallelForAsync(), a child AsyncTask) it is
+// suspended instead of blocking its thread, and resumes on whichever thread finished the awaited work.
+// The AsyncTask object owns the coroutine frame and must outlive the coroutine.
+class AsyncTask
+{
+public:
+    struct promise_type
+    {
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+            void await_resume() const noexcept {}
+        };
+
+        AsyncTask get_return_object() { return AsyncTask{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { SDL_assert(false && "AsyncTask: unhandled exception"); std::terminate(); }
+
+        std::coroutine_handle<> m_Continuation; // parent AsyncTask co_awaiting this one, resumed when the body finishes
+        std::atomic<uint32_t> m_Pending{ 1 };
+        std::mutex m_CompletionMutex;
+        std::condition_variable m_CompletionCondition;
+        bool m_bDone = false;
+    };
+
+    AsyncTask() = default;
+    AsyncTask(AsyncTask&& other) noexcept : m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+    AsyncTask& operator=(AsyncTask&& other) noexcept;
+    AsyncTask(const AsyncTask&) = delete;
+    AsyncTask& operator=(const AsyncTask&) = delete;
+    ~AsyncTask();
+
+    bool IsValid() const { return static_cast<bool>(m_Handle); }
+    bool IsComplete() const { return !m_Handle || m_Handle.promise().m_Pending.load(std::memory_order_acquire) == 0; }
+
+    // co_await from another AsyncTask: the child starts right away on this thread, the parent resumes when it finishes
+    bool await_ready() const noexcept { return !m_Handle; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> parent) noexcept
+    {
+        m_Handle.promise().m_Continuation = parent;
+        return m_Handle;
+    }
+    void await_resume() const noexcept {}
+
+private:
+    friend class TaskScheduler;
+
+    explicit AsyncTask(std::coroutine_handle<promise_type> handle) : m_Handle(handle) {}
+
+    std::coroutine_handle<promise_type> m_Handle;
+};
+
+// Logical processor layout of the machine, detected once (GetLogicalProcessorInformationEx on Windows, sysfs on Linux).
+// Sizes the TaskScheduler pool and decides where its workers are pinned.
+struct CpuTopology
+{
+    struct LogicalProcessor
+    {
+        uint32_t m_Id = 0;              // OS processor number (Linux cpuN, Windows number within m_Group)
+        uint32_t m_Group = 0;           // Windows processor group, always 0 on Linux
+        uint32_t m_CoreIndex = 0;       // physical core this processor belongs to
+        uint32_t m_NumaNode = 0;
+        bool m_bEfficiencyCore = false; // E-core of a hybrid CPU
+        bool m_bPrimaryThread = true;   // first SMT sibling of its core
+    };
+
+    std::vector<LogicalProcessor> m_LogicalProcessors;
+    uint32_t m_PhysicalCoreCount = 0;
+    uint32_t m_EfficiencyCoreCount = 0; // physical E-cores
+    uint32_t m_NumaNodeCount = 1;
+
+    bool IsHybrid() const { return m_EfficiencyCoreCount > 0 && m_EfficiencyCoreCount < m_PhysicalCoreCount; }
+    uint32_t GetPerformanceCoreCount() const { return m_PhysicalCoreCount - m_EfficiencyCoreCount; }
+
+    // Indices into m_LogicalProcessors in the order workers should take them: one thread per performance core
+    // first, then their SMT siblings, then E-cores. Entry 0 is left to the main thread.
+    std::vector<uint32_t> GetWorkerProcessors() const;
+
+    // Restricts the calling thread to the given processors (all of them if empty). Returns false if the OS refused.
+    bool SetCurrentThreadAffinity(std::span<const uint32_t> processors) const;
+
+    static const CpuTopology& Get();
+    static CpuTopology Detect();
+};
+
 class TaskScheduler
 {
+    using RangeFunc = void(*)(void* context, uint32_t chunkBegin, uint32_t chunkEnd, uint32_t threadIndex);
+
 public:
-    static const uint32_t kRuntimeThreadCount = 12;
+    // Awaitable returned by ParallelForAsync(). Small or single-threaded ranges run inline in await_ready();
+    // otherwise await_suspend() hands the range to runner tasks and the last runner to finish resumes the coroutine.
+    class RangeAwaiter
+    {
+    public:
+        RangeAwaiter(const RangeAwaiter&) = delete;
+        RangeAwaiter& operator=(const RangeAwaiter&) = delete;
+
+        bool await_ready();
+        void await_suspend(std::coroutine_handle<> continuation);
+        void await_resume() const noexcept {}
+
+    protected:
+        RangeAwaiter(TaskScheduler& scheduler, uint32_t begin, uint32_t end, uint32_t grainSize, RangeFunc rangeFunc)
+            : m_Scheduler(&scheduler), m_RangeFunc(rangeFunc), m_Begin(begin), m_End(end), m_GrainSize(grainSize) {}
+
+        void RunChunks(uint32_t threadIndex);
+
+        TaskScheduler* m_Scheduler;
+        void* m_Context = nullptr;
+        RangeFunc m_RangeFunc;
+        uint32_t m_Begin;
+        uint32_t m_End;
+        uint32_t m_GrainSize;
+        uint32_t m_ChunkCount = 0;
+        std::atomic<uint32_t> m_NextChunk{ 0 };
+        std::atomic<uint32_t> m_RemainingRunners{ 0 };
+        std::coroutine_handle<> m_Continuation;
+    };
+
+    template <typename Func>
+    class ParallelForAwaiter : public RangeAwaiter
+    {
+    public:
+        template <typename F>
+        ParallelForAwaiter(TaskScheduler& scheduler, uint32_t begin, uint32_t end, uint32_t grainSize, F&& func)
+            : RangeAwaiter(scheduler, begin, end, grainSize, &ParallelForAwaiter::RunRange)
+            , m_Func(std::forward<F>(func))
+        {
+            m_Context = this;
+        }
+
+    private:
+        static void RunRange(void* context, uint32_t chunkBegin, uint32_t chunkEnd, uint32_t threadIndex)
+        {
+            Func& func = static_cast<ParallelForAwaiter*>(context)->m_Func;
+            for (uint32_t i = chunkBegin; i < chunkEnd; ++i)
+            {
+                func(i, threadIndex);
+            }
+        }
+
+        Func m_Func;
+    };
+
+    static const uint32_t kMaxThreadCount = 64;
+    static const uint32_t kPriorityCount = static_cast<uint32_t>(TaskPriority::Count);
+    static const uint32_t kStarvationInterval = 16;
+
+    struct PriorityStats
+    {
+        uint64_t m_Submitted = 0;
+        uint64_t m_Executed = 0;
+        uint64_t m_StarvationPicks = 0; // picked ahead of higher-priority work by the starvation guard
+    };
+
+    // Cumulative since construction or the last ResetWorkerStats()
+    struct WorkerStats
+    {
+        uint64_t m_TasksExecuted = 0;
+        uint64_t m_Steals = 0;              // tasks taken from another worker's deque
+        uint64_t m_IdleNs = 0;              // parked with nothing to do
+        uint64_t m_LockWaitNs = 0;          // blocked acquiring the inject queue mutex
+        uint32_t m_QueueDepthHighWater = 0; // deepest queue this thread pushed into (its own deque, or the inject queue)
+    };
 
     TaskScheduler();
     ~TaskScheduler();
 
     void ParallelFor(uint32_t count, const std::function<void(uint32_t index, uint32_t threadIndex)>& func);
-    void ScheduleTask(std::function<void()> func, bool bImmediateExecute = true);
+
+    // Range-chunked ParallelFor: [begin, end) is split into chunks of grainSize items (grainSize == 0 picks one
+    // adaptively from the range size and thread count). Only one task per participating thread is allocated;
+    // func(index, threadIndex) is called inline inside each chunk, so it costs nothing per item beyond the call.
+    template <typename Func>
+    void ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, Func&& func)
+    {
+        ParallelForChunks(begin, end, grainSize, [&func](uint32_t chunkBegin, uint32_t chunkEnd, uint32_t threadIndex)
+            {
+                for (uint32_t i = chunkBegin; i < chunkEnd; ++i)
+                {
+                    func(i, threadIndex);
+                }
+            });
+    }
+
+    // Same as above but hands whole chunks to func(chunkBegin, chunkEnd, threadIndex)
+    template <typename ChunkFunc>
+    void ParallelForChunks(uint32_t begin, uint32_t end, uint32_t grainSize, ChunkFunc&& chunkFunc)
+    {
+        using FuncType = std::remove_reference_t<ChunkFunc>;
+        ParallelForRange(begin, end, grainSize, const_cast<void*>(static_cast<const void*>(&chunkFunc)),
+            [](void* context, uint32_t chunkBegin, uint32_t chunkEnd, uint32_t threadIndex)
+            {
+                (*static_cast<FuncType*>(context))(chunkBegin, chunkEnd, threadIndex);
+            });
+    }
+
+    // ParallelFor for AsyncTask coroutines: 'co_await scheduler.ParallelForAsync(...)' suspends the coroutine instead
+    // of blocking its thread, so nested parallelism inside a job doesn't tie up a worker while it waits. The awaiter
+    // keeps its own copy of func for the duration of the co_await.
+    template <typename Func>
+    ParallelForAwaiter<std::decay_t<Func>> ParallelForAsync(uint32_t begin, uint32_t end, uint32_t grainSize, Func&& func)
+    {
+        return ParallelForAwaiter<std::decay_t<Func>>{ *this, begin, end, grainSize, std::forward<Func>(func) };
+    }
+
+    // Starts a coroutine on a worker and returns immediately
+    void RunAsync(AsyncTask& task, TaskPriority priority = TaskPriority::Normal);
+    // Executes other tasks until the coroutine completes; safe to call from worker threads
+    void WaitForAsync(AsyncTask& task);
+
+    // ParallelFor runners inherit the priority of the task that calls ParallelFor (Normal from non-worker threads)
+    void ScheduleTask(std::function<void()> func, bool bImmediateExecute = true, TaskPriority priority = TaskPriority::Normal);
+    // Fire-and-forget: ExecuteAllScheduledTasks() does not wait for it, the submitter tracks completion itself
+    // (AsyncQueueBase lanes). Must finish before the scheduler is destroyed.
+    void ScheduleDetachedTask(std::function<void()> func, TaskPriority priority = TaskPriority::Background);
     void ExecuteAllScheduledTasks();
 
+    // Submits the graph's root nodes and returns immediately
+    void RunTaskGraph(TaskGraph& graph);
+    // Executes other tasks until the graph completes; safe to call from worker threads
+    void WaitForTaskGraph(TaskGraph& graph);
+
     void SetThreadCount(uint32_t count);
-    uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+    uint32_t GetThreadCount() const { return m_ThreadCount.load(std::memory_order_relaxed); }
+
+    // Per-thread scratch memory for the job running on the calling thread. threadIndex is the one the scheduler
+    // passed to the job; threads that aren't workers of this scheduler get an arena of their own.
+    ScratchArena& GetScratchArena(uint32_t threadIndex);
+    // Same, for code that doesn't have a threadIndex at hand (AsyncTask coroutines, AsyncQueueBase lane tasks)
+    ScratchArena& GetScratchArena();
+    // Summed over the worker arenas
+    ScratchArena::Stats GetScratchArenaStats() const;
+
+    // One worker per performance core, minus the one the main thread runs on
+    static uint32_t GetDefaultThreadCount();
+
+    // Pins worker N to CpuTopology::GetWorkerProcessors()[N + 1]. Workers pick the change up the next time they
+    // look for work, so it can be toggled at runtime.
+    void SetWorkerPinning(bool bEnabled);
+    bool IsWorkerPinningEnabled() const { return m_bPinWorkers.load(std::memory_order_relaxed); }
+
+    PriorityStats GetPriorityStats(TaskPriority priority) const;
+
+    // threadIndex as passed to tasks; indices >= GetThreadCount() give all non-worker threads combined
+    WorkerStats GetWorkerStats(uint32_t threadIndex) const;
+    void ResetWorkerStats();
+
+    // Chrome trace capture (chrome://tracing, Perfetto): records one event per executed task and per idle wait on
+    // every thread that runs tasks. Plain file output, so it works headless and without the microprofile web UI.
+    void BeginTraceCapture();
+    // Stops recording and writes the events captured since BeginTraceCapture(). Returns false if the file can't be written.
+    bool EndTraceCapture(const std::filesystem::path& path);
+    bool IsTraceCaptureActive() const { return m_bTraceCapture.load(std::memory_order_relaxed); }
 
 private:
+    struct Task
+    {
+        std::function<void(uint32_t)> m_Func;
+        TaskPriority m_Priority = TaskPriority::Normal;
+        bool m_bDetached = false; // not counted in m_RemainingTasks
+        const char* m_Name = "Task"; // trace capture label
+    };
+
+    // Chase-Lev work-stealing deque. The owning worker pushes and pops at the bottom (LIFO, cache-warm),
+    // other threads steal from the top (FIFO). Retired ring buffers are kept alive until destruction since
+    // a thief may still be reading from one after the owner has grown the deque.
+    class WorkStealingDeque
+    {
+    public:
+        WorkStealingDeque();
+
+        void Push(Task* task);
+        Task* Pop();
+        Task* Steal();
+        bool IsEmpty() const;
+        uint32_t GetSize() const; // approximate when read by a thief
+
+    private:
+        struct RingBuffer
+        {
+            explicit RingBuffer(int64_t capacity) : m_Capacity(capacity), m_Mask(capacity - 1), m_Slots(new std::atomic<Task*>[capacity]) {}
+
+            Task* Load(int64_t i) const { return m_Slots[i & m_Mask].load(std::memory_order_relaxed); }
+            void Store(int64_t i, Task* task) { m_Slots[i & m_Mask].store(task, std::memory_order_relaxed); }
+
+            int64_t m_Capacity;
+            int64_t m_Mask;
+            std::unique_ptr<std::atomic<Task*>[]> m_Slots;
+        };
+
+        RingBuffer* Grow(RingBuffer* buffer, int64_t top, int64_t bottom);
+
+        alignas(64) std::atomic<int64_t> m_Top{ 0 };
+        alignas(64) std::atomic<int64_t> m_Bottom{ 0 };
+        std::atomic<RingBuffer*> m_Buffer{ nullptr };
+        std::vector<std::unique_ptr<RingBuffer>> m_Buffers; // owner-only, keeps retired buffers alive
+    };
+
+    // Written with relaxed atomics by the thread(s) they belong to, read by GetWorkerStats()
+    struct WorkerCounters
+    {
+        std::atomic<uint64_t> m_TasksExecuted{ 0 };
+        std::atomic<uint64_t> m_Steals{ 0 };
+        std::atomic<uint64_t> m_IdleTicks{ 0 };
+        std::atomic<uint64_t> m_LockWaitTicks{ 0 };
+        std::atomic<uint32_t> m_QueueDepthHighWater{ 0 };
+    };
+
+    struct TraceEvent
+    {
+        const char* m_Name;
+        const char* m_Category;
+        uint32_t m_ThreadId;
+        uint64_t m_StartTicks;
+        uint64_t m_EndTicks;
+    };
+
+    struct alignas(64) WorkerState
+    {
+        WorkStealingDeque m_Deques[kPriorityCount];
+        WorkerCounters m_Counters;
+        uint32_t m_StealSeed = 0;
+        uint32_t m_PicksSinceStarvationCheck = 0;
+        bool m_bPinned = false; // owner-only, affinity currently applied to the worker thread
+    };
+
+    struct PriorityCounters
+    {
+        std::atomic<uint64_t> m_Submitted{ 0 };
+        std::atomic<uint64_t> m_Executed{ 0 };
+        std::atomic<uint64_t> m_StarvationPicks{ 0 };
+    };
+
+    struct DeferredTask
+    {
+        std::function<void()> m_Func;
+        TaskPriority m_Priority;
+    };
+
+    static uint32_t ResolveGrainSize(uint32_t itemCount, uint32_t grainSize, uint32_t participantCount);
+    void ParallelForRange(uint32_t begin, uint32_t end, uint32_t grainSize, void* context, RangeFunc rangeFunc);
+
     void WorkerThread(uint32_t threadIndex);
 
+    void SubmitTasks(Task* const* tasks, uint32_t count, TaskPriority priority);
+    Task* FindTask(uint32_t threadIndex);
+    Task* FindTaskAtPriority(uint32_t threadIndex, uint32_t priority);
+    Task* PopInjectedTask(uint32_t threadIndex, uint32_t priority);
+    Task* StealTask(uint32_t threadIndex, uint32_t priority);
+    void ExecuteTask(Task* task, uint32_t threadIndex);
+    Task* CreateGraphNodeTask(TaskGraph& graph, TaskGraph::NodeHandle node);
+    void HelpWhilePending(const std::atomic<uint32_t>& pendingCount);
+    void WakeWorkers(uint32_t count);
+
+    WorkerCounters& GetCounters(); // the calling thread's
+    std::unique_lock<std::mutex> LockInjectQueues();
+    void RecordTraceEvent(const char* name, const char* category, uint64_t startTicks, uint64_t endTicks);
+
     std::vector<std::thread> m_Workers;
-    std::vector<std::function<void(uint32_t)>> m_Tasks;
-    std::vector<std::function<void()>> m_DeferredTasks;
-    
-    std::mutex m_QueueMutex;
-    std::condition_variable m_Condition;
+    std::unique_ptr<WorkerState[]> m_WorkerStates; // kMaxThreadCount slots, never reallocated so thieves can index freely
+    std::unique_ptr<ScratchArena[]> m_ScratchArenas; // kMaxThreadCount slots, one per worker index
+
+    // Tasks submitted from threads that are not workers of this scheduler (e.g. the main thread), one queue per priority
+    std::mutex m_InjectMutex;
+    std::deque<Task*> m_InjectQueues[kPriorityCount];
+    std::atomic<uint32_t> m_InjectCounts[kPriorityCount]{};
+
+    std::mutex m_DeferredMutex;
+    std::vector<DeferredTask> m_DeferredTasks;
+
+    PriorityCounters m_PriorityCounters[kPriorityCount];
+    WorkerCounters m_ExternalCounters; // shared by every thread that isn't one of our workers
+
+    std::atomic<bool> m_bTraceCapture{ false };
+    std::mutex m_TraceMutex;
+    std::vector<TraceEvent> m_TraceEvents;
+
     std::atomic<bool> m_Stop{ false };
+    std::atomic<bool> m_bPinWorkers{ false };
+    std::atomic<uint32_t> m_ThreadCount{ 0 };
     std::atomic<uint32_t> m_TargetThreadCount{ 0 };
 
+    // Idle workers park on m_WakeEpoch; every submission bumps it so a worker that raced a push never sleeps on stale state
+    std::atomic<uint32_t> m_WakeEpoch{ 0 };
+    std::atomic<uint32_t> m_SleepingCount{ 0 };
+
     std::atomic<uint32_t> m_RemainingTasks{ 0 };
     std::mutex m_CompletionMutex;
     std::condition_variable m_CompletionCondition;
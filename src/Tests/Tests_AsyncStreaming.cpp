@@ -325,3 +325,142 @@ TEST_SUITE("AsyncStreaming_MeshFlow")
         CHECK(affected.second == 3);
     }
 }
+
+TEST_SUITE("AsyncStreaming_SchedulerLane")
+{
+    // Minimal queue exposing EnqueueTask for lane tests
+    class TestLaneQueue : public AsyncQueueBase
+    {
+    public:
+        explicit TestLaneQueue(uint32_t maxConcurrency) : AsyncQueueBase(maxConcurrency) {}
+        void Enqueue(std::function<void()> task) { EnqueueTask(std::move(task)); }
+    };
+
+    TEST_CASE("TC-ASLN-01 AsyncQueueBase - lane respects its concurrency cap and drains on Flush")
+    {
+        TestLaneQueue q(2);
+
+        std::atomic<int> running{ 0 };
+        std::atomic<int> maxRunning{ 0 };
+        std::atomic<int> completed{ 0 };
+        auto work = [&]()
+        {
+            const int nowRunning = running.fetch_add(1) + 1;
+            int observedMax = maxRunning.load();
+            while (nowRunning > observedMax && !maxRunning.compare_exchange_weak(observedMax, nowRunning)) {}
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            running.fetch_sub(1);
+            completed.fetch_add(1);
+        };
+
+        // Queued before Start(): nothing runs yet
+        for (int i = 0; i < 4; ++i)
+            q.Enqueue(work);
+        CHECK(q.GetPendingCount() == 4);
+
+        q.Start("TC-ASLN-01");
+        for (int i = 0; i < 28; ++i)
+            q.Enqueue(work);
+        q.Flush();
+
+        CHECK(completed.load() == 32);
+        CHECK(q.GetPendingCount() == 0);
+        CHECK(maxRunning.load() <= 2);
+
+        q.Stop("TC-ASLN-01");
+        CHECK_FALSE(q.IsRunning());
+    }
+
+    TEST_CASE("TC-ASLN-02 AsyncQueueBase - ExecuteAllScheduledTasks does not wait for lane tasks")
+    {
+        TestLaneQueue q(1);
+        q.Start("TC-ASLN-02");
+
+        std::atomic<bool> bRelease{ false };
+        std::atomic<bool> bFinished{ false };
+        q.Enqueue([&]()
+        {
+            while (!bRelease.load())
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            bFinished = true;
+        });
+
+        // A frame's worth of scheduler work completes while the lane task is still blocked
+        std::atomic<int> frameWork{ 0 };
+        g_Renderer.m_TaskScheduler->ScheduleTask([&]() { frameWork.fetch_add(1); });
+        g_Renderer.m_TaskScheduler->ExecuteAllScheduledTasks();
+        CHECK(frameWork.load() == 1);
+        CHECK_FALSE(bFinished.load());
+        CHECK(q.GetPendingCount() == 1);
+
+        bRelease = true;
+        q.Flush();
+        CHECK(bFinished.load());
+        q.Stop("TC-ASLN-02");
+    }
+
+    TEST_CASE("TC-ASLN-03 AsyncQueueBase - lanes together stay within the lane budget")
+    {
+        TaskScheduler& scheduler = *g_Renderer.m_TaskScheduler;
+        const uint32_t budget = AsyncQueueBase::GetLaneBudget();
+        if (scheduler.GetThreadCount() > 1)
+            CHECK(budget < scheduler.GetThreadCount());
+
+        // Two lanes whose caps add up to more than the budget
+        TestLaneQueue meshLike(budget);
+        TestLaneQueue textureLike(budget);
+
+        std::atomic<int> running{ 0 };
+        std::atomic<int> maxRunning{ 0 };
+        auto work = [&]()
+        {
+            const int nowRunning = running.fetch_add(1) + 1;
+            int observedMax = maxRunning.load();
+            while (nowRunning > observedMax && !maxRunning.compare_exchange_weak(observedMax, nowRunning)) {}
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+            running.fetch_sub(1);
+        };
+
+        meshLike.Start("TC-ASLN-03-A");
+        textureLike.Start("TC-ASLN-03-B");
+        for (int i = 0; i < 16; ++i)
+        {
+            meshLike.Enqueue(work);
+            textureLike.Enqueue(work);
+        }
+
+        // Poll rather than Flush(): a flushing thread helps and would add itself to the count
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while ((meshLike.GetPendingCount() + textureLike.GetPendingCount()) > 0 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        CHECK(meshLike.GetPendingCount() == 0);
+        CHECK(textureLike.GetPendingCount() == 0);
+        CHECK(maxRunning.load() <= (int)budget);
+
+        textureLike.Stop("TC-ASLN-03-B");
+        meshLike.Stop("TC-ASLN-03-A");
+    }
+
+    TEST_CASE("TC-ASLN-04 AsyncQueueBase - Flush runs queued items itself with no workers")
+    {
+        TaskScheduler& scheduler = *g_Renderer.m_TaskScheduler;
+        const uint32_t previousThreadCount = scheduler.GetThreadCount();
+        scheduler.SetThreadCount(0);
+
+        TestLaneQueue q(2);
+        q.Start("TC-ASLN-04");
+
+        std::atomic<int> completed{ 0 };
+        for (int i = 0; i < 8; ++i)
+            q.Enqueue([&]() { completed.fetch_add(1); });
+
+        // No worker can run the lane; this would block forever if Flush only waited
+        q.Flush();
+        CHECK(completed.load() == 8);
+        CHECK(q.GetPendingCount() == 0);
+
+        q.Stop("TC-ASLN-04");
+        scheduler.SetThreadCount(previousThreadCount);
+    }
+}
@@ -1,6 +1,6 @@
 // Tests_CoreBoot.cpp - Core Boot Tests
 //
-// Systems under test: TaskScheduler, Config, Utilities (timer, math)
+// Systems under test: TaskScheduler, TaskGraph, ScratchArena, Config, Utilities (timer, math)
 // Setup required: None (CPU-only, no GPU/RHI)
 //
 // Run with: HobbyRenderer --run-tests=*CoreBoot*
@@ -16,12 +16,14 @@
 TEST_SUITE("TaskScheduler")
 {
     // ------------------------------------------------------------------
-    // TC-TS-01: Default construction creates kRuntimeThreadCount workers
+    // TC-TS-01: Default construction sizes the pool from the CPU topology
     // ------------------------------------------------------------------
     TEST_CASE("TC-TS-01 Thread pool creation - default thread count")
     {
         TaskScheduler scheduler;
-        CHECK(scheduler.GetThreadCount() == TaskScheduler::kRuntimeThreadCount);
+        CHECK(scheduler.GetThreadCount() == TaskScheduler::GetDefaultThreadCount());
+        CHECK(scheduler.GetThreadCount() >= 1);
+        CHECK(scheduler.GetThreadCount() <= TaskScheduler::kMaxThreadCount);
     }
 
     // ------------------------------------------------------------------
@@ -569,6 +571,563 @@ TEST_SUITE("TaskScheduler_Extended")
 
         CHECK(counter.load() == 200);
     }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-07: Nested ParallelFor from worker threads does not deadlock
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-07 WorkStealing - nested ParallelFor from workers completes")
+    {
+        TaskScheduler scheduler;
+        scheduler.SetThreadCount(2);
+
+        // More outer items than workers: every worker ends up waiting on an inner
+        // ParallelFor and must execute/steal work instead of blocking.
+        std::atomic<int> counter{ 0 };
+        scheduler.ParallelFor(16, [&](uint32_t, uint32_t)
+        {
+            scheduler.ParallelFor(16, [&](uint32_t, uint32_t)
+            {
+                counter.fetch_add(1);
+            });
+        });
+
+        CHECK(counter.load() == 16 * 16);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-08: Per-task scheduling overhead micro-benchmark
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-08 WorkStealing - per-task overhead benchmark")
+    {
+        TaskScheduler scheduler;
+        constexpr uint32_t kTaskCount = 200000;
+
+        // Empty ParallelFor items: measures submit + pop/steal + completion cost only
+        std::atomic<uint32_t> executed{ 0 };
+        SimpleTimer timer;
+        scheduler.ParallelFor(kTaskCount, [&](uint32_t, uint32_t)
+        {
+            executed.fetch_add(1, std::memory_order_relaxed);
+        });
+        const double parallelForNs = timer.TotalSeconds() * 1e9 / kTaskCount;
+        CHECK(executed.load() == kTaskCount);
+
+        // Individually scheduled tasks: one submission per task
+        executed = 0;
+        timer.Reset();
+        for (uint32_t i = 0; i < kTaskCount; ++i)
+        {
+            scheduler.ScheduleTask([&executed]() { executed.fetch_add(1, std::memory_order_relaxed); });
+        }
+        scheduler.ExecuteAllScheduledTasks();
+        const double scheduleTaskNs = timer.TotalSeconds() * 1e9 / kTaskCount;
+        CHECK(executed.load() == kTaskCount);
+
+        SDL_Log("[Bench] TaskScheduler (%u threads): ParallelFor %.1f ns/task, ScheduleTask %.1f ns/task",
+            scheduler.GetThreadCount(), parallelForNs, scheduleTaskNs);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-09: Range ParallelFor visits [begin, end) exactly once for any grain
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-09 RangeParallelFor - every index visited exactly once")
+    {
+        TaskScheduler scheduler;
+        constexpr uint32_t kBegin = 7;
+        constexpr uint32_t kEnd = 10007;
+
+        for (uint32_t grainSize : { 0u, 1u, 3u, 64u, 5000u, 20000u })
+        {
+            CAPTURE(grainSize);
+            std::vector<std::atomic<int>> counters(kEnd);
+            for (auto& c : counters) c.store(0);
+            std::atomic<bool> outOfRange{ false };
+
+            scheduler.ParallelFor(kBegin, kEnd, grainSize, [&](uint32_t index, uint32_t threadIndex)
+            {
+                counters[index].fetch_add(1);
+                if (threadIndex > scheduler.GetThreadCount())
+                    outOfRange.store(true);
+            });
+
+            for (uint32_t i = 0; i < kEnd; ++i)
+                CHECK(counters[i].load() == (i >= kBegin ? 1 : 0));
+            CHECK_FALSE(outOfRange.load());
+        }
+
+        // Empty range is a no-op
+        bool bCalled = false;
+        scheduler.ParallelFor(5, 5, 0, [&](uint32_t, uint32_t) { bCalled = true; });
+        CHECK_FALSE(bCalled);
+
+        // Chunk form receives contiguous, non-overlapping chunks no larger than the grain
+        std::atomic<uint32_t> covered{ 0 };
+        std::atomic<bool> oversized{ false };
+        scheduler.ParallelForChunks(0, 1000, 16, [&](uint32_t chunkBegin, uint32_t chunkEnd, uint32_t)
+        {
+            if (chunkEnd <= chunkBegin || chunkEnd - chunkBegin > 16)
+                oversized.store(true);
+            covered.fetch_add(chunkEnd - chunkBegin);
+        });
+        CHECK(covered.load() == 1000);
+        CHECK_FALSE(oversized.load());
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-10: Adaptive grain vs grain 1 on a fine-grained loop
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-10 RangeParallelFor - adaptive grain vs grain 1 benchmark")
+    {
+        TaskScheduler scheduler;
+        constexpr uint32_t kCount = 100000;
+        std::vector<float> values(kCount, 1.0f);
+
+        SimpleTimer timer;
+        scheduler.ParallelFor(kCount, [&](uint32_t index, uint32_t)
+        {
+            values[index] *= 2.0f;
+        });
+        const double grainOneMs = timer.TotalMilliseconds();
+
+        timer.Reset();
+        scheduler.ParallelFor(0, kCount, 0, [&](uint32_t index, uint32_t)
+        {
+            values[index] *= 0.5f;
+        });
+        const double chunkedMs = timer.TotalMilliseconds();
+
+        for (uint32_t i = 0; i < kCount; ++i)
+            REQUIRE(values[i] == 1.0f);
+
+        SDL_Log("[Bench] ParallelFor %u items: grain 1 %.3f ms, adaptive grain %.3f ms",
+            kCount, grainOneMs, chunkedMs);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-11: Higher priority runs first, background is not starved
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-11 Priorities - frame-critical first, background not starved")
+    {
+        TaskScheduler scheduler;
+        scheduler.SetThreadCount(1);
+
+        constexpr int kBackgroundCount = 4;
+        constexpr int kCriticalCount = 200;
+        std::atomic<int> sequence{ 0 };
+        std::atomic<int> firstCritical{ -1 };
+        std::atomic<int> lastBackground{ -1 };
+        std::atomic<int> done{ 0 };
+
+        // Submitted from a worker so everything lands in that worker's local deques and the
+        // order is decided purely by its priority/starvation policy (the test thread doesn't help).
+        scheduler.ScheduleTask([&]()
+        {
+            for (int i = 0; i < kBackgroundCount; ++i)
+                scheduler.ScheduleTask([&]() { lastBackground.store(sequence.fetch_add(1)); done.fetch_add(1); }, true, TaskPriority::Background);
+            for (int i = 0; i < kCriticalCount; ++i)
+                scheduler.ScheduleTask([&]()
+                {
+                    int expected = -1;
+                    firstCritical.compare_exchange_strong(expected, sequence.fetch_add(1));
+                    done.fetch_add(1);
+                }, true, TaskPriority::FrameCritical);
+        }, true, TaskPriority::FrameCritical);
+
+        while (done.load() < kBackgroundCount + kCriticalCount)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        scheduler.ExecuteAllScheduledTasks();
+
+        // Critical work goes before background work submitted earlier...
+        CHECK(firstCritical.load() == 0);
+        // ...but the starvation guard slots background tasks in well before the critical queue drains
+        CHECK(lastBackground.load() < kCriticalCount);
+        CHECK(scheduler.GetPriorityStats(TaskPriority::Background).m_StarvationPicks >= 1);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-12: Per-priority submitted/executed counters
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-12 Priorities - per-priority counters track submissions")
+    {
+        TaskScheduler scheduler;
+        std::atomic<int> counter{ 0 };
+
+        for (int i = 0; i < 3; ++i)
+            scheduler.ScheduleTask([&]() { counter.fetch_add(1); }, true, TaskPriority::FrameCritical);
+        for (int i = 0; i < 5; ++i)
+            scheduler.ScheduleTask([&]() { counter.fetch_add(1); }, /*bImmediateExecute=*/false, TaskPriority::Background);
+        scheduler.ScheduleTask([&]() { counter.fetch_add(1); });
+        scheduler.ExecuteAllScheduledTasks();
+
+        CHECK(counter.load() == 9);
+
+        const TaskScheduler::PriorityStats critical = scheduler.GetPriorityStats(TaskPriority::FrameCritical);
+        const TaskScheduler::PriorityStats normal = scheduler.GetPriorityStats(TaskPriority::Normal);
+        const TaskScheduler::PriorityStats background = scheduler.GetPriorityStats(TaskPriority::Background);
+        CHECK(critical.m_Submitted == 3);
+        CHECK(critical.m_Executed == 3);
+        CHECK(normal.m_Submitted == 1);
+        CHECK(normal.m_Executed == 1);
+        CHECK(background.m_Submitted == 5);
+        CHECK(background.m_Executed == 5);
+    }
+
+    // Coroutine jobs used by the ParallelForAsync tests below
+    static AsyncTask FillAsync(TaskScheduler& scheduler, std::vector<uint32_t>& values)
+    {
+        co_await scheduler.ParallelForAsync(0, (uint32_t)values.size(), 64, [&values](uint32_t i, uint32_t) { values[i] = i; });
+    }
+
+    static AsyncTask FillAndIncrementAsync(TaskScheduler& scheduler, std::vector<uint32_t>& values, std::atomic<int>& completed)
+    {
+        co_await FillAsync(scheduler, values);
+        co_await scheduler.ParallelForAsync(0, (uint32_t)values.size(), 0, [&values](uint32_t i, uint32_t) { values[i] += 1; });
+        completed.fetch_add(1);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-13: co_await ParallelForAsync visits every index
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-13 Coroutines - ParallelForAsync and child tasks complete")
+    {
+        TaskScheduler scheduler;
+        scheduler.SetThreadCount(4);
+
+        std::vector<uint32_t> values(10000, 0);
+        std::atomic<int> completed{ 0 };
+        AsyncTask task = FillAndIncrementAsync(scheduler, values, completed);
+        CHECK_FALSE(task.IsComplete()); // lazily started
+
+        scheduler.RunAsync(task);
+        scheduler.WaitForAsync(task);
+
+        CHECK(task.IsComplete());
+        CHECK(completed.load() == 1);
+        bool bAllCorrect = true;
+        for (uint32_t i = 0; i < (uint32_t)values.size(); ++i)
+            bAllCorrect &= values[i] == i + 1;
+        CHECK(bAllCorrect);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-14: Suspended coroutines don't hold workers
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-14 Coroutines - more awaiting jobs than workers complete")
+    {
+        // With a single worker, a blocking nested wait per job would serialize everything behind it;
+        // suspended jobs leave the worker free to run the other jobs' chunks
+        TaskScheduler scheduler;
+        scheduler.SetThreadCount(1);
+
+        constexpr int kJobCount = 32;
+        std::vector<std::vector<uint32_t>> values(kJobCount, std::vector<uint32_t>(2000, 0));
+        std::atomic<int> completed{ 0 };
+        std::vector<AsyncTask> tasks;
+        for (int j = 0; j < kJobCount; ++j)
+        {
+            tasks.push_back(FillAndIncrementAsync(scheduler, values[j], completed));
+            scheduler.RunAsync(tasks.back(), TaskPriority::Background);
+        }
+
+        // ExecuteAllScheduledTasks drains coroutines too: a suspended one always has runner tasks in flight
+        scheduler.ExecuteAllScheduledTasks();
+
+        CHECK(completed.load() == kJobCount);
+        for (const AsyncTask& task : tasks)
+            CHECK(task.IsComplete());
+        CHECK(values[kJobCount - 1][1999] == 2000);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-15: WaitForAsync from a worker thread
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-15 Coroutines - WaitForAsync from a worker completes")
+    {
+        TaskScheduler scheduler;
+        scheduler.SetThreadCount(2);
+
+        std::atomic<int> completed{ 0 };
+        std::vector<uint32_t> values(5000, 0);
+        scheduler.ScheduleTask([&]()
+        {
+            AsyncTask task = FillAndIncrementAsync(scheduler, values, completed);
+            scheduler.RunAsync(task);
+            scheduler.WaitForAsync(task);
+        });
+        scheduler.ExecuteAllScheduledTasks();
+
+        CHECK(completed.load() == 1);
+        CHECK(values[4999] == 5000);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-16: Detected CPU topology is self-consistent
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-16 Topology - detected layout is consistent")
+    {
+        const CpuTopology& topology = CpuTopology::Get();
+        const uint32_t processorCount = (uint32_t)topology.m_LogicalProcessors.size();
+
+        REQUIRE(processorCount >= 1);
+        CHECK(topology.m_PhysicalCoreCount >= 1);
+        CHECK(topology.m_PhysicalCoreCount <= processorCount);
+        CHECK(topology.m_EfficiencyCoreCount <= topology.m_PhysicalCoreCount);
+        CHECK(topology.m_NumaNodeCount >= 1);
+
+        // Worker order is a permutation of all processors, primary threads of P-cores first
+        std::vector<uint32_t> workerProcessors = topology.GetWorkerProcessors();
+        CHECK(workerProcessors.size() == processorCount);
+        CHECK(topology.m_LogicalProcessors[workerProcessors[0]].m_bPrimaryThread);
+        std::sort(workerProcessors.begin(), workerProcessors.end());
+        CHECK(std::adjacent_find(workerProcessors.begin(), workerProcessors.end()) == workerProcessors.end());
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-17: Pinned vs unpinned workers
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-17 Topology - pinned vs unpinned benchmark")
+    {
+        TaskScheduler scheduler;
+
+        constexpr uint32_t kCount = 1 << 16;
+        constexpr int kIterations = 20;
+        std::vector<float> values(kCount, 1.0f);
+
+        // Memory-touching work, so cache locality from staying on one core can show up
+        auto runBench = [&]()
+        {
+            SimpleTimer timer;
+            for (int iter = 0; iter < kIterations; ++iter)
+            {
+                scheduler.ParallelFor(0, kCount, 0, [&values](uint32_t i, uint32_t)
+                {
+                    values[i] = values[i] * 0.5f + 1.0f;
+                });
+            }
+            return timer.TotalMilliseconds();
+        };
+
+        runBench(); // warm up
+        const double unpinnedMs = runBench();
+
+        scheduler.SetWorkerPinning(true);
+        CHECK(scheduler.IsWorkerPinningEnabled());
+        const double pinnedMs = runBench();
+
+        scheduler.SetWorkerPinning(false);
+        CHECK_FALSE(scheduler.IsWorkerPinningEnabled());
+
+        CHECK(values[kCount - 1] > 1.0f);
+        SDL_Log("[Bench] ParallelFor %u items x %d, %u workers: unpinned %.3f ms, pinned %.3f ms",
+            kCount, kIterations, scheduler.GetThreadCount(), unpinnedMs, pinnedMs);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-18: ScratchArena scopes rewind, respect alignment and reuse blocks
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-18 ScratchArena - scope rewind, alignment and block reuse")
+    {
+        ScratchArena arena(4096);
+
+        auto fillOnce = [&arena]()
+        {
+            ScratchArena::Scope scope{ arena };
+            std::pmr::vector<uint8_t> bytes(3, &arena);
+            void* aligned = arena.allocate(64, 64);
+            CHECK(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+
+            // Larger than a block: gets a block of its own
+            std::pmr::vector<uint32_t> big(4096, 7u, &arena);
+            CHECK(big.back() == 7u);
+            return aligned;
+        };
+
+        void* first = fillOnce();
+        const ScratchArena::Stats afterFirst = arena.GetStats();
+        CHECK(afterFirst.m_BlockAllocations == 2);
+
+        // Same pattern again: same addresses, nothing new from the heap
+        void* second = fillOnce();
+        const ScratchArena::Stats afterSecond = arena.GetStats();
+        CHECK(second == first);
+        CHECK(afterSecond.m_BlockAllocations == afterFirst.m_BlockAllocations);
+        CHECK(afterSecond.m_Allocations == afterFirst.m_Allocations * 2);
+        CHECK(afterSecond.m_HighWaterBytes >= 4096 * sizeof(uint32_t));
+
+        // Per-thread arenas through the scheduler
+        TaskScheduler scheduler;
+        scheduler.SetThreadCount(4);
+        std::atomic<uint32_t> mismatches{ 0 };
+        scheduler.ParallelFor(0, 256, 1, [&](uint32_t i, uint32_t threadIndex)
+        {
+            ScratchArena& threadArena = scheduler.GetScratchArena(threadIndex);
+            if (&threadArena != &scheduler.GetScratchArena())
+                ++mismatches;
+
+            ScratchArena::Scope scope{ threadArena };
+            std::pmr::vector<uint32_t> values(64, i, &threadArena);
+            if (values.front() != i || values.back() != i)
+                ++mismatches;
+        });
+        CHECK(mismatches.load() == 0);
+        // The calling thread joins in on its own arena, which the worker stats don't include
+        CHECK(scheduler.GetScratchArenaStats().m_Allocations + scheduler.GetScratchArena().GetStats().m_Allocations >= 256);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-19: Heap allocations of meshlet-style scratch, heap vs arena
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-19 ScratchArena - heap allocation count benchmark")
+    {
+        // Counts what reaches the heap
+        struct CountingResource : std::pmr::memory_resource
+        {
+            uint64_t m_Count = 0;
+            void* do_allocate(size_t bytes, size_t alignment) override { ++m_Count; return std::pmr::new_delete_resource()->allocate(bytes, alignment); }
+            void do_deallocate(void* p, size_t bytes, size_t alignment) override { std::pmr::new_delete_resource()->deallocate(p, bytes, alignment); }
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+        };
+
+        constexpr uint32_t kPrimitives = 200;
+        constexpr uint32_t kLods = 4;
+
+        // Same shape as the per-LOD scratch in ProcessSinglePrimitiveFromMapped
+        auto processPrimitive = [](std::pmr::memory_resource* resource, uint32_t prim)
+        {
+            std::pmr::vector<uint32_t> indices(3000 + prim, resource);
+            for (uint32_t i = 0; i < indices.size(); ++i)
+                indices[i] = i;
+
+            for (uint32_t lod = 0; lod < kLods; ++lod)
+            {
+                std::pmr::vector<uint32_t> lodIndices(indices.begin(), indices.begin() + indices.size() / (lod + 1), resource);
+                std::pmr::vector<uint32_t> meshletVerts(lodIndices.size(), resource);
+                std::pmr::vector<uint8_t> meshletTris(lodIndices.size(), resource);
+                meshletVerts.back() = lodIndices.back();
+                meshletTris.back() = 1;
+            }
+        };
+
+        CountingResource heapCounter;
+        for (uint32_t prim = 0; prim < kPrimitives; ++prim)
+            processPrimitive(&heapCounter, prim);
+        const uint64_t heapAllocations = heapCounter.m_Count;
+
+        CountingResource arenaCounter;
+        ScratchArena arena(ScratchArena::kDefaultBlockSize, &arenaCounter);
+        for (uint32_t prim = 0; prim < kPrimitives; ++prim)
+        {
+            ScratchArena::Scope scope{ arena };
+            processPrimitive(&arena, prim);
+        }
+        const uint64_t arenaAllocations = arenaCounter.m_Count;
+
+        CHECK(heapAllocations == kPrimitives * (1 + kLods * 3));
+        CHECK(arenaAllocations < heapAllocations);
+        CHECK(arenaAllocations == arena.GetStats().m_BlockAllocations);
+        SDL_Log("[Bench] Meshlet scratch for %u primitives x %u LODs: %llu heap allocations without arena, %llu with",
+            kPrimitives, kLods, heapAllocations, arenaAllocations);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-20: Worker stats add up and the trace capture writes Chrome JSON
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-20 Instrumentation - worker stats and Chrome trace export")
+    {
+        TaskScheduler scheduler;
+        scheduler.SetThreadCount(4);
+        scheduler.ResetWorkerStats();
+
+        const std::filesystem::path tracePath = std::filesystem::temp_directory_path() / "TC-TSX-20_trace.json";
+        scheduler.BeginTraceCapture();
+        CHECK(scheduler.IsTraceCaptureActive());
+
+        TaskGraph graph;
+        const TaskGraph::NodeHandle a = graph.AddNode("Trace \"A\"", [](uint32_t) {});
+        graph.Then(a, "TraceB", [](uint32_t) {});
+        scheduler.RunTaskGraph(graph);
+        scheduler.WaitForTaskGraph(graph);
+
+        std::atomic<uint32_t> sum{ 0 };
+        scheduler.ParallelFor(0, 1024, 16, [&sum](uint32_t i, uint32_t) { sum += i; });
+        CHECK(sum.load() == 1023u * 1024u / 2u);
+
+        // Waiters are released from inside the last task; this also waits for its bookkeeping (stats, trace event)
+        scheduler.ExecuteAllScheduledTasks();
+        REQUIRE(scheduler.EndTraceCapture(tracePath));
+        CHECK_FALSE(scheduler.IsTraceCaptureActive());
+
+        uint64_t executed = 0;
+        for (uint32_t i = 0; i <= scheduler.GetThreadCount(); ++i)
+        {
+            executed += scheduler.GetWorkerStats(i).m_TasksExecuted;
+        }
+        uint64_t submitted = 0;
+        for (uint32_t p = 0; p < TaskScheduler::kPriorityCount; ++p)
+        {
+            submitted += scheduler.GetPriorityStats(static_cast<TaskPriority>(p)).m_Submitted;
+        }
+        CHECK(executed == submitted);
+        CHECK(executed >= 2);
+
+        std::ifstream file(tracePath);
+        REQUIRE(file.is_open());
+        std::stringstream contents;
+        contents << file.rdbuf();
+        const std::string json = contents.str();
+        CHECK(json.find("\"traceEvents\"") != std::string::npos);
+        CHECK(json.find("\"name\":\"Trace \\\"A\\\"\"") != std::string::npos);
+        CHECK(json.find("\"name\":\"TraceB\"") != std::string::npos);
+        CHECK(json.find("\"ph\":\"X\"") != std::string::npos);
+        CHECK(json.rfind("]}") != std::string::npos);
+        file.close();
+        std::filesystem::remove(tracePath);
+
+        scheduler.ResetWorkerStats();
+        CHECK(scheduler.GetWorkerStats(0).m_TasksExecuted == 0);
+        CHECK(scheduler.GetWorkerStats(scheduler.GetThreadCount()).m_TasksExecuted == 0);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TSX-21: The starvation guard counts dequeued tasks, not scans:
+    //            a worker that idled between tasks still serves
+    //            background work on exactly every kStarvationInterval-th pick
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TSX-21 Priorities - starvation guard ignores idle scans")
+    {
+        TaskScheduler scheduler;
+        scheduler.SetThreadCount(1);
+
+        // A few picks, each followed by the worker scanning its empty queues and going back to sleep
+        constexpr uint32_t kSingles = 5;
+        std::atomic<uint32_t> singlesDone{ 0 };
+        for (uint32_t i = 0; i < kSingles; ++i)
+        {
+            scheduler.ScheduleTask([&]() { singlesDone.fetch_add(1); }, true, TaskPriority::FrameCritical);
+            while (singlesDone.load() <= i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        // The submitting task is the next pick; the background task takes the interval's last one
+        constexpr int kCriticalCount = 32;
+        std::atomic<int> sequence{ 0 };
+        std::atomic<int> backgroundPosition{ -1 };
+        std::atomic<int> done{ 0 };
+        scheduler.ScheduleTask([&]()
+        {
+            scheduler.ScheduleTask([&]() { backgroundPosition.store(sequence.fetch_add(1)); done.fetch_add(1); }, true, TaskPriority::Background);
+            for (int i = 0; i < kCriticalCount; ++i)
+                scheduler.ScheduleTask([&]() { sequence.fetch_add(1); done.fetch_add(1); }, true, TaskPriority::FrameCritical);
+        }, true, TaskPriority::FrameCritical);
+
+        while (done.load() < kCriticalCount + 1)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        scheduler.ExecuteAllScheduledTasks();
+
+        CHECK(backgroundPosition.load() == (int)(TaskScheduler::kStarvationInterval - kSingles - 2));
+        CHECK(scheduler.GetPriorityStats(TaskPriority::Background).m_StarvationPicks == 1);
+    }
 }
 
 // ============================================================================
@@ -648,3 +1207,128 @@ TEST_SUITE("Timer_Extended")
         CHECK(count.load() == 0);
     }
 }
+
+// ============================================================================
+// TEST SUITE: TaskGraph
+// ============================================================================
+TEST_SUITE("TaskGraph")
+{
+    // ------------------------------------------------------------------
+    // TC-TG-01: Diamond graph respects predecessor ordering
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TG-01 Dependencies - diamond graph runs in dependency order")
+    {
+        TaskScheduler scheduler;
+        TaskGraph graph;
+        std::atomic<int> order{ 0 };
+        int a = -1, b = -1, c = -1, d = -1;
+
+        const TaskGraph::NodeHandle nodeA = graph.AddNode("A", [&](uint32_t) { a = order.fetch_add(1); });
+        const TaskGraph::NodeHandle nodeB = graph.Then(nodeA, "B", [&](uint32_t) { b = order.fetch_add(1); });
+        const TaskGraph::NodeHandle nodeC = graph.Then(nodeA, "C", [&](uint32_t) { c = order.fetch_add(1); });
+        const TaskGraph::NodeHandle nodeD = graph.AddNode("D", [&](uint32_t) { d = order.fetch_add(1); });
+        graph.AddDependency(nodeB, nodeD);
+        graph.AddDependency(nodeC, nodeD);
+
+        scheduler.RunTaskGraph(graph);
+        scheduler.WaitForTaskGraph(graph);
+
+        CHECK(graph.IsComplete());
+        CHECK(a == 0);
+        CHECK(d == 3);
+        CHECK((b == 1 || b == 2));
+        CHECK((c == 1 || c == 2));
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TG-02: Completion callback runs once, after every node
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TG-02 Continuation - completion callback runs after all nodes")
+    {
+        TaskScheduler scheduler;
+        TaskGraph graph;
+        constexpr int kChainLength = 32;
+        std::atomic<int> executed{ 0 };
+        int executedAtCompletion = -1;
+        int completionCount = 0;
+
+        TaskGraph::NodeHandle prev = graph.AddNode("Chain 0", [&](uint32_t) { executed.fetch_add(1); });
+        for (int i = 1; i < kChainLength; ++i)
+            prev = graph.Then(prev, "Chain N", [&](uint32_t) { executed.fetch_add(1); });
+
+        graph.SetCompletionCallback([&]()
+        {
+            executedAtCompletion = executed.load();
+            ++completionCount;
+        });
+
+        scheduler.RunTaskGraph(graph);
+        scheduler.WaitForTaskGraph(graph);
+
+        CHECK(executed.load() == kChainLength);
+        CHECK(executedAtCompletion == kChainLength);
+        CHECK(completionCount == 1);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TG-03: A completed graph can be re-run, and ExecuteAllScheduledTasks drains it
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TG-03 Reuse - graph re-runs and is drained by ExecuteAllScheduledTasks")
+    {
+        TaskScheduler scheduler;
+        TaskGraph graph;
+        std::atomic<int> counter{ 0 };
+
+        const TaskGraph::NodeHandle root = graph.AddNode("Root", [&](uint32_t) { counter.fetch_add(1); });
+        for (int i = 0; i < 8; ++i)
+            graph.Then(root, "Leaf", [&](uint32_t) { counter.fetch_add(1); });
+
+        for (int run = 0; run < 3; ++run)
+        {
+            scheduler.RunTaskGraph(graph);
+            scheduler.ExecuteAllScheduledTasks();
+            CHECK(graph.IsComplete());
+        }
+        CHECK(counter.load() == 3 * 9);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TG-04: Waiting on a graph from inside a worker does not deadlock
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TG-04 NestedWait - graphs waited on from worker threads complete")
+    {
+        TaskScheduler scheduler;
+        scheduler.SetThreadCount(2);
+        std::atomic<int> counter{ 0 };
+
+        scheduler.ParallelFor(0, 8, 1, [&](uint32_t, uint32_t)
+        {
+            TaskGraph graph;
+            TaskGraph::NodeHandle prev = graph.AddNode("Inner 0", [&](uint32_t) { counter.fetch_add(1); });
+            for (int i = 1; i < 10; ++i)
+                prev = graph.Then(prev, "Inner N", [&](uint32_t) { counter.fetch_add(1); });
+
+            scheduler.RunTaskGraph(graph);
+            scheduler.WaitForTaskGraph(graph);
+        });
+
+        CHECK(counter.load() == 8 * 10);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-TG-05: Empty graph completes immediately
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-TG-05 EmptyGraph - run and wait on an empty graph is a no-op")
+    {
+        TaskScheduler scheduler;
+        TaskGraph graph;
+        bool bCompleted = false;
+        graph.SetCompletionCallback([&]() { bCompleted = true; });
+
+        scheduler.RunTaskGraph(graph);
+        scheduler.WaitForTaskGraph(graph);
+
+        CHECK(graph.IsComplete());
+        CHECK(bCompleted);
+    }
+}
@@ -611,10 +611,10 @@ TEST_SUITE("MultiFrame_GPULifetime")
         for (uint32_t hi = 0; hi < (uint32_t)heaps.size(); ++hi)
         {
             const auto& heap = heaps[hi];
-            if (!heap.m_Heap) continue; // empty slot
+            if (!heap.IsLive()) continue; // empty slot
 
             size_t total = 0;
-            for (const auto& block : heap.m_Blocks)
+            for (const auto& block : g_Renderer.m_RenderGraph.GetHeapBlocks(hi))
                 total += block.m_Size;
 
             INFO("Heap " << hi << " capacity=" << heap.m_Size << " block-sum=" << total);
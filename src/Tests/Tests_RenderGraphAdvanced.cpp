@@ -32,14 +32,31 @@
 //   - PostRender() does not crash
 //   - InsertAliasBarriers with passIndex=0 and a fresh command list does not crash
 //   - SetActivePass does not crash
+//   - FindAliasOffset packs by lifetime overlap, best fit, heap-relative alignment
+//   - Transient memory stats: aliased <= unaliased, peak live <= unaliased
+//   - Compiled-graph cache hits on identical frames, misses on a desc change
 //   - GetCurrentPassIndex returns 0 before any BeginPass
 //   - Two DeclareTexture calls with same desc return different handles
 //   - Two fresh DeclarePersistentTexture calls with same desc return different handles (no implicit dedup)
 //   - Persistent texture slot is stable when the same handle is re-declared across frames
 //   - Persistent buffer slot is stable when the same handle is re-declared across frames
+//   - History texture pairs swap physical textures every frame, keep their handles and the compile cache, reset on desc change
+//   - The previous half of a history pair hosts aliases after its last read, also when placed from the compile cache
 //   - RenderGraph::Reset() does not crash
 //   - G-buffer textures are accessible via their RG handles after a frame
 //   - HDR color texture is accessible via RG handle after a frame
+//   - ComputeRecordingOrder sorts longest-first, ties keep declaration order
+//   - Every renderer has a CPU time history after a frame
+//   - ComputeCommandListBatches merges cheap same-queue jobs within the budget, splits at syncs (CPU only)
+//   - A full frame records its passes into no more command lists than passes, one per pass with batching off
+//   - Pass culling skips passes whose outputs are never read, keeps side-effect and persistent-output passes
+//   - ScheduleQueues assigns async compute by dependencies and places minimal cross-queue syncs (CPU only)
+//   - Compile plans per-pass state transitions, batches them per pass, marks splittable ones, exports the plan
+//   - Mip-range accesses get per-subresource transitions and lifetimes, shown in the export
+//   - Setup + Compile benchmark: 200 passes x 1000 resources, lifetimes correct
+//   - Parallel setup merges in scheduling order (same graph as serial setup), falls back to serial for new slots
+//   - History declarations replay from the setup builders and swap once per frame
+//   - A frame that needs new slots re-runs only the Setup()s that declare or read them, the rest replay
 //
 // Run with: HobbyRenderer --run-tests=*RGAdv*
 // ============================================================================
@@ -426,6 +443,123 @@ TEST_SUITE("RGAdv_Aliasing")
         RunOneFrame();
         CHECK_NOTHROW(g_Renderer.m_RenderGraph.SetActivePass(0));
     }
+
+    // ------------------------------------------------------------------
+    // TC-RGA-AL-05: FindAliasOffset packs around placements with overlapping
+    //               lifetimes, picks the smallest fitting gap, and aligns
+    //               relative to the heap rather than the region
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGA-AL-05 Aliasing - FindAliasOffset best-fit packing")
+    {
+        using RenderGraphInternal::AliasPlacement;
+        using RenderGraphInternal::ResourceLifetime;
+
+        const ResourceLifetime passes3to4{ 3, 4 };
+        const ResourceLifetime passes5to6{ 5, 6 };
+        uint64_t gapSize = 0;
+
+        // Empty region: lands at the start
+        CHECK(RenderGraphInternal::FindAliasOffset({}, 0, 1024, 256, 1, passes3to4, gapSize) == 0);
+        CHECK(gapSize == 1024);
+
+        // Two small resources share one dead owner side by side
+        std::vector<AliasPlacement> placements = { { 0, 1024, { 1, 2 } } }; // the owner itself, dead after pass 2
+        const uint64_t first = RenderGraphInternal::FindAliasOffset(placements, 0, 1024, 512, 1, passes3to4, gapSize);
+        REQUIRE(first == 0);
+        placements.push_back({ first, 512, passes3to4 });
+        const uint64_t second = RenderGraphInternal::FindAliasOffset(placements, 0, 1024, 512, 1, passes3to4, gapSize);
+        CHECK(second == 512);
+        placements.push_back({ second, 512, passes3to4 });
+
+        // Region is full for passes 3-4, but free again afterwards
+        CHECK(RenderGraphInternal::FindAliasOffset(placements, 0, 1024, 256, 1, passes3to4, gapSize) == UINT64_MAX);
+        CHECK(RenderGraphInternal::FindAliasOffset(placements, 0, 1024, 1024, 1, passes5to6, gapSize) == 0);
+
+        // Best fit: gaps of 300 at [0, 300) and 100 at [400, 500) -> a 100 byte resource takes the small one
+        const std::vector<AliasPlacement> gapped = { { 300, 100, passes3to4 }, { 500, 524, passes3to4 } };
+        CHECK(RenderGraphInternal::FindAliasOffset(gapped, 0, 1024, 100, 1, passes3to4, gapSize) == 400);
+        CHECK(gapSize == 100);
+        CHECK(RenderGraphInternal::FindAliasOffset(gapped, 0, 1024, 200, 1, passes3to4, gapSize) == 0);
+        CHECK(RenderGraphInternal::FindAliasOffset(gapped, 0, 1024, 301, 1, passes3to4, gapSize) == UINT64_MAX);
+
+        // Alignment is relative to the heap: region at heap offset 64, 256-byte alignment -> first aligned byte is 192 in
+        CHECK(RenderGraphInternal::FindAliasOffset({}, 64, 1024, 256, 256, passes3to4, gapSize) == 192);
+        CHECK(RenderGraphInternal::FindAliasOffset({}, 64, 400, 256, 256, passes3to4, gapSize) == UINT64_MAX);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGA-AL-06: Transient memory stats are consistent after a frame
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-AL-06 Aliasing - transient memory stats are consistent")
+    {
+        ConfigGuard guard;
+        auto& cfg = const_cast<Config&>(Config::Get());
+
+        cfg.m_EnableRenderGraphAliasing = true;
+        RunOneFrame();
+        const RenderGraph::Stats aliasedStats = g_Renderer.m_RenderGraph.GetStats();
+        CHECK(aliasedStats.m_TransientMemoryUnaliased > 0);
+        CHECK(aliasedStats.m_TransientMemoryAliased <= aliasedStats.m_TransientMemoryUnaliased);
+        CHECK(aliasedStats.m_TransientMemoryPeakLive <= aliasedStats.m_TransientMemoryUnaliased);
+
+        cfg.m_EnableRenderGraphAliasing = false;
+        RunOneFrame();
+        const RenderGraph::Stats unaliasedStats = g_Renderer.m_RenderGraph.GetStats();
+        CHECK(unaliasedStats.m_TransientMemoryAliased == unaliasedStats.m_TransientMemoryUnaliased);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGA-AL-07: Identical frames hit the compiled-graph cache, keep their
+    //               aliasing decisions, and a changed desc forces a recompile
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-AL-07 Aliasing - compiled graph cache hits on identical frames")
+    {
+        ConfigGuard guard;
+        const_cast<Config&>(Config::Get()).m_EnableRenderGraphAliasing = true;
+
+        auto& rg = g_Renderer.m_RenderGraph;
+
+        // Push engine slots out of the pool-reuse window so hA/hB get fresh slots and alias
+        RunOneFrame();
+
+        RGTextureHandle hA, hB;
+        auto runMiniFrame = [&](uint32_t sizeB)
+        {
+            rg.Reset();
+            rg.BeginSetup();
+            rg.DeclareTexture(MakeTexDesc(128, 128, nvrhi::Format::RGBA8_UNORM, true, "TC-AL-07-A"), hA);
+            rg.BeginPass("TC-AL-07-PassA");
+            rg.DeclareTexture(MakeTexDesc(sizeB, sizeB, nvrhi::Format::RGBA8_UNORM, true, "TC-AL-07-B"), hB);
+            rg.BeginPass("TC-AL-07-PassB");
+            rg.EndSetup();
+            rg.Compile();
+        };
+
+        runMiniFrame(128);
+        CHECK_FALSE(rg.GetStats().m_bCompiledFromCache);
+        REQUIRE(rg.GetTextures()[hB.m_Index].m_AliasedFromIndex == hA.m_Index);
+        const RenderGraph::Stats firstStats = rg.GetStats();
+        rg.PostRender();
+
+        const uint64_t hitsBefore = rg.GetCompileCacheHits();
+        runMiniFrame(128);
+        CHECK(rg.GetStats().m_bCompiledFromCache);
+        CHECK(rg.GetCompileCacheHits() == hitsBefore + 1);
+        // Same decisions as the compiled frame, and the aliased texture was re-created on its placement
+        CHECK(rg.GetTextures()[hB.m_Index].m_AliasedFromIndex == hA.m_Index);
+        CHECK(rg.GetTextureRaw(hA) != nullptr);
+        CHECK(rg.GetTextureRaw(hB) != nullptr);
+        CHECK(rg.GetStats().m_NumAliasedTextures == firstStats.m_NumAliasedTextures);
+        CHECK(rg.GetStats().m_TotalTextureMemory == firstStats.m_TotalTextureMemory);
+        rg.PostRender();
+
+        const uint64_t missesBefore = rg.GetCompileCacheMisses();
+        runMiniFrame(64);
+        CHECK_FALSE(rg.GetStats().m_bCompiledFromCache);
+        CHECK(rg.GetCompileCacheMisses() == missesBefore + 1);
+        CHECK(rg.GetTextureRaw(hB) != nullptr);
+        rg.PostRender();
+    }
 }
 
 // ============================================================================
@@ -512,6 +646,138 @@ TEST_SUITE("RGAdv_PersistentResources")
         CHECK(h.IsValid());
         CHECK(h.m_Index == firstIdx);
     }
+
+    // ------------------------------------------------------------------
+    // TC-RGA-P03: A history texture pair trades physical textures every
+    //             frame: last frame's current texture comes back as the
+    //             previous one, with no copy. The handles, and so the
+    //             compiled graph, stay the same; a desc change drops the
+    //             history. After its last read the previous half's memory
+    //             goes to transient resources, the current half's never.
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-P03 PersistentResources - history texture pair swaps across frames")
+    {
+        ConfigGuard guard;
+        const_cast<Config&>(Config::Get()).m_EnableRenderGraphAliasing = true;
+
+        auto& rg = g_Renderer.m_RenderGraph;
+        RunOneFrame();
+
+        RGTextureHandle hCurrent, hPrevious, hScratch;
+        bool bIsNew = false;
+        auto runMiniFrame = [&](uint32_t size)
+        {
+            rg.Reset();
+            rg.BeginSetup();
+            bIsNew = rg.DeclareHistoryTexture(MakeTexDesc(size, size, nvrhi::Format::RGBA8_UNORM, true, "TC-P03-History"), hCurrent, hPrevious);
+            rg.BeginPass("TC-P03-Write");
+            rg.ReadTexture(hPrevious);
+            rg.ReadTexture(hCurrent);
+            rg.MarkSideEffects();
+            rg.BeginPass("TC-P03-Resolve");
+            // Both halves are dead by now as far as this frame goes
+            rg.DeclareTexture(MakeTexDesc(size, size, nvrhi::Format::RGBA8_UNORM, true, "TC-P03-Scratch"), hScratch);
+            rg.MarkSideEffects();
+            rg.BeginPass("TC-P03-Scratch");
+            rg.EndSetup();
+            rg.Compile();
+        };
+        auto hasTransition = [&](uint16_t passIdx, RGTextureHandle handle)
+        {
+            for (const RenderGraphInternal::StateTransition& transition : rg.GetPassStateTransitions(passIdx))
+            {
+                if (!transition.m_bIsBuffer && transition.m_ResourceIndex == handle.m_Index)
+                    return true;
+            }
+            return false;
+        };
+        // Wherever the previous half's block is this frame, the scratch texture sits in it
+        auto checkScratchInPrevious = [&]()
+        {
+            const RenderGraphInternal::TransientTexture& scratch = rg.GetTextures()[hScratch.m_Index];
+            const RenderGraphInternal::TransientTexture& previous = rg.GetTextures()[hPrevious.m_Index];
+            CHECK(scratch.m_AliasedFromIndex == hPrevious.m_Index);
+            CHECK(scratch.m_Heap == previous.m_Heap);
+            CHECK(scratch.m_Offset == previous.m_Offset);
+        };
+
+        // Frame 1: nothing to look back at yet. Only the current half is written by the declaring pass.
+        runMiniFrame(64);
+        CHECK(bIsNew);
+        REQUIRE(hCurrent.IsValid());
+        REQUIRE(hPrevious.IsValid());
+        CHECK(hCurrent != hPrevious);
+        CHECK_FALSE(rg.IsHistoryValid(hPrevious));
+        CHECK(rg.GetTextures()[hCurrent.m_Index].m_IsPersistent);
+        CHECK(rg.GetTextures()[hPrevious.m_Index].m_IsPersistent);
+        CHECK(hasTransition(1, hCurrent));
+        CHECK_FALSE(hasTransition(1, hPrevious));
+        // The current half is kept for next frame, the previous one is dead after the write pass
+        CHECK(rg.GetTextures()[hScratch.m_Index].m_AliasedFromIndex != hCurrent.m_Index);
+        checkScratchInPrevious();
+        const nvrhi::TextureHandle texA = rg.GetTextureRaw(hCurrent);
+        const nvrhi::TextureHandle texB = rg.GetTextureRaw(hPrevious);
+        REQUIRE(texA != nullptr);
+        REQUIRE(texB != nullptr);
+        CHECK(texA != texB);
+        const RGTextureHandle firstCurrent = hCurrent;
+        const RGTextureHandle firstPrevious = hPrevious;
+        rg.PostRender();
+
+        // Frame 2: last frame's current texture is now the previous one
+        runMiniFrame(64);
+        CHECK_FALSE(bIsNew);
+        CHECK(rg.IsHistoryValid(hPrevious));
+        CHECK_FALSE(rg.IsHistoryValid(hCurrent));
+        CHECK(hCurrent == firstCurrent);
+        CHECK(hPrevious == firstPrevious);
+        CHECK(rg.GetTextureRaw(hPrevious) == texA);
+        CHECK(rg.GetTextureRaw(hCurrent) == texB);
+        checkScratchInPrevious();
+        rg.PostRender();
+
+        // Frame 3: and back again, from the compiled-graph cache. The scratch texture follows the previous half's block
+        // instead of staying where it was last frame, which is now the current half's.
+        runMiniFrame(64);
+        CHECK_FALSE(bIsNew);
+        CHECK(rg.GetStats().m_bCompiledFromCache);
+        CHECK(rg.GetTextureRaw(hPrevious) == texB);
+        CHECK(rg.GetTextureRaw(hCurrent) == texA);
+        checkScratchInPrevious();
+        rg.PostRender();
+
+        // A desc change leaves nothing to look back at, on the same handles
+        runMiniFrame(32);
+        CHECK(bIsNew);
+        CHECK_FALSE(rg.IsHistoryValid(hPrevious));
+        CHECK(hCurrent == firstCurrent);
+        CHECK(hPrevious == firstPrevious);
+        const nvrhi::TextureHandle resizedCurrent = rg.GetTextureRaw(hCurrent);
+        REQUIRE(resizedCurrent != nullptr);
+        CHECK(resizedCurrent->getDesc().width == 32);
+        rg.PostRender();
+
+        runMiniFrame(32);
+        CHECK_FALSE(bIsNew);
+        CHECK(rg.IsHistoryValid(hPrevious));
+        CHECK(rg.GetTextureRaw(hPrevious) == resizedCurrent);
+        rg.PostRender();
+
+        // Declared as a plain texture, the slot leaves the pair: the next history declaration starts over
+        rg.Reset();
+        rg.BeginSetup();
+        rg.DeclarePersistentTexture(MakeTexDesc(32, 32, nvrhi::Format::RGBA8_UNORM, true, "TC-P03-History"), hCurrent);
+        rg.MarkSideEffects();
+        rg.BeginPass("TC-P03-Write");
+        rg.EndSetup();
+        rg.Compile();
+        rg.PostRender();
+
+        runMiniFrame(32);
+        CHECK(bIsNew);
+        CHECK_FALSE(rg.IsHistoryValid(hPrevious));
+        rg.PostRender();
+    }
 }
 TEST_SUITE("RGAdv_GBufferHandles")
 {
@@ -608,3 +874,833 @@ TEST_SUITE("RGAdv_GBufferHandles")
         CHECK(g_RG_ExposureTexture.IsValid());
     }
 }
+
+// ============================================================================
+// TEST SUITE: RGAdv_RecordingOrder
+// ============================================================================
+TEST_SUITE("RGAdv_RecordingOrder")
+{
+    // ------------------------------------------------------------------
+    // TC-RGA-RO-01: ComputeRecordingOrder is longest-first and stable
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGA-RO-01 RecordingOrder - longest first, ties keep declaration order")
+    {
+        const float cpuTimes[] = { 0.1f, 2.0f, 0.0f, 2.0f, 0.5f, 0.0f };
+        const std::vector<uint32_t> order = RenderGraph::ComputeRecordingOrder(cpuTimes);
+
+        const std::vector<uint32_t> expected = { 1, 3, 4, 0, 2, 5 };
+        CHECK(order == expected);
+
+        CHECK(RenderGraph::ComputeRecordingOrder({}).empty());
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGA-RO-02: Enabled renderers carry a CPU time history after frames
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-RO-02 RecordingOrder - renderers record CPU time history")
+    {
+        RunOneFrame();
+        RunOneFrame();
+
+        for (const std::shared_ptr<IRenderer>& pRenderer : g_Renderer.m_Renderers)
+        {
+            INFO("Renderer: " << pRenderer->GetName());
+            if (pRenderer->m_bPassEnabled && pRenderer->m_CPUTime > 0.0f)
+            {
+                CHECK(pRenderer->m_CPUTimeHistory > 0.0f);
+            }
+        }
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGA-RO-03: ComputeCommandListBatches merges adjacent cheap jobs
+    //               within the budget, never across queues or syncs,
+    //               and leaves heavy and unmeasured jobs alone
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGA-RO-03 RecordingOrder - command list batches (CPU only)")
+    {
+        using RenderGraphInternal::CommandListJobInfo;
+        constexpr nvrhi::CommandQueue G = nvrhi::CommandQueue::Graphics;
+        constexpr nvrhi::CommandQueue C = nvrhi::CommandQueue::Compute;
+
+        const CommandListJobInfo jobs[] = {
+            { 0.05f, G },              // 0: new list
+            { 0.05f, G },              // 1: joins 0
+            { 0.10f, G },              // 2: joins 0 (0.20 ms total)
+            { 0.10f, G },              // 3: over the budget, new list
+            { 2.00f, G },              // 4: heavy, alone
+            { 0.05f, G },              // 5: previous job is heavy, new list
+            { 0.0f,  G },              // 6: no history, alone
+            { 0.05f, G },              // 7: previous job unmeasured, new list
+            { 0.05f, C },              // 8: other queue, new list
+            { 0.05f, C, true },        // 9: waits for the graphics queue, new list
+            { 0.05f, C, false, true }, // 10: joins 9, but the graphics queue waits for it
+            { 0.05f, C },              // 11: new list
+        };
+
+        const std::vector<uint32_t> batches = RenderGraph::ComputeCommandListBatches(jobs, 0.25f);
+        const std::vector<uint32_t> expected = { 0, 3, 4, 5, 6, 7, 8, 9, 11 };
+        CHECK(batches == expected);
+
+        // No budget: one list per job
+        const std::vector<uint32_t> unbatched = RenderGraph::ComputeCommandListBatches(jobs, 0.0f);
+        REQUIRE(unbatched.size() == std::size(jobs));
+        for (uint32_t i = 0; i < (uint32_t)unbatched.size(); ++i)
+            CHECK(unbatched[i] == i);
+
+        CHECK(RenderGraph::ComputeCommandListBatches({}, 0.25f).empty());
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGA-RO-04: A full frame groups its passes into at most one list
+    //               per pass, and exactly one per pass with batching off
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-RO-04 RecordingOrder - passes grouped into command lists")
+    {
+        ConfigGuard guard;
+        auto& rg = g_Renderer.m_RenderGraph;
+
+        // Everything looks cheap, so every run of same-queue passes without a cross-queue sync can share a list
+        const_cast<Config&>(Config::Get()).m_CommandListBatchMaxCPUTimeMs = 1000.0f;
+        RunOneFrame();
+        RunOneFrame();
+        const RenderGraph::Stats batched = rg.GetStats();
+        CHECK(batched.m_NumRecordedPasses > 1);
+        CHECK(batched.m_NumPassCommandLists >= 1);
+        CHECK(batched.m_NumPassCommandLists <= batched.m_NumRecordedPasses);
+        CHECK(rg.ExportToString().find("Command Lists:") != std::string::npos);
+
+        const_cast<Config&>(Config::Get()).m_CommandListBatchMaxCPUTimeMs = 0.0f;
+        RunOneFrame();
+        const RenderGraph::Stats unbatched = rg.GetStats();
+        CHECK(unbatched.m_NumPassCommandLists == unbatched.m_NumRecordedPasses);
+    }
+}
+
+// ============================================================================
+// TEST SUITE: RGAdv_PassCulling
+// ============================================================================
+TEST_SUITE("RGAdv_PassCulling")
+{
+    // Scheduled pass with test-provided Setup() that counts its Render() calls
+    class CullTestRenderer : public IRenderer
+    {
+    public:
+        CullTestRenderer(const char* name, std::function<void(RenderGraph&)> setupFunc)
+            : m_Name(name), m_SetupFunc(std::move(setupFunc))
+        {
+            m_GPUQueries[0] = DEV()->createTimerQuery();
+            m_GPUQueries[1] = DEV()->createTimerQuery();
+        }
+
+        bool Setup(RenderGraph& renderGraph) override { m_SetupFunc(renderGraph); return true; }
+        void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) override { ++m_RenderCount; }
+        const char* GetName() const override { return m_Name; }
+
+        const char* m_Name;
+        std::function<void(RenderGraph&)> m_SetupFunc;
+        std::atomic<uint32_t> m_RenderCount = 0;
+    };
+
+    // ------------------------------------------------------------------
+    // TC-RGA-CU-01: Passes whose outputs nobody reads are culled before
+    //               recording; side-effect and persistent-output passes
+    //               (and everything they read) are kept
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-CU-01 PassCulling - unread outputs culled, marked outputs kept")
+    {
+        ConfigGuard guard;
+        const_cast<Config&>(Config::Get()).m_EnableRenderGraphPassCulling = true;
+
+        auto& rg = g_Renderer.m_RenderGraph;
+
+        RGTextureHandle hScene, hDebug, hChainA, hChainB;
+        RGBufferHandle hHistory;
+        CullTestRenderer scenePass("TC-CU-01-Scene", [&](RenderGraph& g)
+        {
+            g.DeclareTexture(MakeTexDesc(64, 64, nvrhi::Format::RGBA8_UNORM, true, "TC-CU-01-SceneTex"), hScene);
+        });
+        CullTestRenderer debugPass("TC-CU-01-Debug", [&](RenderGraph& g)
+        {
+            g.ReadTexture(hScene);
+            g.DeclareTexture(MakeTexDesc(64, 64, nvrhi::Format::RGBA8_UNORM, true, "TC-CU-01-DebugTex"), hDebug);
+        });
+        CullTestRenderer chainAPass("TC-CU-01-ChainA", [&](RenderGraph& g)
+        {
+            g.DeclareTexture(MakeTexDesc(32, 32, nvrhi::Format::RGBA8_UNORM, true, "TC-CU-01-ChainATex"), hChainA);
+        });
+        CullTestRenderer chainBPass("TC-CU-01-ChainB", [&](RenderGraph& g)
+        {
+            g.ReadTexture(hChainA);
+            g.DeclareTexture(MakeTexDesc(32, 32, nvrhi::Format::RGBA8_UNORM, true, "TC-CU-01-ChainBTex"), hChainB);
+        });
+        CullTestRenderer historyPass("TC-CU-01-History", [&](RenderGraph& g)
+        {
+            g.ReadTexture(hScene);
+            g.DeclarePersistentBuffer(MakeBufDesc(256, true, "TC-CU-01-HistoryBuf"), hHistory);
+        });
+        CullTestRenderer outputPass("TC-CU-01-Output", [&](RenderGraph& g)
+        {
+            g.ReadTexture(hScene);
+            g.MarkSideEffects();
+        });
+        CullTestRenderer* passes[] = { &scenePass, &debugPass, &chainAPass, &chainBPass, &historyPass, &outputPass };
+
+        auto runFrame = [&]()
+        {
+            rg.Reset();
+            rg.BeginSetup();
+            for (CullTestRenderer* pPass : passes)
+                rg.ScheduleRenderer(pPass);
+            rg.EndSetup();
+            rg.Compile();
+        };
+        auto recordFrame = [&]()
+        {
+            rg.SubmitRecordingJobs();
+            g_Renderer.m_TaskScheduler->ExecuteAllScheduledTasks();
+            rg.PostRender();
+            g_Renderer.ExecutePendingCommandLists();
+        };
+
+        runFrame();
+        CHECK(rg.GetStats().m_NumCulledPasses == 3);
+        CHECK(rg.IsPassCulled(rg.GetPassIndex("TC-CU-01-Debug")));
+        CHECK(rg.IsPassCulled(rg.GetPassIndex("TC-CU-01-ChainA")));
+        CHECK(rg.IsPassCulled(rg.GetPassIndex("TC-CU-01-ChainB")));
+        CHECK_FALSE(rg.IsPassCulled(rg.GetPassIndex("TC-CU-01-Scene")));
+        CHECK_FALSE(rg.IsPassCulled(rg.GetPassIndex("TC-CU-01-History")));
+        CHECK_FALSE(rg.IsPassCulled(rg.GetPassIndex("TC-CU-01-Output")));
+        CHECK_FALSE(debugPass.m_bPassEnabled);
+        CHECK(scenePass.m_bPassEnabled);
+
+        // Culled passes' resources drop out of the frame; the live ones' lifetimes ignore the culled readers
+        CHECK_FALSE(rg.GetTextures()[hDebug.m_Index].m_IsDeclaredThisFrame);
+        CHECK_FALSE(rg.GetTextures()[hChainA.m_Index].m_IsDeclaredThisFrame);
+        CHECK(rg.GetTextures()[hScene.m_Index].m_IsDeclaredThisFrame);
+        CHECK(rg.GetTextures()[hScene.m_Index].m_Lifetime.m_LastPass == rg.GetPassIndex("TC-CU-01-Output"));
+        CHECK(rg.GetBuffers()[hHistory.m_Index].m_IsDeclaredThisFrame);
+
+        recordFrame();
+        CHECK(scenePass.m_RenderCount == 1);
+        CHECK(historyPass.m_RenderCount == 1);
+        CHECK(outputPass.m_RenderCount == 1);
+        CHECK(debugPass.m_RenderCount == 0);
+        CHECK(chainAPass.m_RenderCount == 0);
+        CHECK(chainBPass.m_RenderCount == 0);
+
+        // With culling off every enabled pass records
+        const_cast<Config&>(Config::Get()).m_EnableRenderGraphPassCulling = false;
+        runFrame();
+        CHECK(rg.GetStats().m_NumCulledPasses == 0);
+        CHECK(debugPass.m_bPassEnabled);
+        recordFrame();
+        CHECK(debugPass.m_RenderCount == 1);
+        CHECK(chainBPass.m_RenderCount == 1);
+        CHECK(outputPass.m_RenderCount == 2);
+    }
+}
+
+// ============================================================================
+// TEST SUITE: RGAdv_QueueScheduling
+// ============================================================================
+TEST_SUITE("RGAdv_QueueScheduling")
+{
+    // ------------------------------------------------------------------
+    // TC-RGA-AQ-01: ScheduleQueues moves compute passes that can overlap
+    //               graphics work to the compute queue and only syncs on
+    //               dependencies a queue hasn't already waited past
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGA-AQ-01 QueueScheduling - async compute assignment and sync points")
+    {
+        using RenderGraphInternal::QueuePassInfo;
+        using RenderGraphInternal::QueueSyncPoint;
+
+        auto makePass = [](bool bPrefersAsyncCompute, std::vector<uint16_t> dependencies)
+        {
+            QueuePassInfo info;
+            info.m_bPrefersAsyncCompute = bPrefersAsyncCompute;
+            info.m_Dependencies = std::move(dependencies);
+            return info;
+        };
+
+        std::vector<QueuePassInfo> passes = {
+            makePass(false, {}),        // 1  graphics
+            makePass(true,  { 1 }),     // 2  compute: overlaps 3, waits for 1
+            makePass(false, { 1 }),     // 3  graphics
+            makePass(false, { 2, 3 }),  // 4  graphics, waits for 2
+            makePass(true,  {}),        // 5  prefers compute, but touches a graphics-only state
+            makePass(true,  { 5 }),     // 6  prefers compute, but needs 5 and 7 needs it: nothing to overlap
+            makePass(false, { 6 }),     // 7  graphics
+            makePass(true,  { 3 }),     // 8  compute: overlaps 9, waits for 3
+            makePass(false, { 1 }),     // 9  graphics
+            makePass(false, { 2, 8 }),  // 10 graphics, waits for 8 (covers 2)
+            makePass(true,  {}),        // 11 culled
+            makePass(true,  { 1, 2 }),  // 12 compute: already waited past 1
+        };
+        passes[4].m_bComputeCompatible = false;
+        passes[10].m_bCulled = true;
+
+        std::vector<nvrhi::CommandQueue> queues;
+        std::vector<QueueSyncPoint> syncPoints;
+        RenderGraph::ScheduleQueues(passes, queues, syncPoints);
+
+        const nvrhi::CommandQueue G = nvrhi::CommandQueue::Graphics;
+        const nvrhi::CommandQueue C = nvrhi::CommandQueue::Compute;
+        const std::vector<nvrhi::CommandQueue> expectedQueues = { G, C, G, G, G, G, G, C, G, G, G, C };
+        CHECK(queues == expectedQueues);
+
+        REQUIRE(syncPoints.size() == 4);
+        const uint16_t expectedSyncs[][2] = { { 1, 2 }, { 2, 4 }, { 3, 8 }, { 8, 10 } };
+        for (size_t i = 0; i < syncPoints.size(); ++i)
+        {
+            INFO("Sync point " << i);
+            CHECK(syncPoints[i].m_SignalPass == expectedSyncs[i][0]);
+            CHECK(syncPoints[i].m_WaitingPass == expectedSyncs[i][1]);
+        }
+
+        // Without any graphics work there is nothing to overlap with
+        std::vector<QueuePassInfo> computeOnly = { makePass(true, {}) };
+        RenderGraph::ScheduleQueues(computeOnly, queues, syncPoints);
+        CHECK(queues[0] == G);
+        CHECK(syncPoints.empty());
+
+        RenderGraph::ScheduleQueues({}, queues, syncPoints);
+        CHECK(queues.empty());
+        CHECK(syncPoints.empty());
+    }
+}
+
+// ============================================================================
+// TEST SUITE: RGAdv_BarrierPlan
+// ============================================================================
+TEST_SUITE("RGAdv_BarrierPlan")
+{
+    // ------------------------------------------------------------------
+    // TC-RGA-BT-01: Compile plans each pass's transitions from its declared
+    //               accesses, one batch per pass; transitions with idle
+    //               passes before them are split; the plan is exported
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-BT-01 BarrierPlan - per-pass transitions, batching and split placement")
+    {
+        ConfigGuard guard;
+        const_cast<Config&>(Config::Get()).m_EnableRenderGraphAliasing = false;
+        const_cast<Config&>(Config::Get()).m_EnableAsyncCompute = false;
+
+        auto& rg = g_Renderer.m_RenderGraph;
+        RunOneFrame();
+
+        // A: UAV texture, tracked across passes. B: same, rewritten in place. C: render target that nvrhi returns to
+        // its initial state after every command list. D: depth, whose read state the desc can't tell.
+        RGTextureDesc rtDesc = MakeTexDesc(64, 64, nvrhi::Format::RGBA8_UNORM, false, "TC-BT-01-C");
+        rtDesc.m_NvrhiDesc.isRenderTarget = true;
+        rtDesc.m_NvrhiDesc.initialState = nvrhi::ResourceStates::RenderTarget;
+        rtDesc.m_NvrhiDesc.keepInitialState = true;
+        RGTextureDesc depthDesc = MakeTexDesc(64, 64, nvrhi::Format::D32, false, "TC-BT-01-D");
+        depthDesc.m_NvrhiDesc.isRenderTarget = true;
+        depthDesc.m_NvrhiDesc.initialState = nvrhi::ResourceStates::DepthWrite;
+        depthDesc.m_NvrhiDesc.keepInitialState = true;
+
+        RGTextureHandle hA, hB, hC, hD;
+        rg.Reset();
+        rg.BeginSetup();
+        rg.DeclareTexture(MakeTexDesc(64, 64, nvrhi::Format::RGBA8_UNORM, true, "TC-BT-01-A"), hA);
+        rg.DeclareTexture(rtDesc, hC);
+        rg.DeclareTexture(depthDesc, hD);
+        rg.BeginPass("TC-BT-01-Pass1");
+        rg.DeclareTexture(MakeTexDesc(64, 64, nvrhi::Format::RGBA8_UNORM, true, "TC-BT-01-B"), hB);
+        rg.BeginPass("TC-BT-01-Pass2");
+        rg.WriteTexture(hB);
+        rg.BeginPass("TC-BT-01-Pass3");
+        rg.ReadTexture(hA);
+        rg.ReadTexture(hB);
+        rg.ReadTexture(hC);
+        rg.ReadTexture(hD);
+        rg.BeginPass("TC-BT-01-Pass4");
+        rg.EndSetup();
+        rg.Compile();
+
+        using RenderGraphInternal::StateTransition;
+        auto find = [&](uint16_t passIdx, RGTextureHandle handle) -> const StateTransition*
+        {
+            for (const StateTransition& transition : rg.GetPassStateTransitions(passIdx))
+            {
+                if (!transition.m_bIsBuffer && transition.m_ResourceIndex == handle.m_Index)
+                    return &transition;
+            }
+            return nullptr;
+        };
+
+        // Pass 1: A leaves its initial state; C and D are written in the state they start every command list in
+        REQUIRE(rg.GetPassStateTransitions(1).size() == 1);
+        REQUIRE(find(1, hA) != nullptr);
+        CHECK(find(1, hA)->m_Before == nvrhi::ResourceStates::ShaderResource);
+        CHECK(find(1, hA)->m_After == nvrhi::ResourceStates::UnorderedAccess);
+        CHECK(find(1, hA)->m_BeginPass == 1);
+
+        // Pass 2: B isn't aliased, so its first transition could already start in pass 1
+        REQUIRE(rg.GetPassStateTransitions(2).size() == 1);
+        REQUIRE(find(2, hB) != nullptr);
+        CHECK(find(2, hB)->m_BeginPass == 1);
+        CHECK(rg.GetPassStateTransitions(3).empty()); // B is already a UAV
+
+        // Pass 4: one batch; A and C were idle since pass 1, B was written by the pass just before
+        REQUIRE(rg.GetPassStateTransitions(4).size() == 3);
+        REQUIRE(find(4, hA) != nullptr);
+        CHECK(find(4, hA)->m_Before == nvrhi::ResourceStates::UnorderedAccess);
+        CHECK(find(4, hA)->m_After == nvrhi::ResourceStates::ShaderResource);
+        CHECK(find(4, hA)->m_BeginPass == 2);
+        REQUIRE(find(4, hB) != nullptr);
+        CHECK(find(4, hB)->m_BeginPass == 4);
+        REQUIRE(find(4, hC) != nullptr);
+        CHECK(find(4, hC)->m_Before == nvrhi::ResourceStates::RenderTarget);
+        CHECK(find(4, hC)->m_BeginPass == 2);
+        CHECK(find(4, hD) == nullptr);
+
+        CHECK(rg.GetStats().m_NumStateTransitions == 5);
+        CHECK(rg.GetStats().m_NumBarrierBatches == 3);
+        CHECK(rg.GetStats().m_NumSplitTransitions == 3);
+
+        const std::string dump = rg.ExportToString();
+        CHECK(dump.find("- State Transitions: 5 in 3 batches, 3 splittable") != std::string::npos);
+        CHECK(dump.find("   - Transition: TC-BT-01-A ShaderResource -> UnorderedAccess\n") != std::string::npos);
+        CHECK(dump.find("   - Transition: TC-BT-01-A UnorderedAccess -> ShaderResource (split, begins at pass 2)") != std::string::npos);
+
+        // Applying the batch to a command list
+        auto cl = DEV()->createCommandList();
+        REQUIRE(cl != nullptr);
+        cl->open();
+        CHECK_NOTHROW(rg.InsertStateTransitions(4, cl));
+        CHECK_NOTHROW(rg.InsertStateTransitions(0, cl));
+        cl->close();
+        rg.PostRender();
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGA-BT-02: Accesses to part of a mip chain only transition the
+    //               touched mips and give each mip its own lifetime
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-BT-02 BarrierPlan - subresource ranges")
+    {
+        ConfigGuard guard;
+        const_cast<Config&>(Config::Get()).m_EnableRenderGraphAliasing = false;
+        const_cast<Config&>(Config::Get()).m_EnableAsyncCompute = false;
+
+        auto& rg = g_Renderer.m_RenderGraph;
+        RunOneFrame();
+
+        RGTextureDesc chainDesc = MakeTexDesc(64, 64, nvrhi::Format::RGBA8_UNORM, true, "TC-BT-02-Chain");
+        chainDesc.m_NvrhiDesc.mipLevels = 4;
+
+        // Pass 2 builds mip 1 from mip 0, pass 3 reads mip 1, pass 4 reads mips 2-3
+        RGTextureHandle hChain;
+        rg.Reset();
+        rg.BeginSetup();
+        rg.DeclareTexture(chainDesc, hChain);
+        rg.BeginPass("TC-BT-02-Pass1");
+        rg.ReadTexture(hChain, nvrhi::TextureSubresourceSet(0, 1, 0, 1));
+        rg.WriteTexture(hChain, nvrhi::TextureSubresourceSet(1, 1, 0, 1));
+        rg.BeginPass("TC-BT-02-Pass2");
+        rg.ReadTexture(hChain, nvrhi::TextureSubresourceSet(1, 1, 0, 1));
+        rg.BeginPass("TC-BT-02-Pass3");
+        rg.ReadTexture(hChain, nvrhi::TextureSubresourceSet(2, 2, 0, 1));
+        rg.BeginPass("TC-BT-02-Pass4");
+        rg.EndSetup();
+        rg.Compile();
+
+        using RenderGraphInternal::StateTransition;
+        auto checkTransition = [&](uint16_t passIdx, uint32_t baseMip, uint32_t numMips, uint16_t beginPass)
+        {
+            CAPTURE(passIdx);
+            const std::vector<StateTransition>& transitions = rg.GetPassStateTransitions(passIdx);
+            REQUIRE(transitions.size() == 1);
+            CHECK(transitions[0].m_Subresources.baseMipLevel == baseMip);
+            CHECK(transitions[0].m_Subresources.numMipLevels == numMips);
+            CHECK(transitions[0].m_BeginPass == beginPass);
+        };
+        checkTransition(1, 0, 4, 1);
+        checkTransition(2, 0, 1, 2); // mip 1 is written as a UAV, which it already is
+        checkTransition(3, 1, 1, 3);
+        checkTransition(4, 2, 2, 2); // mips 2-3 were idle since pass 1
+        CHECK(rg.GetPassStateTransitions(4)[0].m_After == nvrhi::ResourceStates::ShaderResource);
+
+        // The texture lives until pass 4, but its first two mips retire earlier
+        const auto& texture = rg.GetTextures()[hChain.m_Index];
+        CHECK(texture.m_Lifetime.m_LastPass == 4);
+        REQUIRE(texture.m_SubresourceLifetimes.size() == 4);
+        CHECK(texture.m_SubresourceLifetimes[0].m_LastPass == 2);
+        CHECK(texture.m_SubresourceLifetimes[1].m_LastPass == 3);
+        CHECK(texture.m_SubresourceLifetimes[3].m_LastPass == 4);
+
+        const std::string dump = rg.ExportToString();
+        CHECK(dump.find("[R]TC-BT-02-Chain (mips 0-0) [W]TC-BT-02-Chain (mips 1-1)") != std::string::npos);
+        CHECK(dump.find("   - Transition: TC-BT-02-Chain (mips 2-3) UnorderedAccess -> ShaderResource (split, begins at pass 2)") != std::string::npos);
+        CHECK(dump.find("  - Subresource Lifetimes: [mip 0: 1-2] [mip 1: 1-3] [mip 2: 1-4] [mip 3: 1-4]") != std::string::npos);
+        rg.PostRender();
+    }
+}
+
+// ============================================================================
+// TEST SUITE: RGAdv_CompileBenchmark
+// ============================================================================
+TEST_SUITE("RGAdv_CompileBenchmark")
+{
+    // ------------------------------------------------------------------
+    // TC-RGA-BN-01: Setup + Compile of a synthetic 200-pass, 1000-resource
+    //               graph; lifetimes span declaring pass to last reader
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-BN-01 CompileBenchmark - 200 passes x 1000 resources")
+    {
+        constexpr uint32_t kPassCount = 200;
+        constexpr uint32_t kResourceCount = 1000;
+        constexpr uint32_t kResourcesPerPass = kResourceCount / kPassCount;
+        constexpr uint32_t kReaderPassCount = 3; // each resource is read by the next 3 passes
+        constexpr uint32_t kWarmupFrames = 2;
+        constexpr uint32_t kTimedFrames = 10;
+
+        auto& rg = g_Renderer.m_RenderGraph;
+
+        std::vector<std::string> passNames(kPassCount);
+        std::vector<std::string> bufferNames(kResourceCount);
+        for (uint32_t i = 0; i < kPassCount; ++i) passNames[i] = "TC-BN-01-Pass" + std::to_string(i);
+        for (uint32_t i = 0; i < kResourceCount; ++i) bufferNames[i] = "TC-BN-01-Buf" + std::to_string(i);
+
+        std::vector<RGBufferHandle> handles(kResourceCount);
+        double setupSeconds = 0.0;
+        double compileSeconds = 0.0;
+
+        for (uint32_t frame = 0; frame < kWarmupFrames + kTimedFrames; ++frame)
+        {
+            SimpleTimer setupTimer;
+            rg.Reset();
+            rg.BeginSetup();
+            for (uint32_t pass = 0; pass < kPassCount; ++pass)
+            {
+                for (uint32_t r = 0; r < kResourcesPerPass; ++r)
+                {
+                    const uint32_t idx = pass * kResourcesPerPass + r;
+                    rg.DeclareBuffer(MakeBufDesc(4096, true, bufferNames[idx].c_str()), handles[idx]);
+                }
+                for (uint32_t back = 1; back <= kReaderPassCount && back <= pass; ++back)
+                {
+                    for (uint32_t r = 0; r < kResourcesPerPass; ++r)
+                    {
+                        rg.ReadBuffer(handles[(pass - back) * kResourcesPerPass + r]);
+                    }
+                }
+                rg.BeginPass(passNames[pass].c_str());
+            }
+            rg.EndSetup();
+            const double setupElapsed = setupTimer.TotalSeconds();
+
+            SimpleTimer compileTimer;
+            rg.Compile();
+            const double compileElapsed = compileTimer.TotalSeconds();
+
+            if (frame >= kWarmupFrames)
+            {
+                setupSeconds += setupElapsed;
+                compileSeconds += compileElapsed;
+            }
+
+            if (frame + 1 == kWarmupFrames + kTimedFrames)
+            {
+                // Passes are 1-based: resource declared in pass p (0-based) lives in [p + 1, p + 1 + readers]
+                for (uint32_t idx : { 0u, 499u, kResourceCount - 1 })
+                {
+                    CAPTURE(idx);
+                    const uint32_t pass = idx / kResourcesPerPass;
+                    const auto& lifetime = rg.GetBuffers()[handles[idx].m_Index].m_Lifetime;
+                    CHECK(lifetime.m_FirstPass == pass + 1);
+                    CHECK(lifetime.m_LastPass == std::min(pass + 1 + kReaderPassCount, kPassCount));
+                }
+            }
+
+            rg.PostRender();
+        }
+
+        SDL_Log("[Bench] RenderGraph %u passes x %u resources: Setup %.3f ms, Compile %.3f ms per frame",
+            kPassCount, kResourceCount, setupSeconds * 1000.0 / kTimedFrames, compileSeconds * 1000.0 / kTimedFrames);
+    }
+}
+
+// ============================================================================
+// TEST SUITE: RGAdv_ParallelSetup
+// ============================================================================
+TEST_SUITE("RGAdv_ParallelSetup")
+{
+    // Scheduled pass with a test-provided Setup()
+    class SetupTestRenderer : public IRenderer
+    {
+    public:
+        SetupTestRenderer(const char* name, std::function<bool(RenderGraph&)> setupFunc)
+            : m_Name(name), m_SetupFunc(std::move(setupFunc))
+        {
+            m_GPUQueries[0] = DEV()->createTimerQuery();
+            m_GPUQueries[1] = DEV()->createTimerQuery();
+        }
+
+        bool Setup(RenderGraph& renderGraph) override { return m_SetupFunc(renderGraph); }
+        void Render(nvrhi::CommandListHandle commandList, const RenderGraph& renderGraph) override {}
+        const char* GetName() const override { return m_Name; }
+
+        const char* m_Name;
+        std::function<bool(RenderGraph&)> m_SetupFunc;
+    };
+
+    // ------------------------------------------------------------------
+    // TC-RGA-PS-01: Setup()s run in parallel merge in scheduling order into
+    //               the same graph as serial setup; a frame that needs new
+    //               slots falls back to serial setup
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-PS-01 ParallelSetup - scheduling-order merge, serial fallback for new slots")
+    {
+        auto& rg = g_Renderer.m_RenderGraph;
+        RunNFrames(2); // past any force-invalidate frames left by an earlier Shutdown()
+        REQUIRE(rg.GetForceInvalidateFramesRemaining() == 0);
+
+        RGTextureHandle hColor, hHistory;
+        RGBufferHandle hCounts;
+        bool bHistoryIsNew = false;
+        SetupTestRenderer producerPass("TC-PS-01-Producer", [&](RenderGraph& g)
+        {
+            g.DeclareTexture(MakeTexDesc(64, 64, nvrhi::Format::RGBA8_UNORM, true, "TC-PS-01-Color"), hColor);
+            return true;
+        });
+        SetupTestRenderer disabledPass("TC-PS-01-Disabled", [&](RenderGraph& g)
+        {
+            return false;
+        });
+        SetupTestRenderer consumerPass("TC-PS-01-Consumer", [&](RenderGraph& g)
+        {
+            g.ReadTexture(hColor);
+            g.DeclareBuffer(MakeBufDesc(256, true, "TC-PS-01-Counts"), hCounts);
+            return true;
+        });
+        SetupTestRenderer outputPass("TC-PS-01-Output", [&](RenderGraph& g)
+        {
+            g.ReadBuffer(hCounts);
+            bHistoryIsNew = g.DeclarePersistentTexture(MakeTexDesc(32, 32, nvrhi::Format::RGBA8_UNORM, false, "TC-PS-01-History"), hHistory);
+            g.MarkSideEffects();
+            return true;
+        });
+        SetupTestRenderer* passes[] = { &producerPass, &disabledPass, &consumerPass, &outputPass };
+
+        auto runFrame = [&](bool bParallelSetup)
+        {
+            rg.Reset();
+            rg.BeginSetup(bParallelSetup);
+            for (SetupTestRenderer* pPass : passes)
+                rg.ScheduleRenderer(pPass);
+            rg.EndSetup();
+            rg.Compile();
+            rg.SubmitRecordingJobs();
+            g_Renderer.m_TaskScheduler->ExecuteAllScheduledTasks();
+            rg.PostRender();
+            g_Renderer.ExecutePendingCommandLists();
+        };
+        auto checkGraph = [&]()
+        {
+            CHECK(rg.GetPassIndex("TC-PS-01-Producer") == 1);
+            CHECK(rg.GetPassIndex("TC-PS-01-Disabled") == 0);
+            CHECK(rg.GetPassIndex("TC-PS-01-Consumer") == 2);
+            CHECK(rg.GetPassIndex("TC-PS-01-Output") == 3);
+            CHECK_FALSE(disabledPass.m_bPassEnabled);
+            CHECK(outputPass.m_bPassEnabled);
+            REQUIRE(hColor.IsValid());
+            REQUIRE(hCounts.IsValid());
+            REQUIRE(hHistory.IsValid());
+            CHECK(rg.GetTextures()[hColor.m_Index].m_Lifetime.m_FirstPass == 1);
+            CHECK(rg.GetTextures()[hColor.m_Index].m_Lifetime.m_LastPass == 2);
+            CHECK(rg.GetBuffers()[hCounts.m_Index].m_Lifetime.m_LastPass == 3);
+            CHECK(rg.GetTextures()[hHistory.m_Index].m_IsPersistent);
+            CHECK(rg.GetStats().m_NumCulledPasses == 0);
+        };
+
+        // The handles name no slot yet: the consumer could read the producer's handle before it is set
+        uint64_t parallelCount = rg.GetParallelSetupCount();
+        uint64_t fallbackCount = rg.GetSerialSetupFallbackCount();
+        runFrame(true);
+        CHECK(rg.GetSerialSetupFallbackCount() == fallbackCount + 1);
+        CHECK(rg.GetParallelSetupCount() == parallelCount);
+        CHECK(bHistoryIsNew);
+        checkGraph();
+        const RGTextureHandle firstColor = hColor;
+
+        // Same slots now: replayed from the builders, and the structure matches the serial frame's
+        runFrame(true);
+        CHECK(rg.GetParallelSetupCount() == parallelCount + 1);
+        CHECK(rg.GetSerialSetupFallbackCount() == fallbackCount + 1);
+        CHECK_FALSE(bHistoryIsNew);
+        CHECK(hColor == firstColor);
+        CHECK(rg.GetStats().m_bCompiledFromCache);
+        checkGraph();
+
+        // And serial setup of the same renderers still hits the cache the parallel frame left
+        runFrame(false);
+        CHECK(rg.GetParallelSetupCount() == parallelCount + 1);
+        CHECK(rg.GetStats().m_bCompiledFromCache);
+        checkGraph();
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGA-PS-02: History declarations replay from the builders like
+    //               any other: the pair keeps its slots and swaps once
+    //               per frame, whichever way Setup() ran
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-PS-02 ParallelSetup - history textures swap once per frame")
+    {
+        auto& rg = g_Renderer.m_RenderGraph;
+        RunNFrames(2);
+        REQUIRE(rg.GetForceInvalidateFramesRemaining() == 0);
+
+        RGTextureHandle hCurrent, hPrevious;
+        bool bIsNew = false;
+        SetupTestRenderer historyPass("TC-PS-02-History", [&](RenderGraph& g)
+        {
+            bIsNew = g.DeclareHistoryTexture(MakeTexDesc(32, 32, nvrhi::Format::RGBA8_UNORM, true, "TC-PS-02-History"), hCurrent, hPrevious);
+            return true;
+        });
+        SetupTestRenderer readerPass("TC-PS-02-Reader", [&](RenderGraph& g)
+        {
+            g.ReadTexture(hPrevious);
+            g.ReadTexture(hCurrent);
+            g.MarkSideEffects();
+            return true;
+        });
+        SetupTestRenderer* passes[] = { &historyPass, &readerPass };
+
+        auto runFrame = [&](bool bParallelSetup)
+        {
+            rg.Reset();
+            rg.BeginSetup(bParallelSetup);
+            for (SetupTestRenderer* pPass : passes)
+                rg.ScheduleRenderer(pPass);
+            rg.EndSetup();
+            rg.Compile();
+            rg.SubmitRecordingJobs();
+            g_Renderer.m_TaskScheduler->ExecuteAllScheduledTasks();
+            rg.PostRender();
+            g_Renderer.ExecutePendingCommandLists();
+        };
+
+        // New slots: falls back to serial setup
+        const uint64_t fallbackCount = rg.GetSerialSetupFallbackCount();
+        runFrame(true);
+        CHECK(rg.GetSerialSetupFallbackCount() == fallbackCount + 1);
+        CHECK(bIsNew);
+        REQUIRE(hCurrent.IsValid());
+        REQUIRE(hPrevious.IsValid());
+        const nvrhi::TextureHandle texA = rg.GetTextureRaw(hCurrent);
+        const nvrhi::TextureHandle texB = rg.GetTextureRaw(hPrevious);
+        REQUIRE(texA != nullptr);
+
+        // Replayed: the prediction and the replay agree, and the textures traded places once
+        const uint64_t parallelCount = rg.GetParallelSetupCount();
+        runFrame(true);
+        CHECK(rg.GetParallelSetupCount() == parallelCount + 1);
+        CHECK_FALSE(bIsNew);
+        CHECK(rg.IsHistoryValid(hPrevious));
+        CHECK(rg.GetTextureRaw(hPrevious) == texA);
+        CHECK(rg.GetTextureRaw(hCurrent) == texB);
+
+        runFrame(false);
+        CHECK_FALSE(bIsNew);
+        CHECK(rg.GetTextureRaw(hPrevious) == texB);
+        CHECK(rg.GetTextureRaw(hCurrent) == texA);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGA-PS-03: A frame where one renderer needs a new slot re-runs
+    //               only that Setup() and the later ones reading what it
+    //               declared; the others run once and replay
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGA-PS-03 ParallelSetup - only Setup()s that need new slots run twice")
+    {
+        auto& rg = g_Renderer.m_RenderGraph;
+        RunNFrames(2);
+        REQUIRE(rg.GetForceInvalidateFramesRemaining() == 0);
+
+        RGTextureHandle hColor, hCache;
+        bool bDeclareCache = false;
+        uint32_t producerSetups = 0, cacheSetups = 0, cacheReaderSetups = 0, colorReaderSetups = 0;
+        SetupTestRenderer producerPass("TC-PS-03-Producer", [&](RenderGraph& g)
+        {
+            ++producerSetups;
+            g.DeclareTexture(MakeTexDesc(64, 64, nvrhi::Format::RGBA8_UNORM, true, "TC-PS-03-Color"), hColor);
+            return true;
+        });
+        SetupTestRenderer cachePass("TC-PS-03-Cache", [&](RenderGraph& g)
+        {
+            ++cacheSetups;
+            if (!bDeclareCache)
+                return false;
+            g.DeclarePersistentTexture(MakeTexDesc(32, 32, nvrhi::Format::RGBA8_UNORM, true, "TC-PS-03-Cache"), hCache);
+            return true;
+        });
+        SetupTestRenderer cacheReaderPass("TC-PS-03-CacheReader", [&](RenderGraph& g)
+        {
+            ++cacheReaderSetups;
+            if (!bDeclareCache)
+                return false;
+            g.ReadTexture(hCache);
+            g.MarkSideEffects();
+            return true;
+        });
+        SetupTestRenderer colorReaderPass("TC-PS-03-ColorReader", [&](RenderGraph& g)
+        {
+            ++colorReaderSetups;
+            g.ReadTexture(hColor);
+            g.MarkSideEffects();
+            return true;
+        });
+        SetupTestRenderer* passes[] = { &producerPass, &cachePass, &cacheReaderPass, &colorReaderPass };
+
+        auto runFrame = [&]()
+        {
+            producerSetups = cacheSetups = cacheReaderSetups = colorReaderSetups = 0;
+            rg.Reset();
+            rg.BeginSetup(true);
+            for (SetupTestRenderer* pPass : passes)
+                rg.ScheduleRenderer(pPass);
+            rg.EndSetup();
+            rg.Compile();
+            rg.SubmitRecordingJobs();
+            g_Renderer.m_TaskScheduler->ExecuteAllScheduledTasks();
+            rg.PostRender();
+            g_Renderer.ExecutePendingCommandLists();
+        };
+
+        // Give the color texture its slot
+        runFrame();
+        runFrame();
+        CHECK(producerSetups == 1);
+        CHECK(colorReaderSetups == 1);
+
+        // The cache shows up: its declarer and its reader run again, the producer and the color reader don't
+        bDeclareCache = true;
+        const uint64_t rerunCount = rg.GetSetupRerunCount();
+        const uint64_t fallbackCount = rg.GetSerialSetupFallbackCount();
+        runFrame();
+        CHECK(rg.GetSetupRerunCount() == rerunCount + 2);
+        CHECK(rg.GetSerialSetupFallbackCount() == fallbackCount + 1);
+        CHECK(producerSetups == 1);
+        CHECK(cacheSetups == 2);
+        CHECK(cacheReaderSetups == 2);
+        CHECK(colorReaderSetups == 1);
+        REQUIRE(hCache.IsValid());
+        CHECK(rg.GetPassIndex("TC-PS-03-Producer") == 1);
+        CHECK(rg.GetPassIndex("TC-PS-03-Cache") == 2);
+        CHECK(rg.GetPassIndex("TC-PS-03-CacheReader") == 3);
+        CHECK(rg.GetPassIndex("TC-PS-03-ColorReader") == 4);
+        CHECK(rg.GetTextures()[hCache.m_Index].m_Lifetime.m_LastPass == 3);
+        CHECK(rg.GetTextures()[hColor.m_Index].m_Lifetime.m_LastPass == 4);
+
+        // Slots settled: everything replays again
+        const uint64_t parallelCount = rg.GetParallelSetupCount();
+        runFrame();
+        CHECK(rg.GetParallelSetupCount() == parallelCount + 1);
+        CHECK(cacheSetups == 1);
+        CHECK(cacheReaderSetups == 1);
+    }
+}
@@ -17,12 +17,18 @@
 //   RGAlloc_MultiFrameReuse   — physical resources survive across frames
 //   RGAlloc_DescHashVariants  — different descs produce different allocations
 //   RGAlloc_ShutdownReset     — Shutdown + re-init leaves allocator in clean state
+//   RGAlloc_Compaction        — fragmented or over-budget heaps are re-packed
+//   RGAlloc_BufferPool        — small buffers share pool buffers at disjoint ranges
+//   RGAlloc_Simulator         — GPU-free heap allocator, frame dumps and replay
+//   RGAlloc_HeapStress        — fragmentation patterns against the heap block allocator
 //
 // Run with: HobbyRenderer --run-tests=*RGAlloc*
 // ============================================================================
 
 #include "TestFixtures.h"
 
+#include <random>
+
 // ============================================================================
 // TEST SUITE: RGAlloc_RHIAlive
 // Verify that the RHI device and heap infrastructure are alive after the
@@ -1400,6 +1406,52 @@ TEST_SUITE("RGAlloc_MultiFrameReuse")
         REQUIRE(h.IsValid());
         CHECK(rg.GetTextures()[h.m_Index].m_PhysicalTexture == nullptr);
     }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-MF-08: Fresh declarations reuse idle slots with a matching desc,
+    //                lowest slot first, and never a slot of another desc
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGAL-MF-08 MultiFrameReuse - pool reuse picks matching idle slots lowest first")
+    {
+        auto& rg = g_Renderer.m_RenderGraph;
+        const RGTextureDesc descA = MakeTexDesc(24, 24, nvrhi::Format::RGBA8_UNORM, true, "TC-MF-08-A");
+        const RGTextureDesc descB = MakeTexDesc(40, 40, nvrhi::Format::RGBA8_UNORM, true, "TC-MF-08-B");
+
+        // Seed frame: A, B, A in slots of increasing index
+        rg.Reset();
+        rg.BeginSetup();
+        RGTextureHandle hA0, hB, hA1;
+        rg.DeclareTexture(descA, hA0);
+        rg.DeclareTexture(descB, hB);
+        rg.DeclareTexture(descA, hA1);
+        rg.BeginPass("TC-MF-08-SeedPass");
+        rg.EndSetup();
+        rg.Compile();
+        REQUIRE(hA0.m_Index < hA1.m_Index);
+        rg.PostRender();
+
+        // Let the seed slots go idle (used > 1 frame ago, not yet evicted)
+        g_Renderer.m_FrameNumber += 2;
+        rg.Reset();
+
+        rg.BeginSetup();
+        RGTextureHandle hReuse0, hReuse1, hReuse2;
+        rg.DeclareTexture(descA, hReuse0);
+        rg.DeclareTexture(descA, hReuse1);
+        rg.DeclareTexture(descA, hReuse2);
+        rg.BeginPass("TC-MF-08-ReusePass");
+        rg.EndSetup();
+        rg.Compile();
+
+        CHECK(hReuse0.m_Index == hA0.m_Index);
+        CHECK(hReuse1.m_Index == hA1.m_Index);
+        // Both A slots are taken: the third declaration must not steal B's slot
+        CHECK(hReuse2.m_Index != hB.m_Index);
+        CHECK(hReuse2.m_Index != hA0.m_Index);
+        CHECK(hReuse2.m_Index != hA1.m_Index);
+
+        rg.PostRender();
+    }
 }
 
 // ============================================================================
@@ -3064,3 +3116,724 @@ TEST_SUITE("RGAlloc_ResetContract")
         rg.PostRender(); // clears m_IsCompiled so the fixture destructor is safe
     }
 }
+
+// ============================================================================
+// TEST SUITE: RGAlloc_Compaction
+// Fragmented or over-budget heaps get their transient resources re-packed.
+// ============================================================================
+TEST_SUITE("RGAlloc_Compaction")
+{
+    // X and Z: 24 MB each, different descs so pool reuse can't swap their slots. Y: 4 MB.
+    static RGTextureDesc DescX() { return MakeTexDesc(3072, 2048, nvrhi::Format::RGBA8_UNORM, true, "TC-CP-X"); }
+    static RGTextureDesc DescZ() { return MakeTexDesc(2048, 3072, nvrhi::Format::RGBA8_UNORM, true, "TC-CP-Z"); }
+    static RGTextureDesc DescY() { return MakeTexDesc(1024, 1024, nvrhi::Format::RGBA8_UNORM, true, "TC-CP-Y"); }
+
+    // Starts from an empty graph and leaves two 32 MB heaps like this (aliasing off):
+    //   heap A: [free 24 MB][Y 4 MB][free 4 MB]    heap B: [Z 24 MB][free 8 MB]
+    // X took the start of heap A in the first frame and was evicted after going unused.
+    // Returns with Reset() done for the next frame, in which Y and Z are declared again.
+    static void BuildFragmentedHeaps(RenderGraph& rg, RGTextureHandle& hY, RGTextureHandle& hZ)
+    {
+        DEV()->waitForIdle();
+        rg.Shutdown();
+
+        RGTextureHandle hX;
+        rg.Reset();
+        rg.BeginSetup();
+        rg.DeclareTexture(DescX(), hX);
+        rg.DeclareTexture(DescZ(), hZ);
+        rg.DeclareTexture(DescY(), hY);
+        rg.BeginPass("TC-CP-Pass");
+        rg.EndSetup();
+        rg.Compile();
+        REQUIRE(rg.GetTextures()[hX.m_Index].m_HeapIndex == rg.GetTextures()[hY.m_Index].m_HeapIndex);
+        REQUIRE(rg.GetTextures()[hX.m_Index].m_HeapIndex != rg.GetTextures()[hZ.m_Index].m_HeapIndex);
+        rg.PostRender();
+
+        // Y and Z stay in use, X doesn't; 12 MB free is below what compaction bothers with
+        g_Renderer.m_FrameNumber += 2;
+        rg.Reset();
+        rg.BeginSetup();
+        rg.DeclareTexture(DescZ(), hZ);
+        rg.DeclareTexture(DescY(), hY);
+        rg.BeginPass("TC-CP-Pass");
+        rg.EndSetup();
+        rg.Compile();
+        CHECK_FALSE(rg.GetStats().m_bHeapsCompacted);
+        CHECK(rg.GetStats().m_NumHeaps == 2);
+        rg.PostRender();
+
+        // X goes unused for more than 3 frames and is evicted here
+        g_Renderer.m_FrameNumber += 2;
+        rg.Reset();
+        REQUIRE(rg.GetTextures()[hX.m_Index].m_PhysicalTexture == nullptr);
+    }
+
+    static void DeclareSurvivors(RenderGraph& rg, RGTextureHandle& hY, RGTextureHandle& hZ)
+    {
+        rg.BeginSetup();
+        rg.DeclareTexture(DescZ(), hZ);
+        rg.DeclareTexture(DescY(), hY);
+        rg.BeginPass("TC-CP-Pass");
+        rg.EndSetup();
+        rg.Compile();
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-CP-01: Free memory scattered over two heaps past the
+    //                fragmentation threshold is re-packed into one heap,
+    //                and the next identical frame leaves it alone
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGAL-CP-01 Compaction - fragmentation triggers re-packing")
+    {
+        ConfigGuard guard;
+        const_cast<Config&>(Config::Get()).m_EnableRenderGraphAliasing = false;
+        const_cast<Config&>(Config::Get()).m_RenderGraphHeapBudgetMB = 0;
+        const_cast<Config&>(Config::Get()).m_RenderGraphHeapFragmentationThreshold = 25; // the layout is 1/3 fragmented
+
+        auto& rg = g_Renderer.m_RenderGraph;
+        RGTextureHandle hY, hZ;
+        BuildFragmentedHeaps(rg, hY, hZ);
+
+        const uint64_t compactionsBefore = rg.GetHeapCompactionCount();
+        DeclareSurvivors(rg, hY, hZ);
+
+        const RenderGraph::Stats& stats = rg.GetStats();
+        CHECK(stats.m_bHeapsCompacted);
+        CHECK(rg.GetHeapCompactionCount() == compactionsBefore + 1);
+        CHECK_FALSE(stats.m_bCompiledFromCache);
+        CHECK(stats.m_NumHeaps == 1);
+        CHECK(stats.m_TotalHeapMemory == 32ull * 1024 * 1024);
+        CHECK(stats.m_HeapFragmentationPercent == 0.0f);
+        CHECK(rg.GetTextures()[hY.m_Index].m_HeapIndex == rg.GetTextures()[hZ.m_Index].m_HeapIndex);
+        CHECK(rg.GetTextureRaw(hY) != nullptr);
+        CHECK(rg.GetTextureRaw(hZ) != nullptr);
+        CHECK(rg.ExportToString().find("- Heaps: 1, 32 MB") != std::string::npos);
+        rg.PostRender();
+
+        // Same frame again: nothing to compact, the compile cache takes it
+        ++g_Renderer.m_FrameNumber;
+        rg.Reset();
+        DeclareSurvivors(rg, hY, hZ);
+        CHECK_FALSE(rg.GetStats().m_bHeapsCompacted);
+        CHECK(rg.GetStats().m_bCompiledFromCache);
+        CHECK(rg.GetHeapCompactionCount() == compactionsBefore + 1);
+        rg.PostRender();
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-CP-02: Heaps over the configured budget are re-packed even
+    //                below the fragmentation threshold
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGAL-CP-02 Compaction - heap budget triggers re-packing")
+    {
+        ConfigGuard guard;
+        const_cast<Config&>(Config::Get()).m_EnableRenderGraphAliasing = false;
+        const_cast<Config&>(Config::Get()).m_RenderGraphHeapFragmentationThreshold = 100;
+
+        auto& rg = g_Renderer.m_RenderGraph;
+        RGTextureHandle hY, hZ;
+        BuildFragmentedHeaps(rg, hY, hZ);
+
+        // 64 MB of heaps against a 48 MB budget
+        const_cast<Config&>(Config::Get()).m_RenderGraphHeapBudgetMB = 48;
+        DeclareSurvivors(rg, hY, hZ);
+
+        CHECK(rg.GetStats().m_bHeapsCompacted);
+        CHECK(rg.GetStats().m_NumHeaps == 1);
+        CHECK(rg.GetStats().m_TotalHeapMemory <= 48ull * 1024 * 1024);
+        CHECK(rg.GetTextureRaw(hY) != nullptr);
+        CHECK(rg.GetTextureRaw(hZ) != nullptr);
+        rg.PostRender();
+    }
+}
+
+// ============================================================================
+// TEST SUITE: RGAlloc_BufferPool
+// Small transient buffers that opt in share pool buffers instead of heap blocks.
+// ============================================================================
+TEST_SUITE("RGAlloc_BufferPool")
+{
+    // ------------------------------------------------------------------
+    // TC-RGAL-BP-01: SPD counters pack into one pool buffer at disjoint,
+    //                aligned ranges; other views get their own pool;
+    //                large buffers stay placed; packing survives a cached compile
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGAL-BP-01 BufferPool - small buffers share pool buffers")
+    {
+        ConfigGuard guard;
+        const_cast<Config&>(Config::Get()).m_EnableAsyncCompute = false;
+
+        auto& rg = g_Renderer.m_RenderGraph;
+
+        RGBufferDesc rawDesc = MakeBufDesc(100, true, "TC-BP-01-Raw");
+        rawDesc.m_bSuballocate = true;
+        RGBufferDesc largeDesc = MakeBufDesc(128 * 1024, true, "TC-BP-01-Large");
+        largeDesc.m_bSuballocate = true;
+
+        RGBufferHandle hCounters[3], hRaw, hLarge;
+        auto runFrame = [&]()
+        {
+            rg.Reset();
+            rg.BeginSetup();
+            for (uint32_t i = 0; i < 3; ++i)
+                rg.DeclareBuffer(RenderGraph::GetSPDAtomicCounterDesc("TC-BP-01-Counter"), hCounters[i]);
+            rg.DeclareBuffer(rawDesc, hRaw);
+            rg.DeclareBuffer(largeDesc, hLarge);
+            rg.BeginPass("TC-BP-01-Pass");
+            rg.EndSetup();
+            rg.Compile();
+        };
+
+        runFrame();
+
+        nvrhi::BufferRange counterRanges[3];
+        nvrhi::BufferHandle pool = rg.GetBuffer(hCounters[0], RGResourceAccessMode::Write, counterRanges[0]);
+        REQUIRE(pool != nullptr);
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            CAPTURE(i);
+            CHECK(rg.GetBuffers()[hCounters[i].m_Index].m_bSuballocated);
+            CHECK(rg.GetBuffer(hCounters[i], RGResourceAccessMode::Write, counterRanges[i]) == pool);
+            CHECK(counterRanges[i].byteSize == sizeof(uint32_t));
+            CHECK(counterRanges[i].byteOffset % 256 == 0);
+            CHECK(counterRanges[i].byteOffset + counterRanges[i].byteSize <= pool->getDesc().byteSize);
+        }
+        CHECK(counterRanges[0].byteOffset != counterRanges[1].byteOffset);
+        CHECK(counterRanges[1].byteOffset != counterRanges[2].byteOffset);
+        CHECK(counterRanges[0].byteOffset != counterRanges[2].byteOffset);
+        CHECK(pool->getDesc().keepInitialState);
+
+        // Different views can't share the counters' pool
+        nvrhi::BufferRange rawRange;
+        nvrhi::BufferHandle rawPool = rg.GetBuffer(hRaw, RGResourceAccessMode::Write, rawRange);
+        CHECK(rg.GetBuffers()[hRaw.m_Index].m_bSuballocated);
+        CHECK(rawPool != pool);
+        CHECK(rawRange.byteSize == 100);
+
+        // Too large to gain anything from a pool: placed in a heap as usual, whole-buffer range
+        const auto& large = rg.GetBuffers()[hLarge.m_Index];
+        CHECK_FALSE(large.m_bSuballocated);
+        CHECK(large.m_HeapIndex != UINT32_MAX);
+        nvrhi::BufferRange largeRange;
+        CHECK(rg.GetBuffer(hLarge, RGResourceAccessMode::Write, largeRange) == rg.GetBufferRaw(hLarge));
+        CHECK(largeRange.byteOffset == 0);
+        CHECK(largeRange.byteSize == 128 * 1024);
+
+        CHECK(rg.GetStats().m_NumSuballocatedBuffers == 4);
+        CHECK(rg.GetStats().m_NumBufferPools == 2);
+        CHECK(rg.ExportToString().find("- Buffer Pools: 4 buffers in 2 pools") != std::string::npos);
+        rg.PostRender();
+
+        // Same frame again: the compile cache hits and the pools are reused as they are
+        ++g_Renderer.m_FrameNumber;
+        runFrame();
+        CHECK(rg.GetStats().m_bCompiledFromCache);
+        CHECK(rg.GetStats().m_NumSuballocatedBuffers == 4);
+        nvrhi::BufferRange range;
+        CHECK(rg.GetBuffer(hCounters[0], RGResourceAccessMode::Write, range) == pool);
+        rg.PostRender();
+    }
+}
+
+// ============================================================================
+// TEST SUITE: RGAlloc_Simulator
+// The device-independent allocator half that RenderGraphSim replays captures
+// through: heap block lists, frame dumps, and the allocation simulator.
+// ============================================================================
+TEST_SUITE("RGAlloc_Simulator")
+{
+    using namespace RenderGraphInternal;
+
+    class CountingHeapDevice : public IHeapDevice
+    {
+    public:
+        void CreateHeap(uint32_t, uint64_t) override { ++m_NumCreated; }
+        void ReleaseHeap(uint32_t) override { ++m_NumReleased; }
+
+        uint32_t m_NumCreated = 0;
+        uint32_t m_NumReleased = 0;
+    };
+
+    static RecordedResource MakeRecordedTexture(uint32_t slot, uint64_t size, uint16_t firstPass, uint16_t lastPass, const char* name)
+    {
+        RecordedResource resource;
+        resource.m_Slot = slot;
+        resource.m_Name = name;
+        resource.m_DescHash = 0x1000 + slot;
+        resource.m_MemReq = { size, 64 * 1024 };
+        resource.m_Lifetime = { firstPass, lastPass };
+        return resource;
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-SIM-01: HeapAllocator splits blocks, coalesces on
+    //                 free, and releases empty heaps through the device
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGAL-SIM-01 Simulator - heap allocator splits, coalesces and releases")
+    {
+        CountingHeapDevice device;
+        HeapAllocator heaps{ device };
+
+        uint64_t reserve = 0;
+        uint32_t heapIdx[3];
+        uint64_t offset[3];
+        for (uint32_t i = 0; i < 3; ++i)
+            heaps.Allocate(1024, 1024, 1, reserve, heapIdx[i], offset[i]);
+
+        CHECK(device.m_NumCreated == 1);
+        CHECK(heapIdx[0] == 0);
+        CHECK(heapIdx[1] == 0);
+        CHECK(heapIdx[2] == 0);
+        CHECK(offset[0] == 0);
+        CHECK(offset[1] == 1024);
+        CHECK(offset[2] == 2048);
+        CHECK(heaps.GetHeaps()[0].m_Size == 1024 * 1024);
+
+        // Freeing the middle block leaves a hole; freeing its neighbours merges everything back into one block
+        heaps.Free(0, offset[1]);
+        CHECK(heaps.GetUsage().m_FreeSize == 1024 * 1024 - 2048);
+        CHECK(heaps.GetUsage().GetFragmentationPercent() > 0.0f);
+        heaps.Free(0, offset[0]);
+        heaps.Free(0, offset[2]);
+        REQUIRE(heaps.GetBlocks(0).size() == 1);
+        CHECK(heaps.GetBlocks(0)[0].m_IsFree);
+        CHECK(heaps.GetUsage().GetFragmentationPercent() == 0.0f);
+
+        // A reserve sizes the next heap and is consumed by it
+        reserve = 8 * 1024 * 1024;
+        uint32_t bigHeap;
+        uint64_t bigOffset;
+        heaps.Allocate(2 * 1024 * 1024, 64 * 1024, 1, reserve, bigHeap, bigOffset);
+        CHECK(bigHeap == 1);
+        CHECK(heaps.GetHeaps()[1].m_Size == 8 * 1024 * 1024);
+        CHECK(reserve == 0);
+
+        heaps.ReleaseEmptyHeaps();
+        CHECK(device.m_NumReleased == 1);
+        CHECK_FALSE(heaps.GetHeaps()[0].IsLive());
+        CHECK(heaps.GetHeaps()[1].IsLive());
+        CHECK(heaps.GetUsage().m_NumHeaps == 1);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-SIM-02: Frame dumps round-trip; malformed input is rejected
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGAL-SIM-02 Simulator - frame dump round trip")
+    {
+        RecordedFrame frames[2];
+        frames[0].m_FrameNumber = 7;
+        frames[0].m_Resources.push_back(MakeRecordedTexture(0, 4 * 1024 * 1024, 1, 2, "TC-SIM-02 \"Quoted\" \\ Name"));
+        RecordedResource buffer = MakeRecordedTexture(3, 256 * 1024, 2, 5, "TC-SIM-02-Buffer");
+        buffer.m_bIsBuffer = true;
+        buffer.m_bPersistent = true;
+        buffer.m_bAsyncCompute = true;
+        buffer.m_DescHash = UINT64_MAX;
+        frames[0].m_Resources.push_back(buffer);
+        frames[1].m_FrameNumber = 8;
+        frames[1].m_bAliasingEnabled = false;
+
+        std::stringstream stream;
+        WriteFrameDump(stream, frames);
+
+        std::vector<RecordedFrame> readBack;
+        std::string error;
+        REQUIRE(ReadFrameDump(stream, readBack, error));
+        REQUIRE(readBack.size() == 2);
+        CHECK(readBack[0].m_FrameNumber == 7);
+        CHECK(readBack[0].m_bAliasingEnabled);
+        CHECK_FALSE(readBack[1].m_bAliasingEnabled);
+        CHECK(readBack[1].m_Resources.empty());
+        REQUIRE(readBack[0].m_Resources.size() == 2);
+
+        const RecordedResource& tex = readBack[0].m_Resources[0];
+        CHECK(tex.m_Name == frames[0].m_Resources[0].m_Name);
+        CHECK_FALSE(tex.m_bIsBuffer);
+        CHECK(tex.m_MemReq.m_Size == 4 * 1024 * 1024);
+        CHECK(tex.m_Lifetime.m_FirstPass == 1);
+        CHECK(tex.m_Lifetime.m_LastPass == 2);
+
+        const RecordedResource& buf = readBack[0].m_Resources[1];
+        CHECK(buf.m_Slot == 3);
+        CHECK(buf.m_bIsBuffer);
+        CHECK(buf.m_bPersistent);
+        CHECK(buf.m_bAsyncCompute);
+        CHECK(buf.m_DescHash == UINT64_MAX);
+
+        std::stringstream bad("{ \"frames\": [ { \"frame\": 1, \"resources\": [ { \"slot\": 0 } ] } ] }");
+        CHECK_FALSE(ReadFrameDump(bad, readBack, error));
+        CHECK_FALSE(error.empty());
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-SIM-03: The simulator aliases a resource into a dead owner,
+    //                 keeps owners across frames, and honours no-aliasing
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGAL-SIM-03 Simulator - replay aliases dead owners and keeps placements")
+    {
+        RecordedFrame frame;
+        frame.m_FrameNumber = 1;
+        frame.m_Resources.push_back(MakeRecordedTexture(0, 4 * 1024 * 1024, 1, 1, "TC-SIM-03-A"));
+        frame.m_Resources.push_back(MakeRecordedTexture(1, 4 * 1024 * 1024, 2, 2, "TC-SIM-03-B"));
+
+        AllocationSimulator simulator;
+        AllocationSimulator::FrameResult result = simulator.SimulateFrame(frame);
+        CHECK(result.m_Textures.m_NumAllocated == 1);
+        CHECK(result.m_Textures.m_NumAliased == 1);
+        CHECK(result.m_PeakLiveMemory == 4 * 1024 * 1024);
+        const uint64_t heapMemory = result.m_Heaps.m_TotalSize;
+
+        // Same declarations next frame: nothing new is placed
+        frame.m_FrameNumber = 2;
+        result = simulator.SimulateFrame(frame);
+        CHECK(result.m_Textures.m_NumAliased == 1);
+        CHECK(result.m_Heaps.m_TotalSize == heapMemory);
+
+        RecordedFrame noAliasing = frame;
+        noAliasing.m_bAliasingEnabled = false;
+        noAliasing.m_FrameNumber = 1;
+        AllocationSimulator plainSimulator;
+        result = plainSimulator.SimulateFrame(noAliasing);
+        CHECK(result.m_Textures.m_NumAllocated == 2);
+        CHECK(result.m_Textures.m_NumAliased == 0);
+        CHECK(result.m_Textures.m_AllocatedMemory == 8 * 1024 * 1024);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-SIM-04: A live capture holds every heap-placed resource of
+    //                 each frame and replays to the same placement counts
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-RGAL-SIM-04 Simulator - live capture replays")
+    {
+        auto& rg = g_Renderer.m_RenderGraph;
+        const std::filesystem::path path = std::filesystem::temp_directory_path() / "TC-RGAL-SIM-04.json";
+
+        rg.BeginAllocationCapture(path, 2);
+        CHECK(rg.IsCapturingAllocations());
+        REQUIRE(RunNFrames(2));
+        CHECK_FALSE(rg.IsCapturingAllocations());
+
+        std::vector<RecordedFrame> frames;
+        std::string error;
+        {
+            std::ifstream file(path);
+            REQUIRE(file);
+            REQUIRE(ReadFrameDump(file, frames, error));
+        }
+        std::filesystem::remove(path);
+        REQUIRE(frames.size() == 2);
+
+        const RecordedFrame& last = frames.back();
+        const uint32_t numTextures = (uint32_t)std::count_if(last.m_Resources.begin(), last.m_Resources.end(), [](const RecordedResource& r) { return !r.m_bIsBuffer; });
+        const RenderGraph::Stats& stats = rg.GetStats();
+        CHECK(numTextures > 0);
+        CHECK(numTextures == stats.m_NumAllocatedTextures + stats.m_NumAliasedTextures);
+
+        AllocationSimulator simulator;
+        AllocationSimulator::FrameResult result;
+        for (const RecordedFrame& frame : frames)
+            result = simulator.SimulateFrame(frame);
+        CHECK(result.m_Textures.m_NumAllocated + result.m_Textures.m_NumAliased == numTextures);
+        CHECK(result.m_Heaps.m_TotalSize > 0);
+    }
+}
+
+// ============================================================================
+// TEST SUITE: RGAlloc_HeapStress
+// Fragmentation patterns run straight against HeapAllocator (no GPU), with the
+// block lists checked for consistency after every step that changes them.
+// ============================================================================
+TEST_SUITE("RGAlloc_HeapStress")
+{
+    using namespace RenderGraphInternal;
+
+    class NullHeapDevice : public IHeapDevice
+    {
+    public:
+        void CreateHeap(uint32_t, uint64_t) override { ++m_NumLive; }
+        void ReleaseHeap(uint32_t) override { --m_NumLive; }
+
+        int m_NumLive = 0;
+    };
+
+    struct LiveAllocation
+    {
+        uint32_t m_HeapIndex = UINT32_MAX;
+        uint64_t m_Offset = 0;
+        uint64_t m_Size = 0;
+    };
+
+    // Every live heap is covered by its blocks in order, with no two free blocks side by side, the used blocks are
+    // exactly 'live', and the usage totals agree with the blocks
+    static void CheckHeapInvariants(const HeapAllocator& heaps, const std::vector<LiveAllocation>& live)
+    {
+        uint64_t freeSize = 0;
+        uint64_t largestFree = 0;
+        size_t numUsed = 0;
+        for (uint32_t heapIdx = 0; heapIdx < (uint32_t)heaps.GetHeaps().size(); ++heapIdx)
+        {
+            const HeapEntry& heap = heaps.GetHeaps()[heapIdx];
+            const std::vector<HeapBlock> blocks = heaps.GetBlocks(heapIdx);
+            if (!heap.IsLive())
+            {
+                CHECK(blocks.empty());
+                continue;
+            }
+
+            uint64_t expectedOffset = 0;
+            bool bPrevFree = false;
+            for (const HeapBlock& block : blocks)
+            {
+                CAPTURE(heapIdx);
+                CAPTURE(block.m_Offset);
+                CHECK(block.m_Offset == expectedOffset);
+                CHECK(block.m_Size > 0);
+                CHECK_FALSE((bPrevFree && block.m_IsFree));
+                expectedOffset = block.m_Offset + block.m_Size;
+                bPrevFree = block.m_IsFree;
+
+                if (block.m_IsFree)
+                {
+                    freeSize += block.m_Size;
+                    largestFree = std::max(largestFree, block.m_Size);
+                    continue;
+                }
+
+                ++numUsed;
+                const bool bIsLive = std::any_of(live.begin(), live.end(), [&](const LiveAllocation& a)
+                {
+                    return a.m_HeapIndex == heapIdx && a.m_Offset == block.m_Offset && a.m_Size == block.m_Size;
+                });
+                CHECK(bIsLive);
+            }
+            CHECK(expectedOffset == heap.m_Size);
+        }
+        CHECK(numUsed == live.size());
+
+        const HeapAllocator::Usage usage = heaps.GetUsage();
+        CHECK(usage.m_FreeSize == freeSize);
+        CHECK(usage.m_LargestFreeBlock == largestFree);
+    }
+
+    static LiveAllocation Allocate(HeapAllocator& heaps, uint64_t size, uint64_t alignment)
+    {
+        LiveAllocation allocation;
+        allocation.m_Size = size;
+        uint64_t reserve = 0;
+        heaps.Allocate(size, alignment, 1, reserve, allocation.m_HeapIndex, allocation.m_Offset);
+        CHECK(allocation.m_Offset % alignment == 0);
+        return allocation;
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-HS-01: Checkerboard — every other block freed: same-size
+    //                requests refill the holes, a larger one can't use
+    //                them, and freeing the rest merges back to one block
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGAL-HS-01 HeapStress - checkerboard holes")
+    {
+        NullHeapDevice device;
+        HeapAllocator heaps{ device };
+        const uint64_t kBlock = 64 * 1024;
+
+        std::vector<LiveAllocation> live;
+        for (uint32_t i = 0; i < 16; ++i)
+            live.push_back(Allocate(heaps, kBlock, kBlock));
+        REQUIRE(device.m_NumLive == 1);
+        CHECK(heaps.GetUsage().m_FreeSize == 0);
+
+        std::vector<LiveAllocation> kept;
+        for (uint32_t i = 0; i < 16; ++i)
+        {
+            if (i % 2 == 0)
+                heaps.Free(live[i].m_HeapIndex, live[i].m_Offset);
+            else
+                kept.push_back(live[i]);
+        }
+        live = kept;
+        CheckHeapInvariants(heaps, live);
+        CHECK(heaps.GetUsage().m_LargestFreeBlock == kBlock);
+        CHECK(heaps.GetUsage().GetFragmentationPercent() > 80.0f);
+
+        // Twice the hole size: no hole holds it, so it opens a second heap
+        const LiveAllocation wide = Allocate(heaps, 2 * kBlock, kBlock);
+        CHECK(wide.m_HeapIndex == 1);
+        live.push_back(wide);
+
+        // Hole-sized requests land in the first heap's holes instead of the second heap's free space
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            const LiveAllocation refill = Allocate(heaps, kBlock, kBlock);
+            CHECK(refill.m_HeapIndex == 0);
+            live.push_back(refill);
+        }
+        CheckHeapInvariants(heaps, live);
+        CHECK(device.m_NumLive == 2);
+
+        for (const LiveAllocation& allocation : live)
+            heaps.Free(allocation.m_HeapIndex, allocation.m_Offset);
+        live.clear();
+        CheckHeapInvariants(heaps, live);
+        CHECK(heaps.GetBlocks(0).size() == 1);
+        CHECK(heaps.GetBlocks(1).size() == 1);
+        CHECK(heaps.GetUsage().GetFragmentationPercent() < 50.1f);
+
+        heaps.ReleaseEmptyHeaps();
+        CHECK(device.m_NumLive == 0);
+        CHECK(heaps.GetUsage().m_NumHeaps == 0);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-HS-02: Mixed alignments — small-aligned blocks knock the
+    //                free space off 64 KB boundaries; 64 KB-aligned
+    //                requests still come out aligned and the padding they
+    //                skip stays free and is reused
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGAL-HS-02 HeapStress - mixed alignments")
+    {
+        NullHeapDevice device;
+        HeapAllocator heaps{ device };
+
+        std::vector<LiveAllocation> live;
+        for (uint32_t i = 0; i < 24; ++i)
+        {
+            live.push_back(Allocate(heaps, 256 * (i % 5 + 1), 256));
+            live.push_back(Allocate(heaps, 64 * 1024 * (i % 3 + 1), 64 * 1024));
+            CheckHeapInvariants(heaps, live);
+        }
+
+        // Padding before the aligned blocks is free memory small requests can still use
+        const uint64_t freeBefore = heaps.GetUsage().m_FreeSize;
+        const uint32_t heapsBefore = heaps.GetUsage().m_NumHeaps;
+        for (uint32_t i = 0; i < 8; ++i)
+            live.push_back(Allocate(heaps, 1024, 256));
+        CHECK(heaps.GetUsage().m_NumHeaps == heapsBefore);
+        CHECK(heaps.GetUsage().m_FreeSize == freeBefore - 8 * 1024);
+        CheckHeapInvariants(heaps, live);
+
+        // Free the large ones: what is left can't overlap or drift off alignment
+        std::vector<LiveAllocation> small;
+        for (const LiveAllocation& allocation : live)
+        {
+            if (allocation.m_Size >= 64 * 1024)
+                heaps.Free(allocation.m_HeapIndex, allocation.m_Offset);
+            else
+                small.push_back(allocation);
+        }
+        live = small;
+        CheckHeapInvariants(heaps, live);
+        for (uint32_t i = 0; i < 4; ++i)
+            live.push_back(Allocate(heaps, 192 * 1024, 64 * 1024));
+        CheckHeapInvariants(heaps, live);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-HS-03: Random churn — thousands of allocations and frees of
+    //                mixed sizes and alignments keep the block lists
+    //                consistent, never hand out overlapping ranges, and
+    //                leave nothing behind once everything is freed
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGAL-HS-03 HeapStress - random churn")
+    {
+        NullHeapDevice device;
+        HeapAllocator heaps{ device };
+        std::mt19937 rng(1234);
+
+        const uint64_t kSizes[] = { 256, 4 * 1024, 64 * 1024, 192 * 1024, 1024 * 1024, 3 * 1024 * 1024 + 64 * 1024 };
+        const uint64_t kAlignments[] = { 256, 4 * 1024, 64 * 1024 };
+
+        std::vector<LiveAllocation> live;
+        for (uint32_t step = 0; step < 4000; ++step)
+        {
+            // Grow for the first half, shrink for the second, random in between
+            const uint32_t allocChance = step < 2000 ? 60 : 40;
+            if (live.empty() || rng() % 100 < allocChance)
+            {
+                const uint64_t size = kSizes[rng() % std::size(kSizes)] + (rng() % 4) * 256;
+                const uint64_t alignment = kAlignments[rng() % std::size(kAlignments)];
+                const LiveAllocation allocation = Allocate(heaps, size, alignment);
+                for (const LiveAllocation& other : live)
+                {
+                    if (other.m_HeapIndex != allocation.m_HeapIndex)
+                        continue;
+                    const bool bDisjoint = allocation.m_Offset + allocation.m_Size <= other.m_Offset || other.m_Offset + other.m_Size <= allocation.m_Offset;
+                    CHECK(bDisjoint);
+                }
+                live.push_back(allocation);
+            }
+            else
+            {
+                const size_t victim = rng() % live.size();
+                heaps.Free(live[victim].m_HeapIndex, live[victim].m_Offset);
+                live[victim] = live.back();
+                live.pop_back();
+            }
+
+            if (step % 97 == 0)
+                CheckHeapInvariants(heaps, live);
+        }
+        CheckHeapInvariants(heaps, live);
+
+        // Free sizes never exceed what was created
+        const HeapAllocator::Usage usage = heaps.GetUsage();
+        uint64_t liveBytes = 0;
+        for (const LiveAllocation& allocation : live)
+            liveBytes += allocation.m_Size;
+        CHECK(usage.m_TotalSize - usage.m_FreeSize == liveBytes);
+
+        for (const LiveAllocation& allocation : live)
+            heaps.Free(allocation.m_HeapIndex, allocation.m_Offset);
+        live.clear();
+        CheckHeapInvariants(heaps, live);
+        for (uint32_t heapIdx = 0; heapIdx < (uint32_t)heaps.GetHeaps().size(); ++heapIdx)
+        {
+            if (heaps.GetHeaps()[heapIdx].IsLive())
+                CHECK(heaps.GetBlocks(heapIdx).size() == 1);
+        }
+
+        heaps.ReleaseEmptyHeaps();
+        CHECK(device.m_NumLive == 0);
+    }
+
+    // ------------------------------------------------------------------
+    // TC-RGAL-HS-04: Sawtooth — a frame-like pattern of growing sizes freed
+    //                in reverse and then interleaved order reuses the
+    //                same heaps every cycle instead of creating new ones
+    // ------------------------------------------------------------------
+    TEST_CASE("TC-RGAL-HS-04 HeapStress - sawtooth reuse")
+    {
+        NullHeapDevice device;
+        HeapAllocator heaps{ device };
+
+        uint64_t firstCycleMemory = 0;
+        for (uint32_t cycle = 0; cycle < 20; ++cycle)
+        {
+            CAPTURE(cycle);
+            std::vector<LiveAllocation> live;
+            for (uint32_t i = 0; i < 12; ++i)
+                live.push_back(Allocate(heaps, 64 * 1024 * (i + 1), 64 * 1024));
+            CheckHeapInvariants(heaps, live);
+
+            if (cycle == 0)
+                firstCycleMemory = heaps.GetUsage().m_TotalSize;
+            CHECK(heaps.GetUsage().m_TotalSize == firstCycleMemory);
+
+            // Odd cycles free front to back in two interleaved passes, even cycles back to front
+            if (cycle % 2 == 0)
+            {
+                for (auto it = live.rbegin(); it != live.rend(); ++it)
+                    heaps.Free(it->m_HeapIndex, it->m_Offset);
+            }
+            else
+            {
+                for (uint32_t i = 0; i < 12; i += 2)
+                    heaps.Free(live[i].m_HeapIndex, live[i].m_Offset);
+                for (uint32_t i = 1; i < 12; i += 2)
+                    heaps.Free(live[i].m_HeapIndex, live[i].m_Offset);
+            }
+            CheckHeapInvariants(heaps, {});
+            CHECK(heaps.GetUsage().GetFragmentationPercent() < 100.0f);
+        }
+        CHECK(heaps.GetUsage().m_TotalSize == firstCycleMemory);
+    }
+}
@@ -16,6 +16,7 @@
 //     against a real hidden swapchain — no crash, no D3D12 validation errors
 //   - Opaque / masked / transparent bucket counts after scene load
 //   - HZB texture creation, mip chain, and SPD atomic counter
+//   - Phase 2 HZB mip chain recorded on the async compute queue
 //   - Frustum / occlusion / cone culling toggle: full frame survives each combo
 //   - Meshlet vs. vertex rendering toggle: full frame survives both paths
 //   - Forced LOD selection: full frame survives LOD 0 and LOD -1
@@ -1332,6 +1333,33 @@ TEST_SUITE("Rendering_HZB")
 
         g_Renderer.m_EnableOcclusionCulling = prevOcclusion;
     }
+
+    // ------------------------------------------------------------------
+    // TC-HZB-09: The phase 2 HZB mip chain is recorded on the async compute
+    //            queue when the device has one
+    // ------------------------------------------------------------------
+    TEST_CASE_FIXTURE(MinimalSceneFixture, "TC-HZB-09 HZB - phase 2 mip chain runs on the async compute queue")
+    {
+        if (!Config::Get().m_EnableAsyncCompute || !DEV()->queryFeatureSupport(nvrhi::Feature::ComputeQueue))
+        {
+            WARN("Skipping: async compute unavailable");
+            return;
+        }
+
+        const bool prevOcclusion = g_Renderer.m_EnableOcclusionCulling;
+        const bool prevFreeze = g_Renderer.m_FreezeCullingCamera;
+        g_Renderer.m_EnableOcclusionCulling = true;
+        g_Renderer.m_FreezeCullingCamera = false;
+
+        const uint64_t recordedBefore = g_Renderer.m_RenderGraph.GetAsyncComputePassesRecorded();
+        CHECK_NOTHROW(RunOneFrame());
+
+        CHECK(g_Renderer.m_RenderGraph.GetStats().m_NumAsyncComputePasses >= 1u);
+        CHECK(g_Renderer.m_RenderGraph.GetAsyncComputePassesRecorded() > recordedBefore);
+
+        g_Renderer.m_EnableOcclusionCulling = prevOcclusion;
+        g_Renderer.m_FreezeCullingCamera = prevFreeze;
+    }
 }
 
 // ============================================================================